@@ -0,0 +1,85 @@
+#ifndef ARCHIVEEXTRACTOR_H
+#define ARCHIVEEXTRACTOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+struct archive;
+
+/**
+ * ArchiveExtractor - Entpacken im Prozess mit libarchive (zip, 7z, tar.*)
+ *
+ * Ersetzt system("7z x ...") und das anschließende Durchzählen des Zielbaums:
+ * - liest direkt aus der heruntergeladenen Datei, Eintrag für Eintrag
+ * - meldet jede fertig geschriebene Datei sofort (onFile), damit z.B. die
+ *   SID-Konvertierung schon während des Entpackens startet
+ * - echter Fortschritt: gelesene Archiv-Bytes von der Dateigröße, Einträge
+ * - verschachtelte .zip-Archive (HVSC: C64Music.zip im Download) werden aus
+ *   dem äußeren Stream entpackt, ohne Zwischendatei auf der Platte
+ * - absolute Pfade, ".."-Komponenten und Schreiben über Symlinks werden abgewiesen
+ *
+ * Zeitstempel werden nicht übernommen: entpackte Dateien sind "neu", damit
+ * z.B. der Songlengths-Index eine neue Songlengths.md5 erkennt.
+ *
+ * Ohne libarchive (WITH_LIBARCHIVE nicht gesetzt) liefert available() false
+ * und extract() schlägt fehl; Aufrufer fallen dann auf 7z/unzip zurück.
+ *
+ * Verwendung:
+ *   ArchiveExtractor::Options options;
+ *   options.onFile = [](const std::string& path) { ... };
+ *   ArchiveExtractor extractor(options);
+ *   if (!extractor.extract(zipPath, targetDir)) std::cerr << extractor.error();
+ */
+class ArchiveExtractor {
+public:
+    struct Progress {
+        uint64_t bytesRead = 0;         // Gelesene Bytes des (äußeren) Archivs
+        uint64_t bytesTotal = 0;        // Größe der Archivdatei
+        uint64_t bytesWritten = 0;      // Entpackte Bytes
+        size_t entries = 0;
+        size_t files = 0;               // Geschriebene reguläre Dateien
+    };
+
+    struct Options {
+        // Läuft im entpackenden Thread, nachdem die Datei vollständig geschrieben ist
+        std::function<void(const std::string& path)> onFile;
+        std::function<void(const Progress&)> onProgress;
+        int progressIntervalMs = 250;   // onProgress höchstens so oft (plus einmal am Ende)
+        bool expandNestedZips = true;
+        const std::atomic<bool>* stopFlag = nullptr;
+    };
+
+    ArchiveExtractor() : ArchiveExtractor(Options()) {}
+    explicit ArchiveExtractor(const Options& options);
+
+    // true wenn mit libarchive gebaut
+    static bool available();
+
+    /**
+     * Entpackt archivePath nach targetDir (wird angelegt)
+     * @return false bei Lese-/Schreibfehler oder Abbruch (siehe error())
+     */
+    bool extract(const std::string& archivePath, const std::string& targetDir);
+
+    const Progress& progress() const { return progress_; }
+    const std::string& error() const { return error_; }
+    size_t skippedEntries() const { return skipped_; }     // Unsichere oder nicht schreibbare Einträge
+    double lastSeconds() const { return seconds_; }
+
+private:
+    Options options_;
+    Progress progress_;
+    std::string error_;
+    size_t skipped_ = 0;
+    double seconds_ = 0.0;
+    int64_t nextReportMs_ = 0;
+    struct archive* outer_ = nullptr;   // Für bytesRead
+
+    void report(bool force);
+    bool stopped() const { return options_.stopFlag && options_.stopFlag->load(); }
+    bool extractFrom(struct archive* reader, struct archive* disk, const std::string& targetDir, int depth);
+};
+
+#endif // ARCHIVEEXTRACTOR_H
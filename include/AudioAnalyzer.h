@@ -2,11 +2,22 @@
 #define AUDIOANALYZER_H
 
 #include "MediaDatabase.h"
+#include "SpectralWorkspace.h"
+#include "FeatureFrames.h"
 #include <string>
 #include <vector>
 #include <complex>
 #include <memory>
 #include <functional>
+#include <atomic>
+#include <map>
+
+// Optionen für AudioAnalyzer::analyzeBatch
+struct AnalyzerBatchOptions {
+    unsigned int threads = 0;              // 0 = alle CPU-Kerne
+    size_t maxBuffersInFlight = 0;         // Max. gleichzeitig offene Decoder (0 = threads)
+    const std::atomic<bool>* stopFlag = nullptr;  // Optional: Abbruch
+};
 
 /**
  * AudioAnalyzer - FFT-basierte Audio-Feature-Extraktion
@@ -33,9 +44,62 @@ public:
      * @return true bei Erfolg
      */
     bool analyze(const std::string& filepath, MediaMetadata& meta);
-    
+
+    /**
+     * Analysiert bereits dekodierte Mono-Samples (ohne Datei-Zugriff)
+     * @param samples Mono-Samples [-1, 1]
+     * @param sampleRate Sample-Rate der Samples
+     * @param meta Output: MediaMetadata-Struktur (filepath bleibt unverändert)
+     * @return true bei Erfolg
+     */
+    bool analyzeSamples(const std::vector<float>& samples, int sampleRate, MediaMetadata& meta);
+
     /**
-     * Batch-Analyse mit Multi-Threading
+     * Analysiert bereits berechnete Frame-Features (z.B. aus loadFeatureFrames)
+     * @param frames Frame-Speicher des Tracks
+     * @param meta Output: MediaMetadata-Struktur (filepath bleibt unverändert)
+     * @return true bei Erfolg
+     */
+    bool analyzeFrames(const FeatureFrames& frames, MediaMetadata& meta);
+
+    /**
+     * Dekodiert die Datei chunkweise (AudioStreamReader) direkt in den Frame-Speicher.
+     * Der PCM-Speicherbedarf bleibt konstant, unabhängig von der Track-Länge.
+     * @return true bei Erfolg
+     */
+    bool loadFeatureFrames(const std::string& filepath, FeatureFrames& frames);
+
+    /**
+     * SID-Subtune ohne Umweg über MP3/WAV: rendert per SIDLibConverter::renderPCM
+     * (mit Render-Cache) und füttert die Samples direkt in den Frame-Speicher.
+     * Länge aus Songlengths (Fallback 180 s). loadFeatureFrames() nutzt das für .sid.
+     * @param subtune Subtune-Nummer (0 = Start-Song)
+     */
+    bool loadSIDFeatureFrames(const std::string& sidPath, int subtune, FeatureFrames& frames);
+
+    using BatchOptions = AnalyzerBatchOptions;
+
+    // Ergebnis-Callback: (Index in filepaths, Metadaten, Erfolg). Wird aus Worker-Threads aufgerufen!
+    using BatchResultCallback = std::function<void(size_t, const MediaMetadata&, bool)>;
+
+    /**
+     * Parallele Batch-Analyse (Work-Stealing, ein Analyzer pro Worker)
+     * Ergebnisse werden sofort per Callback gestreamt statt gesammelt.
+     * @param filepaths Liste der Audio-Dateien
+     * @param resultCallback callback(index, meta, success) - muss thread-safe sein
+     * @param progressCallback Optional: callback(completed, total)
+     * @param options Threads, Speicher-Limit, Abbruch
+     * @return Anzahl erfolgreich analysierter Dateien
+     */
+    size_t analyzeBatch(
+        const std::vector<std::string>& filepaths,
+        const BatchResultCallback& resultCallback,
+        const std::function<void(size_t, size_t)>& progressCallback = nullptr,
+        const BatchOptions& options = BatchOptions()
+    );
+
+    /**
+     * Batch-Analyse mit Multi-Threading (sammelt alle Ergebnisse)
      * @param filepaths Liste der Audio-Dateien
      * @param progressCallback Optional: callback(current, total)
      * @return Vector mit analysierten Metadaten
@@ -45,15 +109,22 @@ public:
         const std::function<void(size_t, size_t)>& progressCallback = nullptr
     );
     
-    // Feature-Extraktion
+    // Feature-Extraktion (Sample-Varianten rechnen intern FeatureFrames::compute)
     float detectBPM(const std::vector<float>& samples, int sampleRate);
     std::vector<std::string> detectInstruments(const std::vector<float>& samples, int sampleRate);
     std::string classifyGenre(const MediaMetadata& meta);
     std::string detectIntensity(const std::vector<float>& samples);
     std::string detectBassLevel(const std::vector<float>& samples, int sampleRate);
     
+    // Feature-Extraktion aus dem gemeinsamen Frame-Speicher (ein STFT-Durchlauf für alle)
+    float detectBPM(const FeatureFrames& frames);
+    std::vector<std::string> detectInstruments(const FeatureFrames& frames);
+    std::string detectIntensity(const FeatureFrames& frames);
+    std::string detectBassLevel(const FeatureFrames& frames);
+    
     // Automatische Genre-Erkennung aus Audio-Features
     std::string detectGenreFromAudio(const std::vector<float>& samples, int sampleRate, float bpm);
+    std::string detectGenreFromAudio(const FeatureFrames& frames, float bpm);
     
     // Übersteuerungs-Erkennung und Reparatur
     struct ClippingInfo {
@@ -69,6 +140,7 @@ public:
     
     // Erweiterte Stil-Analyse
     std::string analyzeRhythmPattern(const std::vector<float>& samples, int sampleRate, float bpm);
+    std::string analyzeRhythmPattern(const FeatureFrames& frames, float bpm);
     std::string detectMusicalStyle(const MediaMetadata& meta);
     std::vector<std::string> extractStyleTags(const MediaMetadata& meta);
     
@@ -94,6 +166,7 @@ public:
     };
     
     SongStructure analyzeSongStructure(const std::vector<float>& samples, int sampleRate, float bpm);
+    SongStructure analyzeSongStructure(const FeatureFrames& frames, float bpm);
     void learnStructurePatterns(const std::vector<SongStructure>& structures, const std::string& genre);
     
     // Automatische Sortierung
@@ -106,11 +179,12 @@ public:
     std::vector<SortCategory> generateSortStructure(const std::vector<MediaMetadata>& files);
     
     // Spektral-Analyse
-    float calculateSpectralCentroid(const std::vector<std::complex<float>>& spectrum);
+    float calculateSpectralCentroid(const SpectrumView& spectrum);
     float calculateSpectralCentroid(const std::vector<float>& spectrum, int sampleRate); // Overload for frequency-based
-    float calculateSpectralRolloff(const std::vector<std::complex<float>>& spectrum, float threshold = 0.85f);
+    float calculateSpectralRolloff(const SpectrumView& spectrum, float threshold = 0.85f);
     float calculateZeroCrossingRate(const std::vector<float>& samples);
     float calculateMFCCHash(const std::vector<float>& samples, int sampleRate);
+    float calculateMFCCHash(const FeatureFrames& frames);
 
     // Stille-Erkennung / Auto-Trim
     // Analysiert eine WAV-Datei (16-Bit PCM) und ermittelt, ob sie hörbaren Inhalt hat.
@@ -124,22 +198,19 @@ public:
         float tailSilenceSeconds = 3.0f
     );
     
-    // Audio-Loading (public for use in callbacks)
+    // Audio-Loading (public for use in callbacks) - lädt die ganze Datei als Mono-Buffer.
+    // Für reine Analyse loadFeatureFrames bevorzugen (streamt statt alles zu laden).
     bool loadAudioFile(const std::string& filepath, std::vector<float>& samples, int& sampleRate);
     
 private:
-    // FFT-Utilities
-    std::vector<std::complex<float>> performFFT(const std::vector<float>& samples);
-    std::vector<float> extractMFCC(const std::vector<float>& samples, int sampleRate, int numCoeffs = 13);
+    // MFCC aus den gemittelten Mel-Bändern des Frame-Speichers
+    std::vector<float> extractMFCC(const FeatureFrames& frames, int numCoeffs = 13);
     
-    // Rhythmus-Analyse
-    std::vector<float> detectOnsets(const std::vector<float>& samples, int sampleRate);
+    // Rhythmus-Analyse (Onset-Zeitpunkte in Sekunden)
+    std::vector<float> detectOnsets(const FeatureFrames& frames);
     std::vector<int> analyzeTimingPattern(const std::vector<float>& onsets, float bpm);
     std::string classifyRhythmComplexity(const std::vector<int>& pattern);
     
-    // Audio-Loading internal
-    bool loadWAV(const std::string& filepath, std::vector<float>& samples, int& sampleRate);
-    
     // ML/NPU-Integration (falls verfügbar)
     bool useNPU_ = false;
     void initializeNPU();
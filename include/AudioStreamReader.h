@@ -0,0 +1,103 @@
+#ifndef AUDIOSTREAMREADER_H
+#define AUDIOSTREAMREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * AudioStreamReader - Chunkweises Dekodieren von Audio-Dateien als Mono-Frames
+ *
+ * Statt die ganze Datei interleaved zu laden und danach eine zweite Mono-Kopie
+ * zu bauen, liefert read() feste Blöcke Mono-Samples:
+ * - Downmix aller Kanäle on-the-fly
+ * - Optionales Resampling (libsamplerate falls vorhanden, sonst linear)
+ * - Backend: libsndfile (WAV/FLAC/OGG/MP3), ohne libsndfile ein RIFF/WAV-Parser
+ *   (PCM 16/24/32 Bit und Float)
+ *
+ * Der Speicherbedarf ist unabhängig von der Track-Länge (ein Chunk pro Reader).
+ *
+ * Verwendung:
+ *   AudioStreamReader reader;
+ *   if (reader.open(path)) {
+ *       std::vector<float> chunk(AudioStreamReader::kDefaultChunkFrames);
+ *       while (size_t n = reader.read(chunk.data(), chunk.size())) { ... }
+ *   }
+ */
+class AudioStreamReader {
+public:
+    static constexpr size_t kDefaultChunkFrames = 4096;
+
+    AudioStreamReader() = default;
+    ~AudioStreamReader();
+
+    AudioStreamReader(const AudioStreamReader&) = delete;
+    AudioStreamReader& operator=(const AudioStreamReader&) = delete;
+
+    /**
+     * Öffnet eine Audio-Datei
+     * @param filepath Pfad zur Audio-Datei
+     * @param targetSampleRate Ausgabe-Rate (0 = Rate der Quelle beibehalten)
+     * @return true bei Erfolg
+     */
+    bool open(const std::string& filepath, int targetSampleRate = 0);
+    void close();
+    bool isOpen() const { return isOpen_; }
+
+    int sampleRate() const { return targetRate_; }       // Rate der gelieferten Samples
+    int sourceSampleRate() const { return sourceRate_; }
+    int channels() const { return channels_; }           // Kanäle der Quelle
+
+    // Geschätzte Anzahl Mono-Frames nach Resampling (-1 = unbekannt)
+    int64_t estimatedFrames() const;
+
+    /**
+     * Liest bis zu maxFrames Mono-Samples [-1, 1]
+     * @return Anzahl gelesener Frames (0 = Dateiende oder Fehler)
+     */
+    size_t read(float* out, size_t maxFrames);
+
+    /**
+     * Komfort-Funktion: liest die ganze Datei in einen Mono-Buffer
+     * (ohne zusätzliche interleaved Kopie)
+     */
+    static bool readAll(const std::string& filepath, std::vector<float>& samples,
+                        int& sampleRate, int targetSampleRate = 0);
+
+private:
+    // Mono-Samples mit Quell-Rate
+    size_t readSource(float* out, size_t maxFrames);
+    size_t readWavSource(float* out, size_t maxFrames);
+    bool openWav(const std::string& filepath);
+    bool fillResampleInput();
+    size_t readResampled(float* out, size_t maxFrames);
+
+    bool isOpen_ = false;
+    int sourceRate_ = 0;
+    int targetRate_ = 0;
+    int channels_ = 0;
+    int64_t sourceFrames_ = -1;
+
+    // libsndfile-Backend (SNDFILE*, nur mit WITH_SNDFILE)
+    void* sndfile_ = nullptr;
+    std::vector<float> interleaved_;
+
+    // WAV-Fallback
+    std::ifstream wav_;
+    uint64_t wavBytesLeft_ = 0;
+    int wavBitsPerSample_ = 0;
+    bool wavFloat_ = false;
+    std::vector<char> raw_;
+
+    // Resampling
+    bool resample_ = false;
+    bool sourceEof_ = false;
+    std::vector<float> resampleIn_;     // Mono-Samples mit Quell-Rate
+    size_t resampleInPos_ = 0;
+    double resamplePhase_ = 0.0;        // Linear: Position relativ zu resampleIn_[resampleInPos_]
+    void* srcState_ = nullptr;          // SRC_STATE* (nur mit WITH_SAMPLERATE)
+};
+
+#endif // AUDIOSTREAMREADER_H
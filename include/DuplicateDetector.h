@@ -0,0 +1,72 @@
+#ifndef DUPLICATEDETECTOR_H
+#define DUPLICATEDETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * DuplicateDetector - Duplikat-Kandidaten ohne quadratischen Self-Join
+ *
+ * Statt jedes Paar der Bibliothek zu vergleichen, werden nur Tracks
+ * verglichen, die sich einen Bucket teilen:
+ * - Identische Metadaten: Gruppen nach (Titel, Artist), darin nach Dauer
+ *   sortiert und per Sweep-Fenster (±0.1 s) verglichen
+ * - Audio-Duplikate: LSH über den MFCC-/Spektral-Vektor (p-stable, mehrere
+ *   Tabellen), innerhalb jedes LSH-Buckets nach Dauer sortiert und nur im
+ *   ±2 s / ±2 BPM Fenster bewertet
+ * - Tracks ohne MFCC-Vektoren (vor dem MFCC-Update analysiert) werden über
+ *   ein BPM-Raster + Dauer-Sweep gegen alle anderen geprüft
+ *
+ * Ergebnis und Ähnlichkeitsmaß entsprechen dem bisherigen SQL-Vergleich.
+ */
+class DuplicateDetector {
+public:
+    static constexpr float kMaxDurationDiff = 2.0f;     // Sekunden (Audio-Duplikate)
+    static constexpr float kMaxBpmDiff = 2.0f;
+    static constexpr float kIdenticalDurationDiff = 0.1f;
+
+    struct Track {
+        int64_t id = 0;
+        std::string filepath;
+        std::string title;
+        std::string artist;
+        bool hasTitleArtist = false;        // NULL-Titel/Artist matchen nie (wie in SQL)
+        float duration = 0.0f;
+        float bpm = 0.0f;
+        float mfccHash = 0.0f;
+        float spectralCentroid = 0.0f;
+        std::vector<float> mfccMean;        // Leer = nur skalare Signatur vorhanden
+        bool analyzed = false;
+    };
+
+    struct Match {
+        size_t first;                       // Index in tracks()
+        size_t second;
+        float similarity;
+        std::string reason;                 // "identical_metadata", "similar_audio"
+    };
+
+    void clear() { tracks_.clear(); }
+    void reserve(size_t n) { tracks_.reserve(n); }
+    void add(Track track) { tracks_.push_back(std::move(track)); }
+    const std::vector<Track>& tracks() const { return tracks_; }
+
+    // Gleicher Titel + Artist, Dauer-Differenz < 0.1 s
+    std::vector<Match> findIdentical() const;
+
+    // Audio-Ähnlichkeit >= threshold innerhalb ±2 s / ±2 BPM
+    std::vector<Match> findAudioDuplicates(float threshold) const;
+
+    // Ähnlichkeit zweier Tracks (0..1): 70% MFCC, 30% Spectral Centroid
+    static float audioSimilarity(const Track& a, const Track& b);
+
+    // Liegt das Paar im Vergleichsfenster (Dauer/BPM)?
+    static bool withinAudioWindow(const Track& a, const Track& b);
+
+private:
+    std::vector<Track> tracks_;
+};
+
+#endif // DUPLICATEDETECTOR_H
@@ -1,10 +1,12 @@
 #ifndef EXTRACTCONFIG_H
 #define EXTRACTCONFIG_H
 
+#include <algorithm>
 #include <thread>
 
 struct ExtractConfig {
-    int threads;
+    int threads;            // Emulator-Threads (SID-Rendering)
+    int encoderThreads;     // MP3-Encoder-Threads (eigener Pool, siehe MP3EncoderPool)
     int timeoutSec;
 };
 
@@ -28,6 +30,9 @@ inline ExtractConfig autoTuneExtractConfig() {
         cfg.timeoutSec = 180;
     }
 
+    // LAME encodiert etwa 3-4x schneller als ReSIDfp emuliert
+    cfg.encoderThreads = std::max(1, cfg.threads / 4);
+
     return cfg;
 }
 
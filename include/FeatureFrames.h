@@ -0,0 +1,134 @@
+#ifndef FEATUREFRAMES_H
+#define FEATUREFRAMES_H
+
+#include "MFCCKernel.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * FeatureFrames - Gemeinsamer Frame-Speicher für alle Audio-Detektoren
+ *
+ * Ein einziger STFT-Durchlauf (Hann-Fenster, frameSize/hopSize) über den
+ * gesamten Track liefert pro Frame:
+ * - Energie-Hüllkurve (mittlere quadrierte Amplitude, ungefenstert)
+ * - Onset-Funktion (positive Energie-Differenz)
+ * - Mel-Bänder (numMelBands dreieckige Mel-Filter auf dem Leistungsspektrum)
+ * - MFCCs (log-Mel -> DCT), als Mittelwert/Varianz über alle Frames
+ * - Spectral Centroid / Rolloff (Hz) und Zero-Crossing-Rate
+ *
+ * Zusätzlich werden track-weite Werte (RMS, ZCR, mittleres Betragsspektrum)
+ * im selben Durchlauf akkumuliert. BPM, Genre, Intensität, Bass, Instrumente,
+ * MFCC und Struktur lesen nur noch aus diesem Speicher statt die Samples
+ * jeweils erneut zu scannen bzw. zu transformieren.
+ */
+struct FeatureFrames {
+    static constexpr size_t kDefaultFrameSize = 2048;
+    static constexpr size_t kDefaultHopSize = 512;
+    static constexpr size_t kMelBands = 26;
+    static constexpr size_t kMfccCoeffs = 13;
+
+    int sampleRate = 0;
+    size_t sampleCount = 0;
+    size_t frameSize = kDefaultFrameSize;
+    size_t hopSize = kDefaultHopSize;
+    size_t fftSize = 0;                 // Tatsächliche FFT-Größe (ohne FFTW3 ggf. kleiner)
+    size_t numMelBands = kMelBands;
+    size_t numMfcc = kMfccCoeffs;
+
+    // Pro Frame
+    std::vector<float> energy;          // Mittlere quadrierte Amplitude
+    std::vector<float> onset;           // max(0, energy[i] - energy[i-1])
+    std::vector<float> centroid;        // Hz
+    std::vector<float> rolloff;         // Hz (85% der Betragssumme)
+    std::vector<float> zcr;             // Nulldurchgänge / Frame-Länge
+    std::vector<float> melBands;        // frameCount * numMelBands (Filter-Energie, linear)
+
+    // Track-weit
+    float rms = 0.0f;                   // RMS über alle Samples
+    float zeroCrossingRate = 0.0f;      // Nulldurchgänge / Samples
+    float meanCentroid = 0.0f;          // Hz, Mittel über hörbare Frames
+    float meanRolloff = 0.0f;           // Hz, Mittel über hörbare Frames
+    std::vector<float> meanMagnitude;   // Mittleres Betragsspektrum (fftSize/2+1 Bins)
+    std::vector<float> mfccMean;        // numMfcc, Mittel über alle Frames
+    std::vector<float> mfccVariance;    // numMfcc, Varianz über alle Frames
+
+    size_t frameCount() const { return energy.size(); }
+    bool empty() const { return energy.empty(); }
+    float duration() const { return sampleRate > 0 ? static_cast<float>(sampleCount) / sampleRate : 0.0f; }
+    float frameTime(size_t frame) const { return sampleRate > 0 ? static_cast<float>(frame * hopSize) / sampleRate : 0.0f; }
+    float framesPerSecond() const { return hopSize > 0 ? static_cast<float>(sampleRate) / hopSize : 0.0f; }
+    float binFrequency(size_t bin) const { return fftSize > 0 ? static_cast<float>(bin) * sampleRate / fftSize : 0.0f; }
+    const float* mel(size_t frame) const { return melBands.data() + frame * numMelBands; }
+
+    // Frame-Index, in dem der Zeitpunkt (Sekunden) liegt
+    size_t frameAt(float seconds) const;
+
+    /**
+     * Berechnet alle Frame-Features in einem Durchlauf
+     * @param samples Mono-Samples [-1, 1]
+     * @param sampleRate Sample-Rate
+     * @param frameSize Fenstergröße (Samples)
+     * @param hopSize Schrittweite (Samples)
+     */
+    static FeatureFrames compute(const std::vector<float>& samples, int sampleRate,
+                                 size_t frameSize = kDefaultFrameSize,
+                                 size_t hopSize = kDefaultHopSize);
+};
+
+/**
+ * FeatureFrameBuilder - Baut FeatureFrames inkrementell aus Sample-Chunks
+ *
+ * Hält höchstens einen Frame an PCM zwischen zwei Chunks, damit lange
+ * Tracks direkt aus einem AudioStreamReader analysiert werden können.
+ * Ergebnis ist identisch zu FeatureFrames::compute über denselben Samples.
+ *
+ * Verwendung:
+ *   FeatureFrameBuilder builder(reader.sampleRate());
+ *   while ((n = reader.read(chunk.data(), chunk.size())) > 0) builder.push(chunk.data(), n);
+ *   FeatureFrames frames = builder.finish();
+ */
+class FeatureFrameBuilder {
+public:
+    explicit FeatureFrameBuilder(int sampleRate,
+                                 size_t frameSize = FeatureFrames::kDefaultFrameSize,
+                                 size_t hopSize = FeatureFrames::kDefaultHopSize);
+
+    // Hängt count Mono-Samples an und verarbeitet alle vollständigen Frames
+    void push(const float* samples, size_t count);
+
+    // Schließt den Durchlauf ab (Builder ist danach verbraucht)
+    FeatureFrames finish();
+
+    size_t samplesPushed() const { return frames_.sampleCount; }
+
+private:
+    void processFrame(const float* src, size_t len);
+
+    FeatureFrames frames_;
+    bool valid_ = false;
+
+    std::vector<float> pending_;        // Samples ab nextFrameStart_ (< frameSize)
+    size_t nextFrameStart_ = 0;         // Absolute Sample-Position des nächsten Frames
+
+    // Laufende Akkumulatoren
+    double sumSquares_ = 0.0;
+    size_t crossings_ = 0;
+    float prevSample_ = 0.0f;
+    double centroidSum_ = 0.0;
+    double rolloffSum_ = 0.0;
+    size_t audibleFrames_ = 0;
+    std::vector<double> magnitudeSum_;
+    std::vector<double> mfccSum_;
+    std::vector<double> mfccSumSquares_;
+
+    // Arbeitspuffer
+    std::vector<float> frame_;
+    std::vector<float> assembled_;      // Frame über eine Chunk-Grenze hinweg
+    std::vector<float> magnitudes_;
+    std::vector<float> power_;
+    std::vector<float> mfcc_;
+    MelFilterbank melFilters_;
+    MFCCKernel mfccKernel_;
+};
+
+#endif // FEATUREFRAMES_H
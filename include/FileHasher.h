@@ -0,0 +1,57 @@
+#ifndef FILEHASHER_H
+#define FILEHASHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * FileHasher - Schneller Content-Hash für Duplikatserkennung (XXH64)
+ *
+ * Nicht kryptographisch, aber mit mehreren GB/s deutlich schneller als
+ * SHA256/MD5 und für die Erkennung byte-identischer Dateien (HVSC-Re-Extracts,
+ * SMB-Spiegel) ausreichend. Implementierung ohne externe Abhängigkeit,
+ * kompatibel zur Referenz-XXH64 (Seed 0).
+ *
+ * Große Dateien werden per mmap gelesen (optional), sonst in 1-MB-Blöcken.
+ *
+ * Verwendung:
+ *   meta.fileHash = FileHasher::hashFile(path);   // "xxh64:0123456789abcdef"
+ */
+class FileHasher {
+public:
+    static constexpr const char* kPrefix = "xxh64:";
+
+    /**
+     * Hash des Dateiinhalts
+     * @param filepath Pfad zur Datei
+     * @param useMmap Dateien ab 1 MB per mmap lesen (sonst gepufferte Reads)
+     * @return "xxh64:" + 16 Hex-Zeichen, leer bei Lesefehler
+     */
+    static std::string hashFile(const std::string& filepath, bool useMmap = true);
+
+    // XXH64 über einen Speicherbereich
+    static uint64_t hashBytes(const void* data, size_t length, uint64_t seed = 0);
+
+    // Formatiert einen Hash-Wert wie hashFile()
+    static std::string toString(uint64_t hash);
+
+    /**
+     * Streaming-Variante (für Daten, die chunkweise anfallen)
+     */
+    class Stream {
+    public:
+        explicit Stream(uint64_t seed = 0);
+        void update(const void* data, size_t length);
+        uint64_t digest() const;
+
+    private:
+        uint64_t v_[4];
+        uint64_t seed_;
+        uint64_t totalLength_ = 0;
+        unsigned char buffer_[32];
+        size_t bufferSize_ = 0;
+    };
+};
+
+#endif // FILEHASHER_H
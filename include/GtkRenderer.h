@@ -2,11 +2,13 @@
 #define GTKRENDERER_H
 
 #include "MediaDatabase.h"
+#include "MediaPager.h"
 #include "AudioAnalyzer.h"
 #include "FileBrowser.h"
 #include "SongGenerator.h"
 #include "HVSCDownloader.h"
 #include "AudioPlayer.h"
+#include "LibraryWatcher.h"
 #include <gtk/gtk.h>
 #include <memory>
 #include <string>
@@ -107,7 +109,7 @@ private:
     std::unique_ptr<class SongGen::DataQualityAnalyzer> qualityAnalyzer_;  // 📊 Data Quality
     
     // State
-    std::vector<MediaMetadata> filteredMedia_;
+    std::unique_ptr<MediaPager> dbPager_;  // Virtuelle Trefferliste des Datenbank-Tabs
     std::atomic<bool> running_{false};
     std::atomic<bool> isDeleting_{false};
     std::atomic<size_t> deleteProgress_{0};
@@ -115,8 +117,7 @@ private:
     std::atomic<size_t> mp3Extracted_{0};
     std::atomic<size_t> mp3Total_{0};
     std::atomic<bool> stopExtraction_{false};
-    std::thread autoSyncThread_;
-    std::atomic<bool> autoSyncRunning_{false};
+    std::unique_ptr<LibraryWatcher> libraryWatcher_;   // Auto-Sync von ~/.songgen/hvsc/mp3/
     std::atomic<bool> isTraining_{false};
     std::atomic<size_t> trainingEpoch_{0};
     std::atomic<size_t> trainingMaxEpochs_{0};
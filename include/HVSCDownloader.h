@@ -11,10 +11,10 @@
  * 
  * Features:
  * - Download von HVSC aus dem Internet (hvsc.de Mirror)
- * - Multi-Mirror-Unterstützung mit Geschwindigkeitstest
+ * - Multi-Mirror-Unterstützung mit parallelem Geschwindigkeitstest
  * - Automatische SID-Extraktion mit SIDLibConverter
  * - Fortschritts-Tracking
- * - Resume-Support
+ * - Segmentierter Download mit Resume-Support und SHA-256-Prüfung (SegmentedDownloader)
  */
 class HVSCDownloader {
 public:
@@ -56,6 +56,26 @@ public:
         std::atomic<bool>* stopFlag = nullptr
     );
     
+    /**
+     * Entpackt ein HVSC-Archiv und konvertiert jede SID, sobald sie entpackt ist
+     * (Entpacken und Rendern überlappen; benötigt libarchive, siehe ArchiveExtractor)
+     * @param archivePath Heruntergeladenes Archiv (auch mit verschachteltem C64Music.zip)
+     * @param targetDir Ziel-Verzeichnis für die entpackten Dateien
+     * @param wavDir Ausgabe-Verzeichnis für die Audiodateien
+     * @param progressCallback Optional: callback(completed, total) der Konvertierung
+     * @param extracted Optional: ob das Archiv vollständig entpackt wurde
+     * @return Anzahl erfolgreich konvertierter Dateien
+     */
+    size_t extractAndConvertArchive(
+        const std::string& archivePath,
+        const std::string& targetDir,
+        const std::string& wavDir,
+        int threads,
+        std::function<void(size_t, size_t)> progressCallback = nullptr,
+        std::atomic<bool>* stopFlag = nullptr,
+        bool* extracted = nullptr
+    );
+    
     /**
      * Fügt extrahierte WAVs zur Datenbank hinzu
      * @param wavDir Verzeichnis mit WAV-Dateien
@@ -69,6 +89,13 @@ public:
         bool analyzeImmediately = false
     );
     
+    /**
+     * Datenbank-Eintrag für eine extrahierte SID-Audiodatei (WAV/MP3)
+     * @param filepath Pfad der Audiodatei
+     * @param fileHash Content-Hash (FileHasher)
+     */
+    static struct MediaMetadata makeMediaMetadata(const std::string& filepath, const std::string& fileHash);
+    
     // Status
     bool isDownloading() const { return isDownloading_; }
     void cancel();
@@ -89,9 +116,9 @@ private:
     std::string cachedFastestMirror_;
     std::string mirrorCacheFile_ = "~/.songgen/mirror_cache.txt";
     
-    float testMirrorSpeed(const std::string& mirrorUrl);
     bool downloadFile(const std::string& url, const std::string& targetPath,
-                      std::function<void(size_t, size_t, float)> progressCallback);
+                      std::function<void(size_t, size_t, float)> progressCallback,
+                      std::atomic<bool>* stopFlag = nullptr);
     bool extractArchive(const std::string& archivePath, const std::string& targetDir);
     
     void saveFastestMirror(const std::string& mirror);
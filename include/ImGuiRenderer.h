@@ -2,11 +2,13 @@
 #define IMGUIRENDERER_H
 
 #include "MediaDatabase.h"
+#include "MediaPager.h"
 #include "AudioAnalyzer.h"
 #include "FileBrowser.h"
 #include "SongGenerator.h"
 #include "HVSCDownloader.h"
 #include "AudioPlayer.h"
+#include "LibraryWatcher.h"
 #include <memory>
 #include <string>
 
@@ -64,13 +66,24 @@ private:
     void renderSettings();
     
     // Database-Browser
-    std::vector<MediaMetadata> filteredMedia_;
+    std::unique_ptr<MediaPager> mediaPager_;     // Virtuelle Trefferliste, lädt nur sichtbare Zeilen
     std::string searchQuery_;
     std::string genreFilter_;
     std::string intensityFilter_;
+    std::string styleFilter_;                    // Musik-Sorter: Teilstring in mood/genre
+    int mediaSortMode_ = 0;
     int selectedMediaIndex_ = -1;
     std::string currentlyPlaying_;
     
+    // Zähler und Genre-Liste werden mit der Abfrage geladen, nicht pro Frame
+    size_t mediaTotalCount_ = 0;
+    size_t mediaAnalyzedCount_ = 0;
+    size_t mediaWithMoodCount_ = 0;
+    size_t mediaListGeneration_ = 0;
+    std::vector<std::string> mediaGenres_;
+    std::atomic<bool> mediaListDirty_{true};     // Hintergrund-Threads setzen, Render-Thread lädt neu
+    void reloadMediaList();
+    
     // Generator-State
     GenerationParams genParams_;
     std::string outputPath_ = "~/.songgen/generated/";
@@ -79,8 +92,7 @@ private:
     // HVSC-State
     bool isDownloadingHVSC_ = false;
     std::thread hvscThread_;
-    std::thread autoSyncThread_;
-    std::atomic<bool> autoSyncRunning_{false};
+    std::unique_ptr<LibraryWatcher> libraryWatcher_;   // Auto-Sync von ~/.songgen/hvsc/mp3/
     std::string hvscPhase_;
     std::atomic<size_t> hvscProgress_{0};
     std::atomic<size_t> hvscTotal_{0};
@@ -55,7 +55,7 @@ class InstrumentExtractor {
 public:
     /**
      * Extrahiert Instrument-Samples aus einer Audio-Datei
-     * @param audioPath Pfad zur Audio-Datei (MP3/WAV/FLAC)
+     * @param audioPath Pfad zur Audio-Datei (MP3/WAV/FLAC) oder SID (Start-Song, blockweise gerendert)
      * @param minQuality Minimale Qualität (0-1), Standard 0.7
      * @return Liste von extrahierten Instrument-Samples
      */
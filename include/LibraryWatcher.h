@@ -0,0 +1,121 @@
+#ifndef LIBRARYWATCHER_H
+#define LIBRARYWATCHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class MediaDatabase;
+struct MediaMetadata;
+
+/**
+ * LibraryWatcher - Hält die Datenbank inkrementell mit einem Verzeichnisbaum synchron
+ *
+ * Ersetzt das periodische Zählen + Neu-Einlesen des ganzen Baums:
+ * - inotify auf allen Verzeichnissen; fertig geschriebene (IN_CLOSE_WRITE),
+ *   gelöschte und umbenannte Dateien werden gesammelt und gebündelt als
+ *   add/update/remove/move in einem WriteBatch angewendet (umbenannte Dateien
+ *   behalten ihre Analyse, überschriebene werden am Content-Hash erkannt)
+ * - Scan-Journal (Verzeichnis → mtime + Dateinamen), persistiert nach jedem
+ *   Batch. Beim Start, nach einem Event-Überlauf und ohne inotify (Fallback,
+ *   z.B. Watch-Limit erreicht) werden nur Verzeichnisse neu gelesen, deren
+ *   mtime sich geändert hat; alle anderen kosten ein stat().
+ *
+ * Kosten skalieren damit mit den Änderungen, nicht mit der Bibliotheksgröße.
+ *
+ * Verwendung:
+ *   LibraryWatcher watcher(db, mp3Dir, options, [](const LibraryWatcher::Changes& c) { ... });
+ *   watcher.start();   // eigener Thread, stop() bzw. Destruktor beendet ihn
+ */
+class LibraryWatcher {
+public:
+    struct Changes {
+        size_t added = 0;
+        size_t updated = 0;     // Bekannter Pfad mit neuem Inhalt (Analyse wird verworfen)
+        size_t removed = 0;
+        size_t moved = 0;
+        bool any() const { return added + updated + removed + moved > 0; }
+    };
+
+    using ChangeCallback = std::function<void(const Changes&)>;
+    // Erzeugt den Datenbank-Eintrag für eine neue Datei (Pfad, Content-Hash)
+    using MetadataFactory = std::function<MediaMetadata(const std::string&, const std::string&)>;
+
+    struct Options {
+        std::vector<std::string> extensions = {".mp3", ".wav"};
+        std::string journalPath;            // "" = <root>/.songgen_journal
+        int debounceMs = 500;               // Ruhezeit, bevor ein Batch geschrieben wird
+        int maxBatchDelayMs = 3000;         // Spätestens nach dieser Zeit schreiben
+        int fallbackRescanSeconds = 60;     // Journal-Abgleich ohne inotify
+        MetadataFactory makeMetadata;       // Pflicht
+    };
+
+    LibraryWatcher(MediaDatabase& db, const std::string& rootDir, const Options& options,
+                   ChangeCallback onChanges = nullptr);
+    ~LibraryWatcher();
+
+    LibraryWatcher(const LibraryWatcher&) = delete;
+    LibraryWatcher& operator=(const LibraryWatcher&) = delete;
+
+    void start();
+    void stop();
+
+    // true solange inotify aktiv ist (false = Journal-Abgleich im Intervall)
+    bool usingInotify() const { return inotifyFd_ >= 0; }
+
+private:
+    struct DirState {
+        int64_t mtimeNs = -1;
+        std::set<std::string> files;
+        std::set<std::string> subdirs;
+    };
+
+    struct Pending {
+        enum Kind { Upsert, Remove, Move } kind = Upsert;
+        std::string from;                   // nur Move
+        bool verifyContent = true;          // Upsert: bekannten Pfad neu hashen (false = Erstabgleich)
+    };
+
+    MediaDatabase& db_;
+    std::string root_;
+    Options options_;
+    ChangeCallback onChanges_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    // Nur vom Watcher-Thread benutzt
+    int inotifyFd_ = -1;
+    std::unordered_map<int, std::string> watchPaths_;   // wd → Verzeichnis
+    std::unordered_map<std::string, int> watchOf_;      // Verzeichnis → wd
+    std::map<std::string, DirState> journal_;
+    bool journalDirty_ = false;
+    std::map<std::string, Pending> pending_;
+    std::unordered_map<uint32_t, std::string> movedFrom_;   // Cookie → alter Pfad (Datei oder Verzeichnis)
+
+    void run();
+    void processEvents(const char* buffer, size_t length);
+    bool flush();
+
+    // Abgleich gegen das Journal (rekursiv); liest nur geänderte Verzeichnisse
+    void reconcile(const std::string& dir);
+    void forgetDir(const std::string& dir, bool queueRemovals);
+    void moveDir(const std::string& from, const std::string& to);
+    bool addWatch(const std::string& dir);
+    void disableInotify(const char* reason);
+
+    void queueUpsert(const std::string& path);
+    void queueRemove(const std::string& path);
+    bool matchesExtension(const std::string& name) const;
+
+    bool loadJournal();
+    bool saveJournal();
+};
+
+#endif // LIBRARYWATCHER_H
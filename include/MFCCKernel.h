@@ -0,0 +1,98 @@
+#ifndef MFCCKERNEL_H
+#define MFCCKERNEL_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Vektorisierte Grundoperationen für den MFCC-Pfad
+ *
+ * Backend wird zur Compile-Zeit gewählt (Release baut mit -march=native):
+ * - AVX2 (+FMA falls vorhanden) auf x86-64
+ * - NEON auf AArch64
+ * - Skalarer Fallback sonst
+ */
+namespace simd {
+    // Name des aktiven Backends ("AVX2", "NEON", "Scalar")
+    const char* backendName();
+
+    // Skalarprodukt zweier Float-Arrays
+    float dot(const float* a, const float* b, size_t n);
+
+    // power[k] = |X[k]|², magnitude[k] = |X[k]| (magnitude darf nullptr sein)
+    void complexPower(const std::complex<float>* bins, float* power, float* magnitude, size_t n);
+}
+
+/**
+ * MelFilterbank - Vorberechnete dreieckige Mel-Filter (HTK-Mel-Skala)
+ *
+ * Die Filter werden einmal pro (sampleRate, fftSize) als dünn besetzte
+ * Gewichtsvektoren gespeichert (Start-Bin + Gewichte), apply() ist dann
+ * nur noch ein SIMD-Skalarprodukt pro Filter.
+ */
+class MelFilterbank {
+public:
+    MelFilterbank() = default;
+
+    /**
+     * @param sampleRate Sample-Rate
+     * @param fftSize FFT-Größe (Spektrum hat fftSize/2+1 Bins)
+     * @param numFilters Anzahl Mel-Filter
+     * @param minFreq Untere Grenze in Hz
+     * @param maxFreq Obere Grenze in Hz (0 = Nyquist)
+     */
+    MelFilterbank(int sampleRate, size_t fftSize, size_t numFilters = 26,
+                  float minFreq = 20.0f, float maxFreq = 0.0f);
+
+    size_t numFilters() const { return filters_.size(); }
+    size_t numBins() const { return numBins_; }
+
+    // melOut[numFilters] = Filter-Energien des Leistungsspektrums power[numBins]
+    void apply(const float* power, float* melOut) const;
+
+    static float hzToMel(float hz);
+    static float melToHz(float mel);
+
+private:
+    struct Filter {
+        size_t startBin = 0;
+        std::vector<float> weights;
+    };
+
+    std::vector<Filter> filters_;
+    size_t numBins_ = 0;
+};
+
+/**
+ * MFCCKernel - log(Mel) -> DCT-II (orthonormal) mit vorberechneter Matrix
+ *
+ * Ersetzt die naive O(N·M)-cos()-Schleife: die Kosinus-Tabelle wird einmal
+ * aufgebaut, pro Frame bleibt ein SIMD-Skalarprodukt pro Koeffizient.
+ * Nicht thread-safe (interner Log-Puffer) - eine Instanz pro Builder/Thread.
+ */
+class MFCCKernel {
+public:
+    static constexpr float kLogFloor = 1e-10f;
+
+    MFCCKernel() = default;
+    MFCCKernel(size_t numFilters, size_t numCoeffs = 13);
+
+    size_t numFilters() const { return numFilters_; }
+    size_t numCoeffs() const { return numCoeffs_; }
+
+    /**
+     * Berechnet die MFCCs eines Frames
+     * @param melEnergies numFilters lineare Filter-Energien
+     * @param mfccOut numCoeffs Koeffizienten
+     */
+    void compute(const float* melEnergies, float* mfccOut) const;
+
+private:
+    size_t numFilters_ = 0;
+    size_t numCoeffs_ = 0;
+    std::vector<float> dctMatrix_;          // numCoeffs * numFilters
+    mutable std::vector<float> logMel_;     // Arbeitspuffer
+};
+
+#endif // MFCCKERNEL_H
@@ -0,0 +1,117 @@
+#ifndef MP3ENCODERPOOL_H
+#define MP3ENCODERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SPSCRingBuffer.h"
+
+/**
+ * MP3EncoderPool - Eigene Encoder-Threads für die SID→MP3-Pipeline
+ *
+ * Statt Emulation und LAME-Encoding abwechselnd im selben Thread laufen zu
+ * lassen, schieben die Emulator-Threads feste PCM-Blöcke in einen
+ * lock-freien SPSC-Ring pro Stream; ein fest zugeordneter Encoder-Thread
+ * leert ihn. Die Anzahl der Encoder ist unabhängig von der Anzahl der
+ * Emulatoren, so lässt sich die CPU zwischen beiden Stufen aufteilen.
+ *
+ * - Pro Stream: ein Ring mit gefüllten Blöcken (Emulator → Encoder) und ein
+ *   Ring in Gegenrichtung als Freiliste, Blöcke werden wiederverwendet.
+ * - Backpressure: ist der Ring voll, wartet der Emulator (Wartezeit wird gemessen).
+ * - Metriken: Frames pro Stufe, Busy-Zeit der Encoder, Backpressure-Wartezeit
+ *   und daraus Durchsatz je Stufe (Frames pro Kern-Sekunde).
+ *
+ * Verwendung (ein Emulator-Thread pro Stream):
+ *   MP3EncoderPool encoders(2);
+ *   auto stream = encoders.open(mp3Path, 44100, 2, 192);
+ *   encoders.push(*stream, pcm, frames);   // beliebig oft
+ *   bool ok = encoders.finish(*stream);    // wartet, bis die Datei geschrieben ist
+ */
+class MP3EncoderPool {
+public:
+    static constexpr size_t kBlockFrames = 8192;      // ~186 ms @ 44.1kHz
+    static constexpr size_t kDefaultRingBlocks = 32;  // ~6 s Puffer pro Stream
+
+    struct Metrics {
+        size_t streams = 0;
+        uint64_t framesPushed = 0;          // Von Emulatoren übergeben
+        uint64_t framesEncoded = 0;         // Von Encodern verarbeitet
+        double producerSeconds = 0.0;       // open() → finish() über alle Streams
+        double backpressureSeconds = 0.0;   // Davon: Warten auf freien Ring-Platz
+        double finishWaitSeconds = 0.0;     // Davon: Warten auf die letzten Blöcke
+        double encoderBusySeconds = 0.0;    // Summe über alle Encoder
+        double wallSeconds = 0.0;           // Seit Erstellung/resetMetrics()
+    };
+
+    class Stream;
+
+    /**
+     * @param threads Anzahl Encoder-Threads (0 = hardware_concurrency / 4)
+     * @param ringBlocks Kapazität des Rings pro Stream (Blöcke à kBlockFrames)
+     */
+    explicit MP3EncoderPool(unsigned int threads = 0, size_t ringBlocks = kDefaultRingBlocks);
+    ~MP3EncoderPool();
+
+    MP3EncoderPool(const MP3EncoderPool&) = delete;
+    MP3EncoderPool& operator=(const MP3EncoderPool&) = delete;
+
+    unsigned int threadCount() const { return static_cast<unsigned int>(workers_.size()); }
+
+    /**
+     * Öffnet Ausgabedatei und LAME-Encoder
+     * @return nullptr bei Fehler
+     */
+    std::shared_ptr<Stream> open(const std::string& mp3Path, int sampleRate, int channels, int bitrate);
+
+    // Interleaved PCM anhängen (nur vom Emulator-Thread des Streams); blockiert bei vollem Ring
+    bool push(Stream& stream, const int16_t* pcm, size_t frames);
+
+    // Restblock übergeben, auf Encoder warten, LAME flushen, Datei schließen
+    bool finish(Stream& stream);
+
+    Metrics metrics() const;
+    void resetMetrics();
+    void printMetrics(const char* label) const;
+
+private:
+    struct Block {
+        std::vector<int16_t> pcm;
+        size_t frames = 0;
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;                   // schützt streams und das Warten
+        std::condition_variable wake;
+        std::vector<std::shared_ptr<Stream>> streams;
+        std::atomic<size_t> pending{0};     // Signale seit dem letzten Durchlauf
+        std::atomic<uint64_t> busyNanos{0};
+    };
+
+    size_t ringBlocks_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> nextWorker_{0};
+    std::atomic<bool> stop_{false};
+
+    std::atomic<size_t> streams_{0};
+    std::atomic<uint64_t> framesPushed_{0};
+    std::atomic<uint64_t> framesEncoded_{0};
+    std::atomic<uint64_t> producerNanos_{0};
+    std::atomic<uint64_t> backpressureNanos_{0};
+    std::atomic<uint64_t> finishWaitNanos_{0};
+    std::atomic<int64_t> epochNanos_{0};
+    std::atomic<int> sampleRate_{44100};   // Für Echtzeit-Faktoren in printMetrics
+
+    void workerLoop(Worker& worker);
+    bool drain(Worker& worker, Stream& stream);
+    bool submit(Stream& stream);
+    void signal(Stream& stream);
+};
+
+#endif // MP3ENCODERPOOL_H
@@ -0,0 +1,102 @@
+#ifndef MEASUREDLENGTHCACHE_H
+#define MEASUREDLENGTHCACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * MeasuredLengthCache - Geteilter Cache für Fallback-Längen (SID-Pfad + Subtune)
+ *
+ * getTrackLength wird von jedem Render-Thread aufgerufen. Statt einer
+ * std::map hinter einem globalen Mutex:
+ * - Schlüssel ist der 64-Bit-Hash von "Pfad:Subtune", verteilt auf Shards
+ * - Pro Shard eine Open-Addressing-Tabelle mit atomaren Slots: get() liest
+ *   ohne Lock, put() sperrt nur den eigenen Shard. Beim Wachsen wird eine
+ *   neue Tabelle veröffentlicht, alte bleiben für laufende Leser erhalten.
+ * - Persistenz als binäres Append-Log (16 Byte pro Eintrag, letzter gewinnt),
+ *   das periodisch per temp + rename auf die aktuellen Einträge verdichtet wird
+ *
+ * Verwendung:
+ *   MeasuredLengthCache cache(songgenPath("measured_lengths.bin"));
+ *   int seconds = cache.get(sidPath, 2);   // 0 = unbekannt
+ *   cache.put(sidPath, 2, 180);
+ */
+class MeasuredLengthCache {
+public:
+    /**
+     * Lädt das Log (falls vorhanden) und öffnet es zum Anhängen
+     * @param logPath Binäres Append-Log ("" = nur im Speicher)
+     * @param shardCount Anzahl Shards (wird auf Zweierpotenz aufgerundet)
+     */
+    explicit MeasuredLengthCache(const std::string& logPath, size_t shardCount = 64);
+    ~MeasuredLengthCache();
+
+    MeasuredLengthCache(const MeasuredLengthCache&) = delete;
+    MeasuredLengthCache& operator=(const MeasuredLengthCache&) = delete;
+
+    // Länge in Sekunden, 0 wenn nicht im Cache (lock-frei)
+    int get(const std::string& sidPath, int subtune) const;
+
+    // Eintragen/Überschreiben, wird sofort ans Log angehängt
+    void put(const std::string& sidPath, int subtune, int seconds);
+
+    // Entfernen (z.B. wenn eine echte Messung vorliegt)
+    void erase(const std::string& sidPath, int subtune);
+
+    /**
+     * Übernimmt das alte Textformat (Pfad:Subtune=Sekunden pro Zeile)
+     * @return Anzahl übernommener Einträge
+     */
+    size_t importText(const std::string& textPath);
+
+    // Log auf die aktuellen Einträge verdichten
+    bool compact();
+
+    size_t size() const { return count_.load(std::memory_order_relaxed); }
+
+    static uint64_t keyOf(const std::string& sidPath, int subtune);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> key{0};       // 0 = leer
+        std::atomic<int32_t> seconds{0};    // 0 = entfernt
+    };
+
+    struct Table {
+        explicit Table(size_t capacity) : mask(capacity - 1), slots(new Slot[capacity]) {}
+        size_t mask;
+        std::unique_ptr<Slot[]> slots;
+        size_t used = 0;
+    };
+
+    struct alignas(64) Shard {
+        std::atomic<Table*> table{nullptr};
+        std::mutex mutex;                           // nur für Schreiber
+        std::vector<std::unique_ptr<Table>> tables; // alle Generationen
+    };
+
+    std::vector<Shard> shards_;
+    size_t shardMask_;
+    std::atomic<size_t> count_{0};
+
+    std::string logPath_;
+    std::mutex logMutex_;
+    int logFd_ = -1;
+    size_t logRecords_ = 0;
+
+    size_t shardIndex(uint64_t key) const { return (key >> 40) & shardMask_; }
+    // true wenn sich der Wert geändert hat; log = Änderung ans Log anhängen
+    bool store(uint64_t key, int32_t seconds, bool log);
+    bool storeLocked(Shard& shard, uint64_t key, int32_t seconds);
+    void append(uint64_t key, int32_t seconds);
+    bool loadLog();
+    bool openLog();
+    bool compactLocked();
+};
+
+#endif // MEASUREDLENGTHCACHE_H
@@ -5,8 +5,16 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <functional>
+#include <unordered_map>
 #include <sqlite3.h>
 #include <mutex>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include "SQLiteReaderPool.h"
+#include "SimilarityIndex.h"
+#include "DuplicateDetector.h"
 
 /**
  * Struktur für Mediendatei-Metadaten
@@ -41,6 +49,8 @@ struct MediaMetadata {
     float spectralRolloff = 0.0f;
     float zeroCrossingRate = 0.0f;
     float mfccHash = 0.0f;  // Simplified MFCC signature
+    std::vector<float> mfccMean;      // 13 MFCCs, Mittel über alle Frames (leer = nicht analysiert)
+    std::vector<float> mfccVariance;  // 13 MFCCs, Varianz über alle Frames
     
     // Metadaten
     int64_t addedTimestamp = 0;
@@ -48,7 +58,7 @@ struct MediaMetadata {
     int useCount = 0;
     bool analyzed = false;
     bool isTrainingData = true;  // Standard: alle Dateien für Training verwenden
-    std::string fileHash;  // SHA256 oder MD5 für Duplikatserkennung
+    std::string fileHash;  // Content-Hash ("xxh64:...", siehe FileHasher) für Duplikatserkennung
 };
 
 /**
@@ -59,6 +69,10 @@ struct MediaMetadata {
  * - NPU-optimierte Feature-Extraktion
  * - Schnelle Suche nach Genre, Stil, BPM, Instrumenten
  * - Training-Dataset-Verwaltung
+ * 
+ * Verbindungen: WAL-Modus mit einer Schreibverbindung (dbMutex_) und einem
+ * kleinen Pool read-only Verbindungen. Lesende Abfragen laufen parallel zum
+ * Schreiber und sehen den zuletzt committeten Stand.
  */
 class MediaDatabase {
 public:
@@ -68,9 +82,73 @@ public:
     // Datenbank-Operationen
     bool initialize();
     bool addMedia(const MediaMetadata& meta);
-    bool updateMedia(const MediaMetadata& meta);
+    bool updateMedia(const MediaMetadata& meta);  // Upsert: legt fehlende Einträge an
     bool deleteMedia(int64_t id);
     bool existsByPath(const std::string& filepath);
+    bool existsByHash(const std::string& fileHash);  // Byte-identische Datei schon importiert?
+    
+    // Bulk-Schreiben: eine Transaktion pro Chunk statt ein fsync pro Track
+    static constexpr size_t kDefaultBatchChunk = 500;
+    static constexpr int kDefaultBatchOpenMs = 1000;  // Ergebnisse spätestens nach ~1 s für Leser sichtbar
+    
+    /**
+     * WriteBatch - Gebündelte Schreibzugriffe (Import, Analyse-Worker)
+     *
+     * Öffnet beim ersten Schreiben eine Transaktion und committet, sobald
+     * chunkSize Einträge offen sind oder die Transaktion länger als maxOpenMs
+     * läuft, sowie im Destruktor. add()/update() haben dieselbe Semantik wie
+     * addMedia()/updateMedia() und sind thread-safe; mehrere Worker können
+     * denselben Batch benutzen. Jeder andere Schreibzugriff (auch ein anderer
+     * Batch) committet die offene Transaktion vorher, es wird nie fremd
+     * mitgeschrieben.
+     *
+     * Rückgabewerte von add()/update()/... gelten nur für die offene
+     * Transaktion. Als geschrieben zählt ein Eintrag erst nach erfolgreichem
+     * COMMIT (written()); schlägt ein COMMIT fehl, wird der Chunk
+     * zurückgerollt und in failed() gezählt.
+     *
+     * Verwendung:
+     *   MediaDatabase::WriteBatch batch(db);
+     *   for (...) batch.add(meta);
+     *   if (!batch.commit()) ...  // spätestens am Scope-Ende
+     */
+    class WriteBatch {
+    public:
+        explicit WriteBatch(MediaDatabase& db, size_t chunkSize = kDefaultBatchChunk,
+                            int maxOpenMs = kDefaultBatchOpenMs);
+        ~WriteBatch();
+        WriteBatch(const WriteBatch&) = delete;
+        WriteBatch& operator=(const WriteBatch&) = delete;
+        
+        bool add(const MediaMetadata& meta);     // false = Pfad/Inhalt schon vorhanden
+        bool update(const MediaMetadata& meta);  // Upsert
+        bool remove(const std::string& filepath);                           // false = Pfad unbekannt
+        bool move(const std::string& oldPath, const std::string& newPath); // Analyse bleibt erhalten
+        bool commit();                           // Offenen Chunk sofort schreiben, false = COMMIT fehlgeschlagen
+        size_t written() const { return written_; }  // Erfolgreich committete Einträge
+        size_t failed() const { return failed_; }    // Durch fehlgeschlagene Commits verworfene Einträge
+        
+    private:
+        friend class MediaDatabase;
+        
+        MediaDatabase& db_;
+        size_t chunkSize_;
+        std::chrono::milliseconds maxOpen_;
+        size_t pending_ = 0;          // Operationen in der offenen Transaktion
+        size_t pendingWritten_ = 0;   // davon erfolgreich (noch nicht committet)
+        std::atomic<size_t> written_{0};
+        std::atomic<size_t> failed_{0};
+        bool ownsTransaction_ = false;
+        std::chrono::steady_clock::time_point openedAt_;
+        
+        // Aufrufer hält dbMutex_
+        void beginIfNeeded();
+        void finishOperation(bool ok);
+        bool commitLocked();
+    };
+    
+    size_t addMediaBatch(const std::vector<MediaMetadata>& items, size_t chunkSize = kDefaultBatchChunk);
+    size_t updateMediaBatch(const std::vector<MediaMetadata>& items, size_t chunkSize = kDefaultBatchChunk);
     
     // Suche und Filter
     std::vector<MediaMetadata> searchByGenre(const std::string& genre);
@@ -78,11 +156,86 @@ public:
     std::vector<MediaMetadata> searchByBPM(float minBpm, float maxBpm);
     std::vector<MediaMetadata> searchByIntensity(const std::string& intensity);
     std::vector<MediaMetadata> searchByBassLevel(const std::string& bassLevel);
-    std::vector<MediaMetadata> getAll();
+    std::vector<MediaMetadata> getAll();  // Vollständige Tabelle - für GUI/Timer iterate()/countWhere() nutzen
     std::vector<MediaMetadata> getUnanalyzed();
     MediaMetadata getById(int64_t id);
     
+    // Cursor/Paging: Filter, Sortierung und Aggregate laufen in SQLite,
+    // gelesen werden nur die angeforderten Spaltengruppen
+    enum MediaColumns : uint32_t {
+        ColIdentity = 0,        // id, filepath (immer enthalten)
+        ColTags     = 1u << 0,  // title, artist, genre, subgenre, genreTags
+        ColStyle    = 1u << 1,  // intensity, bassLevel, mood, instruments, melodySignature, rhythmPattern
+        ColAnalysis = 1u << 2,  // bpm, duration, spectralCentroid/-Rolloff, zeroCrossingRate, mfccHash, analyzed
+        ColMfcc     = 1u << 3,  // mfccMean, mfccVariance (BLOBs)
+        ColUsage    = 1u << 4,  // addedTimestamp, lastUsed, useCount, fileHash
+        ColAll      = 0xFFu
+    };
+    
+    // Zeilen mit eingeschränkter Projektion nicht per updateMedia() zurückschreiben
+    // (fehlende Spalten sind Default-Werte) - dafür getById() verwenden
+    struct MediaQuery {
+        uint32_t columns = ColAll;
+        std::string where;                 // SQL-Bedingung ohne "WHERE", Werte als "?"
+        std::vector<std::string> params;   // Werte für die Platzhalter (Reihenfolge)
+        std::string orderBy;               // z.B. "title COLLATE NOCASE ASC" (leer = unsortiert)
+        std::string search;                // Volltext (Präfix je Wort); ohne orderBy nach Relevanz
+        size_t limit = 0;                  // 0 = ohne Limit
+        size_t offset = 0;
+    };
+    
+    // Callback pro Zeile; false bricht ab. Datenbank-Aufrufe im Callback sind
+    // erlaubt (Lesen über dieselbe Verbindung, Schreiben über den Writer);
+    // dabei geschriebene Zeilen sieht die laufende Iteration nicht zwingend.
+    using RowCallback = std::function<bool(const MediaMetadata&)>;
+    
+    /**
+     * Streamt die Treffer zeilenweise an callback (kein Vector der ganzen Tabelle)
+     * @return Anzahl gelesener Zeilen
+     */
+    size_t iterate(const MediaQuery& query, const RowCallback& callback);
+    std::vector<MediaMetadata> getPage(const MediaQuery& query);
+    
+    /**
+     * Nur die IDs der Treffer (Sortierung/limit wie iterate()). Für
+     * virtuelle Listen: einmal sortieren, sichtbare Zeilen per getByIds()
+     * nachladen statt pro Seite erneut mit OFFSET zu sortieren.
+     */
+    std::vector<int64_t> queryIds(const MediaQuery& query);
+    
+    // Zeilen in der Reihenfolge von ids; inzwischen gelöschte bleiben mit id = 0 leer
+    std::vector<MediaMetadata> getByIds(const std::vector<int64_t>& ids, uint32_t columns = ColAll);
+    
+    // Aggregate in SQL; where/column sind SQL-Fragmente (keine Benutzereingaben!),
+    // Benutzerwerte gehören in params
+    size_t countWhere(const std::string& where = "", const std::vector<std::string>& params = {});
+    size_t count(const MediaQuery& query);  // Treffer von where + search (ohne limit/offset)
+    std::map<std::string, size_t> countGroupedBy(const std::string& column, const std::string& where = "",
+                                                 const std::vector<std::string>& params = {});
+    
+    // Teilstring-Muster für "spalte LIKE ? ESCAPE '\'" (%, _ und \ werden maskiert)
+    static std::string likePattern(const std::string& text);
+    
+    /**
+     * Volltextsuche über title, artist, genre, genreTags, mood, instruments
+     *
+     * FTS5-Index (media_fts), per Trigger synchron zur media-Tabelle. Jedes
+     * Wort wird als Präfix gesucht ("rob hubb" findet "Rob Hubbard"),
+     * alle Wörter müssen vorkommen. Sortierung nach BM25-Relevanz, Treffer
+     * im Titel zählen am meisten. Ohne FTS5 in der SQLite-Version: LIKE-Suche.
+     */
+    std::vector<MediaMetadata> search(const std::string& text, size_t limit = 100, size_t offset = 0);
+    
+    // FTS5-MATCH-Ausdruck aus Benutzereingabe ("foo bar" -> "foo"* "bar"*), leer = keine Wörter
+    static std::string fullTextQuery(const std::string& text);
+    
     // Erweiterte Suche
+    /**
+     * Ähnlichste Tracks über den In-Memory-Vektorindex (IVF-Flat, siehe SimilarityIndex)
+     * @param reference Referenz-Track (id > 0 wird aus dem Ergebnis ausgeschlossen)
+     * @param limit Maximale Anzahl Treffer
+     * @return Tracks aufsteigend nach Feature-Distanz
+     */
     std::vector<MediaMetadata> findSimilar(const MediaMetadata& reference, int limit = 10);
     std::vector<MediaMetadata> searchAdvanced(
         const std::string& genre = "",
@@ -120,6 +273,14 @@ public:
     std::vector<DuplicateInfo> findDuplicates(float threshold = 0.95f);
     std::vector<DuplicateInfo> findIdenticalFiles();  // Exakte Duplikate (gleicher Pfad/Hash)
     std::vector<DuplicateInfo> findAudioDuplicates(float mfccThreshold = 0.98f);  // Audio-ähnlichkeit
+    
+    /**
+     * Inkrementelle Prüfung eines (neuen) Tracks gegen die Bibliothek, z.B. beim Import.
+     * Liest nur Kandidaten im ±2 s Dauer-Fenster (idx_duration).
+     * @param meta Zu prüfender Track (darf noch nicht in der DB sein)
+     * @return Treffer mit id2/filepath2 = meta
+     */
+    std::vector<DuplicateInfo> checkDuplicate(const MediaMetadata& meta, float mfccThreshold = 0.98f);
     bool removeDuplicate(int64_t keepId, int64_t removeId);
     
     // Training-Dataset Verwaltung
@@ -158,14 +319,105 @@ public:
     bool deleteDecision(int64_t id);
     bool markQuestionAsAnswered(int64_t id, const std::string& answer);
     
+    // Laufzeit pro Abfrage-Typ (Contention-Analyse)
+    struct QueryStats {
+        std::string label;      // Methodenname, z.B. "getAll"
+        uint64_t calls = 0;
+        double totalMs = 0.0;   // Ausführung
+        double maxMs = 0.0;
+        double waitMs = 0.0;    // Warten auf Writer-Lock bzw. Reader-Verbindung
+    };
+    std::vector<QueryStats> getQueryStats();  // Teuerste zuerst
+    void resetQueryStats();
+    void printQueryStats(size_t maxEntries = 10);
+    
 private:
     std::string dbPath_;
     sqlite3* db_ = nullptr;
     std::mutex dbMutex_;
+    SQLiteReaderPool readers_;
+    WriteBatch* openBatch_ = nullptr;  // Batch mit offener Transaktion (unter dbMutex_)
+    
+    /**
+     * QueryScope - Verbindung für eine Abfrage + Zeitmessung
+     * Read: Verbindung aus dem Reader-Pool; sind alle verliehen, wird auf eine
+     *        freie gewartet (Writer unter dbMutex_ nur, wenn es keinen Pool gibt)
+     * Write: Writer-Verbindung unter dbMutex_; eine offene Transaktion eines
+     *        anderen Batches wird vorher committet
+     * WriterRead: Writer-Verbindung unter dbMutex_ ohne zu schreiben (sieht
+     *        auch noch nicht committete Batch-Einträge, z.B. für Duplikatprüfung)
+     * Verschachtelt (Datenbank-Aufruf im iterate-Callback) übernimmt ein Scope
+     * die Verbindung des äußeren Scopes desselben Threads: ein Leser wird nicht
+     * ein zweites Mal aus dem Pool geholt und dbMutex_ nicht erneut gesperrt.
+     */
+    class QueryScope {
+    public:
+        enum Mode { Read, Write, WriterRead };
+        QueryScope(MediaDatabase& db, const char* label, Mode mode, WriteBatch* batch = nullptr);
+        ~QueryScope();
+        QueryScope(const QueryScope&) = delete;
+        QueryScope& operator=(const QueryScope&) = delete;
+        sqlite3* connection() const { return connection_; }
+        
+    private:
+        MediaDatabase& db_;
+        const char* label_;
+        QueryScope* outer_;
+        sqlite3* connection_ = nullptr;
+        bool pooled_ = false;
+        bool writer_ = false;   // connection_ ist die Writer-Verbindung (dbMutex_ gehalten)
+        std::unique_lock<std::mutex> lock_;
+        std::chrono::steady_clock::time_point start_;
+        std::chrono::steady_clock::time_point acquired_;
+        
+        static thread_local QueryScope* innermost_;
+    };
+    
+    std::mutex statsMutex_;
+    std::unordered_map<std::string, QueryStats> queryStats_;
+    void recordQuery(const char* label, double waitMs, double execMs);
+    
+    // Volltextindex (FTS5) - false, wenn die SQLite-Version kein FTS5 hat
+    bool fullTextAvailable_ = false;
+    bool initializeFullTextIndex();
+    // "FROM media ... WHERE ..." für eine Abfrage, Parameter in Bind-Reihenfolge
+    std::string querySource(const MediaQuery& query, std::vector<std::string>& params, bool& ranked) const;
     
     bool executeSQL(const std::string& sql);
     sqlite3_stmt* prepareStatement(const std::string& sql);
+    sqlite3_stmt* prepareStatement(sqlite3* connection, const std::string& sql);
+    
+    // Wiederverwendete Statements für heiße Pfade (nicht finalisieren, nur resetten)
+    std::unordered_map<std::string, sqlite3_stmt*> statementCache_;
+    sqlite3_stmt* cachedStatement(const char* sql);
+    void finalizeCachedStatements();
+    
+    // Schreibpfade ohne Lock (Aufrufer hält dbMutex_)
+    bool insertMediaLocked(const MediaMetadata& meta);
+    bool upsertMediaLocked(const MediaMetadata& meta);
+    bool deleteByPathLocked(const std::string& filepath);
+    bool movePathLocked(const std::string& oldPath, const std::string& newPath);
     std::string expandPath(const std::string& path);
+    
+    // Vektorindex für findSimilar (Snapshot neben der DB, inkrementell gepflegt)
+    SimilarityIndex similarityIndex_;
+    std::string similarityIndexPath() const { return dbPath_ + ".simidx"; }
+    void loadSimilarityIndex();
+    void rebuildSimilarityIndex();
+    void updateSimilarityIndex(int64_t id, const MediaMetadata& meta);
+    // k-Means nach starkem Wachstum im Hintergrund (unter dbMutex_ nur Kopie + Übernahme)
+    std::thread indexTrainer_;
+    bool indexTraining_ = false;    // unter dbMutex_
+    void scheduleIndexTraining();   // Aufrufer hält dbMutex_
+    MediaMetadata fetchById(sqlite3* connection, int64_t id);
+    int64_t findIdByHash(const std::string& fileHash);  // Ohne Lock, 0 = nicht gefunden
+    
+    TrainingStats queryTrainingStats();
+    
+    // Duplikatserkennung (ohne Lock)
+    void loadDuplicateCandidates(sqlite3* connection, DuplicateDetector& detector, const std::string& where);
+    std::vector<DuplicateInfo> toDuplicateInfo(const DuplicateDetector& detector,
+                                               const std::vector<DuplicateDetector::Match>& matches);
 };
 
 #endif // MEDIADATABASE_H
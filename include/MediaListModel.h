@@ -0,0 +1,40 @@
+#ifndef MEDIALISTMODEL_H
+#define MEDIALISTMODEL_H
+
+#include <gtk/gtk.h>
+#include "MediaPager.h"
+
+/**
+ * MediaListModel - Virtuelles GtkTreeModel für den Datenbank-Tab
+ *
+ * Flache Liste über einem MediaPager: GTK fragt Zellwerte nur für sichtbare
+ * Zeilen ab (gtk_tree_view_set_fixed_height_mode), die Metadaten werden
+ * dabei seitenweise nachgeladen. Ersetzt den GtkListStore, der alle Zeilen
+ * als Kopie hielt und deshalb auf 1000 Einträge begrenzt war.
+ *
+ * Spalten wie der bisherige Store (alle G_TYPE_STRING), gtk_tree_model_get()
+ * funktioniert unverändert. Die Zeilenzahl ist fest: nach setQuery()/refresh()
+ * des Pagers ein neues Model setzen.
+ *
+ * Der Pager muss das Model überleben.
+ */
+enum MediaListColumn {
+    MEDIA_LIST_COL_PLAY = 0,      // "▶️"
+    MEDIA_LIST_COL_TITLE,
+    MEDIA_LIST_COL_ARTIST,
+    MEDIA_LIST_COL_GENRE,
+    MEDIA_LIST_COL_DURATION,      // "123s"
+    MEDIA_LIST_COL_FILEPATH,      // versteckt, für Play-Callback
+    MEDIA_LIST_N_COLUMNS
+};
+
+G_BEGIN_DECLS
+
+#define MEDIA_TYPE_LIST_MODEL (media_list_model_get_type())
+G_DECLARE_FINAL_TYPE(MediaListModel, media_list_model, MEDIA, LIST_MODEL, GObject)
+
+MediaListModel* media_list_model_new(MediaPager* pager);
+
+G_END_DECLS
+
+#endif // MEDIALISTMODEL_H
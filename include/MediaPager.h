@@ -0,0 +1,76 @@
+#ifndef MEDIAPAGER_H
+#define MEDIAPAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "MediaDatabase.h"
+
+/**
+ * MediaPager - Virtuelle Trefferliste für die Datenbank-Browser (GTK/ImGui)
+ *
+ * setQuery() holt einmalig nur die sortierten IDs der Treffer (8 Byte pro
+ * Zeile, auch bei 100k+ Tracks). Die Metadaten werden seitenweise erst
+ * geladen, wenn eine Zeile sichtbar wird; ein kleiner LRU-Cache hält die
+ * zuletzt angezeigten Seiten. Kein Limit auf die Trefferzahl mehr.
+ *
+ * Nicht thread-safe - nur aus dem GUI-Thread benutzen.
+ *
+ * Verwendung:
+ *   MediaPager pager(db, MediaDatabase::ColTags | MediaDatabase::ColAnalysis);
+ *   pager.setQuery(query);
+ *   for (size_t i = first; i < last; ++i) if (auto* meta = pager.at(i)) ...
+ */
+class MediaPager {
+public:
+    static constexpr size_t kPageSize = 200;
+    static constexpr size_t kMaxCachedPages = 16;
+
+    explicit MediaPager(MediaDatabase& db, uint32_t columns = MediaDatabase::ColAll);
+
+    // Neue Abfrage (limit/offset/columns der Query werden ignoriert)
+    void setQuery(const MediaDatabase::MediaQuery& query);
+    const MediaDatabase::MediaQuery& query() const { return query_; }
+
+    // Abfrage erneut ausführen (Einträge hinzugefügt/gelöscht)
+    void refresh();
+
+    // Nur geladene Zeilen verwerfen (Metadaten geändert, Reihenfolge gleich)
+    void invalidateRows();
+
+    size_t size() const { return ids_.size(); }
+    bool empty() const { return ids_.empty(); }
+    int64_t idAt(size_t index) const { return index < ids_.size() ? ids_[index] : 0; }
+
+    /**
+     * Zeile index (lädt bei Bedarf deren Seite)
+     * @return nullptr außerhalb des Bereichs oder wenn der Eintrag inzwischen
+     *         gelöscht wurde. Der Zeiger gilt bis zum nächsten at()/prefetch().
+     */
+    const MediaMetadata* at(size_t index);
+
+    // Seiten für [first, last) vorab laden (sichtbarer Bereich)
+    void prefetch(size_t first, size_t last);
+
+    size_t pageLoads() const { return pageLoads_; }
+
+private:
+    struct Page {
+        std::vector<MediaMetadata> rows;
+        uint64_t lastUse = 0;
+    };
+
+    MediaDatabase& db_;
+    uint32_t columns_;
+    MediaDatabase::MediaQuery query_;
+    std::vector<int64_t> ids_;
+    std::unordered_map<size_t, Page> pages_;
+    uint64_t useCounter_ = 0;
+    size_t pageLoads_ = 0;
+
+    Page& loadPage(size_t page);
+    void evictPages(size_t keep);
+};
+
+#endif // MEDIAPAGER_H
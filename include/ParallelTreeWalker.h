@@ -0,0 +1,84 @@
+#ifndef PARALLELTREEWALKER_H
+#define PARALLELTREEWALKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * ParallelTreeWalker - Paralleles Durchsuchen von Verzeichnisbäumen
+ *
+ * fs::recursive_directory_iterator liest ein Verzeichnis nach dem anderen;
+ * auf NAS/SMB-Mounts mit kaltem Cache wartet der Scan so fast nur auf
+ * Round-Trips. Hier ist jedes Verzeichnis ein eigener Work-Item:
+ * - mehrere Threads lesen gleichzeitig (mehr als Kerne, da latenzgebunden)
+ * - Einträge werden blockweise per getdents64 gelesen (64 KB pro Syscall),
+ *   der Typ kommt aus d_type, stat() nur wenn das Dateisystem ihn nicht liefert
+ * - Symlinks auf Dateien zählen wie Dateien, Symlinks auf Verzeichnisse
+ *   werden nicht verfolgt (wie recursive_directory_iterator, keine Zyklen)
+ *
+ * Für "existiert die Ausgabedatei schon?"-Prüfungen liest listNames() bzw.
+ * listDirectories() ein Verzeichnis einmal in ein Hash-Set, statt pro
+ * Kandidat ein fs::exists() abzusetzen.
+ *
+ * Verwendung:
+ *   ParallelTreeWalker::Options options;
+ *   options.extensions = {".sid"};
+ *   auto sids = ParallelTreeWalker(options).collect(hvscDir);
+ */
+class ParallelTreeWalker {
+public:
+    struct Options {
+        std::vector<std::string> extensions;        // leer = alle Dateien; ohne Groß-/Kleinschreibung
+        unsigned int threads = 0;                   // 0 = 2 × hardware_concurrency (mind. 4)
+        const std::atomic<bool>* stopFlag = nullptr;
+    };
+
+    struct Stats {
+        size_t directories = 0;
+        size_t files = 0;           // Treffer
+        size_t errors = 0;          // Nicht lesbare Verzeichnisse (ohne "Zugriff verweigert")
+        double seconds = 0.0;
+    };
+
+    // Inhalt eines einzelnen Verzeichnisses
+    struct Listing {
+        bool exists = false;        // false bei ENOENT/ENOTDIR
+        bool readable = false;      // false auch bei anderen Fehlern (z.B. NAS-Timeout)
+        std::unordered_set<std::string> names;
+    };
+
+    ParallelTreeWalker() : ParallelTreeWalker(Options()) {}
+    explicit ParallelTreeWalker(const Options& options);
+
+    /**
+     * Alle passenden regulären Dateien unter root, sortiert
+     * (root selbst darf eine Datei sein)
+     */
+    std::vector<std::string> collect(const std::string& root);
+
+    // Fehlermeldungen ("Pfad: Grund") und Statistik des letzten collect()
+    const std::vector<std::string>& errors() const { return errors_; }
+    const Stats& lastStats() const { return stats_; }
+
+    // Namen aller Einträge eines Verzeichnisses (nicht rekursiv)
+    static Listing listNames(const std::string& dir);
+
+    // Mehrere Verzeichnisse parallel lesen (z.B. alle Eltern der DB-Pfade)
+    static std::unordered_map<std::string, Listing> listDirectories(const std::vector<std::string>& dirs,
+                                                                    unsigned int threads = 0);
+
+    static unsigned int defaultThreads();
+
+private:
+    Options options_;
+    std::vector<std::string> errors_;
+    Stats stats_;
+
+    bool matches(const char* name) const;
+};
+
+#endif // PARALLELTREEWALKER_H
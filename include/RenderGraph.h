@@ -0,0 +1,82 @@
+#pragma once
+
+#include "AudioEffects.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace SongGen {
+
+// Source node: adds its signal for frames [frame, frame + block.size()) onto block.
+// Blocks are requested strictly in order.
+class RenderNode {
+public:
+    virtual ~RenderNode() = default;
+    virtual void render(uint64_t frame, std::vector<float>& block) = 0;
+};
+
+// Event-driven source: advance() schedules the next event(s) at cursor_ via play()
+// and moves cursor_ forward. Events are only generated once a block reaches them,
+// and voices are dropped once played, so memory depends on note length, not song length.
+class VoiceNode : public RenderNode {
+public:
+    void render(uint64_t frame, std::vector<float>& block) override;
+
+    size_t activeVoices() const { return voices_.size(); }
+
+protected:
+    // Returns false when there are no further events
+    virtual bool advance() = 0;
+    void play(uint64_t start, std::vector<float> samples, float gain);
+
+    uint64_t cursor_ = 0;
+
+private:
+    struct Voice {
+        uint64_t start;
+        std::vector<float> samples;
+        float gain;
+    };
+    std::vector<Voice> voices_;
+    bool exhausted_ = false;
+};
+
+// Pull-based render graph: sources are summed into fixed-size blocks, the effects
+// chain runs in place, then a look-ahead peak limiter and the fade-in are applied
+// and each finished block is handed to the sink (e.g. the MP3 encoder).
+// Only two blocks are alive at any time, independent of the render length.
+class RenderGraph {
+public:
+    static constexpr size_t kBlockFrames = 512;
+
+    explicit RenderGraph(int sampleRate = 44100);
+
+    void addSource(std::unique_ptr<RenderNode> node);
+    AudioEffectsChain& effects() { return effects_; }
+
+    float peakTarget = 0.9f;        // Output peak ceiling (linear)
+    float maxGain = 4.0f;           // Upper bound for make-up gain on quiet material
+    float releaseSeconds = 2.0f;    // Time for the gain to double after a peak
+    float fadeInSeconds = 0.1f;
+
+    // Renders frames in blocks; a false return from sink aborts.
+    // progress (optional) receives the rendered fraction after every block.
+    bool render(uint64_t frames, const std::function<bool(const std::vector<float>&)>& sink,
+                const std::function<void(float)>& progress = nullptr);
+
+    int sampleRate() const { return sampleRate_; }
+    float outputPeak() const { return outputPeak_; }
+
+private:
+    int sampleRate_;
+    std::vector<std::unique_ptr<RenderNode>> sources_;
+    AudioEffectsChain effects_;
+    float gain_ = 1.0f;
+    float outputPeak_ = 0.0f;
+
+    float fillBlock(uint64_t frame, std::vector<float>& block);
+    float requiredGain(float peak) const;
+};
+
+} // namespace SongGen
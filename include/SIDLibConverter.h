@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include <functional>
 #include <thread>
 #include <mutex>
@@ -14,6 +15,9 @@
 #include <sidplayfp/SidConfig.h>
 #include <sidplayfp/builders/residfp.h>
 
+class TrackEndDetector;
+class MP3EncoderPool;
+
 /**
  * SIDLibConverter - Schnelle C++ Library-basierte SID→WAV Konvertierung
  * 
@@ -22,12 +26,29 @@
  * - Echte Parallelität (keine Process-Blockierung)
  * - Direkter Speicherzugriff
  * - Thread-Pool für maximale Performance
+ *
+ * Eine Instanz ist ein Render-Kontext: Engine, ReSIDfp-Builder und ROMs
+ * werden einmal eingerichtet, pro Aufruf wird nur der Tune getauscht.
+ * Instanzen sind nicht thread-sicher - pro Thread eine eigene verwenden
+ * (forThread() oder SIDRenderScheduler).
  */
 class SIDLibConverter {
 public:
     SIDLibConverter();
     ~SIDLibConverter();
     
+    SIDLibConverter(const SIDLibConverter&) = delete;
+    SIDLibConverter& operator=(const SIDLibConverter&) = delete;
+    
+    // Render-Kontext des aufrufenden Threads (lebt bis zum Thread-Ende)
+    static SIDLibConverter& forThread();
+    
+    /**
+     * MP3-Encoding an einen Encoder-Pool abgeben (nullptr = im eigenen Thread)
+     * Der Emulator rendert dann weiter, während der Pool die Blöcke encodiert.
+     */
+    void setEncoderPool(MP3EncoderPool* pool) { encoderPool_ = pool; }
+    
     // SID-Timing Erkennung (PAL vs NTSC)
     enum Timing { PAL = 0, NTSC = 1, PAL_NTSC = 2, UNKNOWN = 3 };
     static Timing getTiming(const std::string& sidPath);
@@ -39,6 +60,9 @@ public:
      */
     static int getSubtuneCount(const std::string& sidPath);
     
+    // Start-Song aus dem SID-Header (1-basiert), den subtune 0 abspielt
+    static int getStartSong(const std::string& sidPath);
+    
     /**
      * Liest die Länge eines SID-Tracks aus (falls im Header angegeben)
      * @param sidPath Pfad zur SID-Datei
@@ -47,17 +71,30 @@ public:
      */
     static int getTrackLength(const std::string& sidPath, int subtune = 1);
     
+    // Länge aus Songlengths/Custom-DB, 0 wenn unbekannt (kein 180s-Fallback)
+    static int getKnownTrackLength(const std::string& sidPath, int subtune = 1);
+    
+    /**
+     * Trägt eine gemessene Länge in ~/.songgen/custom_songlengths.md5 ein
+     * (wirkt sofort auf getTrackLength)
+     */
+    static bool recordMeasuredLength(const std::string& sidPath, int subtune, int seconds);
+    
+    // Songlengths.md5 wurde gerade (neu) geschrieben: beim nächsten Lookup sofort prüfen
+    static void songlengthsChanged();
+    
     /**
-     * Misst die tatsächliche Länge eines Tracks durch Loop-Detection
+     * Misst die tatsächliche Länge eines Tracks (TrackEndDetector: Stille + Loop)
      * @param sidPath Pfad zur SID-Datei
      * @param subtune Subtune-Nummer
      * @param maxSeconds Maximale Messzeit in Sekunden
-     * @return Erkannte Loop-Position in Sekunden (0 wenn kein Loop erkannt)
+     * @return Erkanntes Ende in Sekunden (0 wenn weder Stille noch Loop erkannt)
      */
     int measureTrackLength(const std::string& sidPath, int subtune, int maxSeconds);
     
     /**
-     * Testet ob ein SID hörbar ist (schneller 5s-Test)
+     * Testet ob ein SID hörbar ist (max. 5s, im Prozess gerendert)
+     * Bricht beim ersten hörbaren 100-ms-Block ab.
      * @param sidPath Pfad zur SID-Datei
      * @param subtune Subtune-Nummer
      * @return true wenn hörbar, false wenn stumm
@@ -66,6 +103,8 @@ public:
     
     /**
      * Konvertiert einzelnen SID zu WAV
+     * Endet vorzeitig bei anhaltender Stille; ohne Songlengths-Eintrag auch bei
+     * erkanntem Loop (Länge wird dann in der Custom-DB gespeichert).
      * @param sidPath Pfad zur SID-Datei
      * @param wavPath Ausgabe-WAV-Pfad
      * @param timeoutSec Maximale Länge in Sekunden
@@ -76,6 +115,7 @@ public:
     
     /**
      * Konvertiert einzelnen SID direkt zu MP3 (platzsparend!)
+     * Ende-Erkennung wie convertToWAV.
      * @param sidPath Pfad zur SID-Datei
      * @param mp3Path Ausgabe-MP3-Pfad
      * @param timeoutSec Maximale Länge in Sekunden
@@ -85,6 +125,51 @@ public:
      */
     bool convertToMP3(const std::string& sidPath, const std::string& mp3Path, int timeoutSec = 120, int subtune = 0, int bitrate = 192);
     
+    // Ausgabeformat von renderPCM() (wie convertToWAV)
+    static constexpr int kSampleRate = 44100;
+    static constexpr int kChannels = 2;
+    
+    /**
+     * Emulations-Einstellungen: konfigurieren Engine und ReSIDfp-Builder im
+     * Konstruktor und bilden zusammen mit dem Ausgabeformat den
+     * Render-Cache-Schlüssel (key()). Nur hier ändern, dann passen alte
+     * Cache-Einträge automatisch nicht mehr.
+     */
+    struct EngineSettings {
+        bool interpolate = true;        // RESAMPLE_INTERPOLATE
+        bool fastSampling = false;      // false für Stabilität
+        bool filter = true;
+        double filter6581Curve = 0.5;
+        double filter8580Curve = 0.5;
+        
+        std::string key() const;        // Ausgabeformat + alle Felder als Text
+    };
+    static const EngineSettings& engineSettings();
+    
+    /**
+     * Rendert einen Subtune direkt in den Speicher (ohne WAV/MP3-Umweg)
+     *
+     * Ergebnisse landen im SIDRenderCache (MD5 + Subtune + Einstellungen);
+     * wiederholte Analysen derselben Datei emulieren nicht erneut.
+     *
+     * @param sidPath Pfad zur SID-Datei
+     * @param subtune Subtune-Nummer (0 = default/erstes)
+     * @param seconds Länge in Sekunden
+     * @param pcm Ausgabe: 16-Bit Stereo interleaved, kSampleRate
+     * @param useCache Render-Cache lesen/schreiben
+     * @return true bei Erfolg
+     */
+    bool renderPCM(const std::string& sidPath, int subtune, int seconds, std::vector<int16_t>& pcm, bool useCache = true);
+    
+    // Empfänger für fertig gerendertes PCM (interleaved), false = abbrechen
+    using PCMSink = std::function<bool(const int16_t* pcm, size_t frames)>;
+    
+    /**
+     * Wie renderPCM(), aber blockweise an sink (konstanter Speicher, auch bei
+     * 20-Minuten-Tunes); Cache-Treffer werden ebenfalls blockweise gelesen
+     */
+    bool renderPCM(const std::string& sidPath, int subtune, int seconds, const PCMSink& sink, bool useCache = true);
+    
     /**
      * Berechnet MD5-Checksumme einer Datei
      * @param filepath Pfad zur Datei
@@ -129,8 +214,16 @@ private:
     sidplayfp* engine;
     SidTune* tune;
     ReSIDfpBuilder* builder;
+    MP3EncoderPool* encoderPool_ = nullptr;
     
     bool loadROMs(const std::string& romPath);
+    bool loadTune(const std::string& sidPath, int subtune);
+    bool renderUntilEnd(int seconds, std::vector<int16_t>& pcm, TrackEndDetector* detector,
+                        const PCMSink& sink = nullptr);
+    bool renderTrack(const std::string& sidPath, int seconds, std::vector<int16_t>& pcm,
+                     const PCMSink& sink = nullptr);
+    bool encodeMP3(const std::string& sidPath, const std::string& mp3Path, int timeoutSec, int bitrate);
+    bool encodeMP3Pipelined(const std::string& sidPath, const std::string& mp3Path, int timeoutSec, int bitrate);
     void writeWAVHeader(std::ofstream& file, int dataSize, int sampleRate, int channels, int bitsPerSample);
 };
 
@@ -0,0 +1,104 @@
+#ifndef SIDRENDERCACHE_H
+#define SIDRENDERCACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * SIDRenderCache - Inhaltsadressierter Cache für emuliertes SID-PCM
+ *
+ * Schlüssel = MD5 der SID-Datei + Subtune + Emulations-Einstellungen
+ * (Samplerate, Filter, Sampling-Methode). Umbenannte oder doppelte Dateien
+ * teilen sich damit einen Eintrag; geänderte Einstellungen erzeugen neue.
+ *
+ * Gespeichert wird 16-Bit-PCM (interleaved) ab Songbeginn. Die Emulation ist
+ * deterministisch, eine längere Aufnahme bedient daher auch kürzere
+ * Anfragen. Ablage: <dir>/<2 Hex>/<key>.pcm, Schreiben atomar per rename,
+ * mehrere Threads/Prozesse dürfen gleichzeitig lesen und schreiben.
+ *
+ * Größenbegrenzung: überschreitet der Cache maxBytes, werden die am
+ * längsten nicht benutzten Einträge (mtime, bei Treffern aktualisiert)
+ * gelöscht.
+ */
+class SIDRenderCache {
+public:
+    static constexpr uint64_t kDefaultMaxBytes = 2ULL << 30;  // 2 GB ≈ 3 h Stereo-PCM
+
+    explicit SIDRenderCache(const std::string& directory = "", uint64_t maxBytes = kDefaultMaxBytes);
+
+    // Gemeinsame Instanz unter ~/.songgen/render_cache
+    static SIDRenderCache& shared();
+
+    // Cache-Schlüssel (Dateiname-tauglich)
+    static std::string makeKey(const std::string& sidMd5, int subtune, const std::string& settings);
+
+    /**
+     * Lädt die ersten frames Frames eines Eintrags
+     * @return false, wenn kein Eintrag existiert oder er kürzer ist
+     */
+    bool load(const std::string& key, size_t frames, int channels, int sampleRate, std::vector<int16_t>& pcm);
+
+    // Speichert pcm (interleaved); ein vorhandener kürzerer Eintrag wird ersetzt
+    bool store(const std::string& key, const std::vector<int16_t>& pcm, int channels, int sampleRate);
+    
+    // Empfänger für blockweise gelesenes PCM (interleaved), false = abbrechen
+    using BlockSink = std::function<bool(const int16_t* pcm, size_t frames)>;
+    
+    /**
+     * Wie load(), aber blockweise an sink statt in einen Puffer für den ganzen Track
+     * @return false, wenn kein passender Eintrag existiert oder sink abbricht
+     */
+    bool read(const std::string& key, size_t frames, int channels, int sampleRate, const BlockSink& sink,
+              size_t blockFrames = 32768);
+    
+    /**
+     * Schreibt einen Eintrag blockweise in eine Temp-Datei; commit() benennt
+     * atomar um (Regeln wie store()), ohne commit() wird die Temp-Datei gelöscht.
+     */
+    class Writer {
+    public:
+        Writer(SIDRenderCache& cache, const std::string& key, int channels, int sampleRate);
+        ~Writer();
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+        
+        bool append(const int16_t* pcm, size_t frames);
+        bool commit();
+        uint64_t frames() const { return frames_; }
+        
+    private:
+        SIDRenderCache& cache_;
+        std::string path_;
+        std::string tempPath_;
+        std::ofstream file_;
+        int channels_;
+        int sampleRate_;
+        uint64_t frames_ = 0;
+        bool ok_ = false;
+    };
+
+    // Löscht die ältesten Einträge, bis der Cache unter maxBytes liegt
+    void prune();
+
+    const std::string& directory() const { return directory_; }
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+
+private:
+    std::string directory_;
+    uint64_t maxBytes_;
+    std::mutex pruneMutex_;
+    std::atomic<uint64_t> bytesSincePrune_{0};
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+
+    std::string pathFor(const std::string& key) const;
+};
+
+#endif // SIDRENDERCACHE_H
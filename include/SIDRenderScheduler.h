@@ -0,0 +1,128 @@
+#ifndef SIDRENDERSCHEDULER_H
+#define SIDRENDERSCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+#include "WorkStealingPool.h"
+
+class SIDLibConverter;
+
+/**
+ * SIDRenderScheduler - Verteilung von (SID, Subtune)-Jobs auf Worker
+ *
+ * HVSC-Tracks dauern zwischen 5 s und 20 min. Mit statischen Bereichen
+ * oder Datei-Granularität laufen am Ende einzelne Threads minutenlang
+ * allein. Der Scheduler
+ * - plant pro Subtune statt pro Datei,
+ * - schätzt die Dauer vorab über Songlengths (SIDLibConverter::getTrackLength,
+ *   einmalig im aufrufenden Thread),
+ * - startet die längsten Jobs zuerst (LJF) und
+ * - gleicht den Rest per Work-Stealing aus (kurze Jobs werden gestohlen).
+ *
+ * Jeder Worker bekommt einen eigenen SIDLibConverter (Engine + Builder),
+ * der über alle seine Jobs wiederverwendet wird.
+ *
+ * Verwendung:
+ *   SIDRenderScheduler scheduler(threads);
+ *   scheduler.add(sidPath, subtune, outputPath, maxSeconds);
+ *   scheduler.run([](const SIDRenderScheduler::Job& job, SIDLibConverter& converter, size_t) {
+ *       return converter.convertToMP3(job.sidPath, job.outputPath, job.seconds, job.subtune);
+ *   });
+ *   scheduler.printUtilization();
+ *
+ * Streaming (Jobs entstehen erst während des Renderns, z.B. beim Entpacken):
+ *   std::thread producer([&]() { ... scheduler.push(sidPath, subtune, outputPath); ... scheduler.close(); });
+ *   scheduler.runStreaming(jobFunction);
+ */
+class SIDRenderScheduler {
+public:
+    struct Job {
+        std::string sidPath;
+        int subtune = 0;            // 0 = Start-Song
+        std::string outputPath;
+        int seconds = 0;            // Geplante Render-Länge (Songlengths, begrenzt durch maxSeconds)
+    };
+
+    // Rückgabe: Erfolg. Läuft im Worker-Thread; worker < threadCount() für eigenen Zustand pro Worker.
+    using JobFunction = std::function<bool(const Job& job, SIDLibConverter& converter, size_t worker)>;
+    using ProgressCallback = std::function<void(size_t completed, size_t total)>;
+
+    explicit SIDRenderScheduler(unsigned int threads = 0);
+    ~SIDRenderScheduler();
+
+    /**
+     * Job einplanen; die Länge kommt aus Songlengths
+     * @param maxSeconds Obergrenze (0 = keine)
+     * @param fallbackSeconds Länge, falls Songlengths nichts liefert
+     */
+    void add(const std::string& sidPath, int subtune, const std::string& outputPath,
+             int maxSeconds = 0, int fallbackSeconds = 180);
+
+    // Job mit bereits bekannter Länge
+    void add(Job job);
+
+    /**
+     * Streaming-Betrieb: Job nachreichen, während runStreaming() läuft
+     * (thread-safe). Wartende Jobs werden längste zuerst vergeben.
+     */
+    void push(const std::string& sidPath, int subtune, const std::string& outputPath,
+              int maxSeconds = 0, int fallbackSeconds = 180);
+    void push(Job job);
+
+    // Keine weiteren push()-Aufrufe; runStreaming() endet, sobald alles abgearbeitet ist
+    void close();
+
+    // Bisher per push() eingereichte Jobs
+    size_t pushed() const;
+
+    size_t size() const { return jobs_.size(); }
+    unsigned int threadCount() const { return pool_.threadCount(); }
+    const std::vector<Job>& jobs() const { return jobs_; }
+
+    /**
+     * Führt alle Jobs aus (längste zuerst) und blockiert bis zum Ende
+     * @return Anzahl erfolgreicher Jobs
+     */
+    size_t run(const JobFunction& job, const ProgressCallback& progress = nullptr,
+               const std::atomic<bool>* stopFlag = nullptr);
+
+    /**
+     * Führt per push() eingereichte Jobs aus, bis close() aufgerufen wurde und
+     * die Warteschlange leer ist (blockiert). total im Progress-Callback ist
+     * die Anzahl der bis dahin eingereichten Jobs.
+     * @return Anzahl erfolgreicher Jobs
+     */
+    size_t runStreaming(const JobFunction& job, const ProgressCallback& progress = nullptr,
+                        const std::atomic<bool>* stopFlag = nullptr);
+
+    // Auslastung des letzten run()
+    const std::vector<WorkStealingPool::WorkerStats>& workerStats() const { return pool_.lastStats(); }
+    void printUtilization(bool perWorker = false) const;
+
+private:
+    struct ShorterFirst {
+        bool operator()(const Job& a, const Job& b) const { return a.seconds < b.seconds; }
+    };
+
+    WorkStealingPool pool_;
+    std::vector<Job> jobs_;
+
+    // Streaming-Warteschlange (Max-Heap nach Länge)
+    mutable std::mutex streamMutex_;
+    std::condition_variable streamReady_;
+    std::priority_queue<Job, std::vector<Job>, ShorterFirst> stream_;
+    size_t streamPushed_ = 0;
+    bool streamClosed_ = false;
+
+    static Job makeJob(const std::string& sidPath, int subtune, const std::string& outputPath,
+                       int maxSeconds, int fallbackSeconds);
+};
+
+#endif // SIDRENDERSCHEDULER_H
@@ -0,0 +1,67 @@
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * SPSCRingBuffer - Lock-freier Ringpuffer für genau einen Producer und einen Consumer
+ *
+ * Kapazität wird auf die nächste Zweierpotenz aufgerundet. tryPush() darf nur
+ * vom Producer-Thread, tryPop() nur vom Consumer-Thread aufgerufen werden;
+ * size()/empty() sind von beiden Seiten aus eine Momentaufnahme.
+ *
+ * Elemente werden verschoben, nicht kopiert - mit Puffer-Objekten (z.B.
+ * std::vector) als T lässt sich so ein zweiter Ring in Gegenrichtung als
+ * Freiliste nutzen, ohne pro Block zu allokieren.
+ */
+template <typename T>
+class SPSCRingBuffer {
+public:
+    explicit SPSCRingBuffer(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+    SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+
+    // Producer: false wenn voll (item bleibt unverändert)
+    bool tryPush(T&& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) > mask_) return false;
+        slots_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: false wenn leer
+    bool tryPop(T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) return false;
+        item = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const {
+        // head zuerst lesen: tail kann nur wachsen, die Differenz bleibt >= 0
+        const size_t head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+    // Eigene Cache-Lines, damit Producer und Consumer sich nicht gegenseitig invalidieren
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -0,0 +1,49 @@
+#ifndef SQLITEREADERPOOL_H
+#define SQLITEREADERPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+
+/**
+ * SQLiteReaderPool - Kleiner Pool read-only SQLite-Verbindungen
+ *
+ * Im WAL-Modus laufen Leser parallel zum (einzigen) Schreiber und sehen
+ * jeweils den zuletzt committeten Stand. Jede Verbindung wird exklusiv an
+ * einen Thread verliehen (SQLITE_OPEN_NOMUTEX); acquire() blockiert, wenn
+ * alle Verbindungen belegt sind.
+ */
+class SQLiteReaderPool {
+public:
+    SQLiteReaderPool() = default;
+    ~SQLiteReaderPool();
+    SQLiteReaderPool(const SQLiteReaderPool&) = delete;
+    SQLiteReaderPool& operator=(const SQLiteReaderPool&) = delete;
+
+    /**
+     * Öffnet die Verbindungen
+     * @param path Datenbankdatei (muss bereits existieren)
+     * @param connections Anzahl Leser
+     * @param pragmas Pro Verbindung ausgeführte PRAGMA-Statements
+     * @return false, wenn keine Verbindung geöffnet werden konnte
+     */
+    bool open(const std::string& path, size_t connections, const std::vector<std::string>& pragmas);
+    void close();
+
+    bool empty() const { return connections_.empty(); }
+    size_t size() const { return connections_.size(); }
+
+    sqlite3* acquire();
+    void release(sqlite3* connection);
+
+private:
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<sqlite3*> connections_;
+    std::vector<sqlite3*> idle_;
+};
+
+#endif // SQLITEREADERPOOL_H
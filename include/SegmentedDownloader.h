@@ -0,0 +1,106 @@
+#ifndef SEGMENTEDDOWNLOADER_H
+#define SEGMENTEDDOWNLOADER_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * SegmentedDownloader - Segmentierter, fortsetzbarer HTTP-Download (libcurl multi)
+ *
+ * Statt eines einzelnen Transfers:
+ * - die Datei wird in N Bereiche geteilt, die parallel per Range-Request in
+ *   eine vorab angelegte <ziel>.part geschrieben werden (pwrite an den Offset)
+ * - wird ein Segment früh fertig, übernimmt es die hintere Hälfte des größten
+ *   verbleibenden Segments (kein langsamer Einzel-Connection-Tail)
+ * - Fortschritt steht in <ziel>.part.state; ein abgebrochener Download setzt
+ *   dort fort, solange Größe und ETag/Last-Modified des Servers gleich sind
+ * - abgebrochene Segmente werden einzeln wiederholt
+ * - am Ende SHA-256 (optional gegen einen erwarteten Wert), erst dann wird
+ *   .part nach <ziel> umbenannt
+ *
+ * Server ohne Range-Unterstützung bekommen einen einzelnen Transfer (ohne Resume).
+ *
+ * probe() fragt mehrere Mirrors gleichzeitig an (ein curl-multi-Durchlauf statt
+ * nacheinander je bis zum Timeout).
+ *
+ * Verwendung:
+ *   SegmentedDownloader::Options options;
+ *   options.onProgress = [](const SegmentedDownloader::Progress& p) { ... };
+ *   SegmentedDownloader downloader(options);
+ *   if (!downloader.download(url, "/pfad/HVSC.zip")) std::cerr << downloader.error();
+ */
+class SegmentedDownloader {
+public:
+    struct Progress {
+        uint64_t bytesDone = 0;         // Inklusive fortgesetzter Bytes
+        uint64_t bytesTotal = 0;        // 0 = unbekannt
+        double bytesPerSecond = 0.0;    // Dieser Lauf
+        unsigned int activeSegments = 0;
+    };
+
+    struct Options {
+        unsigned int segments = 4;
+        uint64_t minSegmentSize = 1024 * 1024;  // Kleinere Dateien/Reste nicht weiter teilen
+        int maxRetries = 3;                     // Pro Segment
+        long connectTimeoutSec = 15;
+        long lowSpeedTimeSec = 30;              // Abbruch bei < 1 KB/s über diese Zeit
+        std::string expectedSha256;             // Hex; leer = nur berechnen
+        std::function<void(const Progress&)> onProgress;
+        int progressIntervalMs = 250;
+        const std::atomic<bool>* stopFlag = nullptr;
+    };
+
+    struct ProbeResult {
+        std::string url;
+        bool ok = false;
+        uint64_t bytes = 0;
+        double bytesPerSecond = 0.0;
+    };
+
+    SegmentedDownloader() : SegmentedDownloader(Options()) {}
+    explicit SegmentedDownloader(const Options& options);
+
+    /**
+     * Lädt url nach targetPath (setzt einen vorhandenen .part-Stand fort)
+     * @return true wenn vollständig und Prüfsumme passend
+     */
+    bool download(const std::string& url, const std::string& targetPath);
+
+    const std::string& error() const { return error_; }
+    const std::string& sha256() const { return sha256_; }    // Des fertigen Downloads
+    uint64_t resumedBytes() const { return resumedBytes_; }  // Aus einem früheren Lauf übernommen
+
+    /**
+     * Alle URLs gleichzeitig anfragen (erste probeBytes) und Durchsatz messen
+     * @return Ergebnisse in Reihenfolge der URLs
+     */
+    static std::vector<ProbeResult> probe(const std::vector<std::string>& urls, size_t probeBytes = 100 * 1024,
+                                          long timeoutMs = 5000);
+
+    // SHA-256 einer Datei als Hex, leer bei Lesefehler
+    static std::string sha256File(const std::string& path);
+
+private:
+    struct Segment;
+    struct ServerInfo;
+
+    Options options_;
+    std::string error_;
+    std::string sha256_;
+    uint64_t resumedBytes_ = 0;
+
+    bool queryServer(const std::string& url, ServerInfo& info);
+    bool loadState(const std::string& statePath, const std::string& url, const ServerInfo& info,
+                   std::deque<Segment>& segments) const;
+    bool saveState(const std::string& statePath, const std::string& url, const ServerInfo& info,
+                   const std::deque<Segment>& segments) const;
+    bool transfer(const std::string& url, const ServerInfo& info, int fd, std::deque<Segment>& segments,
+                  const std::string& statePath);
+    static size_t writeSegment(char* data, size_t size, size_t nmemb, void* userdata);    // curl-Callback
+};
+
+#endif // SEGMENTEDDOWNLOADER_H
@@ -0,0 +1,117 @@
+#ifndef SIMILARITYINDEX_H
+#define SIMILARITYINDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct MediaMetadata;
+
+/**
+ * SimilarityIndex - In-Memory ANN-Index (IVF-Flat) über Track-Feature-Vektoren
+ *
+ * Feature-Vektor pro Track (fest skaliert, wie calculateSpectralSimilarity):
+ * - 13 MFCC-Mittelwerte, 13 MFCC-Standardabweichungen
+ * - Spectral Centroid, Rolloff, Zero-Crossing-Rate, BPM
+ *
+ * Die Vektoren werden per k-Means in ~sqrt(N) Listen gruppiert; eine Suche
+ * vergleicht nur die nprobe nächstgelegenen Listen statt der ganzen Bibliothek.
+ * Bis kBruteForceLimit Einträge wird exakt (eine Liste) gesucht.
+ *
+ * Nicht thread-safe - MediaDatabase ruft alles unter dbMutex_ auf. Das
+ * k-Means-Training lässt sich dreiteilen (prepareTraining/runTraining/
+ * applyTraining), damit nur das Kopieren und Übernehmen unter dem Lock läuft.
+ *
+ * Verwendung:
+ *   SimilarityIndex index;
+ *   index.upsert(meta.id, SimilarityIndex::featureVector(meta));
+ *   auto hits = index.search(SimilarityIndex::featureVector(reference), 10);
+ */
+class SimilarityIndex {
+public:
+    static constexpr size_t kDimensions = 30;
+    static constexpr size_t kBruteForceLimit = 1024;
+    static constexpr size_t kDefaultProbes = 8;
+
+    using Vector = std::vector<float>;
+
+    struct Hit {
+        int64_t id;
+        float distance;     // Euklidisch im skalierten Feature-Raum
+    };
+
+    // Skalierter Feature-Vektor eines Tracks (fehlende MFCCs = 0)
+    static Vector featureVector(const MediaMetadata& meta);
+
+    // Ähnlichkeit 0..1 aus einer Distanz (1 = identisch)
+    static float similarityFromDistance(float distance);
+
+    void clear();
+    size_t size() const { return ids_.size() - freeSlots_.size(); }
+    bool empty() const { return size() == 0; }
+
+    // Fügt hinzu oder ersetzt den Vektor einer ID
+    void upsert(int64_t id, const Vector& vector);
+    void remove(int64_t id);
+    bool contains(int64_t id) const { return slotById_.count(id) > 0; }
+
+    /**
+     * Baut die Listen neu (k-Means), synchron. Wird nach dem Laden aus der DB
+     * aufgerufen; upsert() trainiert nie selbst, siehe needsTraining().
+     */
+    void train();
+
+    // Seit dem letzten Training stark gewachsen: Listen sollten neu gebaut werden
+    bool needsTraining() const { return size() > std::max(kBruteForceLimit, trainedSize_ * 4); }
+
+    // Kopie der Vektoren + Ergebnis eines Trainings (zum Rechnen ohne Lock)
+    struct TrainingJob {
+        std::vector<int64_t> ids;
+        std::vector<float> vectors;         // ids.size() * kDimensions
+        std::vector<float> centroids;       // Ergebnis: lists * kDimensions (leer = eine Liste)
+        std::vector<uint32_t> assignment;   // Ergebnis: Liste pro Eintrag
+    };
+    TrainingJob prepareTraining() const;            // Index lesen (unter Lock)
+    static void runTraining(TrainingJob& job);      // k-Means (ohne Lock)
+    void applyTraining(const TrainingJob& job);     // Listen übernehmen (unter Lock)
+
+    /**
+     * Sucht die k nächsten Nachbarn
+     * @param query Feature-Vektor (featureVector())
+     * @param k Anzahl Treffer
+     * @param excludeId Optional: diese ID überspringen (z.B. die Referenz selbst)
+     * @param probes Anzahl durchsuchter Listen
+     * @return Treffer aufsteigend nach Distanz
+     */
+    std::vector<Hit> search(const Vector& query, size_t k, int64_t excludeId = -1,
+                            size_t probes = kDefaultProbes) const;
+
+    // Kompakter Binär-Snapshot (IDs, Vektoren, Zentroiden)
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+private:
+    static size_t nearestList(const float* vector, const std::vector<float>& centroids);
+    size_t nearestList(const float* vector) const { return nearestList(vector, centroids_); }
+    void assignSlot(uint32_t slot);
+    void unassignSlot(uint32_t slot);
+    const float* slotVector(uint32_t slot) const { return vectors_.data() + static_cast<size_t>(slot) * kDimensions; }
+
+    // Slot-Speicher (freie Slots werden wiederverwendet)
+    std::vector<int64_t> ids_;
+    std::vector<float> vectors_;                    // slots * kDimensions
+    std::vector<uint32_t> freeSlots_;
+    std::unordered_map<int64_t, uint32_t> slotById_;
+
+    // Invertierte Listen
+    std::vector<float> centroids_;                  // lists * kDimensions
+    std::vector<std::vector<uint32_t>> lists_;
+    std::vector<std::pair<uint32_t, uint32_t>> listPosition_;  // slot -> (Liste, Position)
+    size_t trainedSize_ = 0;
+};
+
+#endif // SIMILARITYINDEX_H
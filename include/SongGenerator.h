@@ -11,6 +11,7 @@
 #include "MIDIExporter.h"
 #include "BassLineEngine.h"
 #include "PatternCaptureEngine.h"
+#include "RenderGraph.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -64,6 +65,9 @@ struct GenerationParams {
  * 4. Rhythmus-Synthese
  * 5. Instrument-Layering
  * 6. Mixing und Mastering
+ *
+ * Schritte 3-6 bauen einen blockweisen Render-Graph (SongGen::RenderGraph),
+ * der direkt in den MP3-Encoder streamt.
  */
 class SongGenerator {
 public:
@@ -123,22 +127,23 @@ private:
     std::unique_ptr<SongGen::MIDIExporter> midiExporter_;
     std::unique_ptr<SongGen::PatternCaptureEngine> patternEngine_;
     
-    // Generierungs-Pipeline
-    bool generateMelody(const GenerationParams& params, std::vector<float>& samples);
-    bool generateRhythm(const GenerationParams& params, std::vector<float>& samples);
-    bool generateBass(const GenerationParams& params, std::vector<float>& samples);
-    bool layerInstruments(const GenerationParams& params, std::vector<float>& samples);
-    bool addVocals(const GenerationParams& params, std::vector<float>& samples);
-    bool mixAndMaster(std::vector<float>& samples);
+    // Generierungs-Pipeline: jede Phase hängt Knoten in den Render-Graph,
+    // gerendert wird erst beim Export (blockweise, konstanter Speicher)
+    bool generateMelody(const GenerationParams& params, SongGen::RenderGraph& graph);
+    bool generateRhythm(const GenerationParams& params, SongGen::RenderGraph& graph);
+    bool generateBass(const GenerationParams& params, SongGen::RenderGraph& graph);
+    bool layerInstruments(const GenerationParams& params, SongGen::RenderGraph& graph);
+    bool addVocals(const GenerationParams& params, SongGen::RenderGraph& graph);
+    bool mixAndMaster(SongGen::RenderGraph& graph);
     
     // Audio-Synthese
-    bool synthesizeTone(float frequency, float duration, int sampleRate, std::vector<float>& output);
-    bool applyEnvelope(std::vector<float>& samples, float attack, float decay, float sustain, float release);
     bool applyFilter(std::vector<float>& samples, const std::string& type, float cutoff);
     
-    // Audio-Export
-    bool exportWAV(const std::string& path, const std::vector<float>& samples, int sampleRate = 44100);
-    bool exportMP3(const std::string& path, const std::vector<float>& samples, int sampleRate = 44100, int bitrate = 192);
+    // Audio-Export: rendert frames Frames aus dem Graph und schreibt jeden Block sofort
+    bool exportWAV(const std::string& path, SongGen::RenderGraph& graph, uint64_t frames,
+                   int sampleRate = 44100, std::function<void(float)> progress = nullptr);
+    bool exportMP3(const std::string& path, SongGen::RenderGraph& graph, uint64_t frames,
+                   int sampleRate = 44100, int bitrate = 192, std::function<void(float)> progress = nullptr);
 };
 
 #endif // SONGGENERATOR_H
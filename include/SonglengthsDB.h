@@ -3,6 +3,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class SonglengthsDB {
@@ -11,10 +12,12 @@ public:
     
     /**
      * Lädt die Songlengths.md5 Datei
+     * Spätere Zeilen mit demselben MD5 überschreiben frühere (Append-Log der Custom-DB).
      * @param dbPath Pfad zur Songlengths.md5 Datei
+     * @param custom Einträge als eigene Messungen markieren (für saveCustomDB)
      * @return true bei Erfolg
      */
-    bool load(const std::string& dbPath);
+    bool load(const std::string& dbPath, bool custom = false);
     
     /**
      * Hole Track-Länge für einen SID
@@ -38,11 +41,14 @@ public:
      * @param sidPath Pfad zur SID-Datei
      * @param subtune Subtune-Nummer (1-basiert)
      * @param lengthSeconds Länge in Sekunden
+     * @param appendPath Optional: Eintrag sofort an diese Custom-DB anhängen
+     * @return true bei Erfolg
      */
-    void addCustomLength(const std::string& sidPath, int subtune, int lengthSeconds);
+    bool addCustomLength(const std::string& sidPath, int subtune, int lengthSeconds,
+                         const std::string& appendPath = "");
     
     /**
-     * Speichere eigene Messungen in Datei
+     * Speichere eigene Messungen in Datei (kompakt, ein Eintrag pro SID)
      * @param customDbPath Pfad zur eigenen MD5-Liste
      * @return true bei Erfolg
      */
@@ -55,11 +61,21 @@ public:
      */
     static std::string calculateSidMD5(const std::string& sidPath);
     
+    /**
+     * Schlüssel für den Pfad-Lookup: Pfad relativ zu C64Music (z.B.
+     * /MUSICIANS/H/Hubbard_Rob/Commando.sid), sonst leer (nur MD5-Lookup)
+     */
+    static std::string relativePathOf(const std::string& sidPath);
+    
 private:
     // MD5-Hash -> Vector von Track-Längen (in Sekunden)
     std::unordered_map<std::string, std::vector<int>> lengths_;
     // Relativer Pfad -> MD5-Hash (für schnellen Lookup)
     std::unordered_map<std::string, std::string> pathToMD5_;
+    // MD5-Hashes aus eigenen Messungen
+    std::unordered_set<std::string> customMD5s_;
+    
+    static std::string formatEntry(const std::string& md5, const std::vector<int>& times);
     
     /**
      * Parse eine Zeit im Format M:SS oder MM:SS
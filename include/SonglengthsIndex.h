@@ -0,0 +1,93 @@
+#ifndef SONGLENGTHSINDEX_H
+#define SONGLENGTHSINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * SonglengthsIndex - Kompilierter, per mmap geladener Index der Songlengths.md5
+ *
+ * Die HVSC-Songlengths.md5 hat >50.000 Einträge; sie bei jedem Start als Text
+ * in zwei unordered_maps zu parsen kostet Zeit und Speicher pro Prozess. Der
+ * Index wird einmal aus der Textdatei erzeugt und danach nur noch gemappt:
+ *
+ * - Einträge: sortierte 16-Byte-MD5-Schlüssel mit Offset in eine gepackte
+ *   Längentabelle (Millisekunden pro Subtune) → Binärsuche
+ * - Pfade: minimale perfekte Hashfunktion (Hash-and-Displace) über die
+ *   relativen HVSC-Pfade, pro Slot ein 64-Bit-Fingerprint gegen Fehltreffer
+ * - Kopf mit Größe und Änderungszeit der Quelldatei, veraltete Indizes
+ *   werden erkannt und neu erzeugt
+ *
+ * Ein geöffneter Index ist unveränderlich, Lookups sind ohne Lock aus
+ * beliebig vielen Threads möglich. build() schreibt in eine temporäre Datei
+ * und benennt sie um, laufende Leser sehen nie einen halben Index.
+ *
+ * Verwendung:
+ *   auto index = SonglengthsIndex::openOrBuild(md5Path, indexPath);
+ *   int seconds = index ? index->getLength(sidPath, 2) : 0;
+ */
+class SonglengthsIndex {
+public:
+    ~SonglengthsIndex();
+
+    SonglengthsIndex(const SonglengthsIndex&) = delete;
+    SonglengthsIndex& operator=(const SonglengthsIndex&) = delete;
+
+    /**
+     * Erzeugt den Index aus einer Songlengths.md5 (atomar per Umbenennen)
+     * @return true bei Erfolg
+     */
+    static bool build(const std::string& md5Path, const std::string& indexPath);
+
+    /**
+     * Mappt einen vorhandenen Index
+     * @param sourcePath Optional: Quelldatei, ein veralteter Index gilt als Fehler
+     * @return nullptr wenn Datei fehlt, beschädigt oder veraltet ist
+     */
+    static std::shared_ptr<const SonglengthsIndex> open(const std::string& indexPath,
+                                                        const std::string& sourcePath = "");
+
+    // Öffnet den Index, erzeugt ihn vorher neu falls er fehlt oder veraltet ist
+    static std::shared_ptr<const SonglengthsIndex> openOrBuild(const std::string& md5Path,
+                                                               const std::string& indexPath);
+
+    /**
+     * Track-Länge wie SonglengthsDB::getLength (Pfad, sonst MD5 der Datei)
+     * @param subtune Subtune-Nummer (1-basiert)
+     * @return Länge in Sekunden, oder 0 wenn nicht gefunden
+     */
+    int getLength(const std::string& sidPath, int subtune = 1) const;
+
+    // Länge über den MD5-Hex-String (32 Zeichen)
+    int getLengthByMD5(const std::string& md5, int subtune = 1) const;
+
+    // Passt der Index (noch) zur Quelldatei?
+    bool matchesSource(const std::string& sourcePath) const;
+
+    size_t entryCount() const;
+    size_t pathCount() const;
+
+private:
+    struct Header;
+    struct Entry;
+    struct PathSlot;
+
+    SonglengthsIndex() = default;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+
+    const Header* header_ = nullptr;
+    const Entry* entries_ = nullptr;
+    const uint32_t* lengths_ = nullptr;
+    const uint32_t* seeds_ = nullptr;
+    const PathSlot* slots_ = nullptr;
+
+    const Entry* findPath(const std::string& relativePath) const;
+    const Entry* findMD5(const uint8_t md5[16]) const;
+    int lengthOf(const Entry* entry, int subtune) const;
+};
+
+#endif // SONGLENGTHSINDEX_H
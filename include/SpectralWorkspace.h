@@ -0,0 +1,91 @@
+#ifndef SPECTRALWORKSPACE_H
+#define SPECTRALWORKSPACE_H
+
+#include <complex>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * SpectrumView - Nicht-besitzende Sicht auf ein Spektrum (N/2+1 Bins)
+ *
+ * Zeigt in den Thread-lokalen Workspace und ist nur bis zum nächsten
+ * forward()-Aufruf auf demselben Thread gültig.
+ */
+struct SpectrumView {
+    const std::complex<float>* bins = nullptr;
+    size_t binCount = 0;
+
+    SpectrumView() = default;
+    SpectrumView(const std::complex<float>* b, size_t n) : bins(b), binCount(n) {}
+    SpectrumView(const std::vector<std::complex<float>>& v) : bins(v.data()), binCount(v.size()) {}
+
+    size_t size() const { return binCount; }
+    bool empty() const { return binCount == 0; }
+    const std::complex<float>& operator[](size_t i) const { return bins[i]; }
+    const std::complex<float>* begin() const { return bins; }
+    const std::complex<float>* end() const { return bins + binCount; }
+};
+
+/**
+ * SpectralWorkspace - Wiederverwendbare FFT-Puffer pro Thread
+ *
+ * - Aligned Input/Output-Buffer (fftwf_malloc), wachsen nur bei Bedarf
+ * - FFTW-Pläne werden pro FFT-Größe einmal erstellt und prozessweit geteilt
+ *   (begrenzter Cache; FFTW_MEASURE nur für Zweierpotenzen 256..16384)
+ * - Optional: FFTW-Wisdom in ~/.songgen/fftw_wisdom.dat (schnelleres Planen beim
+ *   nächsten Start), geschrieben beim Beenden oder per saveWisdom()
+ * - Ohne FFTW3: iterative Radix-2-FFT statt naiver DFT
+ *
+ * Verwendung:
+ *   auto spectrum = SpectralWorkspace::forThisThread().forward(samples.data(), 4096);
+ */
+class SpectralWorkspace {
+public:
+    ~SpectralWorkspace();
+
+    SpectralWorkspace(const SpectralWorkspace&) = delete;
+    SpectralWorkspace& operator=(const SpectralWorkspace&) = delete;
+
+    // Workspace des aufrufenden Threads (lazy erzeugt)
+    static SpectralWorkspace& forThisThread();
+
+    /**
+     * Reelle FFT über die ersten n Samples
+     * @param samples Input (mindestens n Werte)
+     * @param n FFT-Größe (ohne FFTW3 auf Zweierpotenz abgerundet)
+     * @return Sicht auf n/2+1 komplexe Bins (gültig bis zum nächsten Aufruf)
+     */
+    SpectrumView forward(const float* samples, size_t n);
+
+    /**
+     * Betragsspektrum (|X[k]|) der ersten n Samples
+     * @return Sicht auf n/2+1 Beträge (gültig bis zum nächsten Aufruf)
+     */
+    const std::vector<float>& magnitudes(const float* samples, size_t n);
+
+    // FFT-Größe, die forward() für n Samples tatsächlich nutzt
+    static size_t effectiveSize(size_t n);
+
+    // FFTW-Wisdom (nur mit WITH_FFTW3 wirksam)
+    static void setWisdomEnabled(bool enabled);
+    static bool saveWisdom();
+
+private:
+    SpectralWorkspace() = default;
+
+    void ensureCapacity(size_t n);
+
+    float* input_ = nullptr;                 // n Floats (aligned)
+    std::complex<float>* output_ = nullptr;  // n/2+1 Bins (aligned)
+    size_t capacity_ = 0;
+    std::vector<float> magnitudes_;
+
+    // Radix-2-Fallback (ohne FFTW3): Twiddle-Faktoren und Arbeitspuffer
+    std::vector<std::complex<float>> scratch_;
+    std::vector<std::complex<float>> twiddles_;
+    size_t twiddleSize_ = 0;
+    void radix2(size_t n);
+};
+
+#endif // SPECTRALWORKSPACE_H
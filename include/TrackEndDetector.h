@@ -0,0 +1,109 @@
+#ifndef TRACKENDDETECTOR_H
+#define TRACKENDDETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * TrackEndDetector - Erkennt das Ende eines Tracks während des Renderns
+ *
+ * Viele SID-Tunes fehlen in Songlengths.md5 und werden sonst blind mit dem
+ * Fallback (180 s) gerendert, obwohl sie nach 30 s verstummen oder von vorn
+ * beginnen. Der Detektor bekommt die gerenderten Blöcke (16-Bit interleaved)
+ * und meldet das Ende, sobald
+ * - die Stille länger als silenceSeconds anhält (RMS-Gate pro 20-ms-Block), oder
+ * - sich eine komplette Periode (>= minLoopSeconds) wiederholt.
+ *
+ * Für die Loop-Erkennung wird pro 20-ms-Block (≈ ein Player-Tick) eine
+ * Hüllkurve aus Pegel und Pegel der ersten Differenz (Höhenanteil) in dB
+ * gespeichert. Jede Sekunde wird die letzte Periode gegen die davor
+ * verglichen; die Emulation ist deterministisch, kleine Phasenabweichungen
+ * fängt die dB-Toleranz ab. Wiederholungen werden nur akzeptiert, wenn die
+ * gesamte Periode übereinstimmt und sie nicht nur aus Dauerton besteht.
+ *
+ * Das Ende (endFrame) liegt bei Stille am Beginn der Stille, bei einem Loop
+ * am Beginn des zweiten Durchlaufs (Intro wird rückwärts abgegrenzt).
+ *
+ * Verwendung:
+ *   TrackEndDetector detector(44100, 2);
+ *   while (rendering && !detector.push(buffer, frames)) { ... }
+ *   if (detector.finished()) pcm.resize(detector.endFrame() * 2);
+ */
+class TrackEndDetector {
+public:
+    enum class Reason { None, Silence, Loop };
+
+    struct Settings {
+        float silenceThreshold = 0.001f;    // RMS (wie isAudible), darunter gilt ein Block als still
+        float silenceSeconds = 4.0f;        // So lange Stille beendet den Track
+        bool detectLoops = true;
+        float minLoopSeconds = 10.0f;       // Kürzere Perioden sind Wiederholungen im Song
+        float maxLoopSeconds = 300.0f;
+        float loopToleranceDb = 1.5f;       // Mittlere Abweichung der Hüllkurven
+        float minLoopRangeDb = 6.0f;        // Dynamik, damit Dauertöne nicht als Loop gelten
+    };
+
+    TrackEndDetector(int sampleRate, int channels);
+    TrackEndDetector(int sampleRate, int channels, const Settings& settings);
+
+    /**
+     * Verarbeitet gerenderte Frames
+     * @param samples interleaved, frames * channels Werte
+     * @return true, sobald das Ende erkannt wurde (weiteres Rendern unnötig)
+     */
+    bool push(const int16_t* samples, size_t frames);
+
+    bool finished() const { return reason_ != Reason::None; }
+    Reason reason() const { return reason_; }
+
+    // Schnittposition in Frames (nur gültig wenn finished())
+    size_t endFrame() const { return endFrame_; }
+    double endSeconds() const { return static_cast<double>(endFrame_) / sampleRate_; }
+
+    // Periode des erkannten Loops in Sekunden (0 ohne Loop)
+    double loopSeconds() const;
+
+    /**
+     * Frames, die kein späteres Ende mehr abschneiden kann (dürfen schon
+     * weitergegeben werden): alles vor der aktuellen Stille, mit
+     * Loop-Erkennung höchstens minLoopSeconds (der Loop-Schnitt liegt nie davor)
+     */
+    size_t committedFrames() const;
+
+    size_t framesSeen() const { return framesSeen_; }
+    bool heardSound() const { return heardSound_; }
+
+private:
+    struct Block {
+        float level;        // dB
+        float detail;       // dB der ersten Differenz
+    };
+
+    int sampleRate_;
+    int channels_;
+    Settings settings_;
+    size_t blockFrames_;
+    size_t checkBlocks_;
+
+    std::vector<Block> blocks_;
+    double sumSquares_ = 0.0;
+    double sumDiffSquares_ = 0.0;
+    double previous_ = 0.0;
+    size_t blockPos_ = 0;
+    size_t framesSeen_ = 0;
+
+    bool heardSound_ = false;
+    size_t silentBlocks_ = 0;
+    size_t loopBlocks_ = 0;
+
+    Reason reason_ = Reason::None;
+    size_t endFrame_ = 0;
+
+    void finishBlock();
+    bool checkLoop();
+    float blockDistance(size_t a, size_t b) const;
+    bool matches(size_t start, size_t lag, size_t count, float tolerance) const;
+};
+
+#endif // TRACKENDDETECTOR_H
@@ -0,0 +1,117 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * WorkStealingPool - Batch-Executor mit Work-Stealing
+ *
+ * Verteilt Task-Indizes reihum auf pro-Worker-Queues. Jeder Worker arbeitet
+ * seine eigene Queue von vorne ab (Reihenfolge der Tasks bleibt erhalten) und
+ * stiehlt bei Leerlauf vom Ende fremder Queues. Damit laufen ungleich lange
+ * Jobs (kurze Jingles vs. 10-Minuten-Tracks) ohne statische Bereiche aus.
+ *
+ * Der Task bekommt zusätzlich den Worker-Index, damit Aufrufer pro Worker
+ * eigenen Zustand halten können (z.B. einen AudioAnalyzer pro Thread).
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void(size_t taskIndex, size_t workerIndex)>;
+
+    struct WorkerStats {
+        size_t tasksExecuted = 0;
+        size_t tasksStolen = 0;
+        double busySeconds = 0.0;      // Zeit in Tasks
+        double finishSeconds = 0.0;    // Zeitpunkt (ab Start), ab dem der Worker nichts mehr fand
+    };
+
+    /**
+     * @param threads Anzahl Worker (0 = hardware_concurrency)
+     */
+    explicit WorkStealingPool(unsigned int threads = 0);
+
+    unsigned int threadCount() const { return threads_; }
+
+    /**
+     * Führt taskCount Tasks aus und blockiert bis alle fertig sind
+     * @param taskCount Anzahl der Tasks (Indizes 0..taskCount-1)
+     * @param task Callback(taskIndex, workerIndex)
+     * @param stopFlag Optional: bei true werden keine neuen Tasks mehr gestartet
+     */
+    void run(size_t taskCount, const Task& task, const std::atomic<bool>* stopFlag = nullptr);
+
+    // Statistik des letzten run()-Aufrufs (ein Eintrag pro gestartetem Worker)
+    const std::vector<WorkerStats>& lastStats() const { return stats_; }
+    double lastRunSeconds() const { return runSeconds_; }
+
+    /**
+     * Auslastung des letzten run(): busy/Laufzeit je Worker und "Tail" =
+     * Zeit zwischen dem ersten leerlaufenden Worker und dem Ende
+     * @param perWorker Zusätzlich eine Zeile pro Worker
+     */
+    void printUtilization(const char* label, bool perWorker = false) const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    unsigned int threads_;
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<WorkerStats> stats_;
+    double runSeconds_ = 0.0;
+
+    bool popLocal(size_t worker, size_t& taskIndex);
+    bool steal(size_t thief, size_t& taskIndex);
+};
+
+/**
+ * InFlightLimiter - Zählende Sperre für speicherintensive Abschnitte
+ *
+ * Begrenzt z.B. die Anzahl gleichzeitig dekodierter PCM-Buffer, unabhängig
+ * von der Anzahl der Worker-Threads.
+ */
+class InFlightLimiter {
+public:
+    explicit InFlightLimiter(size_t maxInFlight) : available_(maxInFlight > 0 ? maxInFlight : 1) {}
+
+    void acquire() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return available_ > 0; });
+        --available_;
+    }
+
+    void release() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++available_;
+        }
+        cv_.notify_one();
+    }
+
+    // RAII-Slot: hält einen Platz bis zum Ende des Scopes
+    class Slot {
+    public:
+        explicit Slot(InFlightLimiter& limiter) : limiter_(limiter) { limiter_.acquire(); }
+        ~Slot() { limiter_.release(); }
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+    private:
+        InFlightLimiter& limiter_;
+    };
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t available_;
+};
+
+#endif // WORKSTEALINGPOOL_H
@@ -0,0 +1,257 @@
+#include "ArchiveExtractor.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <strings.h>
+#include <sys/stat.h>
+
+#ifdef WITH_LIBARCHIVE
+#include <archive.h>
+#include <archive_entry.h>
+#endif
+
+namespace {
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifdef WITH_LIBARCHIVE
+
+// Relativ und ohne ".."-Komponente? Nur solche Einträge landen unter targetDir
+bool isSafeRelative(const std::string& name) {
+    if (name.empty() || name[0] == '/') return false;
+    size_t start = 0;
+    while (start <= name.size()) {
+        size_t end = name.find('/', start);
+        if (end == std::string::npos) end = name.size();
+        if (end - start == 2 && name.compare(start, 2, "..") == 0) return false;
+        start = end + 1;
+    }
+    return true;
+}
+
+std::string errorText(struct archive* handle, const char* fallback) {
+    const char* text = archive_error_string(handle);
+    return text ? text : fallback;
+}
+
+bool endsWithZip(const std::string& name) {
+    return name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".zip") == 0;
+}
+
+// Lesequelle für ein verschachteltes Archiv: die Daten des aktuellen äußeren Eintrags
+struct NestedSource {
+    struct archive* outer = nullptr;
+    char buffer[64 * 1024];
+};
+
+la_ssize_t readNested(struct archive* inner, void* client, const void** buffer) {
+    auto* source = static_cast<NestedSource*>(client);
+    la_ssize_t bytes = archive_read_data(source->outer, source->buffer, sizeof(source->buffer));
+    if (bytes < 0) {
+        archive_set_error(inner, EIO, "%s", errorText(source->outer, "Lesefehler").c_str());
+        return ARCHIVE_FATAL;
+    }
+    *buffer = source->buffer;
+    return bytes;
+}
+
+#endif
+
+} // namespace
+
+ArchiveExtractor::ArchiveExtractor(const Options& options) : options_(options) {}
+
+bool ArchiveExtractor::available() {
+#ifdef WITH_LIBARCHIVE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ArchiveExtractor::report(bool force) {
+    if (!options_.onProgress) return;
+    int64_t now = nowMs();
+    if (!force && now < nextReportMs_) return;
+    nextReportMs_ = now + options_.progressIntervalMs;
+#ifdef WITH_LIBARCHIVE
+    if (outer_) progress_.bytesRead = static_cast<uint64_t>(std::max<la_int64_t>(0, archive_filter_bytes(outer_, -1)));
+#endif
+    options_.onProgress(progress_);
+}
+
+bool ArchiveExtractor::extract(const std::string& archivePath, const std::string& targetDir) {
+    const auto start = std::chrono::steady_clock::now();
+    progress_ = Progress();
+    error_.clear();
+    skipped_ = 0;
+    nextReportMs_ = 0;
+
+#ifdef WITH_LIBARCHIVE
+    struct stat st;
+    if (::stat(archivePath.c_str(), &st) != 0) {
+        error_ = archivePath + ": " + std::strerror(errno);
+        return false;
+    }
+    progress_.bytesTotal = static_cast<uint64_t>(st.st_size);
+
+    std::error_code ec;
+    std::filesystem::create_directories(targetDir, ec);
+    if (ec) {
+        error_ = targetDir + ": " + ec.message();
+        return false;
+    }
+
+    struct archive* reader = archive_read_new();
+    archive_read_support_filter_all(reader);
+    archive_read_support_format_all(reader);
+    if (archive_read_open_filename(reader, archivePath.c_str(), 1 << 20) != ARCHIVE_OK) {
+        error_ = errorText(reader, "Archiv nicht lesbar");
+        archive_read_free(reader);
+        return false;
+    }
+
+    // Zeitstempel bewusst nicht übernehmen (siehe Header)
+    struct archive* disk = archive_write_disk_new();
+    archive_write_disk_set_options(disk, ARCHIVE_EXTRACT_PERM | ARCHIVE_EXTRACT_SECURE_SYMLINKS);
+    archive_write_disk_set_standard_lookup(disk);
+
+    outer_ = reader;
+    std::string base = targetDir;
+    while (base.size() > 1 && base.back() == '/') base.pop_back();
+    bool ok = extractFrom(reader, disk, base, 0);
+    report(true);
+    outer_ = nullptr;
+
+    if (archive_write_close(disk) != ARCHIVE_OK && ok) {
+        error_ = errorText(disk, "Schreiben fehlgeschlagen");
+        ok = false;
+    }
+    archive_write_free(disk);
+    archive_read_free(reader);
+
+    seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return ok;
+#else
+    (void)archivePath;
+    (void)targetDir;
+    (void)start;
+    error_ = "ohne libarchive gebaut";
+    return false;
+#endif
+}
+
+bool ArchiveExtractor::extractFrom(struct archive* reader, struct archive* disk, const std::string& targetDir,
+                                   int depth) {
+#ifdef WITH_LIBARCHIVE
+    struct archive_entry* entry = nullptr;
+    while (true) {
+        if (stopped()) {
+            error_ = "abgebrochen";
+            return false;
+        }
+
+        int rc = archive_read_next_header(reader, &entry);
+        if (rc == ARCHIVE_EOF) return true;
+        if (rc < ARCHIVE_WARN) {
+            error_ = errorText(reader, "Lesefehler");
+            return false;
+        }
+        progress_.entries++;
+
+        const char* rawName = archive_entry_pathname(entry);
+        std::string name = rawName ? rawName : "";
+        if (!isSafeRelative(name)) {
+            std::cerr << "⚠️ Überspringe unsicheren Archiv-Eintrag: " << name << "\n";
+            skipped_++;
+            continue;
+        }
+        const bool regular = archive_entry_filetype(entry) == AE_IFREG;
+
+        // Verschachteltes Zip direkt aus dem Stream entpacken (neben die Zip-Datei)
+        if (regular && depth == 0 && options_.expandNestedZips && endsWithZip(name)) {
+            std::string parent = std::filesystem::path(name).parent_path().string();
+            auto source = std::make_unique<NestedSource>();
+            source->outer = reader;
+
+            struct archive* inner = archive_read_new();
+            archive_read_support_filter_all(inner);
+            archive_read_support_format_zip(inner);
+            bool ok = archive_read_open(inner, source.get(), nullptr, readNested, nullptr) == ARCHIVE_OK;
+            if (!ok) {
+                error_ = name + ": " + errorText(inner, "kein Zip");
+            } else {
+                ok = extractFrom(inner, disk, parent.empty() ? targetDir : targetDir + "/" + parent, depth + 1);
+                if (!ok && error_.empty()) error_ = name + ": Lesefehler";
+            }
+            archive_read_free(inner);
+            if (!ok) return false;
+            continue;
+        }
+
+        std::string fullPath = targetDir + "/" + name;
+        archive_entry_set_pathname(entry, fullPath.c_str());
+        if (const char* link = archive_entry_hardlink(entry)) {
+            if (!isSafeRelative(link)) {
+                skipped_++;
+                continue;
+            }
+            archive_entry_set_hardlink(entry, (targetDir + "/" + link).c_str());
+        }
+
+        rc = archive_write_header(disk, entry);
+        if (rc < ARCHIVE_WARN) {
+            // Einzelner Eintrag nicht schreibbar (z.B. Symlink-Schutz): weiter mit dem Rest
+            std::cerr << "⚠️ " << fullPath << ": " << errorText(disk, "Schreibfehler") << "\n";
+            skipped_++;
+            if (rc == ARCHIVE_FATAL) {
+                error_ = errorText(disk, "Schreibfehler");
+                return false;
+            }
+            continue;
+        }
+
+        bool written = true;
+        if (regular) {
+            const void* block = nullptr;
+            size_t size = 0;
+            la_int64_t offset = 0;
+            while ((rc = archive_read_data_block(reader, &block, &size, &offset)) == ARCHIVE_OK) {
+                if (archive_write_data_block(disk, block, size, offset) < ARCHIVE_OK) {
+                    error_ = fullPath + ": " + errorText(disk, "Schreibfehler");
+                    return false;
+                }
+                progress_.bytesWritten += size;
+                report(false);
+            }
+            if (rc != ARCHIVE_EOF) {
+                error_ = name + ": " + errorText(reader, "Lesefehler");
+                return false;
+            }
+        }
+        if (archive_write_finish_entry(disk) < ARCHIVE_WARN) {
+            std::cerr << "⚠️ " << fullPath << ": " << errorText(disk, "Schreibfehler") << "\n";
+            written = false;
+        }
+
+        if (regular && written) {
+            progress_.files++;
+            if (options_.onFile) options_.onFile(fullPath);
+        }
+        report(false);
+    }
+#else
+    (void)reader;
+    (void)disk;
+    (void)targetDir;
+    (void)depth;
+    return false;
+#endif
+}
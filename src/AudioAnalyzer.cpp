@@ -1,15 +1,17 @@
 #include "AudioAnalyzer.h"
+#include "WorkStealingPool.h"
+#include "AudioStreamReader.h"
+#include "SIDLibConverter.h"
 #include <cmath>
 #include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <thread>
 #include <map>
+#include <mutex>
 #include <cstring>
-
-#ifdef WITH_FFTW3
-#include <fftw3.h>
-#endif
+#include <filesystem>
+#include <iomanip>
 
 #ifdef WITH_SNDFILE
 #include <sndfile.h>
@@ -72,29 +74,96 @@ void AudioAnalyzer::initializeNPU() {
 }
 
 bool AudioAnalyzer::analyze(const std::string& filepath, MediaMetadata& meta) {
-    std::vector<float> samples;
-    int sampleRate = 44100;
-    
-    // Lade Audio-Datei
-    if (!loadAudioFile(filepath, samples, sampleRate)) {
+    // Audio-Datei streamen: Chunks gehen direkt in den Frame-Speicher
+    FeatureFrames frames;
+    if (!loadFeatureFrames(filepath, frames)) {
         std::cerr << "Failed to load audio: " << filepath << std::endl;
         return false;
     }
     
     meta.filepath = filepath;
-    meta.duration = static_cast<float>(samples.size()) / sampleRate;
+    return analyzeFrames(frames, meta);
+}
+
+bool AudioAnalyzer::loadFeatureFrames(const std::string& filepath, FeatureFrames& frames) {
+    std::string ext = std::filesystem::path(filepath).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    if (ext == ".sid") {
+        return loadSIDFeatureFrames(filepath, 0, frames);
+    }
+    
+    AudioStreamReader reader;
+    if (!reader.open(filepath)) {
+        return false;  // Silently fail for unsupported formats
+    }
+    
+    FeatureFrameBuilder builder(reader.sampleRate());
+    std::vector<float> chunk(AudioStreamReader::kDefaultChunkFrames);
+    size_t got = 0;
+    while ((got = reader.read(chunk.data(), chunk.size())) > 0) {
+        builder.push(chunk.data(), got);
+    }
+    
+    frames = builder.finish();
+    return frames.sampleCount > 0;
+}
+
+bool AudioAnalyzer::loadSIDFeatureFrames(const std::string& sidPath, int subtune, FeatureFrames& frames) {
+    // Länge des Songs, der tatsächlich läuft (subtune 0 = Start-Song aus dem Header)
+    int song = subtune > 0 ? subtune : SIDLibConverter::getStartSong(sidPath);
+    int seconds = SIDLibConverter::getTrackLength(sidPath, song);
+    
+    // Engine des Threads wiederverwenden; Blöcke gehen direkt in den Builder,
+    // der Speicher bleibt unabhängig von der Tune-Länge
+    const int channels = SIDLibConverter::kChannels;
+    FeatureFrameBuilder builder(SIDLibConverter::kSampleRate);
+    std::vector<float> chunk;
+    bool ok = SIDLibConverter::forThread().renderPCM(sidPath, song, seconds,
+                                                     [&](const int16_t* pcm, size_t count) {
+        // Stereo → Mono wie beim Dekodieren einer Datei
+        chunk.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            int sum = 0;
+            for (int c = 0; c < channels; ++c) sum += pcm[i * channels + c];
+            chunk[i] = static_cast<float>(sum) / (32768.0f * channels);
+        }
+        builder.push(chunk.data(), count);
+        return true;
+    });
+    if (!ok) return false;
+    
+    frames = builder.finish();
+    return frames.sampleCount > 0;
+}
+
+bool AudioAnalyzer::analyzeSamples(const std::vector<float>& samples, int sampleRate, MediaMetadata& meta) {
+    if (samples.empty() || sampleRate <= 0) {
+        return false;
+    }
+    
+    // Ein STFT-Durchlauf über den ganzen Track, alle Detektoren lesen daraus
+    return analyzeFrames(FeatureFrames::compute(samples, sampleRate), meta);
+}
+
+bool AudioAnalyzer::analyzeFrames(const FeatureFrames& frames, MediaMetadata& meta) {
+    if (frames.sampleCount == 0 || frames.sampleRate <= 0) {
+        return false;
+    }
+    
+    meta.duration = frames.duration();
     
     // BPM-Erkennung
-    meta.bpm = detectBPM(samples, sampleRate);
+    meta.bpm = detectBPM(frames);
     
-    // Spektrale Features
-    auto spectrum = performFFT(samples);
-    meta.spectralCentroid = calculateSpectralCentroid(spectrum);
-    meta.spectralRolloff = calculateSpectralRolloff(spectrum);
-    meta.zeroCrossingRate = calculateZeroCrossingRate(samples);
+    // Spektrale Features (Hz, gemittelt über alle hörbaren Frames)
+    meta.spectralCentroid = frames.meanCentroid;
+    meta.spectralRolloff = frames.meanRolloff;
+    meta.zeroCrossingRate = frames.zeroCrossingRate;
     
-    // MFCC-Hash
-    meta.mfccHash = calculateMFCCHash(samples, sampleRate);
+    // MFCC-Vektoren (Mittel/Varianz über alle Frames) + skalare Signatur
+    meta.mfccMean = frames.mfccMean;
+    meta.mfccVariance = frames.mfccVariance;
+    meta.mfccHash = calculateMFCCHash(frames);
     
     // NPU-beschleunigte Feature-Extraktion (falls verfügbar)
     if (useNPU_) {
@@ -110,7 +179,7 @@ bool AudioAnalyzer::analyze(const std::string& filepath, MediaMetadata& meta) {
     }
     
     // Instrument-Erkennung
-    auto instruments = detectInstruments(samples, sampleRate);
+    auto instruments = detectInstruments(frames);
     meta.instruments = "";
     for (size_t i = 0; i < instruments.size(); ++i) {
         meta.instruments += instruments[i];
@@ -118,20 +187,20 @@ bool AudioAnalyzer::analyze(const std::string& filepath, MediaMetadata& meta) {
     }
     
     // Intensität und Bass-Level
-    meta.intensity = detectIntensity(samples);
-    meta.bassLevel = detectBassLevel(samples, sampleRate);
+    meta.intensity = detectIntensity(frames);
+    meta.bassLevel = detectBassLevel(frames);
     
     // Genre-Klassifikation (basierend auf Features)
     meta.genre = classifyGenre(meta);
     
     // Erweiterte Stil-Analyse
-    std::string rhythmPattern = analyzeRhythmPattern(samples, sampleRate, meta.bpm);
+    std::string rhythmPattern = analyzeRhythmPattern(frames, meta.bpm);
     std::string musicalStyle = detectMusicalStyle(meta);
     auto styleTags = extractStyleTags(meta);
     
     // 🎵 Song-Struktur-Analyse (nur wenn BPM erkannt wurde)
     if (meta.bpm > 0) {
-        auto structure = analyzeSongStructure(samples, sampleRate, meta.bpm);
+        auto structure = analyzeSongStructure(frames, meta.bpm);
         
         // Speichere Struktur-Info im mood-Feld zusammen mit Style-Info
         meta.mood = rhythmPattern + " | " + musicalStyle + " | " + structure.arrangement;
@@ -165,13 +234,13 @@ bool AudioAnalyzer::detectSilenceAndTrimWav(
     std::vector<float> samples;
     int sampleRate = 44100;
 
-    if (!loadWAV(inPath, samples, sampleRate) || samples.empty()) {
+    if (!AudioStreamReader::readAll(inPath, samples, sampleRate) || samples.empty()) {
         std::cerr << "[Analyzer] ❌ Kann WAV nicht laden: " << inPath << "\n";
         return false;
     }
 
     const size_t totalSamples = samples.size();
-    const int channels = 1; // loadWAV normalisiert bereits auf Mono
+    const int channels = 1; // AudioStreamReader liefert bereits Mono
     float durationSec = static_cast<float>(totalSamples) / sampleRate;
     
     std::cerr << "[Analyzer] Track-Länge: " << durationSec << "s, " << totalSamples << " samples\n";
@@ -284,54 +353,91 @@ bool AudioAnalyzer::detectSilenceAndTrimWav(
     return true;
 }
 
-std::vector<MediaMetadata> AudioAnalyzer::analyzeBatch(
+size_t AudioAnalyzer::analyzeBatch(
     const std::vector<std::string>& filepaths,
-    const std::function<void(size_t, size_t)>& progressCallback) {
+    const BatchResultCallback& resultCallback,
+    const std::function<void(size_t, size_t)>& progressCallback,
+    const BatchOptions& options) {
     
-    std::vector<MediaMetadata> results;
-    size_t completed = 0;
+    if (filepaths.empty()) return 0;
+    
+    WorkStealingPool pool(options.threads);
+    const unsigned int numWorkers = pool.threadCount();
     
-    // TODO: Multi-Threading für Batch-Processing
-    for (const auto& filepath : filepaths) {
+    // Limit für gleichzeitig offene Decoder (Datei-Handles, Decoder-Zustand)
+    InFlightLimiter decoderLimiter(options.maxBuffersInFlight > 0 ? options.maxBuffersInFlight : numWorkers);
+    
+    // Ein Analyzer pro Worker (lazy, damit ungenutzte Worker nichts kosten).
+    // Der Aufrufer-Analyzer wird für Worker 0 wiederverwendet.
+    std::vector<std::unique_ptr<AudioAnalyzer>> workerAnalyzers(numWorkers);
+    
+    std::atomic<size_t> completed(0);
+    std::atomic<size_t> succeeded(0);
+    const size_t total = filepaths.size();
+    
+    std::cout << "🚀 Batch-Analyse: " << total << " Dateien, " << numWorkers << " Worker\n";
+    
+    pool.run(total, [&](size_t idx, size_t worker) {
+        AudioAnalyzer* analyzer = this;
+        if (worker != 0) {
+            if (!workerAnalyzers[worker]) {
+                workerAnalyzers[worker] = std::make_unique<AudioAnalyzer>();
+            }
+            analyzer = workerAnalyzers[worker].get();
+        }
+        
         MediaMetadata meta;
-        if (analyze(filepath, meta)) {
-            results.push_back(meta);
+        meta.filepath = filepaths[idx];
+        bool ok = false;
+        {
+            // Dekodiert chunkweise: pro Worker nur ein Chunk PCM + Frame-Features
+            InFlightLimiter::Slot slot(decoderLimiter);
+            ok = analyzer->analyze(filepaths[idx], meta);
+        }  // Decoder schließen bevor das Ergebnis weitergereicht wird
+        
+        if (ok) succeeded++;
+        if (resultCallback) {
+            resultCallback(idx, meta, ok);
         }
         
-        completed++;
+        size_t done = ++completed;
         if (progressCallback) {
-            progressCallback(completed, filepaths.size());
+            progressCallback(done, total);
         }
-    }
+    }, options.stopFlag);
     
-    return results;
+    return succeeded.load();
 }
 
-float AudioAnalyzer::detectBPM(const std::vector<float>& samples, int sampleRate) {
-    if (samples.empty()) return 120.0f;
+std::vector<MediaMetadata> AudioAnalyzer::analyzeBatch(
+    const std::vector<std::string>& filepaths,
+    const std::function<void(size_t, size_t)>& progressCallback) {
     
-    // Energy-basierte Beat-Detection mit Autocorrelation
-    size_t hopSize = 512;
-    size_t windowSize = 2048;
-    std::vector<float> energy;
+    std::vector<MediaMetadata> results;
+    std::mutex resultMutex;
     
-    // Berechne Energy pro Frame
-    for (size_t i = 0; i + windowSize < samples.size(); i += hopSize) {
-        float frameEnergy = 0.0f;
-        for (size_t j = 0; j < windowSize; ++j) {
-            frameEnergy += samples[i + j] * samples[i + j];
-        }
-        energy.push_back(frameEnergy / windowSize);
-    }
+    analyzeBatch(filepaths,
+        [&](size_t, const MediaMetadata& meta, bool ok) {
+            if (!ok) return;
+            std::lock_guard<std::mutex> lock(resultMutex);
+            results.push_back(meta);
+        },
+        progressCallback);
     
-    if (energy.size() < 100) return 120.0f;
+    return results;
+}
+
+float AudioAnalyzer::detectBPM(const std::vector<float>& samples, int sampleRate) {
+    if (samples.empty()) return 120.0f;
+    return detectBPM(FeatureFrames::compute(samples, sampleRate));
+}
+
+float AudioAnalyzer::detectBPM(const FeatureFrames& frames) {
+    // Energy-basierte Beat-Detection mit Autocorrelation auf der Energie-Hüllkurve
+    if (frames.frameCount() < 100) return 120.0f;
     
-    // Onset-Detection (Energieänderung)
-    std::vector<float> onsets;
-    for (size_t i = 1; i < energy.size(); ++i) {
-        float diff = energy[i] - energy[i-1];
-        onsets.push_back(diff > 0 ? diff : 0);
-    }
+    // Onset-Funktion (Energieänderung), Frame 0 hat keinen Vorgänger
+    const std::vector<float> onsets(frames.onset.begin() + 1, frames.onset.end());
     
     // Autocorrelation für periodische Peaks
     std::vector<float> autocorr(300, 0.0f);  // ~2 Sekunden bei 150 BPM
@@ -354,7 +460,7 @@ float AudioAnalyzer::detectBPM(const std::vector<float>& samples, int sampleRate
     // Konvertiere Lag zu BPM
     if (peakLag == 0) return 120.0f;  // Fallback bei ungültigem Peak
     
-    float framesPerSecond = static_cast<float>(sampleRate) / hopSize;
+    float framesPerSecond = frames.framesPerSecond();
     float beatsPerSecond = framesPerSecond / peakLag;
     float bpm = beatsPerSecond * 60.0f;
     
@@ -367,19 +473,23 @@ float AudioAnalyzer::detectBPM(const std::vector<float>& samples, int sampleRate
 }
 
 std::vector<std::string> AudioAnalyzer::detectInstruments(const std::vector<float>& samples, int sampleRate) {
+    return detectInstruments(FeatureFrames::compute(samples, sampleRate));
+}
+
+std::vector<std::string> AudioAnalyzer::detectInstruments(const FeatureFrames& frames) {
     // TODO: ML-basierte Instrument-Erkennung
     // Für jetzt: Dummy-Implementation
     std::vector<std::string> instruments;
     
-    // Basierend auf spektralen Features einfache Heuristik
-    auto spectrum = performFFT(samples);
+    // Basierend auf dem mittleren Betragsspektrum des ganzen Tracks einfache Heuristik
+    const std::vector<float>& spectrum = frames.meanMagnitude;
     float lowEnergy = 0.0f, midEnergy = 0.0f, highEnergy = 0.0f;
     
     size_t lowBound = spectrum.size() / 10;
     size_t midBound = spectrum.size() / 3;
     
     for (size_t i = 0; i < spectrum.size(); ++i) {
-        float mag = std::abs(spectrum[i]);
+        float mag = spectrum[i];
         if (i < lowBound) lowEnergy += mag;
         else if (i < midBound) midEnergy += mag;
         else highEnergy += mag;
@@ -467,17 +577,31 @@ std::string AudioAnalyzer::detectIntensity(const std::vector<float>& samples) {
     return "mittel";
 }
 
+std::string AudioAnalyzer::detectIntensity(const FeatureFrames& frames) {
+    if (frames.sampleCount == 0) return "mittel";
+    
+    // RMS wurde im STFT-Durchlauf bereits über alle Samples berechnet
+    if (frames.rms > 0.5f) return "hart";
+    if (frames.rms < 0.2f) return "soft";
+    return "mittel";
+}
+
 std::string AudioAnalyzer::detectBassLevel(const std::vector<float>& samples, int sampleRate) {
-    auto spectrum = performFFT(samples);
+    return detectBassLevel(FeatureFrames::compute(samples, sampleRate));
+}
+
+std::string AudioAnalyzer::detectBassLevel(const FeatureFrames& frames) {
+    const std::vector<float>& spectrum = frames.meanMagnitude;
+    if (spectrum.empty()) return "mittel";
     
     // Bass = 20-250 Hz
-    size_t bassEnd = static_cast<size_t>(250.0f * spectrum.size() / (sampleRate / 2.0f));
+    size_t bassEnd = static_cast<size_t>(250.0f * frames.fftSize / frames.sampleRate);
     
     float bassEnergy = 0.0f;
     float totalEnergy = 0.0f;
     
     for (size_t i = 0; i < spectrum.size(); ++i) {
-        float mag = std::abs(spectrum[i]);
+        float mag = spectrum[i];
         totalEnergy += mag;
         if (i < bassEnd) bassEnergy += mag;
     }
@@ -490,7 +614,7 @@ std::string AudioAnalyzer::detectBassLevel(const std::vector<float>& samples, in
     return "mittel";
 }
 
-float AudioAnalyzer::calculateSpectralCentroid(const std::vector<std::complex<float>>& spectrum) {
+float AudioAnalyzer::calculateSpectralCentroid(const SpectrumView& spectrum) {
     if (spectrum.empty()) return 0.0f;
     
     float weightedSum = 0.0f;
@@ -523,7 +647,7 @@ float AudioAnalyzer::calculateSpectralCentroid(const std::vector<float>& spectru
     return magnitudeSum > 0 ? weightedSum / magnitudeSum : 0.0f;
 }
 
-float AudioAnalyzer::calculateSpectralRolloff(const std::vector<std::complex<float>>& spectrum, float threshold) {
+float AudioAnalyzer::calculateSpectralRolloff(const SpectrumView& spectrum, float threshold) {
     if (spectrum.empty()) return 0.0f;
     
     float totalEnergy = 0.0f;
@@ -558,8 +682,12 @@ float AudioAnalyzer::calculateZeroCrossingRate(const std::vector<float>& samples
 }
 
 float AudioAnalyzer::calculateMFCCHash(const std::vector<float>& samples, int sampleRate) {
-    // Vereinfachter MFCC-Hash (eigentlich braucht man richtige MFCC-Berechnung)
-    auto mfcc = extractMFCC(samples, sampleRate);
+    return calculateMFCCHash(FeatureFrames::compute(samples, sampleRate));
+}
+
+float AudioAnalyzer::calculateMFCCHash(const FeatureFrames& frames) {
+    // Skalare Kurz-Signatur (Kompatibilität); für Ähnlichkeit meta.mfccMean verwenden
+    auto mfcc = extractMFCC(frames);
     
     float hash = 0.0f;
     for (size_t i = 0; i < mfcc.size(); ++i) {
@@ -569,206 +697,18 @@ float AudioAnalyzer::calculateMFCCHash(const std::vector<float>& samples, int sa
     return hash;
 }
 
-std::vector<std::complex<float>> AudioAnalyzer::performFFT(const std::vector<float>& samples) {
-#ifdef WITH_FFTW3
-    // FFTW3-basierte FFT (schnell!)
-    size_t N = std::min(samples.size(), size_t(8192));
-    std::vector<std::complex<float>> spectrum(N / 2 + 1);
-    
-    fftwf_complex* out = reinterpret_cast<fftwf_complex*>(spectrum.data());
-    float* in = const_cast<float*>(samples.data());
-    
-    fftwf_plan plan = fftwf_plan_dft_r2c_1d(N, in, out, FFTW_ESTIMATE);
-    fftwf_execute(plan);
-    fftwf_destroy_plan(plan);
-    
-    return spectrum;
-#else
-    // Fallback: Vereinfachte DFT
-    size_t N = std::min(samples.size(), size_t(2048));  // Kleinere Größe ohne FFTW3
-    std::vector<std::complex<float>> spectrum(N);
-    
-    const float pi = 3.14159265358979323846f;
-    
-    for (size_t k = 0; k < N; ++k) {
-        std::complex<float> sum(0, 0);
-        for (size_t n = 0; n < N; ++n) {
-            float angle = 2 * pi * k * n / N;
-            sum += samples[n] * std::complex<float>(std::cos(angle), -std::sin(angle));
-        }
-        spectrum[k] = sum;
-    }
-    
-    return spectrum;
-#endif
-}
-
-std::vector<float> AudioAnalyzer::extractMFCC(const std::vector<float>& samples, int sampleRate, int numCoeffs) {
-    // MFCC-Berechnung (vereinfacht)
-    auto spectrum = performFFT(samples);
-    
-    // Mel-Filterbank (26 Filter, typisch)
-    const int numFilters = 26;
-    std::vector<float> melEnergies(numFilters, 0.0f);
-    
-    // Vereinfachte Mel-Filter
-    for (int i = 0; i < numFilters; ++i) {
-        float centerFreq = 300.0f + (i * 200.0f);  // 300-5500 Hz
-        size_t centerBin = static_cast<size_t>(centerFreq * spectrum.size() / (sampleRate / 2.0f));
-        
-        // Summiere Energie um Center-Bin
-        for (size_t j = std::max(size_t(0), centerBin - 10); 
-             j < std::min(spectrum.size(), centerBin + 10); ++j) {
-            melEnergies[i] += std::abs(spectrum[j]);
-        }
-        
-        // Log-Energie
-        melEnergies[i] = std::log(melEnergies[i] + 1e-10f);
-    }
-    
-    // DCT für MFCC-Koeffizienten
-    std::vector<float> mfcc(numCoeffs, 0.0f);
-    const float pi = 3.14159265358979323846f;
-    
-    for (int i = 0; i < numCoeffs; ++i) {
-        for (int j = 0; j < numFilters; ++j) {
-            mfcc[i] += melEnergies[j] * std::cos(pi * i * (j + 0.5f) / numFilters);
-        }
-    }
-    
+std::vector<float> AudioAnalyzer::extractMFCC(const FeatureFrames& frames, int numCoeffs) {
+    // MFCCs werden pro Frame im STFT-Durchlauf berechnet (Mel-Filterbank + DCT),
+    // hier nur der Track-Mittelwert
+    std::vector<float> mfcc(frames.mfccMean);
+    mfcc.resize(numCoeffs, 0.0f);
     return mfcc;
 }
 
 bool AudioAnalyzer::loadAudioFile(const std::string& filepath, std::vector<float>& samples, int& sampleRate) {
-#ifdef WITH_SNDFILE
-    // Use libsndfile for all formats (WAV, MP3, FLAC, OGG, etc.)
-    SF_INFO sfinfo;
-    std::memset(&sfinfo, 0, sizeof(sfinfo));
-    
-    SNDFILE* file = sf_open(filepath.c_str(), SFM_READ, &sfinfo);
-    if (!file) {
-        return false;  // Silently fail for unsupported formats
-    }
-    
-    sampleRate = sfinfo.samplerate;
-    size_t numSamples = sfinfo.frames * sfinfo.channels;
-    
-    std::vector<float> tempBuffer(numSamples);
-    sf_count_t framesRead = sf_readf_float(file, tempBuffer.data(), sfinfo.frames);
-    sf_close(file);
-    
-    if (framesRead <= 0) {
-        return false;
-    }
-    
-    // Convert to mono if stereo
-    samples.clear();
-    samples.reserve(framesRead);
-    
-    if (sfinfo.channels == 1) {
-        samples.assign(tempBuffer.begin(), tempBuffer.begin() + framesRead);
-    } else {
-        // Mix down to mono (average channels)
-        for (sf_count_t i = 0; i < framesRead; ++i) {
-            float sum = 0.0f;
-            for (int ch = 0; ch < sfinfo.channels; ++ch) {
-                sum += tempBuffer[i * sfinfo.channels + ch];
-            }
-            samples.push_back(sum / sfinfo.channels);
-        }
-    }
-    
-    return true;
-#else
-    // Fallback: WAV-only support
-    if (filepath.find(".wav") != std::string::npos || filepath.find(".WAV") != std::string::npos) {
-        return loadWAV(filepath, samples, sampleRate);
-    }
-    return false;  // Silently skip unsupported formats
-#endif
-}
-
-bool AudioAnalyzer::loadWAV(const std::string& filepath, std::vector<float>& samples, int& sampleRate) {
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    // WAV-Header lesen
-    char header[44];
-    file.read(header, 44);
-    
-    if (!file.good() || file.gcount() != 44) {
-        file.close();
-        return false;
-    }
-    
-    // Validate RIFF header
-    if (strncmp(header, "RIFF", 4) != 0 || strncmp(header + 8, "WAVE", 4) != 0) {
-        file.close();
-        return false;
-    }
-    
-    // Extract header info
-    short numChannels = *reinterpret_cast<short*>(&header[22]);
-    sampleRate = *reinterpret_cast<int*>(&header[24]);
-    short bitsPerSample = *reinterpret_cast<short*>(&header[34]);
-    
-    // Validate critical values
-    if (numChannels <= 0 || numChannels > 16 || 
-        sampleRate <= 0 || sampleRate > 192000 ||
-        bitsPerSample <= 0 || bitsPerSample > 32) {
-        file.close();
-        return false;
-    }
-    
-    // Get file size
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    if (fileSize <= 44) {
-        file.close();
-        return false;
-    }
-    file.seekg(44);
-    
-    size_t dataSize = fileSize - 44;
-    size_t bytesPerSample = bitsPerSample / 8;
-    size_t totalSamples = dataSize / bytesPerSample;
-    size_t monoSamples = totalSamples / numChannels;
-    
-    if (totalSamples == 0 || monoSamples == 0) {
-        file.close();
-        return false;
-    }
-    
-    samples.clear();
-    samples.reserve(monoSamples);
-    
-    if (bitsPerSample == 16) {
-        std::vector<short> rawSamples(totalSamples);
-        file.read(reinterpret_cast<char*>(rawSamples.data()), dataSize);
-        
-        if (!file.good()) {
-            file.close();
-            return false;
-        }
-        
-        // Convert to mono float [-1, 1]
-        for (size_t i = 0; i < totalSamples; i += numChannels) {
-            float monoSample = 0.0f;
-            for (short ch = 0; ch < numChannels; ++ch) {
-                monoSample += rawSamples[i + ch] / 32768.0f;
-            }
-            samples.push_back(monoSample / numChannels);
-        }
-    } else {
-        // Unsupported bit depth
-        file.close();
-        return false;
-    }
-    
-    file.close();
-    return true;
+    // Mono-Buffer direkt aus dem Stream-Reader (keine interleaved Zwischenkopie).
+    // Ohne libsndfile liest der Reader WAV-Dateien (PCM/Float) selbst.
+    return AudioStreamReader::readAll(filepath, samples, sampleRate);
 }
 
 std::vector<float> AudioAnalyzer::runNPUInference(const std::vector<float>& features) {
@@ -808,21 +748,30 @@ std::vector<float> AudioAnalyzer::runNPUInference(const std::vector<float>& feat
 
 // ===== RHYTHMUS-ANALYSE =====
 
-std::vector<float> AudioAnalyzer::detectOnsets(const std::vector<float>& samples, int sampleRate) {
-    // Onset-Detection via Energie-Differenz
+std::vector<float> AudioAnalyzer::detectOnsets(const FeatureFrames& frames) {
+    // Onset-Detection via Peak-Picking auf der Onset-Funktion (Energie-Differenz)
+    // mit adaptivem Schwellwert (lokaler Mittelwert über ~±100ms)
     std::vector<float> onsets;
-    const int windowSize = sampleRate / 20; // 50ms Windows
-    const int hopSize = windowSize / 2;
+    const std::vector<float>& flux = frames.onset;
+    if (flux.size() < 3) return onsets;
     
-    for (size_t i = 0; i + windowSize < samples.size(); i += hopSize) {
-        float energy = 0.0f;
-        for (int j = 0; j < windowSize; j++) {
-            energy += samples[i + j] * samples[i + j];
-        }
-        energy /= windowSize;
+    const size_t radius = std::max<size_t>(1, static_cast<size_t>(frames.framesPerSecond() * 0.1f));
+    const float minGap = 0.05f;  // Mindestabstand 50ms
+    
+    for (size_t i = 1; i + 1 < flux.size(); ++i) {
+        if (flux[i] <= flux[i-1] || flux[i] < flux[i+1]) continue;
+        
+        size_t lo = i > radius ? i - radius : 0;
+        size_t hi = std::min(flux.size(), i + radius + 1);
+        float localMean = 0.0f;
+        for (size_t j = lo; j < hi; ++j) localMean += flux[j];
+        localMean /= (hi - lo);
         
-        if (onsets.empty() || energy > onsets.back() * 1.3f) {
-            onsets.push_back(static_cast<float>(i) / sampleRate);
+        if (flux[i] > localMean * 1.5f && flux[i] > 1e-6f) {
+            float t = frames.frameTime(i);
+            if (onsets.empty() || t - onsets.back() >= minGap) {
+                onsets.push_back(t);
+            }
         }
     }
     
@@ -867,7 +816,11 @@ std::string AudioAnalyzer::classifyRhythmComplexity(const std::vector<int>& patt
 }
 
 std::string AudioAnalyzer::analyzeRhythmPattern(const std::vector<float>& samples, int sampleRate, float bpm) {
-    auto onsets = detectOnsets(samples, sampleRate);
+    return analyzeRhythmPattern(FeatureFrames::compute(samples, sampleRate), bpm);
+}
+
+std::string AudioAnalyzer::analyzeRhythmPattern(const FeatureFrames& frames, float bpm) {
+    auto onsets = detectOnsets(frames);
     auto pattern = analyzeTimingPattern(onsets, bpm);
     std::string complexity = classifyRhythmComplexity(pattern);
     
@@ -998,23 +951,15 @@ std::vector<AudioAnalyzer::SortCategory> AudioAnalyzer::generateSortStructure(
 // === Genre Detection from Audio Features ===
 std::string AudioAnalyzer::detectGenreFromAudio(const std::vector<float>& samples, int sampleRate, float bpm) {
     if (samples.empty()) return "Unknown";
+    return detectGenreFromAudio(FeatureFrames::compute(samples, sampleRate), bpm);
+}
+
+std::string AudioAnalyzer::detectGenreFromAudio(const FeatureFrames& frames, float bpm) {
+    if (frames.empty()) return "Unknown";
     
-    // Calculate spectral centroid
-    std::vector<std::complex<float>> complexSpectrum = performFFT(samples);
-    
-    // Convert to magnitude spectrum
-    std::vector<float> spectrum;
-    spectrum.reserve(complexSpectrum.size());
-    for (const auto& c : complexSpectrum) {
-        spectrum.push_back(std::abs(c));
-    }
-    
-    float spectralCentroid = calculateSpectralCentroid(spectrum, sampleRate);
-    
-    // Calculate energy
-    float energy = 0.0f;
-    for (float s : samples) energy += s * s;
-    energy = std::sqrt(energy / samples.size());
+    // Spectral centroid (Hz) and energy (RMS) over the whole track
+    float spectralCentroid = frames.meanCentroid;
+    float energy = frames.rms;
     
     // BPM-based primary classification
     if (bpm >= 165 && bpm <= 185) {
@@ -1224,78 +1169,77 @@ AudioAnalyzer::SongStructure AudioAnalyzer::analyzeSongStructure(
     const std::vector<float>& samples, 
     int sampleRate, 
     float bpm
+) {
+    return analyzeSongStructure(FeatureFrames::compute(samples, sampleRate), bpm);
+}
+
+AudioAnalyzer::SongStructure AudioAnalyzer::analyzeSongStructure(
+    const FeatureFrames& frames, 
+    float bpm
 ) {
     SongStructure structure;
-    structure.totalDuration = (float)samples.size() / sampleRate;
+    structure.totalDuration = frames.duration();
     structure.numVariations = 0;
     structure.complexityScore = 0.0f;
     
-    if (samples.empty() || sampleRate <= 0) {
+    if (frames.empty() || frames.sampleRate <= 0 || bpm <= 0) {
         return structure;
     }
     
     // 1. Segmentiere Song in ~4-Sekunden-Abschnitte basierend auf BPM
     float beatsPerSecond = bpm / 60.0f;
     float secondsPerBar = 4.0f / beatsPerSecond;  // 4/4 Takt
-    int samplesPerSegment = (int)(secondsPerBar * 4.0f * sampleRate);  // 4 Takte = typische Phrase
+    float secondsPerSegment = secondsPerBar * 4.0f;  // 4 Takte = typische Phrase
+    size_t framesPerSegment = std::max<size_t>(1, static_cast<size_t>(secondsPerSegment * frames.framesPerSecond()));
     
     std::cout << "🎵 [Structure] Analysiere " << structure.totalDuration << "s Song bei " 
-              << bpm << " BPM (Segment: " << (samplesPerSegment / sampleRate) << "s)\n";
+              << bpm << " BPM (Segment: " << (int)secondsPerSegment << "s)\n";
     
-    // 2. Berechne Features für jedes Segment
+    // 2. Aggregiere Frame-Features für jedes Segment
     struct SegmentFeatures {
         float startTime;
         float endTime;
         float energy;           // RMS
-        float spectralCentroid; // Helligkeit
+        float spectralCentroid; // Helligkeit (Hz)
         float spectralFlux;     // Veränderung
         float zeroCrossing;     // Noise-Level
         int numOnsets;          // Rhythmische Dichte
-        std::vector<float> spectrum;
+        std::vector<float> spectrum;  // Mittlere Mel-Bänder
     };
     
     std::vector<SegmentFeatures> segments;
+    std::vector<float> onsetTimes = detectOnsets(frames);
+    size_t nextOnset = 0;
     
-    for (size_t i = 0; i < samples.size(); i += samplesPerSegment) {
-        size_t end = std::min(i + samplesPerSegment, samples.size());
-        std::vector<float> segment(samples.begin() + i, samples.begin() + end);
+    for (size_t first = 0; first < frames.frameCount(); first += framesPerSegment) {
+        size_t last = std::min(first + framesPerSegment, frames.frameCount());
+        size_t count = last - first;
         
         SegmentFeatures feat;
-        feat.startTime = (float)i / sampleRate;
-        feat.endTime = (float)end / sampleRate;
-        
-        // Energy (RMS)
-        float sumSquares = 0.0f;
-        for (float s : segment) sumSquares += s * s;
-        feat.energy = std::sqrt(sumSquares / segment.size());
+        feat.startTime = frames.frameTime(first);
+        feat.endTime = std::min(frames.frameTime(last), structure.totalDuration);
+        feat.spectralFlux = 0.0f;
         
-        // Zero Crossing Rate
-        feat.zeroCrossing = calculateZeroCrossingRate(segment);
-        
-        // Spectral Features
-        auto fft = performFFT(segment);
-        feat.spectrum.resize(fft.size());
-        for (size_t j = 0; j < fft.size(); ++j) {
-            feat.spectrum[j] = std::abs(fft[j]);
+        float energySum = 0.0f, zcrSum = 0.0f, centroidSum = 0.0f;
+        feat.spectrum.assign(frames.numMelBands, 0.0f);
+        for (size_t f = first; f < last; ++f) {
+            energySum += frames.energy[f];
+            zcrSum += frames.zcr[f];
+            centroidSum += frames.centroid[f];
+            const float* mel = frames.mel(f);
+            for (size_t b = 0; b < frames.numMelBands; ++b) feat.spectrum[b] += mel[b];
         }
-        feat.spectralCentroid = calculateSpectralCentroid(fft);
+        for (float& band : feat.spectrum) band /= count;
+        
+        feat.energy = std::sqrt(energySum / count);
+        feat.zeroCrossing = zcrSum / count;
+        feat.spectralCentroid = centroidSum / count;
         
-        // Onset Detection (vereinfacht)
+        // Onsets in diesem Segment
         feat.numOnsets = 0;
-        float prevEnergy = 0.0f;
-        int windowSize = sampleRate / 20;  // 50ms windows
-        for (size_t j = 0; j < segment.size(); j += windowSize) {
-            size_t wEnd = std::min(j + windowSize, segment.size());
-            float windowEnergy = 0.0f;
-            for (size_t k = j; k < wEnd; ++k) {
-                windowEnergy += segment[k] * segment[k];
-            }
-            windowEnergy /= (wEnd - j);
-            
-            if (windowEnergy > prevEnergy * 1.5f && windowEnergy > 0.01f) {
-                feat.numOnsets++;
-            }
-            prevEnergy = windowEnergy;
+        while (nextOnset < onsetTimes.size() && onsetTimes[nextOnset] < feat.endTime) {
+            if (onsetTimes[nextOnset] >= feat.startTime) feat.numOnsets++;
+            nextOnset++;
         }
         
         segments.push_back(feat);
@@ -1326,7 +1270,7 @@ AudioAnalyzer::SongStructure AudioAnalyzer::analyzeSongStructure(
     for (const auto& seg : segments) avgFlux += seg.spectralFlux;
     avgFlux /= segments.size();
     
-    for (size_t i = 2; i < segments.size() - 2; ++i) {
+    for (size_t i = 2; i + 2 < segments.size(); ++i) {
         if (segments[i].spectralFlux > avgFlux * 1.8f) {
             // Verhindere zu nahe Boundaries (min. 2 Segmente = 8 Sekunden)
             if (boundaries.empty() || (i - boundaries.back()) >= 2) {
@@ -1,4 +1,5 @@
 #include "AudioSegmenter.h"
+#include "AudioStreamReader.h"
 #include <fstream>
 #include <cmath>
 #include <algorithm>
@@ -7,69 +8,59 @@
 std::vector<SongSegment> AudioSegmenter::analyzeStructure(const std::string& wavPath) {
     std::vector<SongSegment> segments;
     
-    // 1. Lade WAV
-    std::ifstream file(wavPath, std::ios::binary);
-    if (!file.is_open()) {
+    // 1. Audio streamen (Mono, chunkweise) - es wird nie der ganze Track gehalten
+    AudioStreamReader reader;
+    if (!reader.open(wavPath)) {
         std::cerr << "❌ Cannot open: " << wavPath << std::endl;
         return segments;
     }
     
-    // WAV-Header lesen
-    char header[44];
-    file.read(header, 44);
-    
-    int sampleRate = *reinterpret_cast<int*>(&header[24]);
-    short numChannels = *reinterpret_cast<short*>(&header[22]);
-    short bitsPerSample = *reinterpret_cast<short*>(&header[34]);
+    int sampleRate = reader.sampleRate();
+    
+    // 2. Energie-Analyse: mittlere Amplitude pro 100ms-Block (kompakte Hüllkurve)
+    const size_t blockSize = std::max(1, sampleRate / 10);
+    std::vector<float> blockAbsSum;     // Summe |x| pro Block
+    std::vector<size_t> blockCount;     // Samples pro Block (letzter ggf. kürzer)
+    size_t totalSamples = 0;
+    
+    std::vector<float> chunk(AudioStreamReader::kDefaultChunkFrames);
+    size_t got = 0;
+    while ((got = reader.read(chunk.data(), chunk.size())) > 0) {
+        for (size_t i = 0; i < got; ++i) {
+            size_t block = (totalSamples + i) / blockSize;
+            if (block >= blockAbsSum.size()) {
+                blockAbsSum.push_back(0.0f);
+                blockCount.push_back(0);
+            }
+            blockAbsSum[block] += std::abs(chunk[i]);
+            blockCount[block]++;
+        }
+        totalSamples += got;
+    }
     
-    if (bitsPerSample != 16) {
-        std::cerr << "⚠️ Only 16-bit WAV supported for segmentation\n";
+    if (totalSamples == 0) {
         return segments;
     }
     
-    // Audio-Daten lesen
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    file.seekg(44);
-    
-    size_t dataSize = fileSize - 44;
-    size_t numSamples = dataSize / 2; // 16-bit = 2 bytes
-    
-    std::vector<short> rawSamples(numSamples);
-    file.read(reinterpret_cast<char*>(rawSamples.data()), dataSize);
-    file.close();
-    
-    // Konvertiere zu float und Mono
-    std::vector<float> samples;
-    if (numChannels == 1) {
-        samples.resize(numSamples);
-        for (size_t i = 0; i < numSamples; ++i) {
-            samples[i] = rawSamples[i] / 32768.0f;
-        }
-    } else {
-        // Stereo -> Mono
-        size_t monoSamples = numSamples / 2;
-        samples.resize(monoSamples);
-        for (size_t i = 0; i < monoSamples; ++i) {
-            samples[i] = (rawSamples[i*2] + rawSamples[i*2+1]) / 65536.0f;
+    // Mittlere Amplitude im Sample-Bereich [startSample, endSample) aus der Block-Hüllkurve
+    auto meanAbs = [&](size_t startSample, size_t endSample) {
+        size_t first = startSample / blockSize;
+        size_t last = std::min((endSample + blockSize - 1) / blockSize, blockAbsSum.size());
+        float sum = 0.0f;
+        size_t count = 0;
+        for (size_t b = first; b < last; ++b) {
+            sum += blockAbsSum[b];
+            count += blockCount[b];
         }
-    }
-    
-    // 2. Energie-Analyse (EINFACHE VERSION - für Proof-of-Concept)
-    std::vector<float> energy = calculateEnergyEnvelope(samples, sampleRate);
+        return count > 0 ? sum / count : 0.0f;
+    };
     
-    float songDuration = samples.size() / static_cast<float>(sampleRate);
+    float songDuration = totalSamples / static_cast<float>(sampleRate);
     
     // 3. Heuristik-basierte Segmentierung
     // INTRO: Erste 10-20% mit niedrigerer Energie
-    float introThreshold = songDuration * 0.15f;
     if (songDuration > 10.0f) {
-        float introEnergy = 0.0f;
-        int introSamples = std::min(static_cast<int>(sampleRate * 10), static_cast<int>(samples.size()));
-        for (int i = 0; i < introSamples; ++i) {
-            introEnergy += std::abs(samples[i]);
-        }
-        introEnergy /= introSamples;
+        float introEnergy = meanAbs(0, std::min(static_cast<size_t>(sampleRate) * 10, totalSamples));
         
         segments.push_back({
             SongSegment::INTRO,
@@ -85,13 +76,6 @@ std::vector<SongSegment> AudioSegmenter::analyzeStructure(const std::string& wav
     float bodyStart = segments.empty() ? 0.0f : segments.back().startTime + segments.back().duration;
     float bodyEnd = songDuration * 0.85f;
     
-    // Finde hohe Energie-Peaks für Chorus
-    float avgEnergy = 0.0f;
-    for (size_t i = 0; i < energy.size(); ++i) {
-        avgEnergy += energy[i];
-    }
-    avgEnergy /= energy.size();
-    
     // Vereinfacht: alternierende Verse/Chorus-Struktur
     float sectionDuration = 15.0f; // 15 Sekunden pro Abschnitt
     bool isVerse = true;
@@ -100,14 +84,9 @@ std::vector<SongSegment> AudioSegmenter::analyzeStructure(const std::string& wav
         float dur = std::min(sectionDuration, bodyEnd - t);
         
         // Berechne Energie für diesen Abschnitt
-        int startSample = static_cast<int>(t * sampleRate);
-        int endSample = std::min(startSample + static_cast<int>(dur * sampleRate), static_cast<int>(samples.size()));
-        
-        float sectionEnergy = 0.0f;
-        for (int i = startSample; i < endSample; ++i) {
-            sectionEnergy += std::abs(samples[i]);
-        }
-        sectionEnergy /= (endSample - startSample);
+        size_t startSample = static_cast<size_t>(t * sampleRate);
+        size_t endSample = std::min(startSample + static_cast<size_t>(dur * sampleRate), totalSamples);
+        float sectionEnergy = meanAbs(startSample, endSample);
         
         segments.push_back({
             isVerse ? SongSegment::VERSE : SongSegment::CHORUS,
@@ -0,0 +1,333 @@
+#include "AudioStreamReader.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef WITH_SNDFILE
+#include <sndfile.h>
+#endif
+
+#ifdef WITH_SAMPLERATE
+#include <samplerate.h>
+#endif
+
+namespace {
+
+uint16_t readLE16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readLE32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Ein PCM-/Float-Sample aus dem WAV-Datenblock nach [-1, 1]
+float decodeWavSample(const unsigned char* p, int bits, bool isFloat) {
+    if (isFloat) {
+        float value;
+        std::memcpy(&value, p, sizeof(float));
+        return value;
+    }
+    switch (bits) {
+        case 8:
+            return (static_cast<int>(p[0]) - 128) / 128.0f;
+        case 16:
+            return static_cast<int16_t>(readLE16(p)) / 32768.0f;
+        case 24: {
+            int32_t v = (p[0] << 8) | (p[1] << 16) | (p[2] << 24);
+            return (v >> 8) / 8388608.0f;
+        }
+        case 32:
+            return static_cast<int32_t>(readLE32(p)) / 2147483648.0f;
+        default:
+            return 0.0f;
+    }
+}
+
+} // namespace
+
+AudioStreamReader::~AudioStreamReader() {
+    close();
+}
+
+bool AudioStreamReader::open(const std::string& filepath, int targetSampleRate) {
+    close();
+
+#ifdef WITH_SNDFILE
+    SF_INFO sfinfo;
+    std::memset(&sfinfo, 0, sizeof(sfinfo));
+    SNDFILE* file = sf_open(filepath.c_str(), SFM_READ, &sfinfo);
+    if (file) {
+        if (sfinfo.channels <= 0 || sfinfo.samplerate <= 0) {
+            sf_close(file);
+            return false;
+        }
+        sndfile_ = file;
+        channels_ = sfinfo.channels;
+        sourceRate_ = sfinfo.samplerate;
+        sourceFrames_ = sfinfo.frames;
+    }
+#endif
+
+    if (!sndfile_ && !openWav(filepath)) {
+        return false;  // Nicht unterstütztes Format
+    }
+
+    targetRate_ = targetSampleRate > 0 ? targetSampleRate : sourceRate_;
+    resample_ = targetRate_ != sourceRate_;
+
+#ifdef WITH_SAMPLERATE
+    if (resample_) {
+        int error = 0;
+        srcState_ = src_new(SRC_SINC_FASTEST, 1, &error);
+        if (!srcState_) {
+            close();
+            return false;
+        }
+    }
+#endif
+
+    isOpen_ = true;
+    return true;
+}
+
+bool AudioStreamReader::openWav(const std::string& filepath) {
+    wav_.open(filepath, std::ios::binary);
+    if (!wav_.is_open()) return false;
+
+    unsigned char riff[12];
+    wav_.read(reinterpret_cast<char*>(riff), sizeof(riff));
+    if (wav_.gcount() != sizeof(riff) ||
+        std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        wav_.close();
+        return false;
+    }
+
+    // Chunks durchlaufen bis "data" (fmt muss vorher kommen)
+    bool haveFormat = false;
+    int blockAlign = 0;
+    unsigned char chunkHeader[8];
+    while (wav_.read(reinterpret_cast<char*>(chunkHeader), sizeof(chunkHeader))) {
+        uint32_t chunkSize = readLE32(chunkHeader + 4);
+
+        // Rest eines Chunks inkl. Pad-Byte (64 Bit, chunkSize kommt ungeprüft aus der Datei)
+        const std::streamoff skip = static_cast<std::streamoff>(chunkSize) + (chunkSize & 1);
+
+        if (std::memcmp(chunkHeader, "fmt ", 4) == 0) {
+            // Nur die bekannten Felder lesen (WAVEFORMATEXTENSIBLE: 40 Bytes), Rest überspringen
+            unsigned char fmt[40] = {};
+            const uint32_t fmtBytes = std::min<uint32_t>(chunkSize, sizeof(fmt));
+            if (chunkSize < 16 || !wav_.read(reinterpret_cast<char*>(fmt), fmtBytes)) break;
+
+            uint16_t formatTag = readLE16(&fmt[0]);
+            channels_ = readLE16(&fmt[2]);
+            sourceRate_ = static_cast<int>(readLE32(&fmt[4]));
+            blockAlign = readLE16(&fmt[12]);
+            wavBitsPerSample_ = readLE16(&fmt[14]);
+
+            // WAVE_FORMAT_EXTENSIBLE: eigentliches Format steht im SubFormat-GUID
+            if (formatTag == 0xFFFE && chunkSize >= 26) {
+                formatTag = readLE16(&fmt[24]);
+            }
+            wavFloat_ = (formatTag == 3);
+            haveFormat = (formatTag == 1 || formatTag == 3);
+            wav_.seekg(skip - fmtBytes, std::ios::cur);
+        } else if (std::memcmp(chunkHeader, "data", 4) == 0) {
+            wavBytesLeft_ = chunkSize;
+            break;
+        } else {
+            wav_.seekg(skip, std::ios::cur);
+        }
+    }
+
+    // Validate critical values
+    bool supportedBits = wavFloat_ ? wavBitsPerSample_ == 32
+                                   : (wavBitsPerSample_ == 8 || wavBitsPerSample_ == 16 ||
+                                      wavBitsPerSample_ == 24 || wavBitsPerSample_ == 32);
+    if (!haveFormat || wavBytesLeft_ == 0 || !supportedBits ||
+        channels_ <= 0 || channels_ > 16 || sourceRate_ <= 0 || sourceRate_ > 192000 ||
+        blockAlign != channels_ * (wavBitsPerSample_ / 8)) {
+        wav_.close();
+        wavBytesLeft_ = 0;
+        return false;
+    }
+
+    sourceFrames_ = static_cast<int64_t>(wavBytesLeft_ / blockAlign);
+    return true;
+}
+
+void AudioStreamReader::close() {
+#ifdef WITH_SNDFILE
+    if (sndfile_) sf_close(static_cast<SNDFILE*>(sndfile_));
+#endif
+    sndfile_ = nullptr;
+
+#ifdef WITH_SAMPLERATE
+    if (srcState_) src_delete(static_cast<SRC_STATE*>(srcState_));
+#endif
+    srcState_ = nullptr;
+
+    if (wav_.is_open()) wav_.close();
+    wav_.clear();
+    wavBytesLeft_ = 0;
+    wavBitsPerSample_ = 0;
+    wavFloat_ = false;
+
+    isOpen_ = false;
+    sourceRate_ = targetRate_ = channels_ = 0;
+    sourceFrames_ = -1;
+    resample_ = false;
+    sourceEof_ = false;
+    resampleIn_.clear();
+    resampleInPos_ = 0;
+    resamplePhase_ = 0.0;
+}
+
+int64_t AudioStreamReader::estimatedFrames() const {
+    if (sourceFrames_ < 0 || sourceRate_ <= 0) return -1;
+    if (!resample_) return sourceFrames_;
+    return static_cast<int64_t>(static_cast<double>(sourceFrames_) * targetRate_ / sourceRate_);
+}
+
+size_t AudioStreamReader::readSource(float* out, size_t maxFrames) {
+#ifdef WITH_SNDFILE
+    if (sndfile_) {
+        interleaved_.resize(maxFrames * channels_);
+        sf_count_t got = sf_readf_float(static_cast<SNDFILE*>(sndfile_), interleaved_.data(), maxFrames);
+        if (got <= 0) return 0;
+
+        if (channels_ == 1) {
+            std::copy(interleaved_.begin(), interleaved_.begin() + got, out);
+        } else {
+            // Mix down to mono (average channels)
+            for (sf_count_t i = 0; i < got; ++i) {
+                float sum = 0.0f;
+                for (int ch = 0; ch < channels_; ++ch) {
+                    sum += interleaved_[i * channels_ + ch];
+                }
+                out[i] = sum / channels_;
+            }
+        }
+        return static_cast<size_t>(got);
+    }
+#endif
+    return readWavSource(out, maxFrames);
+}
+
+size_t AudioStreamReader::readWavSource(float* out, size_t maxFrames) {
+    if (!wav_.is_open() || wavBytesLeft_ == 0) return 0;
+
+    const size_t bytesPerSample = wavBitsPerSample_ / 8;
+    const size_t blockAlign = bytesPerSample * channels_;
+    size_t frames = std::min<uint64_t>(maxFrames, wavBytesLeft_ / blockAlign);
+    if (frames == 0) return 0;
+
+    raw_.resize(frames * blockAlign);
+    wav_.read(raw_.data(), raw_.size());
+    frames = static_cast<size_t>(wav_.gcount()) / blockAlign;  // Abgeschnittene Dateien
+    wavBytesLeft_ = frames > 0 ? wavBytesLeft_ - frames * blockAlign : 0;
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(raw_.data());
+    for (size_t i = 0; i < frames; ++i) {
+        float sum = 0.0f;
+        for (int ch = 0; ch < channels_; ++ch) {
+            sum += decodeWavSample(p, wavBitsPerSample_, wavFloat_);
+            p += bytesPerSample;
+        }
+        out[i] = sum / channels_;
+    }
+    return frames;
+}
+
+bool AudioStreamReader::fillResampleInput() {
+    if (sourceEof_) return false;
+
+    // Verbrauchte Samples verwerfen, Rest nach vorne. Beim Downsampling um mehr
+    // als Faktor 2 kann resampleInPos_ hinter dem Puffer stehen: der Überhang
+    // bleibt stehen und wird von den neu gelesenen Samples abgezogen.
+    const size_t consumed = std::min(resampleInPos_, resampleIn_.size());
+    resampleIn_.erase(resampleIn_.begin(), resampleIn_.begin() + consumed);
+    resampleInPos_ -= consumed;
+
+    size_t oldSize = resampleIn_.size();
+    resampleIn_.resize(oldSize + kDefaultChunkFrames);
+    size_t got = readSource(resampleIn_.data() + oldSize, kDefaultChunkFrames);
+    resampleIn_.resize(oldSize + got);
+
+    if (got == 0) sourceEof_ = true;
+    return got > 0;
+}
+
+size_t AudioStreamReader::readResampled(float* out, size_t maxFrames) {
+    size_t produced = 0;
+
+#ifdef WITH_SAMPLERATE
+    SRC_STATE* state = static_cast<SRC_STATE*>(srcState_);
+    while (produced < maxFrames) {
+        if (resampleInPos_ >= resampleIn_.size()) fillResampleInput();
+
+        SRC_DATA data;
+        std::memset(&data, 0, sizeof(data));
+        data.data_in = resampleIn_.data() + resampleInPos_;
+        data.input_frames = static_cast<long>(resampleIn_.size() - resampleInPos_);
+        data.data_out = out + produced;
+        data.output_frames = static_cast<long>(maxFrames - produced);
+        data.src_ratio = static_cast<double>(targetRate_) / sourceRate_;
+        data.end_of_input = sourceEof_ ? 1 : 0;
+
+        if (src_process(state, &data) != 0) break;
+        resampleInPos_ += data.input_frames_used;
+        produced += data.output_frames_gen;
+
+        if (data.input_frames_used == 0 && data.output_frames_gen == 0) {
+            if (data.end_of_input) break;  // Vollständig geflusht
+            fillResampleInput();           // Neue Eingabe oder sourceEof_ (nächster Durchlauf flusht)
+        }
+    }
+#else
+    // Lineare Interpolation zwischen Nachbar-Samples
+    const double step = static_cast<double>(sourceRate_) / targetRate_;
+    while (produced < maxFrames) {
+        if (resampleInPos_ + 1 >= resampleIn_.size()) {
+            if (!fillResampleInput()) break;
+            continue;
+        }
+        float a = resampleIn_[resampleInPos_];
+        float b = resampleIn_[resampleInPos_ + 1];
+        out[produced++] = a + (b - a) * static_cast<float>(resamplePhase_);
+
+        resamplePhase_ += step;
+        size_t advance = static_cast<size_t>(resamplePhase_);
+        resampleInPos_ += advance;
+        resamplePhase_ -= advance;
+    }
+#endif
+
+    return produced;
+}
+
+size_t AudioStreamReader::read(float* out, size_t maxFrames) {
+    if (!isOpen_ || !out || maxFrames == 0) return 0;
+    return resample_ ? readResampled(out, maxFrames) : readSource(out, maxFrames);
+}
+
+bool AudioStreamReader::readAll(const std::string& filepath, std::vector<float>& samples,
+                                int& sampleRate, int targetSampleRate) {
+    AudioStreamReader reader;
+    if (!reader.open(filepath, targetSampleRate)) return false;
+
+    sampleRate = reader.sampleRate();
+    samples.clear();
+    int64_t expected = reader.estimatedFrames();
+    if (expected > 0) samples.reserve(static_cast<size_t>(expected) + kDefaultChunkFrames);
+
+    size_t got = 0;
+    do {
+        size_t oldSize = samples.size();
+        samples.resize(oldSize + kDefaultChunkFrames);
+        got = reader.read(samples.data() + oldSize, kDefaultChunkFrames);
+        samples.resize(oldSize + got);
+    } while (got > 0);
+
+    return !samples.empty();
+}
@@ -14,8 +14,8 @@ DataQualityMetrics DataQualityAnalyzer::analyze() {
     
     std::cout << "🔍 Analyzing data quality...\n";
     
-    auto allMedia = db_.getAll();
-    int totalTracks = allMedia.size();
+    // Nur Aggregate aus SQLite holen, keine vollständige Tabelle
+    int totalTracks = static_cast<int>(db_.countWhere());
     
     if (totalTracks == 0) {
         metrics.overallQuality = 0.0f;
@@ -26,10 +26,8 @@ DataQualityMetrics DataQualityAnalyzer::analyze() {
     
     // Analysiere Genre-Verteilung
     std::map<std::string, int> genreCount;
-    for (const auto& track : allMedia) {
-        if (!track.genre.empty()) {
-            genreCount[track.genre]++;
-        }
+    for (const auto& [genre, count] : db_.countGroupedBy("genre", "genre != ''")) {
+        genreCount[genre] = static_cast<int>(count);
     }
     
     metrics.genreDistribution = genreCount;
@@ -65,33 +63,19 @@ DataQualityMetrics DataQualityAnalyzer::analyze() {
     metrics.tempoRangeCoverage = std::max(0.0f, tempoBalance);
     
     // Feature-Vollständigkeit
-    int tracksWithMFCC = 0;
-    int tracksWithSpectral = 0;
-    int tracksWithChords = 0;
-    int tracksWithStructure = 0;
-    
-    for (const auto& track : allMedia) {
-        // Prüfe ob Features existieren (simplified - real check würde in DB schauen)
-        if (track.bpm > 0) tracksWithMFCC++;
-        if (track.spectralCentroid > 0) tracksWithSpectral++;
-        if (!track.genreTags.empty()) tracksWithChords++;
-        if (track.duration > 0) tracksWithStructure++;
-    }
+    int tracksWithMFCC = static_cast<int>(db_.countWhere("bpm > 0"));
+    int tracksWithSpectral = static_cast<int>(db_.countWhere("spectralCentroid > 0"));
+    int tracksWithChords = static_cast<int>(db_.countWhere("genreTags != ''"));
+    int tracksWithStructure = static_cast<int>(db_.countWhere("duration > 0"));
     
     metrics.tracksWithMFCC = static_cast<float>(tracksWithMFCC) / totalTracks;
     metrics.tracksWithSpectral = static_cast<float>(tracksWithSpectral) / totalTracks;
     metrics.tracksWithChords = static_cast<float>(tracksWithChords) / totalTracks;
     metrics.tracksWithStructure = static_cast<float>(tracksWithStructure) / totalTracks;
     
-    // Instrument Diversity (simplified)
-    std::set<std::string> instruments;
-    for (const auto& track : allMedia) {
-        if (!track.genreTags.empty()) {
-            // Parse instruments from tags
-            instruments.insert(track.genreTags);
-        }
-    }
-    metrics.instrumentDiversity = std::min(1.0f, static_cast<float>(instruments.size()) / 20.0f);
+    // Instrument Diversity (simplified): verschiedene Tag-Kombinationen
+    size_t distinctTags = db_.countGroupedBy("genreTags", "genreTags != ''").size();
+    metrics.instrumentDiversity = std::min(1.0f, static_cast<float>(distinctTags) / 20.0f);
     
     // Overall Score berechnen
     metrics.overallQuality = calculateOverallScore(metrics);
@@ -108,7 +92,6 @@ DataQualityMetrics DataQualityAnalyzer::analyze() {
 std::vector<GenreCompleteness> DataQualityAnalyzer::analyzeGenreCoverage() {
     std::vector<GenreCompleteness> results;
     
-    auto allMedia = db_.getAll();
     std::map<std::string, GenreCompleteness> genreMap;
     
     // Empfohlene Mindestanzahl pro Genre
@@ -118,9 +101,11 @@ std::vector<GenreCompleteness> DataQualityAnalyzer::analyzeGenreCoverage() {
         {"Jazz", 100}, {"Classical", 100}, {"Ambient", 80}, {"Trance", 100}
     };
     
-    for (const auto& track : allMedia) {
-        if (track.genre.empty()) continue;
-        
+    // Nur Genre- und Feature-Spalten streamen
+    MediaDatabase::MediaQuery query;
+    query.columns = MediaDatabase::ColTags | MediaDatabase::ColAnalysis;
+    query.where = "genre != ''";
+    db_.iterate(query, [&](const MediaMetadata& track) {
         auto& gc = genreMap[track.genre];
         gc.genre = track.genre;
         gc.trackCount++;
@@ -132,7 +117,8 @@ std::vector<GenreCompleteness> DataQualityAnalyzer::analyzeGenreCoverage() {
             gc.tracksWithGoodFeatures++;
             gc.avgMFCCQuality += 1.0f;
         }
-    }
+        return true;
+    });
     
     // Berechne Completeness
     for (auto& [genre, gc] : genreMap) {
@@ -324,19 +310,9 @@ std::vector<std::pair<std::string, float>> DataQualityAnalyzer::getPriorityActio
 }
 
 void DataQualityAnalyzer::analyzeTempoDistribution(DataQualityMetrics& metrics) {
-    auto allMedia = db_.getAll();
-    
-    for (const auto& track : allMedia) {
-        if (track.bpm <= 0) continue;
-        
-        if (track.bpm < 90) {
-            metrics.tracksSlow++;
-        } else if (track.bpm <= 130) {
-            metrics.tracksMedium++;
-        } else {
-            metrics.tracksFast++;
-        }
-    }
+    metrics.tracksSlow = static_cast<int>(db_.countWhere("bpm > 0 AND bpm < 90"));
+    metrics.tracksMedium = static_cast<int>(db_.countWhere("bpm >= 90 AND bpm <= 130"));
+    metrics.tracksFast = static_cast<int>(db_.countWhere("bpm > 130"));
 }
 
 } // namespace SongGen
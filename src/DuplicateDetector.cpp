@@ -0,0 +1,201 @@
+#include "DuplicateDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// LSH-Parameter: L Tabellen mit je K p-stabilen Hashes
+constexpr size_t kLshTables = 8;
+constexpr size_t kHashesPerTable = 2;
+constexpr uint32_t kLshSeed = 0x5106u;
+
+float vectorNorm(const std::vector<float>& v) {
+    double sum = 0.0;
+    for (float x : v) sum += static_cast<double>(x) * x;
+    return static_cast<float>(std::sqrt(sum));
+}
+
+// Relative Ähnlichkeit wie im bisherigen SQL-Vergleich (0/0 zählt nicht als ähnlich)
+float relativeSimilarity(float diff, float scale) {
+    if (!(scale > 0.0f)) return 0.0f;
+    return 1.0f - diff / scale;
+}
+
+inline uint64_t pairKey(size_t a, size_t b) {
+    return (static_cast<uint64_t>(a) << 32) | static_cast<uint64_t>(b);
+}
+
+inline uint64_t mixHash(uint64_t h, uint64_t v) {
+    h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+// Indizes nach Dauer sortieren und alle Paare im Fenster an visit() geben
+template <typename Visit>
+void sweepByDuration(std::vector<size_t>& members, const std::vector<DuplicateDetector::Track>& tracks,
+                     float window, Visit visit) {
+    std::sort(members.begin(), members.end(), [&](size_t a, size_t b) {
+        return tracks[a].duration < tracks[b].duration;
+    });
+    for (size_t i = 0; i < members.size(); ++i) {
+        for (size_t j = i + 1; j < members.size(); ++j) {
+            if (tracks[members[j]].duration - tracks[members[i]].duration >= window) break;
+            visit(members[i], members[j]);
+        }
+    }
+}
+
+} // namespace
+
+bool DuplicateDetector::withinAudioWindow(const Track& a, const Track& b) {
+    return std::abs(a.duration - b.duration) < kMaxDurationDiff &&
+           std::abs(a.bpm - b.bpm) < kMaxBpmDiff;
+}
+
+float DuplicateDetector::audioSimilarity(const Track& a, const Track& b) {
+    float mfccSim;
+    if (!a.mfccMean.empty() && a.mfccMean.size() == b.mfccMean.size()) {
+        // MFCC-Vektoren: relative euklidische Distanz
+        double diff = 0.0;
+        for (size_t i = 0; i < a.mfccMean.size(); ++i) {
+            double d = a.mfccMean[i] - b.mfccMean[i];
+            diff += d * d;
+        }
+        mfccSim = relativeSimilarity(static_cast<float>(std::sqrt(diff)),
+                                     std::max(vectorNorm(a.mfccMean), vectorNorm(b.mfccMean)));
+    } else {
+        // Ältere Einträge: nur skalare Signatur
+        mfccSim = relativeSimilarity(std::abs(a.mfccHash - b.mfccHash),
+                                     std::max(std::abs(a.mfccHash), std::abs(b.mfccHash)));
+    }
+    float scSim = relativeSimilarity(std::abs(a.spectralCentroid - b.spectralCentroid),
+                                     std::max(a.spectralCentroid, b.spectralCentroid));
+    return mfccSim * 0.7f + scSim * 0.3f;
+}
+
+std::vector<DuplicateDetector::Match> DuplicateDetector::findIdentical() const {
+    std::vector<Match> matches;
+
+    std::unordered_map<std::string, std::vector<size_t>> groups;
+    for (size_t i = 0; i < tracks_.size(); ++i) {
+        if (!tracks_[i].hasTitleArtist) continue;
+        groups[tracks_[i].title + '\x1f' + tracks_[i].artist].push_back(i);
+    }
+
+    for (auto& entry : groups) {
+        if (entry.second.size() < 2) continue;
+        sweepByDuration(entry.second, tracks_, kIdenticalDurationDiff, [&](size_t a, size_t b) {
+            matches.push_back({std::min(a, b), std::max(a, b), 1.0f, "identical_metadata"});
+        });
+    }
+
+    std::sort(matches.begin(), matches.end(), [&](const Match& x, const Match& y) {
+        if (tracks_[x.first].id != tracks_[y.first].id) return tracks_[x.first].id < tracks_[y.first].id;
+        return tracks_[x.second].id < tracks_[y.second].id;
+    });
+    return matches;
+}
+
+std::vector<DuplicateDetector::Match> DuplicateDetector::findAudioDuplicates(float threshold) const {
+    std::vector<Match> matches;
+    std::unordered_set<uint64_t> compared;
+
+    auto consider = [&](size_t a, size_t b) {
+        if (a == b) return;
+        if (a > b) std::swap(a, b);
+        if (!withinAudioWindow(tracks_[a], tracks_[b])) return;
+        if (!compared.insert(pairKey(a, b)).second) return;
+        float similarity = audioSimilarity(tracks_[a], tracks_[b]);
+        if (similarity >= threshold) {
+            matches.push_back({a, b, similarity, "similar_audio"});
+        }
+    };
+
+    // Obergrenze der relativen MFCC-Distanz, die den Threshold noch erreichen kann
+    // (Centroid-Anteil maximal 0.3): mfccSim >= (threshold - 0.3) / 0.7
+    const float maxRelativeDistance = 1.0f - (threshold - 0.3f) / 0.7f;
+    const bool useLsh = maxRelativeDistance < 1.0f;
+
+    std::vector<size_t> vectorTracks, gridQueries;
+    const size_t dims = tracks_.empty() ? 0 : 13;
+    for (size_t i = 0; i < tracks_.size(); ++i) {
+        if (useLsh && tracks_[i].mfccMean.size() == dims && dims > 0) {
+            vectorTracks.push_back(i);
+        } else {
+            gridQueries.push_back(i);
+        }
+    }
+
+    // 1) LSH über MFCC-Vektoren: nur Tracks in gemeinsamen Buckets vergleichen
+    if (vectorTracks.size() > 1) {
+        std::vector<float> norms;
+        norms.reserve(vectorTracks.size());
+        for (size_t i : vectorTracks) norms.push_back(vectorNorm(tracks_[i].mfccMean));
+        std::nth_element(norms.begin(), norms.begin() + norms.size() / 2, norms.end());
+        const float bucketWidth = std::max(4.0f * std::max(maxRelativeDistance, 0.01f) * norms[norms.size() / 2], 1e-3f);
+
+        std::mt19937 gen(kLshSeed);
+        std::normal_distribution<float> gauss(0.0f, 1.0f);
+        std::uniform_real_distribution<float> offset(0.0f, bucketWidth);
+        const size_t hashCount = kLshTables * kHashesPerTable;
+        std::vector<float> projections(hashCount * dims);
+        std::vector<float> offsets(hashCount);
+        for (float& p : projections) p = gauss(gen);
+        for (float& o : offsets) o = offset(gen);
+
+        for (size_t table = 0; table < kLshTables; ++table) {
+            std::unordered_map<uint64_t, std::vector<size_t>> buckets;
+            for (size_t i : vectorTracks) {
+                const std::vector<float>& v = tracks_[i].mfccMean;
+                uint64_t key = table;
+                for (size_t h = 0; h < kHashesPerTable; ++h) {
+                    size_t hashIndex = table * kHashesPerTable + h;
+                    const float* a = projections.data() + hashIndex * dims;
+                    float dot = 0.0f;
+                    for (size_t d = 0; d < dims; ++d) dot += a[d] * v[d];
+                    int64_t slot = static_cast<int64_t>(std::floor((dot + offsets[hashIndex]) / bucketWidth));
+                    key = mixHash(key, static_cast<uint64_t>(slot));
+                }
+                buckets[key].push_back(i);
+            }
+            for (auto& entry : buckets) {
+                if (entry.second.size() < 2) continue;
+                sweepByDuration(entry.second, tracks_, kMaxDurationDiff, consider);
+            }
+        }
+    }
+
+    // 2) Tracks ohne MFCC-Vektoren: BPM-Raster (Breite = max. Differenz) + Dauer-Fenster
+    if (!gridQueries.empty()) {
+        std::unordered_map<int64_t, std::vector<size_t>> bpmBins;
+        auto binOf = [](float bpm) { return static_cast<int64_t>(std::floor(bpm / kMaxBpmDiff)); };
+        for (size_t i = 0; i < tracks_.size(); ++i) bpmBins[binOf(tracks_[i].bpm)].push_back(i);
+        auto byDuration = [&](size_t a, size_t b) { return tracks_[a].duration < tracks_[b].duration; };
+        for (auto& entry : bpmBins) std::sort(entry.second.begin(), entry.second.end(), byDuration);
+
+        for (size_t i : gridQueries) {
+            const Track& query = tracks_[i];
+            int64_t bin = binOf(query.bpm);
+            for (int64_t b = bin - 1; b <= bin + 1; ++b) {
+                auto it = bpmBins.find(b);
+                if (it == bpmBins.end()) continue;
+                const std::vector<size_t>& members = it->second;
+                auto first = std::lower_bound(members.begin(), members.end(), query.duration - kMaxDurationDiff,
+                    [&](size_t idx, float value) { return tracks_[idx].duration <= value; });
+                for (auto m = first; m != members.end(); ++m) {
+                    if (tracks_[*m].duration >= query.duration + kMaxDurationDiff) break;
+                    consider(i, *m);
+                }
+            }
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [&](const Match& x, const Match& y) {
+        if (tracks_[x.first].id != tracks_[y.first].id) return tracks_[x.first].id < tracks_[y.first].id;
+        return tracks_[x.second].id < tracks_[y.second].id;
+    });
+    return matches;
+}
@@ -0,0 +1,226 @@
+#include "FeatureFrames.h"
+#include "SpectralWorkspace.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Hann-Fenster pro Thread cachen (Größe ändert sich praktisch nie)
+const std::vector<float>& hannWindow(size_t n) {
+    thread_local std::vector<float> window;
+    if (window.size() != n) {
+        const float pi = 3.14159265358979323846f;
+        window.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            window[i] = 0.5f - 0.5f * std::cos(2.0f * pi * i / (n - 1));
+        }
+    }
+    return window;
+}
+
+inline bool isZeroCrossing(float prev, float cur) {
+    return (cur >= 0 && prev < 0) || (cur < 0 && prev >= 0);
+}
+
+} // namespace
+
+size_t FeatureFrames::frameAt(float seconds) const {
+    if (empty() || hopSize == 0 || seconds <= 0.0f) return 0;
+    size_t frame = static_cast<size_t>(seconds * sampleRate / hopSize);
+    return std::min(frame, frameCount() - 1);
+}
+
+FeatureFrames FeatureFrames::compute(const std::vector<float>& samples, int sampleRate,
+                                     size_t frameSize, size_t hopSize) {
+    FeatureFrameBuilder builder(sampleRate, frameSize, hopSize);
+    builder.push(samples.data(), samples.size());
+    return builder.finish();
+}
+
+FeatureFrameBuilder::FeatureFrameBuilder(int sampleRate, size_t frameSize, size_t hopSize) {
+    frames_.sampleRate = sampleRate;
+    frames_.frameSize = frameSize;
+    frames_.hopSize = hopSize;
+
+    if (sampleRate <= 0 || frameSize < 2 || hopSize == 0) return;
+
+    frames_.fftSize = SpectralWorkspace::effectiveSize(frameSize);
+    if (frames_.fftSize < 2) return;
+    valid_ = true;
+
+    const size_t bins = frames_.fftSize / 2 + 1;
+    frame_.resize(frames_.fftSize);
+    magnitudes_.resize(bins);
+    power_.resize(bins);
+    magnitudeSum_.assign(bins, 0.0);
+    assembled_.resize(frameSize);
+
+    // Filterbank und DCT-Matrix einmal pro Track vorberechnen
+    melFilters_ = MelFilterbank(sampleRate, frames_.fftSize, frames_.numMelBands);
+    mfccKernel_ = MFCCKernel(frames_.numMelBands, frames_.numMfcc);
+    mfcc_.resize(frames_.numMfcc);
+    mfccSum_.assign(frames_.numMfcc, 0.0);
+    mfccSumSquares_.assign(frames_.numMfcc, 0.0);
+}
+
+void FeatureFrameBuilder::push(const float* samples, size_t count) {
+    if (!samples || count == 0) return;
+
+    // Track-weite RMS und Nulldurchgänge (über Chunk-Grenzen hinweg)
+    for (size_t i = 0; i < count; ++i) {
+        sumSquares_ += static_cast<double>(samples[i]) * samples[i];
+        if (frames_.sampleCount + i > 0 && isZeroCrossing(prevSample_, samples[i])) {
+            crossings_++;
+        }
+        prevSample_ = samples[i];
+    }
+    frames_.sampleCount += count;
+
+    if (!valid_) return;
+
+    const size_t frameSize = frames_.frameSize;
+    const size_t hopSize = frames_.hopSize;
+    const size_t inStart = frames_.sampleCount - count;   // Absolute Position des Chunks
+    const size_t inEnd = frames_.sampleCount;
+
+    // Alle Frames verarbeiten, die jetzt vollständig sind. Frames, die komplett im
+    // Chunk liegen, werden direkt gelesen; nur Frames über die Chunk-Grenze werden
+    // aus dem Rest-Puffer zusammengesetzt.
+    while (nextFrameStart_ + frameSize <= inEnd) {
+        if (nextFrameStart_ >= inStart) {
+            processFrame(samples + (nextFrameStart_ - inStart), frameSize);
+        } else {
+            size_t fromPending = inStart - nextFrameStart_;
+            const float* pendingSrc = pending_.data() + (pending_.size() - fromPending);
+            std::copy(pendingSrc, pendingSrc + fromPending, assembled_.begin());
+            std::copy(samples, samples + (frameSize - fromPending), assembled_.begin() + fromPending);
+            processFrame(assembled_.data(), frameSize);
+        }
+        nextFrameStart_ += hopSize;
+    }
+
+    // Nur die Samples ab dem nächsten Frame-Start behalten (< frameSize)
+    if (nextFrameStart_ < inStart) {
+        size_t fromPending = inStart - nextFrameStart_;
+        pending_.erase(pending_.begin(), pending_.end() - fromPending);
+    } else {
+        pending_.clear();
+    }
+    size_t inputFrom = nextFrameStart_ > inStart ? nextFrameStart_ - inStart : 0;
+    if (inputFrom < count) {
+        pending_.insert(pending_.end(), samples + inputFrom, samples + count);
+    }
+}
+
+void FeatureFrameBuilder::processFrame(const float* src, size_t len) {
+    FeatureFrames& f = frames_;
+    const size_t frameSize = f.frameSize;
+    const size_t bins = f.fftSize / 2 + 1;
+    const size_t fr = f.energy.size();
+
+    // Energie + ZCR (ungefenstert, wie bisher in detectBPM)
+    float frameEnergy = 0.0f;
+    size_t frameCrossings = 0;
+    for (size_t j = 0; j < len; ++j) {
+        frameEnergy += src[j] * src[j];
+        if (j > 0 && isZeroCrossing(src[j-1], src[j])) {
+            frameCrossings++;
+        }
+    }
+    frameEnergy /= frameSize;
+    f.energy.push_back(frameEnergy);
+    f.zcr.push_back(static_cast<float>(frameCrossings) / frameSize);
+    f.onset.push_back(fr == 0 ? 0.0f : std::max(0.0f, frameEnergy - f.energy[fr - 1]));
+
+    // Gefensterter Frame (Zero-Padding am Track-Ende)
+    const std::vector<float>& window = hannWindow(f.fftSize);
+    size_t copyLen = std::min(len, f.fftSize);
+    for (size_t j = 0; j < copyLen; ++j) frame_[j] = src[j] * window[j];
+    std::fill(frame_.begin() + copyLen, frame_.end(), 0.0f);
+
+    SpectrumView spectrum = SpectralWorkspace::forThisThread().forward(frame_.data(), f.fftSize);
+
+    // |X|² und |X| in einem vektorisierten Durchlauf
+    simd::complexPower(spectrum.bins, power_.data(), magnitudes_.data(), bins);
+
+    const float binWidth = static_cast<float>(f.sampleRate) / f.fftSize;
+    float total = 0.0f, weighted = 0.0f;
+    for (size_t k = 0; k < bins; ++k) {
+        float mag = magnitudes_[k];
+        magnitudeSum_[k] += mag;
+        total += mag;
+        weighted += k * binWidth * mag;
+    }
+
+    float frameCentroid = 0.0f, frameRolloff = 0.0f;
+    if (total > 0.0f) {
+        frameCentroid = weighted / total;
+        float target = total * 0.85f;
+        float cumulative = 0.0f;
+        size_t k = 0;
+        for (; k < bins; ++k) {
+            cumulative += magnitudes_[k];
+            if (cumulative >= target) break;
+        }
+        frameRolloff = std::min(k, bins - 1) * binWidth;
+    }
+    f.centroid.push_back(frameCentroid);
+    f.rolloff.push_back(frameRolloff);
+
+    // Leistungsspektrum -> Mel-Filter -> log -> DCT
+    size_t melOffset = f.melBands.size();
+    f.melBands.resize(melOffset + f.numMelBands);
+    melFilters_.apply(power_.data(), f.melBands.data() + melOffset);
+    mfccKernel_.compute(f.melBands.data() + melOffset, mfcc_.data());
+    for (size_t c = 0; c < f.numMfcc; ++c) {
+        mfccSum_[c] += mfcc_[c];
+        mfccSumSquares_[c] += static_cast<double>(mfcc_[c]) * mfcc_[c];
+    }
+
+    const float silenceFloor = 1e-8f;
+    if (frameEnergy > silenceFloor && total > 0.0f) {
+        centroidSum_ += frameCentroid;
+        rolloffSum_ += frameRolloff;
+        audibleFrames_++;
+    }
+}
+
+FeatureFrames FeatureFrameBuilder::finish() {
+    FeatureFrames& f = frames_;
+
+    if (f.sampleCount > 0) {
+        f.rms = static_cast<float>(std::sqrt(sumSquares_ / f.sampleCount));
+        f.zeroCrossingRate = static_cast<float>(crossings_) / f.sampleCount;
+    }
+
+    if (valid_) {
+        // Track kürzer als ein Frame: ein Zero-Padded Frame
+        if (f.energy.empty() && !pending_.empty()) {
+            processFrame(pending_.data(), pending_.size());
+        }
+
+        size_t frames = f.frameCount();
+        if (frames > 0) {
+            f.meanMagnitude.resize(magnitudeSum_.size());
+            for (size_t k = 0; k < magnitudeSum_.size(); ++k) {
+                f.meanMagnitude[k] = static_cast<float>(magnitudeSum_[k] / frames);
+            }
+            f.mfccMean.resize(f.numMfcc);
+            f.mfccVariance.resize(f.numMfcc);
+            for (size_t c = 0; c < f.numMfcc; ++c) {
+                double mean = mfccSum_[c] / frames;
+                f.mfccMean[c] = static_cast<float>(mean);
+                f.mfccVariance[c] = static_cast<float>(std::max(0.0, mfccSumSquares_[c] / frames - mean * mean));
+            }
+        }
+        if (audibleFrames_ > 0) {
+            f.meanCentroid = static_cast<float>(centroidSum_ / audibleFrames_);
+            f.meanRolloff = static_cast<float>(rolloffSum_ / audibleFrames_);
+        }
+    }
+
+    pending_.clear();
+    pending_.shrink_to_fit();
+    valid_ = false;
+    return std::move(frames_);
+}
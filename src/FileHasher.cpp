@@ -0,0 +1,181 @@
+#include "FileHasher.h"
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint64_t kPrime1 = 11400714785074694791ULL;
+constexpr uint64_t kPrime2 = 14029467366897019727ULL;
+constexpr uint64_t kPrime3 = 1609587929392839161ULL;
+constexpr uint64_t kPrime4 = 9650029242287828579ULL;
+constexpr uint64_t kPrime5 = 2870177450012600261ULL;
+
+constexpr size_t kReadBlockSize = 1 << 20;
+constexpr size_t kMmapThreshold = 1 << 20;
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// XXH64 ist als Little-Endian definiert
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+inline uint32_t read32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t xxhRound(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t value) {
+    acc ^= xxhRound(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+} // namespace
+
+FileHasher::Stream::Stream(uint64_t seed) : seed_(seed) {
+    v_[0] = seed + kPrime1 + kPrime2;
+    v_[1] = seed + kPrime2;
+    v_[2] = seed;
+    v_[3] = seed - kPrime1;
+}
+
+void FileHasher::Stream::update(const void* data, size_t length) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + length;
+    totalLength_ += length;
+
+    // Rest vom letzten Aufruf auffüllen
+    if (bufferSize_ + length < sizeof(buffer_)) {
+        std::memcpy(buffer_ + bufferSize_, p, length);
+        bufferSize_ += length;
+        return;
+    }
+    if (bufferSize_ > 0) {
+        size_t fill = sizeof(buffer_) - bufferSize_;
+        std::memcpy(buffer_ + bufferSize_, p, fill);
+        for (int i = 0; i < 4; ++i) v_[i] = xxhRound(v_[i], read64(buffer_ + 8 * i));
+        p += fill;
+        bufferSize_ = 0;
+    }
+
+    // 32-Byte-Stripes direkt aus dem Input
+    while (p + 32 <= end) {
+        v_[0] = xxhRound(v_[0], read64(p));
+        v_[1] = xxhRound(v_[1], read64(p + 8));
+        v_[2] = xxhRound(v_[2], read64(p + 16));
+        v_[3] = xxhRound(v_[3], read64(p + 24));
+        p += 32;
+    }
+
+    if (p < end) {
+        bufferSize_ = static_cast<size_t>(end - p);
+        std::memcpy(buffer_, p, bufferSize_);
+    }
+}
+
+uint64_t FileHasher::Stream::digest() const {
+    uint64_t h;
+    if (totalLength_ >= 32) {
+        h = rotl(v_[0], 1) + rotl(v_[1], 7) + rotl(v_[2], 12) + rotl(v_[3], 18);
+        for (int i = 0; i < 4; ++i) h = mergeRound(h, v_[i]);
+    } else {
+        h = seed_ + kPrime5;
+    }
+    h += totalLength_;
+
+    const unsigned char* p = buffer_;
+    const unsigned char* end = buffer_ + bufferSize_;
+    while (p + 8 <= end) {
+        h ^= xxhRound(0, read64(p));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+        h = rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= static_cast<uint64_t>(*p) * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t FileHasher::hashBytes(const void* data, size_t length, uint64_t seed) {
+    Stream stream(seed);
+    stream.update(data, length);
+    return stream.digest();
+}
+
+std::string FileHasher::toString(uint64_t hash) {
+    static const char hex[] = "0123456789abcdef";
+    std::string result(kPrefix);
+    for (int shift = 60; shift >= 0; shift -= 4) {
+        result += hex[(hash >> shift) & 0xF];
+    }
+    return result;
+}
+
+std::string FileHasher::hashFile(const std::string& filepath, bool useMmap) {
+#ifdef __unix__
+    if (useMmap) {
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) return "";
+
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+            static_cast<size_t>(st.st_size) >= kMmapThreshold) {
+            size_t size = static_cast<size_t>(st.st_size);
+            void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                ::madvise(mapped, size, MADV_SEQUENTIAL);
+                uint64_t hash = hashBytes(mapped, size);
+                ::munmap(mapped, size);
+                ::close(fd);
+                return toString(hash);
+            }
+        }
+        ::close(fd);
+    }
+#endif
+
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) return "";
+
+    Stream stream;
+    std::vector<char> block(kReadBlockSize);
+    while (file) {
+        file.read(block.data(), block.size());
+        std::streamsize got = file.gcount();
+        if (got <= 0) break;
+        stream.update(block.data(), static_cast<size_t>(got));
+    }
+    if (file.bad()) return "";
+    return toString(stream.digest());
+}
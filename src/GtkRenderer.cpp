@@ -2,6 +2,9 @@
 #include "TrainingModel.h"
 #include "PatternCaptureEngine.h"
 #include "DataQualityAnalyzer.h"
+#include "FileHasher.h"
+#include "MediaListModel.h"
+#include "ParallelTreeWalker.h"
 #include <iostream>
 #include <iomanip>
 #include <filesystem>
@@ -71,20 +74,9 @@ bool GtkRenderer::initialize() {
         }
     }
     
-    // Lade Datenbank - unkorrigierte zuerst (lastUsed=0 oder niedrig oben)
-    filteredMedia_ = database_->getAll();
-    
     // 🤖 Automatisches Genre-Learning: Lerne aus bereits korrigierten Tracks
     autoLearnGenresFromCorrectedTracks();
     
-    // Sortiere: Noch nicht bearbeitete (lastUsed=0) zuerst, dann nach lastUsed aufsteigend
-    std::sort(filteredMedia_.begin(), filteredMedia_.end(),
-        [](const MediaMetadata& a, const MediaMetadata& b) {
-            if (a.lastUsed == 0 && b.lastUsed != 0) return true;   // Unbearbeitet zuerst
-            if (a.lastUsed != 0 && b.lastUsed == 0) return false;
-            return a.lastUsed < b.lastUsed;  // Ältere Korrekturen vor neueren
-        });
-    
     // Erstelle Hauptfenster
     window_ = gtk_window_new(GTK_WINDOW_TOPLEVEL);
     gtk_window_set_title(GTK_WINDOW(window_), "🎵 SongGen - KI Song Generator");
@@ -323,7 +315,7 @@ void GtkRenderer::buildDatabaseTab() {
     // Info-Label
     dbInfoLabel_ = gtk_label_new(NULL);
     gtk_label_set_selectable(GTK_LABEL(dbInfoLabel_), TRUE);
-    std::string info = "Einträge in Datenbank: " + std::to_string(filteredMedia_.size());
+    std::string info = "Einträge in Datenbank: " + std::to_string(database_->getTotalCount());
     gtk_label_set_text(GTK_LABEL(dbInfoLabel_), info.c_str());
     gtk_box_pack_start(GTK_BOX(vbox), dbInfoLabel_, FALSE, FALSE, 0);
     
@@ -335,47 +327,64 @@ void GtkRenderer::buildDatabaseTab() {
     gtk_box_pack_start(GTK_BOX(vbox), scrolled, TRUE, TRUE, 0);
     
     // TreeView mit Columns (5 Spalten: Play, Title, Artist, Genre, Duration)
-    GtkListStore* store = gtk_list_store_new(6, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING);
-    dbTreeView_ = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
-    g_object_unref(store);
+    // Virtuelles Model: Zeilen werden erst beim Anzeigen aus der DB geladen
+    dbPager_ = std::make_unique<MediaPager>(*database_, MediaDatabase::ColTags | MediaDatabase::ColAnalysis);
+    MediaListModel* listModel = media_list_model_new(dbPager_.get());
+    dbTreeView_ = gtk_tree_view_new_with_model(GTK_TREE_MODEL(listModel));
+    g_object_unref(listModel);
+    
+    // Feste Zeilenhöhe: GTK misst nicht jede Zeile aus, sondern fragt nur die sichtbaren ab
+    // (alle Spalten brauchen dafür GTK_TREE_VIEW_COLUMN_FIXED)
+    auto setFixedWidth = [](GtkTreeViewColumn* column, int width) {
+        gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_column_set_fixed_width(column, width);
+        gtk_tree_view_column_set_resizable(column, TRUE);
+    };
     
     // Play-Button Column
     GtkCellRenderer* rendererButton = gtk_cell_renderer_text_new();
-    GtkTreeViewColumn* playColumn = gtk_tree_view_column_new_with_attributes("▶️", rendererButton, "text", 0, NULL);
+    GtkTreeViewColumn* playColumn = gtk_tree_view_column_new_with_attributes("▶️", rendererButton, "text", MEDIA_LIST_COL_PLAY, NULL);
     gtk_tree_view_column_set_min_width(playColumn, 50);
+    setFixedWidth(playColumn, 50);
     gtk_tree_view_append_column(GTK_TREE_VIEW(dbTreeView_), playColumn);
     
     // Text Columns: Title, Artist, Genre, Duration (clickable f\u00fcr Sortierung)
     GtkCellRenderer* renderer = gtk_cell_renderer_text_new();
     
-    GtkTreeViewColumn* colTitle = gtk_tree_view_column_new_with_attributes("Titel ⬍", renderer, "text", 1, NULL);
+    GtkTreeViewColumn* colTitle = gtk_tree_view_column_new_with_attributes("Titel ⬍", renderer, "text", MEDIA_LIST_COL_TITLE, NULL);
+    setFixedWidth(colTitle, 400);
     gtk_tree_view_column_set_clickable(colTitle, TRUE);
     g_signal_connect(colTitle, "clicked", G_CALLBACK(onColumnHeaderClicked), this);
     g_object_set_data(G_OBJECT(colTitle), "column-name", (gpointer)"title");
     gtk_tree_view_append_column(GTK_TREE_VIEW(dbTreeView_), colTitle);
     
-    GtkTreeViewColumn* colArtist = gtk_tree_view_column_new_with_attributes("Artist ⬍", renderer, "text", 2, NULL);
+    GtkTreeViewColumn* colArtist = gtk_tree_view_column_new_with_attributes("Artist ⬍", renderer, "text", MEDIA_LIST_COL_ARTIST, NULL);
+    setFixedWidth(colArtist, 250);
     gtk_tree_view_column_set_clickable(colArtist, TRUE);
     g_signal_connect(colArtist, "clicked", G_CALLBACK(onColumnHeaderClicked), this);
     g_object_set_data(G_OBJECT(colArtist), "column-name", (gpointer)"artist");
     gtk_tree_view_append_column(GTK_TREE_VIEW(dbTreeView_), colArtist);
     
-    GtkTreeViewColumn* colGenre = gtk_tree_view_column_new_with_attributes("Genre ⬍", renderer, "text", 3, NULL);
+    GtkTreeViewColumn* colGenre = gtk_tree_view_column_new_with_attributes("Genre ⬍", renderer, "text", MEDIA_LIST_COL_GENRE, NULL);
+    setFixedWidth(colGenre, 150);
     gtk_tree_view_column_set_clickable(colGenre, TRUE);
     g_signal_connect(colGenre, "clicked", G_CALLBACK(onColumnHeaderClicked), this);
     g_object_set_data(G_OBJECT(colGenre), "column-name", (gpointer)"genre");
     gtk_tree_view_append_column(GTK_TREE_VIEW(dbTreeView_), colGenre);
     
-    GtkTreeViewColumn* colDuration = gtk_tree_view_column_new_with_attributes("Dauer ⬍", renderer, "text", 4, NULL);
+    GtkTreeViewColumn* colDuration = gtk_tree_view_column_new_with_attributes("Dauer ⬍", renderer, "text", MEDIA_LIST_COL_DURATION, NULL);
+    setFixedWidth(colDuration, 120);
     gtk_tree_view_column_set_clickable(colDuration, TRUE);
     g_signal_connect(colDuration, "clicked", G_CALLBACK(onColumnHeaderClicked), this);
     g_object_set_data(G_OBJECT(colDuration), "column-name", (gpointer)"duration");
     gtk_tree_view_append_column(GTK_TREE_VIEW(dbTreeView_), colDuration);
     
     // Filepath (hidden column for play callback)
-    gtk_tree_view_insert_column_with_attributes(GTK_TREE_VIEW(dbTreeView_), -1, "Pfad", renderer, "text", 5, NULL);
+    gtk_tree_view_insert_column_with_attributes(GTK_TREE_VIEW(dbTreeView_), -1, "Pfad", renderer, "text", MEDIA_LIST_COL_FILEPATH, NULL);
     GtkTreeViewColumn* pathColumn = gtk_tree_view_get_column(GTK_TREE_VIEW(dbTreeView_), 5);
+    setFixedWidth(pathColumn, 300);
     gtk_tree_view_column_set_visible(pathColumn, FALSE);
+    gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(dbTreeView_), TRUE);
     
     // Double-click oder Enter zum Abspielen
     g_signal_connect(dbTreeView_, "row-activated", G_CALLBACK(onPlaySong), this);
@@ -399,15 +408,7 @@ void GtkRenderer::buildDatabaseTab() {
 }
 
 void GtkRenderer::refreshDatabaseView() {
-    if (!dbTreeView_) return;
-    
-    GtkTreeModel* model = gtk_tree_view_get_model(GTK_TREE_VIEW(dbTreeView_));
-    if (!model || !GTK_IS_LIST_STORE(model)) return;
-    
-    gtk_list_store_clear(GTK_LIST_STORE(model));
-    
-    // Hole alle Einträge
-    auto allMedia = database_->getAll();
+    if (!dbTreeView_ || !dbPager_) return;
     
     // Filter nach Genre
     std::string selectedGenre = "Alle";
@@ -419,67 +420,42 @@ void GtkRenderer::refreshDatabaseView() {
         }
     }
     
-    // Filter nach Suchtext
+    // Filter nach Suchtext (Volltextindex, Präfix-Suche je Wort)
     std::string searchText;
     if (dbSearchEntry_) {
         const char* text = gtk_entry_get_text(GTK_ENTRY(dbSearchEntry_));
         if (text) {
             searchText = text;
-            // Zu Kleinbuchstaben für case-insensitive Suche
-            std::transform(searchText.begin(), searchText.end(), searchText.begin(), ::tolower);
         }
     }
     
-    // Filtere Einträge
-    filteredMedia_.clear();
-    for (const auto& meta : allMedia) {
-        // Genre-Filter
-        if (selectedGenre != "Alle" && meta.genre != selectedGenre) {
-            continue;
-        }
-        
-        // Such-Filter
-        if (!searchText.empty()) {
-            std::string title = meta.title;
-            std::string artist = meta.artist;
-            std::string genre = meta.genre;
-            std::transform(title.begin(), title.end(), title.begin(), ::tolower);
-            std::transform(artist.begin(), artist.end(), artist.begin(), ::tolower);
-            std::transform(genre.begin(), genre.end(), genre.begin(), ::tolower);
-            
-            if (title.find(searchText) == std::string::npos &&
-                artist.find(searchText) == std::string::npos &&
-                genre.find(searchText) == std::string::npos) {
-                continue;
-            }
-        }
-        
-        filteredMedia_.push_back(meta);
+    // Filter und Sortierung laufen in SQLite; die Liste lädt nur sichtbare Zeilen nach
+    MediaDatabase::MediaQuery query;
+    if (selectedGenre != "Alle") {
+        query.where = "genre = ?";
+        query.params.push_back(selectedGenre);
     }
+    query.search = searchText;
+    
+    // Ohne gewählte Spalte: Suchtreffer nach Relevanz, sonst neueste zuerst
+    if (currentSortColumn_ == "title" || currentSortColumn_ == "artist" ||
+        currentSortColumn_ == "genre" || currentSortColumn_ == "duration") {
+        query.orderBy = currentSortColumn_ + (sortAscending_ ? " ASC" : " DESC");
+    } else if (searchText.empty()) {
+        query.orderBy = "addedTimestamp DESC";
+    }
+    
+    dbPager_->setQuery(query);
+    size_t totalCount = database_->getTotalCount();
     
     // Update Info-Label
-    std::string info = "Einträge: " + std::to_string(filteredMedia_.size()) + " / " + std::to_string(allMedia.size());
+    std::string info = "Einträge: " + std::to_string(dbPager_->size()) + " / " + std::to_string(totalCount);
     gtk_label_set_text(GTK_LABEL(dbInfoLabel_), info.c_str());
     
-    // Füge Einträge hinzu (max 1000 für Performance)
-    size_t count = 0;
-    for (const auto& meta : filteredMedia_) {
-        if (count++ > 1000) break;
-        
-        GtkTreeIter iter;
-        gtk_list_store_append(GTK_LIST_STORE(model), &iter);
-        
-        std::string duration = std::to_string(meta.duration) + "s";
-        
-        gtk_list_store_set(GTK_LIST_STORE(model), &iter,
-                          0, "▶️",  // Play-Button Symbol
-                          1, meta.title.c_str(),
-                          2, meta.artist.c_str(),
-                          3, meta.genre.c_str(),
-                          4, duration.c_str(),
-                          5, meta.filepath.c_str(),  // Hidden filepath
-                          -1);
-    }
+    // Neues Model mit der neuen Zeilenzahl (der Pager hält keine Zeilen des alten mehr)
+    MediaListModel* listModel = media_list_model_new(dbPager_.get());
+    gtk_tree_view_set_model(GTK_TREE_VIEW(dbTreeView_), GTK_TREE_MODEL(listModel));
+    g_object_unref(listModel);
 }
 
 void GtkRenderer::buildBrowserTab() {
@@ -755,14 +731,12 @@ void GtkRenderer::buildHVSCTab() {
         int skipped = 0;
         
         for (const auto& mp3Path : mp3Files) {
-            // Prüfe ob bereits in DB
-            auto existing = renderer->database_->getAll();
-            bool alreadyExists = false;
-            for (const auto& media : existing) {
-                if (media.filepath == mp3Path) {
-                    alreadyExists = true;
-                    break;
-                }
+            // Prüfe ob bereits in DB (Pfad bzw. byte-identischer Inhalt, beides indiziert)
+            std::string fileHash;
+            bool alreadyExists = renderer->database_->existsByPath(mp3Path);
+            if (!alreadyExists) {
+                fileHash = FileHasher::hashFile(mp3Path);
+                alreadyExists = renderer->database_->existsByHash(fileHash);
             }
             
             if (alreadyExists) {
@@ -774,12 +748,19 @@ void GtkRenderer::buildHVSCTab() {
                 meta.title = std::filesystem::path(mp3Path).stem().string();
                 meta.artist = "HVSC";
                 meta.genre = "SID";
+                meta.fileHash = fileHash;
                 
                 if (renderer->analyzer_->analyze(mp3Path, meta)) {
                     meta.analyzed = true;
                     meta.addedTimestamp = std::time(nullptr);
                     
-                    if (renderer->database_->addMedia(meta)) {
+                    // Gleicher Song in anderer Datei (Metadaten bzw. MFCC), nur Bereichs-Kandidaten
+                    auto duplicates = renderer->database_->checkDuplicate(meta);
+                    if (!duplicates.empty()) {
+                        std::cout << "🔁 Duplikat übersprungen: " << mp3Path << " ≈ "
+                                  << duplicates.front().filepath1 << " (" << duplicates.front().reason << ")\n";
+                        skipped++;
+                    } else if (renderer->database_->addMedia(meta)) {
                         added++;
                     } else {
                         skipped++;
@@ -930,7 +911,7 @@ void GtkRenderer::buildGeneratorTab() {
     gtk_box_pack_start(GTK_BOX(vbox), hbox3, FALSE, FALSE, 0);
     gtk_box_pack_start(GTK_BOX(hbox3), gtk_label_new("Dauer (Sekunden):"), FALSE, FALSE, 0);
     
-    genDurationSpin_ = gtk_spin_button_new_with_range(30, 600, 10);
+    genDurationSpin_ = gtk_spin_button_new_with_range(30, 1800, 10);
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(genDurationSpin_), 180);
     gtk_box_pack_start(GTK_BOX(hbox3), genDurationSpin_, FALSE, FALSE, 0);
     
@@ -1413,7 +1394,7 @@ void GtkRenderer::buildSettingsTab() {
     gtk_container_set_border_width(GTK_CONTAINER(vbox3), 10);
     gtk_container_add(GTK_CONTAINER(frame3), vbox3);
     
-    GtkWidget* checkAutoSync = gtk_check_button_new_with_label("Auto-Sync aktiviert (alle 30s)");
+    GtkWidget* checkAutoSync = gtk_check_button_new_with_label("Auto-Sync aktiviert (überwacht hvsc/mp3)");
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(checkAutoSync), TRUE);
     gtk_box_pack_start(GTK_BOX(vbox3), checkAutoSync, FALSE, FALSE, 0);
     
@@ -2089,7 +2070,7 @@ void GtkRenderer::onDeleteDatabase(GtkWidget* widget, gpointer data) {
         GTK_MESSAGE_WARNING,
         GTK_BUTTONS_YES_NO,
         "⚠️ WARNUNG: Alle Datenbank-Einträge werden gelöscht!\nDiese Aktion kann nicht rückgängig gemacht werden.\n\nAktuell: %zu Einträge in der Datenbank",
-        self->filteredMedia_.size()
+        self->database_->getTotalCount()
     );
     
     gtk_window_set_title(GTK_WINDOW(dialog), "Datenbank löschen?");
@@ -2122,11 +2103,18 @@ void GtkRenderer::onDeleteDatabase(GtkWidget* widget, gpointer data) {
         
         // Löschung im Thread
         std::thread([self, progressDialog, progressBar, labelProgress]() {
-            auto allMedia = self->database_->getAll();
-            self->deleteTotal_ = allMedia.size();
+            // Nur die IDs lesen, gelöscht wird nach dem Durchlauf
+            std::vector<int64_t> ids;
+            MediaDatabase::MediaQuery query;
+            query.columns = MediaDatabase::ColIdentity;
+            self->database_->iterate(query, [&ids](const MediaMetadata& meta) {
+                ids.push_back(meta.id);
+                return true;
+            });
+            self->deleteTotal_ = ids.size();
             
-            for (const auto& meta : allMedia) {
-                self->database_->deleteMedia(meta.id);
+            for (int64_t id : ids) {
+                self->database_->deleteMedia(id);
                 self->deleteProgress_++;
                 
                 // Update GUI (thread-safe via gdk_threads_add_idle)
@@ -2145,8 +2133,11 @@ void GtkRenderer::onDeleteDatabase(GtkWidget* widget, gpointer data) {
                 }, new std::tuple<GtkWidget*, GtkWidget*, GtkRenderer*>(progressBar, labelProgress, self));
             }
             
-            self->filteredMedia_.clear();
             self->isDeleting_ = false;
+            gdk_threads_add_idle([](gpointer data) -> gboolean {
+                static_cast<GtkRenderer*>(data)->refreshDatabaseView();
+                return G_SOURCE_REMOVE;
+            }, self);
             
             // Schließe Dialog
             gdk_threads_add_idle([](gpointer dialog) -> gboolean {
@@ -2162,20 +2153,39 @@ void GtkRenderer::onCleanupMissing(GtkWidget* widget, gpointer data) {
     GtkRenderer* self = static_cast<GtkRenderer*>(data);
     
     std::thread([self]() {
-        auto allMedia = self->database_->getAll();
+        // Nur id + Pfad lesen; Dateisystem-Prüfung erst nach dem Durchlauf
+        std::vector<std::pair<int64_t, std::string>> entries;
+        MediaDatabase::MediaQuery query;
+        query.columns = MediaDatabase::ColIdentity;
+        self->database_->iterate(query, [&entries](const MediaMetadata& meta) {
+            entries.emplace_back(meta.id, meta.filepath);
+            return true;
+        });
         size_t removed = 0;
         
-        for (const auto& meta : allMedia) {
-            if (!std::filesystem::exists(meta.filepath)) {
-                self->database_->deleteMedia(meta.id);
-                removed++;
-            }
+        // Jedes Elternverzeichnis einmal (parallel) lesen statt fs::exists pro Eintrag
+        std::vector<std::string> parents;
+        parents.reserve(entries.size());
+        for (const auto& entry : entries) {
+            std::string parent = std::filesystem::path(entry.second).parent_path().string();
+            parents.push_back(parent.empty() ? "." : parent);
         }
-        
-        self->filteredMedia_ = self->database_->getAll();
+        auto listings = ParallelTreeWalker::listDirectories(parents);
+        
+        // Nicht lesbare Verzeichnisse (z.B. NAS weg) zählen nicht als "fehlt"
+        MediaDatabase::WriteBatch batch(*self->database_);
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const auto& listing = listings[parents[i]];
+            std::string name = std::filesystem::path(entries[i].second).filename().string();
+            bool missing = !listing.exists || (listing.readable && !listing.names.count(name));
+            if (missing) batch.remove(entries[i].second);
+        }
+        batch.commit();
+        removed = batch.written();
         
         gdk_threads_add_idle([](gpointer data) -> gboolean {
             auto* info = static_cast<std::pair<GtkRenderer*, size_t>*>(data);
+            info->first->refreshDatabaseView();
             
             GtkWidget* dialog = gtk_message_dialog_new(
                 GTK_WINDOW(info->first->window_),
@@ -2255,13 +2265,12 @@ void GtkRenderer::onAutoDetectGenres(GtkWidget* widget, gpointer data) {
         for (const auto& media : allMedia) {
             processed++;
             
-            // Lade Audio und analysiere
-            std::vector<float> samples;
-            int sampleRate;
+            // Audio streamen und analysieren (ein STFT-Durchlauf für BPM und Genre)
+            FeatureFrames frames;
             
-            if (self->analyzer_->loadAudioFile(media.filepath, samples, sampleRate)) {
-                float bpm = self->analyzer_->detectBPM(samples, sampleRate);
-                std::string detectedGenre = self->analyzer_->detectGenreFromAudio(samples, sampleRate, bpm);
+            if (self->analyzer_->loadFeatureFrames(media.filepath, frames)) {
+                float bpm = self->analyzer_->detectBPM(frames);
+                std::string detectedGenre = self->analyzer_->detectGenreFromAudio(frames, bpm);
                 
                 // Simuliere Konfidenz basierend auf BPM-Konsistenz
                 float confidence = 0.85f;
@@ -2399,9 +2408,9 @@ void GtkRenderer::onAutoDetectGenres(GtkWidget* widget, gpointer data) {
 void GtkRenderer::onAnalyzeAll(GtkWidget* widget, gpointer data) {
     GtkRenderer* self = static_cast<GtkRenderer*>(data);
     
-    auto allMedia = self->database_->getAll();
+    size_t totalCount = self->database_->getTotalCount();
     
-    if (allMedia.empty()) {
+    if (totalCount == 0) {
         GtkWidget* dialog = gtk_message_dialog_new(
             GTK_WINDOW(self->window_),
             GTK_DIALOG_MODAL,
@@ -2414,13 +2423,8 @@ void GtkRenderer::onAnalyzeAll(GtkWidget* widget, gpointer data) {
         return;
     }
     
-    // Filter: Nur nicht-analysierte Dateien
-    std::vector<MediaMetadata> unanalyzed;
-    for (const auto& meta : allMedia) {
-        if (!meta.analyzed) {
-            unanalyzed.push_back(meta);
-        }
-    }
+    // Nur nicht-analysierte Dateien (Filter in SQL)
+    std::vector<MediaMetadata> unanalyzed = self->database_->getUnanalyzed();
     
     if (unanalyzed.empty()) {
         GtkWidget* dialog = gtk_message_dialog_new(
@@ -2429,7 +2433,7 @@ void GtkRenderer::onAnalyzeAll(GtkWidget* widget, gpointer data) {
             GTK_MESSAGE_INFO,
             GTK_BUTTONS_OK,
             "✅ Alle Dateien bereits analysiert!\n\n%zu von %zu Dateien sind analysiert.",
-            allMedia.size(), allMedia.size()
+            totalCount, totalCount
         );
         gtk_dialog_run(GTK_DIALOG(dialog));
         gtk_widget_destroy(dialog);
@@ -2490,116 +2494,94 @@ void GtkRenderer::onAnalyzeAll(GtkWidget* widget, gpointer data) {
         }
     }), cancelFlag);
     
-    // Analyse mit Multi-Threading (nutzt alle CPU-Kerne)
+    // Analyse über AudioAnalyzer::analyzeBatch (Work-Stealing, nutzt alle CPU-Kerne)
     std::thread([self, unanalyzed, progressDialog, progressBar, labelProgress, labelDetails, cancelFlag]() {
-        std::atomic<size_t> processed(0);
-        std::atomic<size_t> analyzed(0);
-        std::mutex dbMutex;  // Schütze Datenbank-Zugriff
-        
-        // Anzahl Threads = CPU-Kerne
-        unsigned int numThreads = std::thread::hardware_concurrency();
-        if (numThreads == 0) numThreads = 4;  // Fallback
+        // Gemeinsamer Schreib-Batch für alle Worker (thread-safe). Commit spätestens
+        // nach 1 s, damit die View Ergebnisse sieht und ein Abbruch wenig verliert
+        MediaDatabase::WriteBatch batch(*self->database_);
+        std::atomic<bool> analysisDone(false);
+        std::thread committer([&batch, &analysisDone]() {
+            int ticks = 0;
+            while (!analysisDone) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                if (++ticks % 10 == 0) batch.commit();
+            }
+        });
         
-        std::cout << "🚀 Starte parallele Analyse mit " << numThreads << " Threads\n";
+        std::vector<std::string> paths;
+        paths.reserve(unanalyzed.size());
+        for (const auto& media : unanalyzed) {
+            paths.push_back(media.filepath);
+        }
         
-        // Thread-Pool
-        std::vector<std::thread> workers;
-        std::atomic<size_t> nextIndex(0);
+        AudioAnalyzer::BatchOptions options;
+        options.stopFlag = cancelFlag;
         
-        for (unsigned int t = 0; t < numThreads; ++t) {
-            workers.emplace_back([&, self]() {
-                // Jeder Thread erstellt eigenen Analyzer (thread-safe)
-                AudioAnalyzer localAnalyzer;
+        self->analyzer_->analyzeBatch(paths,
+            [&](size_t idx, const MediaMetadata& result, bool ok) {
+                if (!ok) return;
                 
-                while (true) {
-                    // Check Cancel-Flag
-                    if (*cancelFlag) {
-                        std::cout << "⚠️ Thread " << t << " abgebrochen\n";
-                        break;
-                    }
-                    
-                    size_t idx = nextIndex.fetch_add(1);
-                    if (idx >= unanalyzed.size()) break;
+                // Übernimm Analyse-Features, behalte DB-Felder (id, Titel, Artist)
+                MediaMetadata updatedMeta = unanalyzed[idx];
+                updatedMeta.duration = result.duration;
+                updatedMeta.bpm = result.bpm;
+                updatedMeta.genre = result.genre;
+                updatedMeta.intensity = result.intensity;
+                updatedMeta.bassLevel = result.bassLevel;
+                updatedMeta.mood = result.mood;
+                updatedMeta.instruments = result.instruments;
+                updatedMeta.spectralCentroid = result.spectralCentroid;
+                updatedMeta.spectralRolloff = result.spectralRolloff;
+                updatedMeta.zeroCrossingRate = result.zeroCrossingRate;
+                updatedMeta.mfccHash = result.mfccHash;
+                updatedMeta.mfccMean = result.mfccMean;
+                updatedMeta.mfccVariance = result.mfccVariance;
+                updatedMeta.analyzed = true;
+                
+                batch.update(updatedMeta);  // Gezählt wird erst nach erfolgreichem Commit
+            },
+            [&](size_t done, size_t total) {
+                // Update Progress (alle 5 Dateien)
+                if (done % 5 == 0 || done == total) {
+                    gdk_threads_add_idle([](gpointer data) -> gboolean {
+                        auto* info = static_cast<std::tuple<GtkWidget*, GtkWidget*, GtkWidget*, size_t, size_t, size_t>*>(data);
                     
-                    const auto& media = unanalyzed[idx];
+                        float progress = (float)std::get<3>(*info) / std::get<4>(*info);
+                        gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(std::get<0>(*info)), progress);
                     
-                    // Lade Audio und analysiere vollständig
-                    std::vector<float> samples;
-                    int sampleRate;
+                        // Text mit Prozent
+                        char percentText[64];
+                        snprintf(percentText, sizeof(percentText), "%.1f%%", progress * 100.0f);
+                        gtk_progress_bar_set_text(GTK_PROGRESS_BAR(std::get<0>(*info)), percentText);
+                        gtk_progress_bar_set_show_text(GTK_PROGRESS_BAR(std::get<0>(*info)), TRUE);
                     
-                    if (localAnalyzer.loadAudioFile(media.filepath, samples, sampleRate)) {
-                        MediaMetadata updatedMeta = media;
-                        
-                        // BPM-Erkennung
-                        updatedMeta.bpm = localAnalyzer.detectBPM(samples, sampleRate);
-                        
-                        // Genre-Erkennung
-                        updatedMeta.genre = localAnalyzer.detectGenreFromAudio(samples, sampleRate, updatedMeta.bpm);
-                        
-                        // Intensität
-                        updatedMeta.intensity = localAnalyzer.detectIntensity(samples);
-                        
-                        // Bass-Level
-                        updatedMeta.bassLevel = localAnalyzer.detectBassLevel(samples, sampleRate);
-                        
-                        // Spektrale Features
-                        updatedMeta.spectralCentroid = localAnalyzer.calculateSpectralCentroid(samples, sampleRate);
-                        updatedMeta.zeroCrossingRate = localAnalyzer.calculateZeroCrossingRate(samples);
-                        updatedMeta.mfccHash = localAnalyzer.calculateMFCCHash(samples, sampleRate);
-                        
-                        // Markiere als analysiert
-                        updatedMeta.analyzed = true;
-                        
-                        // Thread-safe Datenbank-Update
-                        {
-                            std::lock_guard<std::mutex> lock(dbMutex);
-                            if (self->database_->updateMedia(updatedMeta)) {
-                                analyzed++;
-                            }
-                        }
-                    }
+                        std::string text = std::to_string(std::get<3>(*info)) + " / " + 
+                                          std::to_string(std::get<4>(*info)) + " (" + percentText + ")";
+                        gtk_label_set_text(GTK_LABEL(std::get<1>(*info)), text.c_str());
                     
-                    processed++;
+                        float analyzedPercent = (float)std::get<5>(*info) / std::get<4>(*info) * 100.0f;
+                        char detailsText[128];
+                        snprintf(detailsText, sizeof(detailsText), "✓ Analysiert: %zu (%.1f%%)", 
+                                std::get<5>(*info), analyzedPercent);
+                        gtk_label_set_text(GTK_LABEL(std::get<2>(*info)), detailsText);
                     
-                    // Update Progress (alle 5 Dateien)
-                    if (processed % 5 == 0 || processed == unanalyzed.size()) {
-                        gdk_threads_add_idle([](gpointer data) -> gboolean {
-                            auto* info = static_cast<std::tuple<GtkWidget*, GtkWidget*, GtkWidget*, size_t, size_t, size_t>*>(data);
-                            
-                            float progress = (float)std::get<3>(*info) / std::get<4>(*info);
-                            gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(std::get<0>(*info)), progress);
-                            
-                            // Text mit Prozent
-                            char percentText[64];
-                            snprintf(percentText, sizeof(percentText), "%.1f%%", progress * 100.0f);
-                            gtk_progress_bar_set_text(GTK_PROGRESS_BAR(std::get<0>(*info)), percentText);
-                            gtk_progress_bar_set_show_text(GTK_PROGRESS_BAR(std::get<0>(*info)), TRUE);
-                            
-                            std::string text = std::to_string(std::get<3>(*info)) + " / " + 
-                                              std::to_string(std::get<4>(*info)) + " (" + percentText + ")";
-                            gtk_label_set_text(GTK_LABEL(std::get<1>(*info)), text.c_str());
-                            
-                            float analyzedPercent = (float)std::get<5>(*info) / std::get<4>(*info) * 100.0f;
-                            char detailsText[128];
-                            snprintf(detailsText, sizeof(detailsText), "✓ Analysiert: %zu (%.1f%%)", 
-                                    std::get<5>(*info), analyzedPercent);
-                            gtk_label_set_text(GTK_LABEL(std::get<2>(*info)), detailsText);
-                            
-                            delete info;
-                            return G_SOURCE_REMOVE;
-                        }, new std::tuple<GtkWidget*, GtkWidget*, GtkWidget*, size_t, size_t, size_t>(
-                            progressBar, labelProgress, labelDetails, processed.load(), unanalyzed.size(), analyzed.load()));
-                    }
+                        delete info;
+                        return G_SOURCE_REMOVE;
+                    }, new std::tuple<GtkWidget*, GtkWidget*, GtkWidget*, size_t, size_t, size_t>(
+                        progressBar, labelProgress, labelDetails, done, total, batch.written()));
                 }
-            });
-        }
-        
-        // Warte auf alle Worker-Threads
-        for (auto& worker : workers) {
-            worker.join();
-        }
+            },
+            options);
+        analysisDone = true;
+        committer.join();
+        batch.commit();  // Vor dem Refresh, damit die View alle Ergebnisse sieht
+        size_t analyzed = batch.written();
+        size_t lost = batch.failed();
         
         std::cout << "✅ Alle Worker-Threads beendet. Analyzed: " << analyzed << " Cancelled: " << *cancelFlag << "\n";
+        if (lost > 0) {
+            std::cerr << "❌ " << lost << " Analyse-Ergebnisse konnten nicht gespeichert werden\n";
+        }
         
         bool wasCancelled = *cancelFlag;
         delete cancelFlag;  // Cleanup
@@ -2614,17 +2596,19 @@ void GtkRenderer::onAnalyzeAll(GtkWidget* widget, gpointer data) {
         
         // Schließe Dialog und zeige Ergebnis (NACH refresh)
         gdk_threads_add_idle([](gpointer data) -> gboolean {
-            auto* info = static_cast<std::tuple<GtkRenderer*, GtkWidget*, size_t, bool>*>(data);
+            auto* info = static_cast<std::tuple<GtkRenderer*, GtkWidget*, size_t, bool, size_t>*>(data);
             GtkRenderer* self = std::get<0>(*info);
             GtkWidget* progressDlg = std::get<1>(*info);
             size_t analyzedCount = std::get<2>(*info);
             bool cancelled = std::get<3>(*info);
+            size_t lostCount = std::get<4>(*info);
             
             gtk_widget_destroy(progressDlg);
             
             char message[512];
-            float percentAnalyzed = self->filteredMedia_.empty() ? 0.0f : 
-                                   (float)analyzedCount / self->filteredMedia_.size() * 100.0f;
+            size_t totalCount = self->database_->getTotalCount();
+            float percentAnalyzed = totalCount == 0 ? 0.0f : 
+                                   (float)analyzedCount / totalCount * 100.0f;
             
             if (cancelled) {
                 snprintf(message, sizeof(message),
@@ -2643,11 +2627,17 @@ void GtkRenderer::onAnalyzeAll(GtkWidget* widget, gpointer data) {
                     "Dateien sind jetzt bereit für KI-Training!",
                     analyzedCount, percentAnalyzed);
             }
+            if (lostCount > 0) {
+                size_t used = strlen(message);
+                snprintf(message + used, sizeof(message) - used,
+                    "\n\n⚠️ %zu Ergebnisse konnten nicht gespeichert werden (Datenbank-Fehler).",
+                    lostCount);
+            }
             
             GtkWidget* resultDialog = gtk_message_dialog_new(
                 GTK_WINDOW(self->window_),
                 GTK_DIALOG_MODAL,
-                cancelled ? GTK_MESSAGE_WARNING : GTK_MESSAGE_INFO,
+                cancelled || lostCount > 0 ? GTK_MESSAGE_WARNING : GTK_MESSAGE_INFO,
                 GTK_BUTTONS_OK,
                 "%s", message);
             gtk_window_set_title(GTK_WINDOW(resultDialog), cancelled ? "Analyse abgebrochen" : "Analyse abgeschlossen");
@@ -2659,7 +2649,7 @@ void GtkRenderer::onAnalyzeAll(GtkWidget* widget, gpointer data) {
             
             delete info;
             return G_SOURCE_REMOVE;
-        }, new std::tuple<GtkRenderer*, GtkWidget*, size_t, bool>(self, progressDialog, analyzed.load(), wasCancelled));
+        }, new std::tuple<GtkRenderer*, GtkWidget*, size_t, bool, size_t>(self, progressDialog, analyzed, wasCancelled, lost));
         
     }).detach();
 }
@@ -2667,7 +2657,10 @@ void GtkRenderer::onAnalyzeAll(GtkWidget* widget, gpointer data) {
 void GtkRenderer::onRepairClipping(GtkWidget* widget, gpointer data) {
     GtkRenderer* self = static_cast<GtkRenderer*>(data);
     
-    auto allMedia = self->database_->getAll();
+    // Für die Reparatur werden nur die Pfade benötigt
+    MediaDatabase::MediaQuery pathQuery;
+    pathQuery.columns = MediaDatabase::ColIdentity;
+    auto allMedia = self->database_->getPage(pathQuery);
     
     if (allMedia.empty()) {
         GtkWidget* dialog = gtk_message_dialog_new(
@@ -3355,6 +3348,7 @@ void GtkRenderer::onBrowseLocal(GtkWidget* widget, gpointer data) {
                 meta.title = std::filesystem::path(finalPath).stem().string();
                 meta.genre = "Unknown";
                 meta.artist = "Unknown";
+                meta.fileHash = FileHasher::hashFile(finalPath);
                 meta.analyzed = false;
                 meta.addedTimestamp = std::time(nullptr);
                 
@@ -3712,6 +3706,7 @@ void GtkRenderer::onAddSelectedFiles(GtkWidget* widget, gpointer data) {
             meta.title = std::filesystem::path(finalPath).stem().string();
             meta.genre = "Unknown";
             meta.artist = "Unknown";
+            meta.fileHash = FileHasher::hashFile(finalPath);
             meta.analyzed = false;
             meta.addedTimestamp = std::time(nullptr);
             
@@ -3866,32 +3861,19 @@ void GtkRenderer::onAddCurrentFolder(GtkWidget* widget, gpointer data) {
         std::vector<std::string> allFiles;
         std::vector<std::string> errors;
         
-        // Sammle alle Dateien rekursiv
-        try {
-            std::filesystem::recursive_directory_iterator iter(folderPath, 
-                std::filesystem::directory_options::skip_permission_denied);
-            
-            for (const auto& entry : iter) {
-                try {
-                    if (entry.is_regular_file()) {
-                        std::string ext = entry.path().extension().string();
-                        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-                        // Audio-Formate
-                        if (ext == ".mp3" || ext == ".wav" || ext == ".sid" || 
-                            ext == ".flac" || ext == ".ogg" || ext == ".m4a" ||
-                            // Video-Formate
-                            ext == ".mp4" || ext == ".mkv" || ext == ".avi" || 
-                            ext == ".webm" || ext == ".mov" || ext == ".flv") {
-                            allFiles.push_back(entry.path().string());
-                        }
-                    }
-                } catch (const std::exception& e) {
-                    errors.push_back(entry.path().string() + ": " + e.what());
-                }
-            }
-        } catch (const std::exception& e) {
-            errors.push_back(folderPath + ": " + e.what());
-            std::cerr << "❌ Fehler beim Durchsuchen: " << e.what() << std::endl;
+        // Sammle alle Dateien rekursiv (parallel, nicht lesbare Verzeichnisse → errors)
+        ParallelTreeWalker::Options walkOptions;
+        walkOptions.extensions = {
+            // Audio-Formate
+            ".mp3", ".wav", ".sid", ".flac", ".ogg", ".m4a",
+            // Video-Formate
+            ".mp4", ".mkv", ".avi", ".webm", ".mov", ".flv"
+        };
+        ParallelTreeWalker walker(walkOptions);
+        allFiles = walker.collect(folderPath);
+        errors.insert(errors.end(), walker.errors().begin(), walker.errors().end());
+        if (!walker.errors().empty()) {
+            std::cerr << "❌ Fehler beim Durchsuchen: " << walker.errors().front() << std::endl;
         }
         
         total = allFiles.size();
@@ -3961,6 +3943,7 @@ void GtkRenderer::onAddCurrentFolder(GtkWidget* widget, gpointer data) {
             meta.title = std::filesystem::path(finalPath).stem().string();
             meta.genre = "Unknown";
             meta.artist = "Unknown";
+            meta.fileHash = FileHasher::hashFile(finalPath);
             meta.analyzed = false;
             meta.addedTimestamp = std::time(nullptr);
             
@@ -4547,10 +4530,10 @@ void GtkRenderer::onDBSync(GtkWidget* widget, gpointer data) {
         }
         
         size_t added = self->hvscDownloader_->addToDatabase(hvscMp3Dir, *self->database_, false);
-        self->filteredMedia_ = self->database_->getAll();
         
         gdk_threads_add_idle([](gpointer data) -> gboolean {
             auto* info = static_cast<std::pair<GtkRenderer*, size_t>*>(data);
+            info->first->refreshDatabaseView();
             
             GtkWidget* dialog = gtk_message_dialog_new(
                 GTK_WINDOW(info->first->window_),
@@ -4813,60 +4796,37 @@ void GtkRenderer::onShowDecisionHistory(GtkWidget* widget, gpointer data) {
 }
 
 void GtkRenderer::startAutoSync() {
-    autoSyncRunning_ = true;
+    const char* home = getenv("HOME");
+    if (!home) return;
     
-    autoSyncThread_ = std::thread([this]() {
-        const char* home = getenv("HOME");
-        if (!home) return;
-        
-        std::string hvscMp3Dir = std::string(home) + "/.songgen/hvsc/mp3/";
-        
-        while (autoSyncRunning_) {
-            std::this_thread::sleep_for(std::chrono::seconds(30));
-            
-            if (!fs::exists(hvscMp3Dir) || !fs::is_directory(hvscMp3Dir)) {
-                continue;
-            }
-            
-            size_t dbCount = 0;
-            {
-                auto allFiles = database_->getAll();
-                for (const auto& meta : allFiles) {
-                    if (meta.genre == "SID") dbCount++;
-                }
-            }
-            
-            size_t mp3Count = 0;
-            try {
-                for (const auto& entry : fs::recursive_directory_iterator(hvscMp3Dir)) {
-                    if (entry.is_regular_file() && entry.path().extension() == ".mp3") {
-                        mp3Count++;
-                    }
-                }
-            } catch (...) {
-                continue;
-            }
+    // Dateisystem-Events statt Rescan alle 30 s: Kosten nur bei Änderungen
+    std::string hvscMp3Dir = std::string(home) + "/.songgen/hvsc/mp3/";
+    LibraryWatcher::Options options;
+    options.journalPath = std::string(home) + "/.songgen/hvsc/mp3.journal";
+    options.makeMetadata = HVSCDownloader::makeMediaMetadata;
+    
+    libraryWatcher_ = std::make_unique<LibraryWatcher>(*database_, hvscMp3Dir, options,
+        [this](const LibraryWatcher::Changes& changes) {
+            // Liste im GUI-Thread neu laden
+            gdk_threads_add_idle([](gpointer data) -> gboolean {
+                static_cast<GtkRenderer*>(data)->refreshDatabaseView();
+                return G_SOURCE_REMOVE;
+            }, this);
             
-            if (mp3Count > 0 && dbCount < mp3Count) {
-                size_t added = hvscDownloader_->addToDatabase(hvscMp3Dir, *database_, false);
-                
-                if (added > 0) {
-                    filteredMedia_ = database_->getAll();
-                    
-                    // Desktop-Benachrichtigung
-                    std::string msg = "✅ Auto-Sync: " + std::to_string(added) + " neue SID-MP3s importiert";
-                    std::string cmd = "notify-send -a 'SongGen' '" + msg + "' 2>/dev/null &";
-                    system(cmd.c_str());
-                }
+            if (changes.added > 0) {
+                // Desktop-Benachrichtigung
+                std::string msg = "✅ Auto-Sync: " + std::to_string(changes.added) + " neue SID-MP3s importiert";
+                std::string cmd = "notify-send -a 'SongGen' '" + msg + "' 2>/dev/null &";
+                system(cmd.c_str());
             }
-        }
-    });
+        });
+    libraryWatcher_->start();
 }
 
 void GtkRenderer::stopAutoSync() {
-    autoSyncRunning_ = false;
-    if (autoSyncThread_.joinable()) {
-        autoSyncThread_.join();
+    if (libraryWatcher_) {
+        libraryWatcher_->stop();
+        libraryWatcher_.reset();
     }
 }
 
@@ -4888,22 +4848,7 @@ void GtkRenderer::sortDatabaseBy(const std::string& column) {
         sortAscending_ = true;
     }
     
-    // Sortiere filteredMedia_
-    std::sort(filteredMedia_.begin(), filteredMedia_.end(), 
-        [this, column](const MediaMetadata& a, const MediaMetadata& b) {
-            bool result = false;
-            if (column == "title") {
-                result = a.title < b.title;
-            } else if (column == "artist") {
-                result = a.artist < b.artist;
-            } else if (column == "genre") {
-                result = a.genre < b.genre;
-            } else if (column == "duration") {
-                result = a.duration < b.duration;
-            }
-            return sortAscending_ ? result : !result;
-        });
-    
+    // Sortierung übernimmt die Abfrage in refreshDatabaseView()
     refreshDatabaseView();
     
     std::string msg = "Sortiert nach " + column + (sortAscending_ ? " ↑" : " ↓");
@@ -5441,14 +5386,12 @@ void GtkRenderer::onEditHistoryMetadata(GtkWidget* widget, gpointer data) {
     }
     
     // Lade Metadaten aus Datenbank
-    auto allMedia = self->database_->getAll();
-    MediaMetadata* targetMeta = nullptr;
-    for (auto& meta : allMedia) {
-        if (meta.filepath == filepath) {
-            targetMeta = &meta;
-            break;
-        }
-    }
+    MediaDatabase::MediaQuery pathQuery;
+    pathQuery.where = "filepath = ?";
+    pathQuery.params = {filepath};
+    pathQuery.limit = 1;
+    auto allMedia = self->database_->getPage(pathQuery);
+    MediaMetadata* targetMeta = allMedia.empty() ? nullptr : &allMedia.front();
     
     if (!targetMeta) {
         GtkWidget* dialog = gtk_message_dialog_new(
@@ -5826,8 +5769,9 @@ void GtkRenderer::onAnalyzeDatabase(GtkWidget* widget, gpointer data) {
                 
                 gtk_widget_destroy(progressDlg);
                 
-                float correctionPercent = self->filteredMedia_.empty() ? 0.0f :
-                    (float)corrections / self->filteredMedia_.size() * 100.0f;
+                size_t totalCount = self->database_->getTotalCount();
+                float correctionPercent = totalCount == 0 ? 0.0f :
+                    (float)corrections / totalCount * 100.0f;
                 
                 char message[512];
                 snprintf(message, sizeof(message),
@@ -5950,17 +5894,22 @@ void GtkRenderer::onLearnSongStructure(GtkWidget* widget, gpointer data) {
         std::cout << "🎵 Starte Song-Struktur-Analyse" 
                   << (targetGenre.empty() ? "" : " für Genre: " + targetGenre) << "...\n";
         
-        auto allMedia = self->database_->getAll();
+        // Brauchen BPM für Struktur-Analyse; Genre-Filter in SQL
+        MediaDatabase::MediaQuery query;
+        query.columns = MediaDatabase::ColTags | MediaDatabase::ColAnalysis;
+        query.where = "bpm > 0";
+        if (!targetGenre.empty()) {
+            query.where += " AND genre = ?";
+            query.params.push_back(targetGenre);
+        }
+        auto allMedia = self->database_->getPage(query);
         std::vector<AudioAnalyzer::SongStructure> structures;
         
         for (const auto& media : allMedia) {
-            if (!targetGenre.empty() && media.genre != targetGenre) continue;
-            if (media.bpm <= 0) continue;  // Brauchen BPM für Struktur-Analyse
             
-            std::vector<float> samples;
-            int sampleRate;
-            if (self->analyzer_->loadAudioFile(media.filepath, samples, sampleRate)) {
-                auto structure = self->analyzer_->analyzeSongStructure(samples, sampleRate, media.bpm);
+            FeatureFrames frames;
+            if (self->analyzer_->loadFeatureFrames(media.filepath, frames)) {
+                auto structure = self->analyzer_->analyzeSongStructure(frames, media.bpm);
                 structures.push_back(structure);
                 
                 if (structures.size() % 10 == 0) {
@@ -6266,8 +6215,11 @@ void GtkRenderer::onInteractiveTraining(GtkWidget* widget, gpointer data) {
     gtk_label_set_selectable(GTK_LABEL(statusLabel), TRUE);
     gtk_box_pack_start(GTK_BOX(searchVbox), statusLabel, FALSE, FALSE, 0);
     
-    // Lade alle Medien
-    auto allMedia = self->database_->getAll();
+    // Für Suche und Autovervollständigung reichen Tags + Analyse-Spalten;
+    // die Review-Queue lädt die ausgewählten Tracks vollständig nach
+    MediaDatabase::MediaQuery searchQuery;
+    searchQuery.columns = MediaDatabase::ColTags | MediaDatabase::ColAnalysis;
+    auto allMedia = self->database_->getPage(searchQuery);
     
     // Fülle Autovervollständigung (auch nicht-analysierte Tracks)
     for (const auto& media : allMedia) {
@@ -6447,17 +6399,12 @@ void GtkRenderer::onInteractiveTraining(GtkWidget* widget, gpointer data) {
         for (gint64 trackId : result->selectedIds) {
             std::cout << "   → Suche Track-ID: " << trackId << "\n";
             
-            bool found = false;
-            for (const auto& media : allMedia) {
-                if (media.id == trackId) {
-                    reviewQueue.push_back(media);
-                    originalGenres.push_back(media.genre);
-                    std::cout << "   ✓ Gefunden: " << std::filesystem::path(media.filepath).filename().string() << "\n";
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) {
+            MediaMetadata media = self->database_->getById(trackId);
+            if (media.id == trackId) {
+                reviewQueue.push_back(media);
+                originalGenres.push_back(media.genre);
+                std::cout << "   ✓ Gefunden: " << std::filesystem::path(media.filepath).filename().string() << "\n";
+            } else {
                 std::cout << "   ❌ Track-ID " << trackId << " nicht in allMedia gefunden!\n";
             }
         }
@@ -6476,8 +6423,8 @@ void GtkRenderer::onInteractiveTraining(GtkWidget* widget, gpointer data) {
             return;
         }
     } else if (response == GTK_RESPONSE_ACCEPT) {
-        // Alle Tracks (auch neue/unanalysierte)
-        for (const auto& media : allMedia) {
+        // Alle Tracks (auch neue/unanalysierte) - vollständige Zeilen für die Korrektur
+        for (const auto& media : self->database_->getAll()) {
             reviewQueue.push_back(media);
             // Bei neuen Tracks "Unknown" als Original-Genre verwenden
             originalGenres.push_back(media.genre.empty() ? "Unknown" : media.genre);
@@ -6961,7 +6908,7 @@ void GtkRenderer::startIdleLearning() {
     
     // Initialisiere Datenbank-Größe für Änderungs-Erkennung
     if (database_) {
-        lastDatabaseSize_ = database_->getAll().size();
+        lastDatabaseSize_ = database_->getTotalCount();
     }
     
     // Starte Idle-Check-Timer (alle 1 Sekunde)
@@ -7046,7 +6993,7 @@ void GtkRenderer::idleLearningLoop() {
         
         // Überwache Datenbank-Änderungen (alle 5 Sekunden)
         if (idleSecondsCounter_ % 5 == 0 && database_) {
-            size_t currentSize = database_->getAll().size();
+            size_t currentSize = database_->getTotalCount();
             if (currentSize != lastDatabaseSize_) {
                 lastDatabaseSize_ = currentSize;
                 if (!hasMoreToLearn_ && currentSize > 0) {
@@ -7107,9 +7054,7 @@ void GtkRenderer::performIdleLearningTask() {
     
     // 1. Analysiere Datenbank für Pattern
     if (trainingModel_ && database_) {
-        auto allMedia = database_->getAll();
-        
-        if (!allMedia.empty()) {
+        if (database_->getTotalCount() > 0) {
             // Lerne aus existierenden Correction-Patterns
             if (idleSecondsCounter_ % 15 == 0) {  // Alle 15 Sekunden
                 std::cout << "   🔍 Analysiere Genre-Patterns..." << std::endl;
@@ -7185,15 +7130,15 @@ void GtkRenderer::performIdleLearningTask() {
     // 3. Lerne Rhythmus-Patterns aus der Datenbank
     if (idleSecondsCounter_ % 30 == 0 && database_) {  // Alle 30 Sekunden
         std::cout << "   🎼 Analysiere Rhythmus-Patterns..." << std::endl;
-        auto allMedia = database_->getAll();
-        
         // Gruppiere nach Genre und analysiere BPM-Patterns
         std::map<std::string, std::vector<float>> bpmByGenre;
-        for (const auto& m : allMedia) {
-            if (m.bpm > 0) {
-                bpmByGenre[m.genre].push_back(m.bpm);
-            }
-        }
+        MediaDatabase::MediaQuery query;
+        query.columns = MediaDatabase::ColTags | MediaDatabase::ColAnalysis;
+        query.where = "bpm > 0";
+        database_->iterate(query, [&bpmByGenre](const MediaMetadata& m) {
+            bpmByGenre[m.genre].push_back(m.bpm);
+            return true;
+        });
         
         for (const auto& [genre, bpms] : bpmByGenre) {
             if (bpms.size() >= 5) {
@@ -7211,11 +7156,17 @@ void GtkRenderer::performIdleLearningTask() {
     if (idleSecondsCounter_ % 60 == 0 && database_) {  // Jede Minute
         std::cout << "   🧹 Cleanup und Wartung..." << std::endl;
         
-        // Entferne kaputte Referenzen
-        auto allMedia = database_->getAll();
+        // Entferne kaputte Referenzen (nur Pfade lesen)
+        std::vector<std::string> paths;
+        MediaDatabase::MediaQuery query;
+        query.columns = MediaDatabase::ColIdentity;
+        database_->iterate(query, [&paths](const MediaMetadata& m) {
+            paths.push_back(m.filepath);
+            return true;
+        });
         int cleanedUp = 0;
-        for (const auto& m : allMedia) {
-            if (!std::filesystem::exists(m.filepath)) {
+        for (const auto& path : paths) {
+            if (!std::filesystem::exists(path)) {
                 cleanedUp++;
             }
         }
@@ -7475,20 +7426,19 @@ void GtkRenderer::onLearnArtistStyle(GtkWidget* widget, gpointer data) {
 
 // 🤖 Automatisches Genre-Learning: Lerne aus bereits korrigierten Tracks
 void GtkRenderer::autoLearnGenresFromCorrectedTracks() {
-    auto allMedia = database_->getAll();
-    if (allMedia.empty()) return;
-    
     // Schritt 1: Sammle korrigierte Tracks als Trainingsbeispiele
+    // Nur Tracks die korrigiert wurden (lastUsed > 0) und ein Genre haben
     std::map<std::string, std::vector<MediaMetadata>> genreExamples;
     int correctedCount = 0;
     
-    for (const auto& media : allMedia) {
-        // Nur Tracks die korrigiert wurden (lastUsed > 0) und ein Genre haben
-        if (media.lastUsed > 0 && media.genre != "Unknown" && !media.genre.empty() && media.analyzed) {
-            genreExamples[media.genre].push_back(media);
-            correctedCount++;
-        }
-    }
+    MediaDatabase::MediaQuery exampleQuery;
+    exampleQuery.columns = MediaDatabase::ColTags | MediaDatabase::ColStyle | MediaDatabase::ColAnalysis;
+    exampleQuery.where = "lastUsed > 0 AND genre != 'Unknown' AND genre != '' AND analyzed = 1";
+    database_->iterate(exampleQuery, [&](const MediaMetadata& media) {
+        genreExamples[media.genre].push_back(media);
+        correctedCount++;
+        return true;
+    });
     
     if (correctedCount == 0) {
         std::cout << "ℹ️ Keine korrigierten Tracks zum Lernen gefunden." << std::endl;
@@ -7555,10 +7505,12 @@ void GtkRenderer::autoLearnGenresFromCorrectedTracks() {
     
     std::cout << "\n🔍 Klassifiziere Unknown-Tracks..." << std::endl;
     
-    for (auto media : allMedia) {
-        if (media.genre != "Unknown" && !media.genre.empty()) continue;
-        if (!media.analyzed) continue;  // Nur analysierte Tracks
-        
+    // Nur analysierte Tracks; vollständige Zeilen, da sie zurückgeschrieben werden
+    MediaDatabase::MediaQuery unknownQuery;
+    unknownQuery.where = "(genre = 'Unknown' OR genre = '' OR genre IS NULL) AND analyzed = 1";
+    unknownQuery.limit = 50;
+    
+    for (auto media : database_->getPage(unknownQuery)) {
         unknownCount++;
         
         // Finde ähnlichstes Genre-Profil
@@ -7611,8 +7563,7 @@ void GtkRenderer::onSuggestGenreTags(GtkWidget* widget, gpointer data) {
     
     if (!self->trainingModel_) return;
     
-    auto allMedia = self->database_->getAll();
-    if (allMedia.empty()) {
+    if (self->database_->getTotalCount() == 0) {
         GtkWidget* dialog = gtk_message_dialog_new(
             GTK_WINDOW(self->window_), GTK_DIALOG_MODAL,
             GTK_MESSAGE_INFO, GTK_BUTTONS_OK,
@@ -7623,13 +7574,15 @@ void GtkRenderer::onSuggestGenreTags(GtkWidget* widget, gpointer data) {
     }
     
     // Analysiere alle Tracks und schlage Tags vor
-    std::thread([self, allMedia]() {
+    std::thread([self]() {
         int updated = 0;
         int analyzed = 0;
         
-        for (auto media : allMedia) {
-            if (!media.analyzed || media.genre == "Unknown") continue;
-            
+        // Nur analysierte Tracks mit bekanntem Genre (vollständige Zeilen für updateMedia)
+        MediaDatabase::MediaQuery query;
+        query.where = "analyzed = 1 AND (genre IS NULL OR genre != 'Unknown')";
+        
+        for (auto media : self->database_->getPage(query)) {
             analyzed++;
             
             // Schlage Genre-Tags vor
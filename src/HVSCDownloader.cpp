@@ -3,6 +3,13 @@
 #include "MediaDatabase.h"
 #include "AudioAnalyzer.h"
 #include "ExtractConfig.h"
+#include "FileHasher.h"
+#include "WorkStealingPool.h"
+#include "SIDRenderScheduler.h"
+#include "MP3EncoderPool.h"
+#include "ParallelTreeWalker.h"
+#include "ArchiveExtractor.h"
+#include "SegmentedDownloader.h"
 #include <curl/curl.h>
 #include <iostream>
 #include <fstream>
@@ -14,6 +21,9 @@
 #include <thread>
 #include <atomic>
 #include <memory>
+#include <unordered_set>
+#include <cctype>
+#include <strings.h>
 
 namespace fs = std::filesystem;
 
@@ -35,16 +45,23 @@ std::string HVSCDownloader::findFastestMirror() {
     
     std::cout << "🌐 Testing mirror speeds...\n";
     
+    // Alle Mirrors gleichzeitig anfragen (je die ersten 100KB)
+    std::vector<std::string> testUrls;
+    for (const auto& mirror : mirrors_) {
+        testUrls.push_back(mirror + "C64Music.zip");
+    }
+    auto results = SegmentedDownloader::probe(testUrls);
+    
     std::string fastestMirror = mirrors_[0];
     float fastestSpeed = 0.0f;
     
-    for (const auto& mirror : mirrors_) {
-        float speed = testMirrorSpeed(mirror);
-        std::cout << "  " << mirror << ": " << speed << " KB/s\n";
+    for (size_t i = 0; i < mirrors_.size(); ++i) {
+        float speed = results[i].ok ? static_cast<float>(results[i].bytesPerSecond / 1024.0) : 0.0f;
+        std::cout << "  " << mirrors_[i] << ": " << speed << " KB/s\n";
         
         if (speed > fastestSpeed) {
             fastestSpeed = speed;
-            fastestMirror = mirror;
+            fastestMirror = mirrors_[i];
         }
     }
     
@@ -53,42 +70,6 @@ std::string HVSCDownloader::findFastestMirror() {
     return fastestMirror;
 }
 
-float HVSCDownloader::testMirrorSpeed(const std::string& mirrorUrl) {
-    CURL* curl = curl_easy_init();
-    if (!curl) return 0.0f;
-    
-    // Download ersten 100KB zum Testen
-    std::string testUrl = mirrorUrl + "C64Music.zip";
-    
-    auto startTime = std::chrono::high_resolution_clock::now();
-    
-    // Callback der Download verwirft
-    auto writeCallback = [](void* ptr, size_t size, size_t nmemb, void* data) -> size_t {
-        return size * nmemb;  // Verwerfe Daten
-    };
-    
-    curl_easy_setopt(curl, CURLOPT_URL, testUrl.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +writeCallback);
-    curl_easy_setopt(curl, CURLOPT_RANGE, "0-102400");  // Nur 100KB
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    
-    CURLcode res = curl_easy_perform(curl);
-    
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-    
-    curl_easy_cleanup(curl);
-    
-    if (res != CURLE_OK || duration.count() == 0) {
-        return 0.0f;
-    }
-    
-    // KB/s berechnen
-    float speed = 100.0f / (duration.count() / 1000.0f);
-    return speed;
-}
-
 bool HVSCDownloader::downloadHVSC(
     const std::string& targetDir,
     std::function<void(size_t, size_t, float)> progressCallback,
@@ -135,10 +116,21 @@ bool HVSCDownloader::downloadHVSC(
         }
     } else {
         // Download
-        success = downloadFile(hvscUrl, targetPath, progressCallback);
+        success = downloadFile(hvscUrl, targetPath, progressCallback, stopFlag);
     }
     
-    if (success && !cancelRequested_) {
+    if (success && !cancelRequested_ && autoConvertAndImport && ArchiveExtractor::available()) {
+        // Entpacken und Konvertieren überlappen: jede SID wird eingeplant, sobald sie geschrieben ist
+        ExtractConfig cfg = autoTuneExtractConfig();
+        size_t converted = extractAndConvertArchive(targetPath, expandedDir, expandedDir + "/mp3", cfg.threads,
+            [progressCallback](size_t current, size_t total) {
+                if (progressCallback) {
+                    progressCallback(current, total, 0.0f);
+                }
+            },
+            stopFlag, &success);
+        std::cout << "✅ " << converted << " SID-Dateien konvertiert\n";
+    } else if (success && !cancelRequested_) {
         std::cout << "📦 Extracting HVSC archive...\n";
         success = extractArchive(targetPath, expandedDir);
         
@@ -214,70 +206,113 @@ bool HVSCDownloader::downloadHVSC(
     return success;
 }
 
-struct DownloadProgress {
-    std::function<void(size_t, size_t, float)> callback;
-    std::chrono::high_resolution_clock::time_point startTime;
-    size_t lastBytes = 0;
-};
+namespace {
 
-static int progressCallbackStatic(void* clientp, curl_off_t dltotal, curl_off_t dlnow, 
-                                   curl_off_t ultotal, curl_off_t ulnow) {
-    DownloadProgress* progress = static_cast<DownloadProgress*>(clientp);
+// Veröffentlichte Prüfsumme neben dem Archiv (<url>.sha256), leer wenn keine vorhanden
+std::string fetchPublishedSha256(const std::string& url) {
+    CURL* curl = curl_easy_init();
+    if (!curl) return "";
     
-    if (progress->callback && dltotal > 0) {
-        auto now = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - progress->startTime);
-        
-        float speed = 0.0f;
-        if (duration.count() > 0) {
-            speed = (dlnow - progress->lastBytes) / (duration.count() / 1000.0f) / 1024.0f;  // KB/s
-            progress->lastBytes = dlnow;
-            progress->startTime = now;
-        }
-        
-        progress->callback(dlnow, dltotal, speed);
-    }
+    std::string content;
+    auto writeCallback = [](void* ptr, size_t size, size_t nmemb, void* data) -> size_t {
+        std::string* text = static_cast<std::string*>(data);
+        if (text->size() > 4096) return 0;  // Keine Prüfsummendatei
+        text->append(static_cast<char*>(ptr), size * nmemb);
+        return size * nmemb;
+    };
+    
+    std::string shaUrl = url + ".sha256";
+    curl_easy_setopt(curl, CURLOPT_URL, shaUrl.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +writeCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &content);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
     
-    return 0;
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+    if (res != CURLE_OK || content.size() < 64) return "";
+    
+    // Format "sha256sum": <64 Hex-Zeichen> <Dateiname>
+    std::string hex = content.substr(0, 64);
+    bool valid = std::all_of(hex.begin(), hex.end(), [](unsigned char c) { return std::isxdigit(c); });
+    return valid ? hex : "";
 }
 
+} // namespace
+
 bool HVSCDownloader::downloadFile(
     const std::string& url,
     const std::string& targetPath,
-    std::function<void(size_t, size_t, float)> progressCallback) {
+    std::function<void(size_t, size_t, float)> progressCallback,
+    std::atomic<bool>* stopFlag) {
     
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        std::cerr << "Failed to initialize CURL" << std::endl;
-        return false;
+    SegmentedDownloader::Options options;
+    options.expectedSha256 = fetchPublishedSha256(url);
+    options.stopFlag = stopFlag;
+    if (progressCallback) {
+        options.onProgress = [progressCallback](const SegmentedDownloader::Progress& progress) {
+            if (progress.bytesTotal == 0) return;  // Größe unbekannt
+            progressCallback(progress.bytesDone, progress.bytesTotal, progress.bytesPerSecond / 1024.0f);  // KB/s
+        };
     }
     
-    FILE* fp = fopen(targetPath.c_str(), "wb");
-    if (!fp) {
-        curl_easy_cleanup(curl);
+    SegmentedDownloader downloader(options);
+    if (!downloader.download(url, targetPath)) {
+        std::cerr << "❌ Download fehlgeschlagen: " << downloader.error() << "\n";
         return false;
     }
     
-    DownloadProgress progress;
-    progress.callback = progressCallback;
-    progress.startTime = std::chrono::high_resolution_clock::now();
-    
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
-    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progressCallbackStatic);
-    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &progress);
-    
-    CURLcode res = curl_easy_perform(curl);
-    
-    fclose(fp);
-    curl_easy_cleanup(curl);
-    
-    return res == CURLE_OK;
+    if (downloader.resumedBytes() > 0) {
+        std::cout << "⏩ Fortgesetzt ab " << (downloader.resumedBytes() / (1024*1024)) << " MB\n";
+    }
+    std::cout << "🔒 SHA-256: " << downloader.sha256()
+              << (options.expectedSha256.empty() ? "" : " (geprüft)") << "\n";
+    return true;
+}
+
+namespace {
+
+void printExtractProgress(const ArchiveExtractor::Progress& progress, size_t tracksQueued = 0) {
+    float percent = progress.bytesTotal > 0 ? (progress.bytesRead * 100.0f) / progress.bytesTotal : 0.0f;
+    std::cout << "  📦 Entpackt: " << (progress.bytesRead / (1024*1024)) << " / "
+              << (progress.bytesTotal / (1024*1024)) << " MB (" << std::fixed << std::setprecision(1)
+              << percent << "%), " << progress.entries << " Einträge";
+    if (tracksQueued > 0) std::cout << ", " << tracksQueued << " Tracks eingeplant";
+    std::cout << "\n";
 }
 
+} // namespace
+
 bool HVSCDownloader::extractArchive(const std::string& archivePath, const std::string& targetDir) {
+    if (ArchiveExtractor::available()) {
+        // Im Prozess, streamend aus der Datei; Zählen passiert beim Schreiben
+        std::cout << "📦 Extrahiere Archiv (libarchive)...\n";
+        ArchiveExtractor::Options options;
+        options.progressIntervalMs = 1000;
+        options.onProgress = [](const ArchiveExtractor::Progress& progress) { printExtractProgress(progress); };
+        ArchiveExtractor extractor(options);
+        
+        bool ok = extractor.extract(archivePath, targetDir);
+        const auto& progress = extractor.progress();
+        if (!ok) {
+            std::cerr << "❌ Extraktion fehlgeschlagen: " << extractor.error() << "\n";
+            return false;
+        }
+        std::cout << "✅ Extraktion abgeschlossen in " << static_cast<int>(extractor.lastSeconds()) << " Sekunden: "
+                  << progress.files << " Dateien, " << (progress.bytesWritten / (1024*1024)) << " MB\n";
+        if (extractor.skippedEntries() > 0) {
+            std::cerr << "⚠️ " << extractor.skippedEntries() << " Einträge übersprungen\n";
+        }
+        if (progress.files == 0) {
+            std::cerr << "❌ Warnung: Keine Dateien extrahiert!\n";
+            return false;
+        }
+        // Entpackte Dateien tragen die aktuelle Zeit → Songlengths-Index wird neu gebaut
+        SIDLibConverter::songlengthsChanged();
+        return true;
+    }
+    
     std::cout << "📦 Extrahiere Archiv (optimiert)...\n";
     
     // Prüfe Archiv-Größe
@@ -477,6 +512,191 @@ std::string HVSCDownloader::findLatestHVSCFile(const std::string& mirrorUrl) {
     return files[0].first;
 }
 
+namespace {
+
+// Konfiguration: MP3 oder WAV?
+const bool USE_MP3 = true;  // MP3 spart ~90% Speicher!
+const int MP3_BITRATE = 192;  // kbps
+
+std::string expandHome(const std::string& path) {
+    if (!path.empty() && path[0] == '~') {
+        const char* home = getenv("HOME");
+        if (home) {
+            return std::string(home) + path.substr(1);
+        }
+    }
+    return path;
+}
+
+// Bereits konvertierte SID (WAV oder MP3 ohne Subtune-Suffix existiert)?
+bool alreadyConverted(const std::string& sidPath, const std::unordered_set<std::string>& existingOutputs) {
+    std::string baseName = fs::path(sidPath).stem().string();
+    return existingOutputs.count(baseName + ".wav") || existingOutputs.count(baseName + ".mp3");
+}
+
+/**
+ * Ruft addJob(sub, outputPath) für jede noch nicht konvertierte Subtune auf
+ * @return Anzahl übersprungener (bereits vorhandener) Subtunes
+ */
+template <typename AddJob>
+int planSubtunes(const std::string& sidPath, int subtuneCount, const std::string& wavDir,
+                 const std::unordered_set<std::string>& existingOutputs, AddJob&& addJob) {
+    const std::string extension = USE_MP3 ? ".mp3" : ".wav";
+    std::string baseName = fs::path(sidPath).stem().string();
+    int skipped = 0;
+    
+    for (int sub = 1; sub <= subtuneCount; ++sub) {
+        std::string fileName = baseName;
+        if (subtuneCount > 1) {
+            // Format: filename_01.mp3, filename_02.mp3
+            char suffix[8];
+            snprintf(suffix, sizeof(suffix), "_%02d", sub);
+            fileName += suffix;
+        }
+        fileName += extension;
+        
+        // Überspringe bereits konvertierte Subtunes
+        if (existingOutputs.count(fileName)) {
+            skipped++;
+            continue;
+        }
+        
+        addJob(sub, (fs::path(wavDir) / fileName).string());
+    }
+    return skipped;
+}
+
+/**
+ * Rendert die eingeplanten Jobs (run) bzw. die nachgereichten (runStreaming)
+ * @return Anzahl erfolgreich konvertierter Tracks
+ */
+size_t renderJobs(SIDRenderScheduler& scheduler, bool streaming, const ExtractConfig& cfg,
+                  const std::function<void(size_t, size_t)>& progressCallback, std::atomic<bool>* stopFlag) {
+    std::atomic<size_t> lastReported{0};
+    std::vector<std::string> results;
+    std::mutex resultMutex;
+    
+    // total = bisher eingeplante Tracks (wächst im Streaming-Betrieb noch)
+    auto liveProgress = [&lastReported, &progressCallback](size_t current, size_t total) {
+        size_t last = lastReported.load(std::memory_order_relaxed);
+        if (current - last >= 100 || current == total) {
+            if (lastReported.compare_exchange_strong(last, current, std::memory_order_relaxed)) {
+                float percent = (current * 100.0f) / total;
+                std::cout << "\r  🎵 Konvertierung: " << current << "/" << total 
+                          << " (" << std::fixed << std::setprecision(1) << percent << "%)     " << std::flush;
+                if (progressCallback) progressCallback(current, total);
+            }
+        }
+    };
+    
+    // Job-Funktion (läuft im Worker, Converter gehört dem Worker)
+    const int MAX_RETRIES = 3;
+    const size_t MIN_VALID_SIZE = USE_MP3 ? 1000 : 10000; // MP3: 1KB, WAV: 10KB minimum
+    
+    // AudioAnalyzer nur für WAV-Trimming nötig, nicht für MP3 (lazy, einer pro Worker)
+    std::vector<std::unique_ptr<AudioAnalyzer>> analyzers(scheduler.threadCount());
+    
+    // MP3: Encoding läuft in eigenen Threads, die Worker emulieren nur
+    std::unique_ptr<MP3EncoderPool> encoders;
+    if (USE_MP3) {
+        encoders = std::make_unique<MP3EncoderPool>(static_cast<unsigned int>(cfg.encoderThreads));
+    }
+    
+    auto convertJob = [&](const SIDRenderScheduler::Job& task, SIDLibConverter& converter, size_t worker) {
+        AudioAnalyzer* analyzer = nullptr;
+        if (!USE_MP3) {
+            if (!analyzers[worker]) analyzers[worker] = std::make_unique<AudioAnalyzer>();
+            analyzer = analyzers[worker].get();
+        }
+        converter.setEncoderPool(encoders.get());
+        bool success = false;
+        
+        // Länge wurde beim Einplanen aus Songlengths gelesen
+        int actualTimeout = task.seconds;
+        
+        for (int retry = 0; retry < MAX_RETRIES && !success; ++retry) {
+            if (retry > 0) {
+                // Lösche fehlerhafte Datei vor Wiederholung
+                try {
+                    if (fs::exists(task.outputPath)) {
+                        fs::remove(task.outputPath);
+                    }
+                } catch (...) {}
+            }
+            
+            // Konvertierung durchführen (MP3 oder WAV) mit exakter Länge
+            bool convSuccess = false;
+            if (USE_MP3) {
+                convSuccess = converter.convertToMP3(task.sidPath, task.outputPath, actualTimeout, task.subtune, MP3_BITRATE);
+            } else {
+                convSuccess = converter.convertToWAV(task.sidPath, task.outputPath, actualTimeout, task.subtune);
+            }
+            
+            if (!convSuccess) {
+                continue; // Nächster Versuch
+            }
+            
+            // Validiere: Datei muss existieren und > 0 Bytes haben
+            std::error_code ec;
+            if (!fs::exists(task.outputPath, ec) || ec) {
+                std::cerr << "[Fehler:0] Datei nicht erstellt: " << task.outputPath << "\n";
+                continue;
+            }
+            
+            auto fileSize = fs::file_size(task.outputPath, ec);
+            if (ec || fileSize < MIN_VALID_SIZE) {
+                try {
+                    fs::remove(task.outputPath);
+                } catch (...) {}
+                continue;
+            }
+            
+            // Stille-/Fehlererkennung nur für WAV (MP3 ist bereits komprimiert)
+            if (analyzer) {
+                if (!analyzer->detectSilenceAndTrimWav(task.outputPath, task.outputPath)) {
+                    // Fehlerhaft → Datei verwerfen
+                    try {
+                        if (fs::exists(task.outputPath)) {
+                            fs::remove(task.outputPath);
+                        }
+                    } catch (...) {}
+                    success = false;
+                    break; // Keine Wiederholung
+                }
+            }
+            
+            // Erfolg!
+            std::cerr << "[✓] Track erfolgreich extrahiert!\n";
+            std::lock_guard<std::mutex> lock(resultMutex);
+            results.push_back(task.outputPath);
+            success = true;
+        }
+        
+        if (!success) {
+            std::cerr << "[Fehler:0] Konvertierung fehlgeschlagen nach " << MAX_RETRIES << " Versuchen: " << task.sidPath << "\n";
+        }
+        
+        return success;
+    };
+    
+    // Stop-Flag: laufende Jobs werden fertig, neue nicht mehr gestartet
+    if (streaming) {
+        scheduler.runStreaming(convertJob, liveProgress, stopFlag);
+    } else {
+        scheduler.run(convertJob, liveProgress, stopFlag);
+    }
+    if (stopFlag && stopFlag->load()) {
+        std::cerr << "\n⏹️ Extraktion gestoppt durch Benutzer\n";
+    }
+    std::cout << "\n";
+    scheduler.printUtilization();
+    if (encoders) encoders->printMetrics("MP3-Pipeline");
+    
+    return results.size();
+}
+
+} // namespace
+
 size_t HVSCDownloader::extractSIDsToWAV(
     const std::string& sidDir,
     const std::string& wavDir,
@@ -487,40 +707,32 @@ size_t HVSCDownloader::extractSIDsToWAV(
     std::cout << "🎵 Extracting SIDs to WAV...\n";
     
     // Expandiere Pfade (Tilde-Support)
-    auto expandPath = [](const std::string& path) -> std::string {
-        if (!path.empty() && path[0] == '~') {
-            const char* home = getenv("HOME");
-            if (home) {
-                return std::string(home) + path.substr(1);
-            }
-        }
-        return path;
-    };
-    
-    std::string expandedSidDir = expandPath(sidDir);
-    std::string expandedWavDir = expandPath(wavDir);
+    std::string expandedSidDir = expandHome(sidDir);
+    std::string expandedWavDir = expandHome(wavDir);
     
     std::cout << "  SID-Verzeichnis: " << expandedSidDir << "\n";
     std::cout << "  WAV-Ausgabe: " << expandedWavDir << "\n";
     
-    // Sammle alle SID-Dateien (überspringe bereits konvertierte)
+    // Sammle alle SID-Dateien parallel; Ausgabeverzeichnis einmal lesen statt fs::exists pro Kandidat
+    ParallelTreeWalker::Options walkOptions;
+    walkOptions.extensions = {".sid"};
+    walkOptions.stopFlag = stopFlag;
+    ParallelTreeWalker walker(walkOptions);
+    std::vector<std::string> allSids = walker.collect(expandedSidDir);
+    for (const auto& error : walker.errors()) {
+        std::cerr << "⚠️ " << error << "\n";
+    }
+    const auto existingOutputs = ParallelTreeWalker::listNames(expandedWavDir).names;
+    
+    // Überspringe bereits konvertierte SIDs
     std::vector<std::string> sidFiles;
     int skipped = 0;
-    for (const auto& entry : fs::recursive_directory_iterator(expandedSidDir)) {
-        if (entry.is_regular_file()) {
-            std::string ext = entry.path().extension().string();
-            if (ext == ".sid" || ext == ".SID") {
-                // Prüfe ob WAV oder MP3 bereits existiert
-                std::string baseName = entry.path().stem().string();
-                std::string wavPath = expandedWavDir + "/" + baseName + ".wav";
-                std::string mp3Path = expandedWavDir + "/" + baseName + ".mp3";
-                if (fs::exists(wavPath) || fs::exists(mp3Path)) {
-                    skipped++;
-                    continue;
-                }
-                sidFiles.push_back(entry.path().string());
-            }
+    for (auto& sidPath : allSids) {
+        if (alreadyConverted(sidPath, existingOutputs)) {
+            skipped++;
+            continue;
         }
+        sidFiles.push_back(std::move(sidPath));
     }
     
     if (skipped > 0) {
@@ -540,191 +752,135 @@ size_t HVSCDownloader::extractSIDsToWAV(
     // SCHRITT 1: Scanne alle SIDs und erkenne Subtunes
     std::cout << "  🔍 Scanne Subtunes..." << std::flush;
     
-    struct ConversionTask {
-        std::string sidPath;
-        std::string outputPath;  // Kann .wav oder .mp3 sein
-        int subtune;
-    };
+    // Auto-Tuning für Timeout bei der Konvertierung (hardwareabhängig)
+    ExtractConfig cfg = autoTuneExtractConfig();
     
-    // Konfiguration: MP3 oder WAV?
-    const bool USE_MP3 = true;  // MP3 spart ~90% Speicher!
-    const int MP3_BITRATE = 192;  // kbps
-    const std::string extension = USE_MP3 ? ".mp3" : ".wav";
+    // Jobs pro Subtune; Länge aus Songlengths → längste zuerst, Rest per Work-Stealing
+    SIDRenderScheduler scheduler(static_cast<unsigned int>(std::max(1, threads)));
+    
+    // Subtune-Anzahl parallel aus den SID-Headern lesen (ein kleiner Read pro Datei)
+    std::vector<int> subtuneCounts(sidFiles.size(), 1);
+    {
+        WorkStealingPool probePool(ParallelTreeWalker::defaultThreads());
+        probePool.run(sidFiles.size(), [&](size_t idx, size_t) {
+            subtuneCounts[idx] = SIDLibConverter::getSubtuneCount(sidFiles[idx]);
+        }, stopFlag);
+    }
     
-    std::vector<ConversionTask> tasks;
     int skippedTasks = 0;
-    for (const auto& sidPath : sidFiles) {
-        int subtuneCount = SIDLibConverter::getSubtuneCount(sidPath);
-        std::string baseName = fs::path(sidPath).stem().string();
-        
-        for (int sub = 1; sub <= subtuneCount; ++sub) {
-            std::string fileName = baseName;
-            if (subtuneCount > 1) {
-                // Format: filename_01.mp3, filename_02.mp3
-                char suffix[8];
-                snprintf(suffix, sizeof(suffix), "_%02d", sub);
-                fileName += suffix;
-            }
-            fileName += extension;
-            
-            std::string outputPath = (fs::path(expandedWavDir) / fileName).string();
-            
-            // Überspringe bereits konvertierte Subtunes
-            if (fs::exists(outputPath)) {
-                skippedTasks++;
-                continue;
-            }
-            
-            tasks.push_back({
-                sidPath,
-                outputPath,
-                sub
+    for (size_t i = 0; i < sidFiles.size(); ++i) {
+        const std::string& sidPath = sidFiles[i];
+        skippedTasks += planSubtunes(sidPath, subtuneCounts[i], expandedWavDir, existingOutputs,
+            [&](int sub, const std::string& outputPath) {
+                scheduler.add(sidPath, sub, outputPath, 0, cfg.timeoutSec);
             });
-        }
     }
     
     if (skippedTasks > 0) {
         std::cout << "  ⏭️ Überspringe " << skippedTasks << " bereits konvertierte Tracks\n";
     }
     
-    std::cout << "\r  ✅ Gefunden: " << tasks.size() << " Tracks aus " << sidFiles.size() << " SIDs\n";
+    std::cout << "\r  ✅ Gefunden: " << scheduler.size() << " Tracks aus " << sidFiles.size() << " SIDs\n";
     std::cout << "  📦 Format: " << (USE_MP3 ? "MP3" : "WAV") << " (" << (USE_MP3 ? std::to_string(MP3_BITRATE) + " kbps" : "16-bit PCM") << ")\n";
     
-    std::cout << "\r  ✅ Gefunden: " << tasks.size() << " Tracks aus " << sidFiles.size() << " SIDs\n";
     
     // SCHRITT 2: Parallel-Konvertierung aller Tracks
-    std::atomic<size_t> completed{0};
-    std::atomic<size_t> lastReported{0};
-    size_t total = tasks.size();
-    std::vector<std::string> results;
-    std::mutex resultMutex;
+    size_t converted = renderJobs(scheduler, false, cfg, progressCallback, stopFlag);
     
-    auto liveProgress = [total, &lastReported](size_t current) {
-        size_t last = lastReported.load(std::memory_order_relaxed);
-        if (current - last >= 100 || current == total) {
-            if (lastReported.compare_exchange_strong(last, current, std::memory_order_relaxed)) {
-                float percent = (current * 100.0f) / total;
-                std::cout << "\r  🎵 Konvertierung: " << current << "/" << total 
-                          << " (" << std::fixed << std::setprecision(1) << percent << "%)     " << std::flush;
-            }
+    std::cout << "\n✅ Extracted " << converted << " Tracks\n";
+    return converted;
+}
+
+size_t HVSCDownloader::extractAndConvertArchive(
+    const std::string& archivePath,
+    const std::string& targetDir,
+    const std::string& wavDir,
+    int threads,
+    std::function<void(size_t, size_t)> progressCallback,
+    std::atomic<bool>* stopFlag,
+    bool* extracted) {
+    
+    std::cout << "📦 Entpacke Archiv und konvertiere SIDs parallel...\n";
+    std::string expandedTargetDir = expandHome(targetDir);
+    std::string expandedWavDir = expandHome(wavDir);
+    std::cout << "  WAV-Ausgabe: " << expandedWavDir << "\n";
+    
+    fs::create_directories(expandedWavDir);
+    const auto existingOutputs = ParallelTreeWalker::listNames(expandedWavDir).names;
+    ExtractConfig cfg = autoTuneExtractConfig();
+    SIDRenderScheduler scheduler(static_cast<unsigned int>(std::max(1, threads)));
+    
+    // Alles ab hier läuft im entpackenden Thread
+    size_t sidCount = 0;
+    size_t skipped = 0;
+    size_t skippedTasks = 0;
+    auto plan = [&](const std::string& sidPath) {
+        if (alreadyConverted(sidPath, existingOutputs)) {
+            skipped++;
+            return;
         }
+        sidCount++;
+        skippedTasks += planSubtunes(sidPath, SIDLibConverter::getSubtuneCount(sidPath), expandedWavDir,
+            existingOutputs, [&](int sub, const std::string& outputPath) {
+                scheduler.push(sidPath, sub, outputPath, 0, cfg.timeoutSec);
+            });
     };
     
-    // Worker-Thread-Funktion
-    // Auto-Tuning für Timeout bei der Konvertierung (hardwareabhängig)
-    ExtractConfig cfg = autoTuneExtractConfig();
-
-    auto worker = [&, USE_MP3, MP3_BITRATE](size_t start, size_t end) {
-        SIDLibConverter converter;
-        // AudioAnalyzer nur für WAV-Trimming nötig, nicht für MP3
-        std::unique_ptr<AudioAnalyzer> analyzer;
-        if (!USE_MP3) {
-            analyzer = std::make_unique<AudioAnalyzer>();
+    // Ohne Songlengths.md5 würde jede Länge auf den Fallback fallen (und im Cache landen):
+    // SIDs, die vor der Datei aus dem Archiv kommen, werden bis dahin zurückgehalten
+    bool haveSonglengths = fs::exists(expandedTargetDir + "/C64Music/DOCUMENTS/Songlengths.md5");
+    std::vector<std::string> heldBack;
+    
+    ArchiveExtractor::Options options;
+    options.stopFlag = stopFlag;
+    options.progressIntervalMs = 1000;
+    options.onProgress = [&scheduler](const ArchiveExtractor::Progress& progress) {
+        printExtractProgress(progress, scheduler.pushed());
+    };
+    options.onFile = [&](const std::string& path) {
+        std::string name = fs::path(path).filename().string();
+        if (name == "Songlengths.md5") {
+            SIDLibConverter::songlengthsChanged();
+            haveSonglengths = true;
+            for (const auto& sidPath : heldBack) plan(sidPath);
+            heldBack.clear();
+            return;
         }
-        const int MAX_RETRIES = 3;
-        const size_t MIN_VALID_SIZE = USE_MP3 ? 1000 : 10000; // MP3: 1KB, WAV: 10KB minimum
-        
-        for (size_t i = start; i < end && i < tasks.size(); ++i) {
-            const auto& task = tasks[i];
-            bool success = false;
-            
-            // Lese tatsächliche Track-Länge aus SID-Header (falls vorhanden)
-            int trackLength = SIDLibConverter::getTrackLength(task.sidPath, task.subtune);
-            int actualTimeout = (trackLength > 0) ? trackLength : cfg.timeoutSec;
-            
-            // SCHRITT 2: Volle Konvertierung nur wenn hörbar
-            for (int retry = 0; retry < MAX_RETRIES && !success; ++retry) {
-                if (retry > 0) {
-                    // Lösche fehlerhafte Datei vor Wiederholung
-                    try {
-                        if (fs::exists(task.outputPath)) {
-                            fs::remove(task.outputPath);
-                        }
-                    } catch (...) {}
-                }
-                
-                // Konvertierung durchführen (MP3 oder WAV) mit exakter Länge
-                
-                bool convSuccess = false;
-                if (USE_MP3) {
-                    convSuccess = converter.convertToMP3(task.sidPath, task.outputPath, actualTimeout, task.subtune, MP3_BITRATE);
-                } else {
-                    convSuccess = converter.convertToWAV(task.sidPath, task.outputPath, actualTimeout, task.subtune);
-                }
-                
-                if (!convSuccess) {
-                    continue; // Nächster Versuch
-                }
-                
-                // Validiere: Datei muss existieren und > 0 Bytes haben
-                std::error_code ec;
-                if (!fs::exists(task.outputPath, ec) || ec) {
-                    std::cerr << "[Fehler:0] Datei nicht erstellt: " << task.outputPath << "\n";
-                    continue;
-                }
-                
-                auto fileSize = fs::file_size(task.outputPath, ec);
-                if (ec || fileSize < MIN_VALID_SIZE) {
-                    try {
-                        fs::remove(task.outputPath);
-                    } catch (...) {}
-                    continue;
-                }
-                
-                // Stille-/Fehlererkennung nur für WAV (MP3 ist bereits komprimiert)
-                if (!USE_MP3 && analyzer) {
-                    if (!analyzer->detectSilenceAndTrimWav(task.outputPath, task.outputPath)) {
-                        // Fehlerhaft → Datei verwerfen
-                        try {
-                            if (fs::exists(task.outputPath)) {
-                                fs::remove(task.outputPath);
-                            }
-                        } catch (...) {}
-                        success = false;
-                        break; // Keine Wiederholung
-                    }
-                }
-                
-                // Erfolg!
-                std::cerr << "[✓] Track erfolgreich extrahiert!\n";
-                std::lock_guard<std::mutex> lock(resultMutex);
-                results.push_back(task.outputPath);
-                success = true;
-            }
-            
-            if (!success) {
-                std::cerr << "[Fehler:0] Konvertierung fehlgeschlagen nach " << MAX_RETRIES << " Versuchen: " << task.sidPath << "\n";
-            }
-            
-            liveProgress(++completed);
-            
-            // Check Stop-Flag
-            if (stopFlag && stopFlag->load()) {
-                std::cerr << "\n⏹️ Extraktion gestoppt durch Benutzer\n";
-                return;
+        if (name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".sid") == 0) {
+            if (haveSonglengths) {
+                plan(path);
+            } else {
+                heldBack.push_back(path);
             }
         }
     };
     
-    // Starte Worker-Threads
-    std::vector<std::thread> workers;
-    size_t tasksPerThread = (tasks.size() + threads - 1) / threads;
-    
-    for (int t = 0; t < threads; ++t) {
-        size_t start = t * tasksPerThread;
-        size_t end = std::min(start + tasksPerThread, tasks.size());
-        if (start < tasks.size()) {
-            workers.emplace_back(worker, start, end);
+    ArchiveExtractor extractor(options);
+    bool ok = false;
+    std::thread producer([&]() {
+        ok = extractor.extract(archivePath, expandedTargetDir);
+        if (!(stopFlag && stopFlag->load())) {
+            for (const auto& sidPath : heldBack) plan(sidPath);   // Archiv ohne Songlengths.md5
         }
-    }
+        scheduler.close();
+    });
     
-    // Warte auf Completion
-    for (auto& w : workers) {
-        if (w.joinable()) w.join();
+    size_t converted = renderJobs(scheduler, true, cfg, progressCallback, stopFlag);
+    producer.join();
+    
+    if (ok) {
+        std::cout << "✅ Entpackt in " << static_cast<int>(extractor.lastSeconds()) << " Sekunden: "
+                  << extractor.progress().files << " Dateien, " << sidCount << " neue SIDs\n";
+    } else {
+        std::cerr << "❌ Extraktion fehlgeschlagen: " << extractor.error() << "\n";
     }
+    if (skipped > 0 || skippedTasks > 0) {
+        std::cout << "⏭️ Übersprungen (bereits konvertiert): " << skipped << " SIDs, " << skippedTasks << " Tracks\n";
+    }
+    std::cout << "✅ Extracted " << converted << " Tracks\n";
     
-    std::cout << "\n✅ Extracted " << results.size() << " Tracks\n";
-    return results.size();
+    if (extracted) *extracted = ok;
+    return converted;
 }
 
 size_t HVSCDownloader::addToDatabase(
@@ -745,39 +901,60 @@ size_t HVSCDownloader::addToDatabase(
         return 0;
     }
     
-    size_t count = 0;
-    size_t total = 0;
-    
-    for (const auto& entry : fs::recursive_directory_iterator(wavDir)) {
-        if (entry.is_regular_file()) {
-            std::string ext = entry.path().extension().string();
-            // Akzeptiere sowohl WAV als auch MP3
-            if (ext == ".wav" || ext == ".mp3") {
-                total++;
-                MediaMetadata meta;
-                meta.filepath = entry.path().string();
-                meta.title = entry.path().stem().string();
-                meta.genre = "SID";  // HVSC SIDs
-                meta.artist = "C64";
-                meta.analyzed = false;
-                meta.addedTimestamp = std::time(nullptr);
-                
-                if (db.addMedia(meta)) {
-                    count++;
-                    if (count % 100 == 0) {
-                        std::cout << "  Hinzugefügt: " << count << " / " << total << "\n";
-                    }
-                } else {
-                    // Fehler beim Hinzufügen (z.B. Duplikat) - ignorieren
-                }
-            }
+    // Pfade sammeln, dann Content-Hashes parallel berechnen (I/O-bound)
+    // Akzeptiere sowohl WAV als auch MP3
+    ParallelTreeWalker::Options walkOptions;
+    walkOptions.extensions = {".wav", ".mp3"};
+    ParallelTreeWalker walker(walkOptions);
+    std::vector<std::string> files = walker.collect(wavDir);
+    for (const auto& error : walker.errors()) {
+        std::cerr << "⚠️ " << error << "\n";
+    }
+    
+    // Bekannte Pfade vorab aussortieren: gehasht werden nur neue Dateien
+    const size_t walked = files.size();
+    files.erase(std::remove_if(files.begin(), files.end(),
+                               [&db](const std::string& path) { return db.existsByPath(path); }),
+                files.end());
+    
+    const size_t total = files.size();
+    std::vector<std::string> hashes(total);
+    WorkStealingPool pool;
+    pool.run(total, [&](size_t idx, size_t) {
+        hashes[idx] = FileHasher::hashFile(files[idx]);
+    });
+    
+    MediaDatabase::WriteBatch batch(db);  // Commit pro Chunk bzw. Sekunde statt pro Datei
+    
+    for (size_t i = 0; i < total; ++i) {
+        // false = Pfad oder Inhalt schon vorhanden - ignorieren
+        batch.add(makeMediaMetadata(files[i], hashes[i]));
+        if ((i + 1) % 100 == 0) {
+            std::cout << "  Hinzugefügt: " << batch.written() << " / " << total << "\n";
         }
     }
+    if (!batch.commit() || batch.failed() > 0) {
+        std::cerr << "❌ " << batch.failed() << " Einträge konnten nicht gespeichert werden\n";
+    }
+    size_t count = batch.written();
     
-    std::cout << "✅ " << count << " von " << total << " Audio-Dateien zur Datenbank hinzugefügt\n";
+    std::cout << "✅ " << count << " von " << walked << " Audio-Dateien zur Datenbank hinzugefügt ("
+              << walked - total << " bereits bekannt)\n";
     return count;
 }
 
+MediaMetadata HVSCDownloader::makeMediaMetadata(const std::string& filepath, const std::string& fileHash) {
+    MediaMetadata meta;
+    meta.filepath = filepath;
+    meta.title = fs::path(filepath).stem().string();
+    meta.genre = "SID";  // HVSC SIDs
+    meta.artist = "C64";
+    meta.fileHash = fileHash;
+    meta.analyzed = false;
+    meta.addedTimestamp = std::time(nullptr);
+    return meta;
+}
+
 void HVSCDownloader::cancel() {
     cancelRequested_ = true;
 }
@@ -1,6 +1,7 @@
 #include "ImGuiRenderer.h"
 #include "Logger.h"
 #include "AudioAnalyzer.h"
+#include "FileHasher.h"
 #include "imgui.h"
 #include "imgui_impl_sdl2.h"
 #include "imgui_impl_sdlrenderer2.h"
@@ -96,6 +97,8 @@ bool ImGuiRenderer::initialize(int width, int height) {
         std::cerr << "Failed to initialize database" << std::endl;
         return false;
     }
+    mediaPager_ = std::make_unique<MediaPager>(
+        *database_, MediaDatabase::ColTags | MediaDatabase::ColStyle | MediaDatabase::ColAnalysis);
     
     analyzer_ = std::make_unique<AudioAnalyzer>();
     fileBrowser_ = std::make_unique<FileBrowser>();
@@ -113,8 +116,8 @@ bool ImGuiRenderer::initialize(int width, int height) {
         fileBrowser_->navigate(home);
     }
     
-    // Lade Datenbank
-    filteredMedia_ = database_->getAll();
+    // Lade Datenbank (erste Seite + Zähler)
+    reloadMediaList();
     
     running_ = true;
     
@@ -162,65 +165,30 @@ bool ImGuiRenderer::initialize(int width, int height) {
 }
 
 void ImGuiRenderer::startAutoSync() {
-    autoSyncRunning_ = true;
-    
-    autoSyncThread_ = std::thread([this]() {
-        const char* home = getenv("HOME");
-        if (!home) return;
-        
-        std::string hvscMp3Dir = std::string(home) + "/.songgen/hvsc/mp3/";
-        
-        while (autoSyncRunning_) {
-            // Prüfe alle 30 Sekunden
-            std::this_thread::sleep_for(std::chrono::seconds(30));
-            
-            if (!fs::exists(hvscMp3Dir) || !fs::is_directory(hvscMp3Dir)) {
-                continue;
-            }
-            
-            // Zähle DB-Einträge und MP3-Dateien
-            size_t dbCount = 0;
-            {
-                auto allFiles = database_->getAll();
-                for (const auto& meta : allFiles) {
-                    if (meta.genre == "SID") dbCount++;
-                }
-            }
-            
-            size_t mp3Count = 0;
-            try {
-                for (const auto& entry : fs::recursive_directory_iterator(hvscMp3Dir)) {
-                    if (entry.is_regular_file() && entry.path().extension() == ".mp3") {
-                        mp3Count++;
-                    }
-                }
-            } catch (...) {
-                continue; // Fehler beim Iterator ignorieren
-            }
-            
-            // Import wenn Differenz (nur SID-Dateien als MP3)
-            if (mp3Count > 0 && dbCount < mp3Count) {
-                std::string msg = "🔄 Auto-Sync: " + std::to_string(mp3Count) + " MP3s, " + 
-                                  std::to_string(dbCount) + " SIDs in DB → Importiere " + 
-                                  std::to_string(mp3Count - dbCount);
-                addLogMessage(msg);
-                
-                size_t added = hvscDownloader_->addToDatabase(hvscMp3Dir, *database_, false);
-                
-                if (added > 0) {
-                    filteredMedia_ = database_->getAll();
-                    std::string successMsg = "✅ Auto-Sync: " + std::to_string(added) + " neue SID-MP3s importiert";
-                    addLogMessage(successMsg);
-                }
-            }
-        }
-    });
+    const char* home = getenv("HOME");
+    if (!home) return;
+    
+    // Dateisystem-Events statt Rescan alle 30 s: Kosten nur bei Änderungen
+    std::string hvscMp3Dir = std::string(home) + "/.songgen/hvsc/mp3/";
+    LibraryWatcher::Options options;
+    options.journalPath = std::string(home) + "/.songgen/hvsc/mp3.journal";
+    options.makeMetadata = HVSCDownloader::makeMediaMetadata;
+    
+    libraryWatcher_ = std::make_unique<LibraryWatcher>(*database_, hvscMp3Dir, options,
+        [this](const LibraryWatcher::Changes& changes) {
+            mediaListDirty_ = true;
+            std::string msg = "✅ Auto-Sync: " + std::to_string(changes.added) + " neu, " +
+                              std::to_string(changes.removed) + " entfernt, " +
+                              std::to_string(changes.moved) + " verschoben";
+            addLogMessage(msg);
+        });
+    libraryWatcher_->start();
 }
 
 void ImGuiRenderer::stopAutoSync() {
-    autoSyncRunning_ = false;
-    if (autoSyncThread_.joinable()) {
-        autoSyncThread_.join();
+    if (libraryWatcher_) {
+        libraryWatcher_->stop();
+        libraryWatcher_.reset();
     }
 }
 
@@ -261,6 +229,11 @@ void ImGuiRenderer::run() {
             }
         }
         
+        // Datenbank-Ansicht nach Änderungen aus Hintergrund-Threads neu laden
+        if (mediaListDirty_) {
+            reloadMediaList();
+        }
+        
         // ImGui New Frame
         ImGui_ImplSDLRenderer2_NewFrame();
         ImGui_ImplSDL2_NewFrame();
@@ -295,7 +268,7 @@ void ImGuiRenderer::run() {
             }
         } else {
             // Default Status Info
-            ImGui::Text("📊 DB: %zu Einträge", filteredMedia_.size());
+            ImGui::Text("📊 DB: %zu Einträge", mediaTotalCount_);
             ImGui::SameLine(200);
             
             if (audioPlayer_->isPlaying()) {
@@ -364,10 +337,55 @@ void ImGuiRenderer::renderMainMenu() {
     }
 }
 
+void ImGuiRenderer::reloadMediaList() {
+    mediaListDirty_ = false;
+    
+    // Filter und Sortierung laufen in SQLite - der Pager lädt nur sichtbare Zeilen nach
+    MediaDatabase::MediaQuery query;
+    std::vector<std::string> conditions;
+    if (!genreFilter_.empty()) {
+        conditions.push_back("genre = ?");
+        query.params.push_back(genreFilter_);
+    }
+    if (!styleFilter_.empty()) {
+        conditions.push_back("(instr(mood, ?) > 0 OR instr(genre, ?) > 0)");
+        query.params.insert(query.params.end(), {styleFilter_, styleFilter_});
+    }
+    for (const auto& condition : conditions) {
+        if (!query.where.empty()) query.where += " AND ";
+        query.where += condition;
+    }
+    
+    // Suchtext über den Volltextindex (Präfix je Wort)
+    query.search = searchQuery_;
+    
+    // "Original": Suchtreffer nach Relevanz, ohne Suche neueste zuerst
+    static const char* kSortOrders[] = {
+        "addedTimestamp DESC", "title ASC", "title DESC", "genre ASC", "bpm ASC", "bpm DESC"
+    };
+    if (mediaSortMode_ < 0 || mediaSortMode_ >= static_cast<int>(IM_ARRAYSIZE(kSortOrders))) {
+        mediaSortMode_ = 0;
+    }
+    if (mediaSortMode_ != 0 || searchQuery_.empty()) {
+        query.orderBy = kSortOrders[mediaSortMode_];
+    }
+    
+    mediaPager_->setQuery(query);
+    if (selectedMediaIndex_ >= static_cast<int>(mediaPager_->size())) {
+        selectedMediaIndex_ = -1;
+    }
+    
+    mediaTotalCount_ = database_->getTotalCount();
+    mediaAnalyzedCount_ = database_->countWhere("analyzed = 1 AND genre != ''");
+    mediaWithMoodCount_ = database_->countWhere("mood != ''");
+    mediaGenres_ = database_->getAllGenres();
+    mediaListGeneration_++;
+}
+
 void ImGuiRenderer::renderDatabaseBrowser() {
     ImGui::Begin("Datenbank Browser", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
     
-    ImGui::Text("🗂️ Medien-Datenbank: %zu Einträge", filteredMedia_.size());
+    ImGui::Text("🗂️ Medien-Datenbank: %zu / %zu Einträge", mediaPager_->size(), mediaTotalCount_);
     
     // Audio-Player-Controls
     if (!currentlyPlaying_.empty()) {
@@ -407,7 +425,10 @@ void ImGuiRenderer::renderDatabaseBrowser() {
     
     // Suche und Filter
     static char searchBuf[256] = "";
-    ImGui::InputText("🔍 Suche", searchBuf, sizeof(searchBuf));
+    if (ImGui::InputText("🔍 Suche", searchBuf, sizeof(searchBuf))) {
+        searchQuery_ = searchBuf;
+        mediaListDirty_ = true;
+    }
     
     ImGui::SameLine();
     if (ImGui::Button("➕ Zur Datenbank hinzufügen")) {
@@ -419,14 +440,21 @@ void ImGuiRenderer::renderDatabaseBrowser() {
     if (ImGui::Button("🔄 Fehlende Dateien bereinigen")) {
         // Entferne DB-Einträge für nicht existierende Dateien
         std::thread([this]() {
-            auto allMedia = database_->getAll();
+            // Nur id + Pfad lesen; Dateisystem-Prüfung erst nach dem Durchlauf
+            std::vector<std::pair<int64_t, std::string>> entries;
+            MediaDatabase::MediaQuery query;
+            query.columns = MediaDatabase::ColIdentity;
+            database_->iterate(query, [&entries](const MediaMetadata& meta) {
+                entries.emplace_back(meta.id, meta.filepath);
+                return true;
+            });
             size_t removed = 0;
             
-            addLogMessage("🔍 Prüfe " + std::to_string(allMedia.size()) + " Datenbank-Einträge...");
+            addLogMessage("🔍 Prüfe " + std::to_string(entries.size()) + " Datenbank-Einträge...");
             
-            for (const auto& meta : allMedia) {
-                if (!std::filesystem::exists(meta.filepath)) {
-                    database_->deleteMedia(meta.id);
+            for (const auto& entry : entries) {
+                if (!std::filesystem::exists(entry.second)) {
+                    database_->deleteMedia(entry.first);
                     removed++;
                     if (removed % 100 == 0) {
                         addLogMessage("🗑️ Entfernt: " + std::to_string(removed) + " fehlende Dateien");
@@ -436,7 +464,7 @@ void ImGuiRenderer::renderDatabaseBrowser() {
             
             if (removed > 0) {
                 addLogMessage("✅ " + std::to_string(removed) + " fehlende Einträge aus DB entfernt");
-                filteredMedia_ = database_->getAll();
+                mediaListDirty_ = true;
             } else {
                 addLogMessage("✅ Alle Dateien vorhanden - keine Bereinigung nötig");
             }
@@ -455,7 +483,7 @@ void ImGuiRenderer::renderDatabaseBrowser() {
             ImGui::Text("⚠️ WARNUNG: Alle Datenbank-Einträge werden gelöscht!");
             ImGui::Text("Diese Aktion kann nicht rückgängig gemacht werden.");
             ImGui::Separator();
-            ImGui::Text("Aktuell: %zu Einträge in der Datenbank", filteredMedia_.size());
+            ImGui::Text("Aktuell: %zu Einträge in der Datenbank", mediaTotalCount_);
             ImGui::Separator();
             
             if (ImGui::Button("✅ Ja, wirklich löschen", ImVec2(200, 0))) {
@@ -464,18 +492,25 @@ void ImGuiRenderer::renderDatabaseBrowser() {
                 
                 // Lösche alle Einträge asynchron
                 std::thread([this]() {
-                    auto allMedia = database_->getAll();
-                    deleteTotal_ = allMedia.size();
+                    // Nur die IDs lesen, gelöscht wird nach dem Durchlauf
+                    std::vector<int64_t> ids;
+                    MediaDatabase::MediaQuery query;
+                    query.columns = MediaDatabase::ColIdentity;
+                    database_->iterate(query, [&ids](const MediaMetadata& meta) {
+                        ids.push_back(meta.id);
+                        return true;
+                    });
+                    deleteTotal_ = ids.size();
                     
                     addLogMessage("🗑️ Lösche " + std::to_string(deleteTotal_.load()) + " Datenbank-Einträge...");
                     
-                    for (const auto& meta : allMedia) {
-                        database_->deleteMedia(meta.id);
+                    for (int64_t id : ids) {
+                        database_->deleteMedia(id);
                         deleteProgress_++;
                     }
                     
                     addLogMessage("✅ Datenbank vollständig geleert!");
-                    filteredMedia_.clear();
+                    mediaListDirty_ = true;
                     isDeleting_ = false;
                 }).detach();
             }
@@ -532,8 +567,22 @@ void ImGuiRenderer::renderDatabaseBrowser() {
                             if (entry.is_regular_file()) {
                                 std::string ext = entry.path().extension().string();
                                 if (ext == ".wav" || ext == ".WAV" || ext == ".mp3" || ext == ".MP3") {
+                                    // Bekannte Pfade ohne Hashen überspringen, byte-identische
+                                    // Dateien nicht erneut analysieren
+                                    if (database_->existsByPath(entry.path().string())) continue;
+                                    std::string fileHash = FileHasher::hashFile(entry.path().string());
+                                    if (database_->existsByHash(fileHash)) continue;
+                                    
                                     MediaMetadata meta;
+                                    meta.fileHash = fileHash;
                                     if (analyzer.analyze(entry.path().string(), meta)) {
+                                        meta.analyzed = true;
+                                        auto duplicates = database_->checkDuplicate(meta);
+                                        if (!duplicates.empty()) {
+                                            addLogMessage("🔁 Duplikat übersprungen: " + entry.path().string() +
+                                                          " ≈ " + duplicates.front().filepath1);
+                                            continue;
+                                        }
                                         database_->addMedia(meta);
                                         added++;
                                         if (added % 100 == 0) {
@@ -544,14 +593,28 @@ void ImGuiRenderer::renderDatabaseBrowser() {
                             }
                         }
                         addLogMessage("✅ " + std::to_string(added) + " Dateien zur Datenbank hinzugefügt");
-                        filteredMedia_ = database_->getAll();
+                        mediaListDirty_ = true;
                     } else if (std::filesystem::is_regular_file(pathStr)) {
                         // Einzelne Datei
                         MediaMetadata meta;
-                        if (analyzer.analyze(pathStr, meta)) {
-                            database_->addMedia(meta);
-                            addLogMessage("✅ Datei zur Datenbank hinzugefügt: " + pathStr);
-                            filteredMedia_ = database_->getAll();
+                        if (database_->existsByPath(pathStr)) {
+                            addLogMessage("🔁 Datei bereits in der Datenbank: " + pathStr);
+                            return;
+                        }
+                        meta.fileHash = FileHasher::hashFile(pathStr);
+                        if (database_->existsByHash(meta.fileHash)) {
+                            addLogMessage("🔁 Identische Datei bereits in der Datenbank: " + pathStr);
+                        } else if (analyzer.analyze(pathStr, meta)) {
+                            meta.analyzed = true;
+                            auto duplicates = database_->checkDuplicate(meta);
+                            if (!duplicates.empty()) {
+                                addLogMessage("🔁 Duplikat von " + duplicates.front().filepath1 + " (" +
+                                              duplicates.front().reason + "): " + pathStr);
+                            } else {
+                                database_->addMedia(meta);
+                                addLogMessage("✅ Datei zur Datenbank hinzugefügt: " + pathStr);
+                                mediaListDirty_ = true;
+                            }
                         } else {
                             addLogMessage("❌ Fehler beim Analysieren: " + pathStr);
                         }
@@ -572,40 +635,29 @@ void ImGuiRenderer::renderDatabaseBrowser() {
         ImGui::EndPopup();
     }
     
-    // Genre-Filter
-    auto genres = database_->getAllGenres();
+    // Genre-Filter (Liste wird mit der Seite geladen)
     static int selectedGenre = 0;
     std::vector<const char*> genreItems;
     genreItems.push_back("Alle");
-    for (const auto& g : genres) genreItems.push_back(g.c_str());
+    for (const auto& g : mediaGenres_) genreItems.push_back(g.c_str());
+    if (selectedGenre >= static_cast<int>(genreItems.size())) selectedGenre = 0;
     
-    ImGui::Combo("Genre", &selectedGenre, genreItems.data(), genreItems.size());
+    if (ImGui::Combo("Genre", &selectedGenre, genreItems.data(), genreItems.size())) {
+        genreFilter_ = selectedGenre > 0 ? genreItems[selectedGenre] : "";
+        mediaListDirty_ = true;
+    }
     
-    // Sortierung
-    static int sortMode = 0;
+    // Sortierung (läuft in SQLite, siehe reloadMediaList)
     const char* sortItems[] = {"Original", "Titel A-Z", "Titel Z-A", "Genre A-Z", "BPM aufsteigend", "BPM absteigend"};
-    ImGui::Combo("Sortierung", &sortMode, sortItems, IM_ARRAYSIZE(sortItems));
-    
-    // Sortiere filteredMedia_ basierend auf sortMode
-    if (sortMode == 1) { // Titel A-Z
-        std::sort(filteredMedia_.begin(), filteredMedia_.end(), 
-            [](const MediaMetadata& a, const MediaMetadata& b) { return a.title < b.title; });
-    } else if (sortMode == 2) { // Titel Z-A
-        std::sort(filteredMedia_.begin(), filteredMedia_.end(), 
-            [](const MediaMetadata& a, const MediaMetadata& b) { return a.title > b.title; });
-    } else if (sortMode == 3) { // Genre A-Z
-        std::sort(filteredMedia_.begin(), filteredMedia_.end(), 
-            [](const MediaMetadata& a, const MediaMetadata& b) { return a.genre < b.genre; });
-    } else if (sortMode == 4) { // BPM aufsteigend
-        std::sort(filteredMedia_.begin(), filteredMedia_.end(), 
-            [](const MediaMetadata& a, const MediaMetadata& b) { return a.bpm < b.bpm; });
-    } else if (sortMode == 5) { // BPM absteigend
-        std::sort(filteredMedia_.begin(), filteredMedia_.end(), 
-            [](const MediaMetadata& a, const MediaMetadata& b) { return a.bpm > b.bpm; });
-    }
-    
-    // Tabelle mit Play-Button
-    if (ImGui::BeginTable("MediaTable", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+    if (ImGui::Combo("Sortierung", &mediaSortMode_, sortItems, IM_ARRAYSIZE(sortItems))) {
+        mediaListDirty_ = true;
+    }
+    
+    // Tabelle mit Play-Button; scrollbar mit fester Höhe, damit der Clipper
+    // nur die sichtbaren Zeilen anfordert
+    ImGuiTableFlags tableFlags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY;
+    if (ImGui::BeginTable("MediaTable", 6, tableFlags, ImVec2(0.0f, ImGui::GetTextLineHeightWithSpacing() * 25))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
         ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed, 40.0f);
         ImGui::TableSetupColumn("Titel");
         ImGui::TableSetupColumn("Genre");
@@ -614,32 +666,40 @@ void ImGuiRenderer::renderDatabaseBrowser() {
         ImGui::TableSetupColumn("Bass");
         ImGui::TableHeadersRow();
         
-        for (size_t i = 0; i < filteredMedia_.size(); ++i) {
-            const auto& meta = filteredMedia_[i];
-            ImGui::TableNextRow();
-            
-            // Play-Button
-            ImGui::TableNextColumn();
-            ImGui::PushID(static_cast<int>(i));
-            if (ImGui::SmallButton("▶")) {
-                if (audioPlayer_->load(meta.filepath)) {
-                    audioPlayer_->play();
-                    currentlyPlaying_ = meta.title;
-                    selectedMediaIndex_ = static_cast<int>(i);
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(mediaPager_->size()));
+        while (clipper.Step()) {
+            mediaPager_->prefetch(static_cast<size_t>(clipper.DisplayStart), static_cast<size_t>(clipper.DisplayEnd));
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                size_t i = static_cast<size_t>(row);
+                ImGui::TableNextRow();
+                const MediaMetadata* entry = mediaPager_->at(i);
+                if (!entry) continue;  // Inzwischen gelöscht
+                const auto& meta = *entry;
+                
+                // Play-Button
+                ImGui::TableNextColumn();
+                ImGui::PushID(static_cast<int>(i));
+                if (ImGui::SmallButton("▶")) {
+                    if (audioPlayer_->load(meta.filepath)) {
+                        audioPlayer_->play();
+                        currentlyPlaying_ = meta.title;
+                        selectedMediaIndex_ = static_cast<int>(i);
+                    }
                 }
+                ImGui::PopID();
+                
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", meta.title.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", meta.genre.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", meta.bpm);
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", meta.intensity.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", meta.bassLevel.c_str());
             }
-            ImGui::PopID();
-            
-            ImGui::TableNextColumn();
-            ImGui::Text("%s", meta.title.c_str());
-            ImGui::TableNextColumn();
-            ImGui::Text("%s", meta.genre.c_str());
-            ImGui::TableNextColumn();
-            ImGui::Text("%.1f", meta.bpm);
-            ImGui::TableNextColumn();
-            ImGui::Text("%s", meta.intensity.c_str());
-            ImGui::TableNextColumn();
-            ImGui::Text("%s", meta.bassLevel.c_str());
         }
         
         ImGui::EndTable();
@@ -752,10 +812,8 @@ void ImGuiRenderer::renderAnalyzer() {
             }
         );
         
-        // Update Database
-        for (const auto& meta : results) {
-            database_->updateMedia(meta);
-        }
+        // Update Database (ein Commit pro Chunk)
+        database_->updateMediaBatch(results);
         
         updateStatus("Analyse abgeschlossen!", 1.0f);
     }
@@ -791,7 +849,7 @@ void ImGuiRenderer::renderGenerator() {
     genParams_.bassLevel = bassLevels[bassIdx];
     
     // Dauer
-    ImGui::SliderInt("Dauer (Sek)", &genParams_.duration, 30, 600);
+    ImGui::SliderInt("Dauer (Sek)", &genParams_.duration, 30, 1800);
     
     // Vocals
     ImGui::Checkbox("Vocals hinzufügen", &genParams_.useVocals);
@@ -1056,10 +1114,7 @@ void ImGuiRenderer::renderHVSC() {
                     }
                 }
                 
-                size_t dbCount = 0;
-                for (const auto& meta : filteredMedia_) {
-                    if (meta.genre == "SID") dbCount++;
-                }
+                size_t dbCount = database_->getCountByGenre("SID");
                 
                 hvscPhase_ = "📊 Status: " + std::to_string(sidCount) + " SIDs | " +
                             std::to_string(mp3Count) + " MP3s | " +
@@ -1087,12 +1142,9 @@ void ImGuiRenderer::renderHVSC() {
             addLogMessage(hvscPhase_);
             
             size_t added = hvscDownloader_->addToDatabase(wavDir, *database_, false);
-            filteredMedia_ = database_->getAll();
+            mediaListDirty_ = true;
             
-            size_t dbCount = 0;
-            for (const auto& meta : filteredMedia_) {
-                if (meta.genre == "SID") dbCount++;
-            }
+            size_t dbCount = database_->getCountByGenre("SID");
             
             hvscPhase_ = "✅ DB Sync: " + std::to_string(added) + " neue, " +
                         std::to_string(dbCount) + " total in DB";
@@ -1273,10 +1325,12 @@ void ImGuiRenderer::addFilesToDatabase() {
     int added = 0;
     for (const auto& entry : selected) {
         if (entry.isDirectory) continue;  // Skip Verzeichnisse
+        if (database_->existsByPath(entry.path)) continue;  // Bekannt: nicht erneut hashen
         
         MediaMetadata meta;
         meta.filepath = entry.path;
         meta.title = entry.name;
+        meta.fileHash = FileHasher::hashFile(entry.path);
         meta.analyzed = false;
         
         if (database_->addMedia(meta)) {
@@ -1286,7 +1340,7 @@ void ImGuiRenderer::addFilesToDatabase() {
     
     fileBrowser_->deselectAll();  // Auswahl zurücksetzen
     updateStatus("✅ Dateien hinzugefügt: " + std::to_string(added), 1.0f);
-    filteredMedia_ = database_->getAll();
+    mediaListDirty_ = true;
 }
 
 void ImGuiRenderer::extractAudioToMP3() {
@@ -1369,22 +1423,14 @@ void ImGuiRenderer::renderMusicSorter() {
     ImGui::Text("📚 Zeigt erkannte Stile, Rhythmen und Genre-Kategorien");
     ImGui::Separator();
     
-    // Statistiken
-    auto allFiles = database_->getAll();
-    int analyzed = 0;
-    int withMood = 0;
-    for (const auto& file : allFiles) {
-        if (file.analyzed && !file.genre.empty()) analyzed++;
-        if (!file.mood.empty()) withMood++;
-    }
-    
+    // Statistiken (Zähler aus reloadMediaList)
     ImGui::Text("📊 Analyse-Status:");
-    ImGui::Text("  Analysiert: %d / %zu Dateien", analyzed, allFiles.size());
-    float analyzedProgress = allFiles.empty() ? 0.0f : static_cast<float>(analyzed) / allFiles.size();
+    ImGui::Text("  Analysiert: %zu / %zu Dateien", mediaAnalyzedCount_, mediaTotalCount_);
+    float analyzedProgress = mediaTotalCount_ == 0 ? 0.0f : static_cast<float>(mediaAnalyzedCount_) / mediaTotalCount_;
     ImGui::ProgressBar(analyzedProgress, ImVec2(400, 0));
     
-    ImGui::Text("  Mit Stil-Info: %d / %zu Dateien", withMood, allFiles.size());
-    float moodProgress = allFiles.empty() ? 0.0f : static_cast<float>(withMood) / allFiles.size();
+    ImGui::Text("  Mit Stil-Info: %zu / %zu Dateien", mediaWithMoodCount_, mediaTotalCount_);
+    float moodProgress = mediaTotalCount_ == 0 ? 0.0f : static_cast<float>(mediaWithMoodCount_) / mediaTotalCount_;
     ImGui::ProgressBar(moodProgress, ImVec2(400, 0));
     
     ImGui::Separator();
@@ -1395,19 +1441,14 @@ void ImGuiRenderer::renderMusicSorter() {
     ImGui::InputText("##stylefilter", styleFilter, sizeof(styleFilter));
     ImGui::SameLine();
     if (ImGui::Button("Suchen")) {
-        std::string filter = styleFilter;
-        filteredMedia_.clear();
-        for (const auto& file : allFiles) {
-            if (file.mood.find(filter) != std::string::npos || 
-                file.genre.find(filter) != std::string::npos) {
-                filteredMedia_.push_back(file);
-            }
-        }
+        styleFilter_ = styleFilter;
+        mediaListDirty_ = true;
     }
     ImGui::SameLine();
     if (ImGui::Button("Reset")) {
-        filteredMedia_ = allFiles;
+        styleFilter_.clear();
         styleFilter[0] = '\0';
+        mediaListDirty_ = true;
     }
     
     ImGui::Separator();
@@ -1422,64 +1463,55 @@ void ImGuiRenderer::renderMusicSorter() {
     ImGui::RadioButton("Nach Mood", &sortMode, 2);
     ImGui::Separator();
     
-    if (sortMode == 0) {
-        // Gruppiert nach Genre
-        auto grouped = database_->getGroupedByGenre();
-        for (const auto& [genre, files] : grouped) {
-            if (ImGui::TreeNode((genre + " (" + std::to_string(files.size()) + ")").c_str())) {
-                for (size_t i = 0; i < std::min(files.size(), size_t(5)); i++) {
-                    std::filesystem::path p(files[i].filepath);
-                    ImGui::BulletText("%s (%.0f BPM)", p.filename().c_str(), files[i].bpm);
-                }
-                if (files.size() > 5) {
-                    ImGui::TextDisabled("... und %zu weitere", files.size() - 5);
+    // Gruppen nur bei Moduswechsel oder geänderter Datenbank neu laden (nicht pro Frame)
+    static int cachedMode = -1;
+    static size_t cachedGeneration = 0;
+    static std::map<std::string, std::vector<MediaMetadata>> grouped;
+    if (sortMode != cachedMode || cachedGeneration != mediaListGeneration_) {
+        cachedMode = sortMode;
+        cachedGeneration = mediaListGeneration_;
+        if (sortMode == 0) {
+            // Gruppiert nach Genre
+            grouped = database_->getGroupedByGenre();
+        } else if (sortMode == 1) {
+            // Gruppiert nach BPM
+            grouped = database_->getGroupedByBPMRange();
+        } else {
+            // Nach Mood sortiert
+            grouped.clear();
+            auto moodFiles = database_->getAllSortedByMood();
+            for (const auto& file : moodFiles) {
+                // Extrahiere ersten Tag aus Mood
+                size_t pos = file.mood.find('#');
+                if (pos != std::string::npos) {
+                    size_t end = file.mood.find(' ', pos);
+                    std::string tag = file.mood.substr(pos, end - pos);
+                    grouped[tag].push_back(file);
                 }
-                ImGui::TreePop();
             }
         }
-    } else if (sortMode == 1) {
-        // Gruppiert nach BPM
-        auto grouped = database_->getGroupedByBPMRange();
-        for (const auto& [range, files] : grouped) {
-            if (ImGui::TreeNode((range + " (" + std::to_string(files.size()) + ")").c_str())) {
-                for (size_t i = 0; i < std::min(files.size(), size_t(5)); i++) {
-                    std::filesystem::path p(files[i].filepath);
+    }
+    
+    for (const auto& [group, files] : grouped) {
+        if (ImGui::TreeNode((group + " (" + std::to_string(files.size()) + ")").c_str())) {
+            for (size_t i = 0; i < std::min(files.size(), size_t(5)); i++) {
+                std::filesystem::path p(files[i].filepath);
+                if (sortMode == 0) {
+                    ImGui::BulletText("%s (%.0f BPM)", p.filename().c_str(), files[i].bpm);
+                } else if (sortMode == 1) {
                     ImGui::BulletText("%s (%s)", p.filename().c_str(), files[i].genre.c_str());
-                }
-                if (files.size() > 5) {
-                    ImGui::TextDisabled("... und %zu weitere", files.size() - 5);
-                }
-                ImGui::TreePop();
-            }
-        }
-    } else {
-        // Nach Mood sortiert
-        auto moodFiles = database_->getAllSortedByMood();
-        std::map<std::string, std::vector<MediaMetadata>> moodGroups;
-        for (const auto& file : moodFiles) {
-            // Extrahiere ersten Tag aus Mood
-            size_t pos = file.mood.find('#');
-            if (pos != std::string::npos) {
-                size_t end = file.mood.find(' ', pos);
-                std::string tag = file.mood.substr(pos, end - pos);
-                moodGroups[tag].push_back(file);
-            }
-        }
-        for (const auto& [mood, files] : moodGroups) {
-            if (ImGui::TreeNode((mood + " (" + std::to_string(files.size()) + ")").c_str())) {
-                for (size_t i = 0; i < std::min(files.size(), size_t(5)); i++) {
-                    std::filesystem::path p(files[i].filepath);
+                } else {
                     ImGui::BulletText("%s", p.filename().c_str());
                 }
-                if (files.size() > 5) {
-                    ImGui::TextDisabled("... und %zu weitere", files.size() - 5);
-                }
-                ImGui::TreePop();
             }
+            if (files.size() > 5) {
+                ImGui::TextDisabled("... und %zu weitere", files.size() - 5);
+            }
+            ImGui::TreePop();
         }
     }
     
-    if (allFiles.empty()) {
+    if (mediaTotalCount_ == 0) {
         ImGui::TextDisabled("Keine analysierten Dateien vorhanden.");
         ImGui::TextDisabled("Nutze den Analyse-Tab um Dateien zu analysieren.");
     }
@@ -1,5 +1,7 @@
 #include "../include/InstrumentExtractor.h"
 #include "../include/AudioAnalyzer.h"
+#include "../include/AudioStreamReader.h"
+#include "../include/SIDLibConverter.h"
 #include <sndfile.h>
 #include <cmath>
 #include <cstring>
@@ -13,42 +15,123 @@ std::vector<InstrumentSample> InstrumentExtractor::extractInstruments(
     
     std::vector<InstrumentSample> allSamples;
     
-    // Lade Audio-Datei
-    SF_INFO sfInfo;
-    std::memset(&sfInfo, 0, sizeof(sfInfo));
-    
-    SNDFILE* file = sf_open(audioPath.c_str(), SFM_READ, &sfInfo);
-    if (!file) {
-        std::cerr << "❌ Konnte Datei nicht öffnen: " << audioPath << std::endl;
-        return allSamples;
+    std::string extension = std::filesystem::path(audioPath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    const bool isSID = extension == ".sid";
+    
+    // Audio-Dateien werden gestreamt, SIDs direkt per SIDLibConverter::renderPCM
+    // gerendert (Render-Cache, kein MP3-Umweg); beide schieben Mono-Blöcke in feed()
+    AudioStreamReader reader;
+    int sampleRate = SIDLibConverter::kSampleRate;
+    if (!isSID) {
+        if (!reader.open(audioPath)) {
+            std::cerr << "❌ Konnte Datei nicht öffnen: " << audioPath << std::endl;
+            return allSamples;
+        }
+        sampleRate = reader.sampleRate();
     }
     
-    // Lese Audio-Daten
-    std::vector<float> samples(sfInfo.frames * sfInfo.channels);
-    sf_readf_float(file, samples.data(), sfInfo.frames);
-    sf_close(file);
+    std::cout << "🔍 Extrahiere Instrumente aus: " << std::filesystem::path(audioPath).filename() << std::endl;
     
-    // Konvertiere zu Mono falls nötig
-    if (sfInfo.channels > 1) {
-        std::vector<float> mono(sfInfo.frames);
-        for (sf_count_t i = 0; i < sfInfo.frames; ++i) {
-            float sum = 0.0f;
-            for (int ch = 0; ch < sfInfo.channels; ++ch) {
-                sum += samples[i * sfInfo.channels + ch];
+    // Blockweise Extraktion: Jeder Block "besitzt" 10 s, davor liegen 0.5 s Vorlauf
+    // (Onset-Historie) und danach 2 s Nachlauf (längste Samples: Bass/Lead).
+    // Treffer zählen nur, wenn sie im eigenen Bereich starten -> keine Duplikate.
+    const size_t ownedSize = static_cast<size_t>(sampleRate) * 10;
+    const size_t leadIn = static_cast<size_t>(sampleRate) / 2;
+    const size_t tail = static_cast<size_t>(sampleRate) * 2;
+    
+    // Limits pro Track (wie bisher)
+    const size_t maxKicks = 10, maxSnares = 10, maxHihats = 10, maxBass = 5, maxLeads = 5;
+    std::vector<InstrumentSample> kicks, snares, hihats, bassLines, leads;
+    
+    std::vector<float> block;           // Samples ab blockStart
+    size_t blockStart = 0;              // Absolute Position von block[0]
+    size_t ownedStart = 0;              // Beginn des eigenen Bereichs
+    bool done = false;                  // Alle Limits erreicht
+    
+    auto keep = [&](std::vector<InstrumentSample>& target, std::vector<InstrumentSample> found,
+                    size_t ownedEnd, size_t limit) {
+        for (auto& sample : found) {
+            if (target.size() >= limit) break;
+            size_t absStart = blockStart + static_cast<size_t>(sample.startTime * sampleRate + 0.5f);
+            if (absStart < ownedStart || absStart >= ownedEnd) continue;
+            
+            sample.startTime = static_cast<float>(absStart) / sampleRate;
+            size_t at = sample.description.find(" @ ");
+            if (at != std::string::npos) {
+                sample.description = sample.description.substr(0, at) + " @ " + std::to_string(sample.startTime) + "s";
             }
-            mono[i] = sum / sfInfo.channels;
+            target.push_back(std::move(sample));
         }
-        samples = std::move(mono);
-    }
+    };
     
-    std::cout << "🔍 Extrahiere Instrumente aus: " << std::filesystem::path(audioPath).filename() << std::endl;
-    
-    // Extrahiere verschiedene Instrument-Typen
-    auto kicks = findKicks(samples, sfInfo.samplerate, audioPath);
-    auto snares = findSnares(samples, sfInfo.samplerate, audioPath);
-    auto hihats = findHiHats(samples, sfInfo.samplerate, audioPath);
-    auto bassLines = findBassLines(samples, sfInfo.samplerate, audioPath);
-    auto leads = findLeads(samples, sfInfo.samplerate, audioPath);
+    auto process = [&](bool eof) {
+        size_t blockEnd = blockStart + block.size();
+        size_t ownedEnd = eof ? blockEnd : ownedStart + ownedSize;
+        
+        if (kicks.size() < maxKicks) keep(kicks, findKicks(block, sampleRate, audioPath), ownedEnd, maxKicks);
+        if (snares.size() < maxSnares) keep(snares, findSnares(block, sampleRate, audioPath), ownedEnd, maxSnares);
+        if (hihats.size() < maxHihats) keep(hihats, findHiHats(block, sampleRate, audioPath), ownedEnd, maxHihats);
+        if (bassLines.size() < maxBass) keep(bassLines, findBassLines(block, sampleRate, audioPath), ownedEnd, maxBass);
+        if (leads.size() < maxLeads) keep(leads, findLeads(block, sampleRate, audioPath), ownedEnd, maxLeads);
+        
+        // Alle Limits erreicht: Rest der Datei muss nicht mehr dekodiert/gerendert werden
+        if (kicks.size() >= maxKicks && snares.size() >= maxSnares && hihats.size() >= maxHihats &&
+            bassLines.size() >= maxBass && leads.size() >= maxLeads) {
+            done = true;
+            return;
+        }
+        
+        // Nächster Block: Vorlauf behalten, Rest verwerfen
+        ownedStart = ownedEnd;
+        size_t newBlockStart = ownedStart > leadIn ? ownedStart - leadIn : 0;
+        if (newBlockStart > blockStart) {
+            block.erase(block.begin(), block.begin() + std::min(newBlockStart - blockStart, block.size()));
+            blockStart = newBlockStart;
+        }
+    };
+    
+    // Mono-Samples anhängen, volle Blöcke (ownedStart + ownedSize + tail) sofort auswerten
+    auto feed = [&](const float* mono, size_t count) {
+        while (count > 0 && !done) {
+            size_t wanted = ownedStart + ownedSize + tail - blockStart;
+            size_t take = std::min(count, wanted - block.size());
+            block.insert(block.end(), mono, mono + take);
+            mono += take;
+            count -= take;
+            if (block.size() == wanted) process(false);
+        }
+        return !done;
+    };
+    
+    if (isSID) {
+        // Länge des Songs, der tatsächlich läuft (Start-Song), gerendert wird blockweise
+        int song = SIDLibConverter::getStartSong(audioPath);
+        int seconds = SIDLibConverter::getTrackLength(audioPath, song);
+        std::vector<float> mono;
+        bool rendered = SIDLibConverter::forThread().renderPCM(audioPath, song, seconds,
+                                                               [&](const int16_t* pcm, size_t count) {
+            const int channels = SIDLibConverter::kChannels;
+            mono.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                int sum = 0;
+                for (int c = 0; c < channels; ++c) sum += pcm[i * channels + c];
+                mono[i] = static_cast<float>(sum) / (32768.0f * channels);
+            }
+            return feed(mono.data(), count);
+        });
+        if (!rendered && !done) {
+            std::cerr << "❌ Konnte SID nicht rendern: " << audioPath << std::endl;
+            return allSamples;
+        }
+    } else {
+        std::vector<float> chunk(AudioStreamReader::kDefaultChunkFrames);
+        size_t got = 0;
+        while (!done && (got = reader.read(chunk.data(), chunk.size())) > 0) {
+            feed(chunk.data(), got);
+        }
+    }
+    if (!done && !block.empty()) process(true);
     
     // Kombiniere und filtere nach Qualität
     allSamples.insert(allSamples.end(), kicks.begin(), kicks.end());
@@ -0,0 +1,527 @@
+#include "LibraryWatcher.h"
+#include "MediaDatabase.h"
+#include "FileHasher.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_set>
+
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t kWatchMask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                IN_ONLYDIR;
+constexpr int kPollMs = 200;
+constexpr int kMissingRootRetryMs = 5000;
+constexpr const char* kJournalHeader = "SGJOURNAL 1";
+constexpr size_t kLookupChunk = 500;   // Pfade pro "filepath IN (...)"-Abfrage
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string parentOf(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos || slash == 0 ? std::string("/") : path.substr(0, slash);
+}
+
+std::string nameOf(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool isWithin(const std::string& path, const std::string& dir) {
+    return path.size() > dir.size() && path.compare(0, dir.size(), dir) == 0 && path[dir.size()] == '/';
+}
+
+} // namespace
+
+LibraryWatcher::LibraryWatcher(MediaDatabase& db, const std::string& rootDir, const Options& options,
+                               ChangeCallback onChanges)
+    : db_(db), root_(rootDir), options_(options), onChanges_(std::move(onChanges)) {
+    while (root_.size() > 1 && root_.back() == '/') root_.pop_back();
+    if (options_.journalPath.empty()) options_.journalPath = root_ + ".journal";
+    for (auto& ext : options_.extensions) {
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    }
+}
+
+LibraryWatcher::~LibraryWatcher() {
+    stop();
+}
+
+void LibraryWatcher::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread([this]() { run(); });
+}
+
+void LibraryWatcher::stop() {
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+}
+
+void LibraryWatcher::run() {
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) disableInotify(std::strerror(errno));
+
+    // Änderungen seit dem letzten Lauf nachholen und dabei die Watches setzen
+    loadJournal();
+    reconcile(root_);
+    flush();
+
+    std::vector<char> buffer(64 * 1024);
+    int64_t lastEvent = nowMs();
+    int64_t pendingSince = 0;
+    int64_t lastReconcile = lastEvent;
+
+    while (running_) {
+        int64_t now;
+        if (inotifyFd_ >= 0) {
+            pollfd pfd{inotifyFd_, POLLIN, 0};
+            int ready = ::poll(&pfd, 1, kPollMs);
+            now = nowMs();
+            if (ready > 0) {
+                ssize_t length;
+                while (inotifyFd_ >= 0 && (length = ::read(inotifyFd_, buffer.data(), buffer.size())) > 0) {
+                    processEvents(buffer.data(), static_cast<size_t>(length));
+                }
+                lastEvent = now;
+            }
+            // Wurzel fehlt noch (z.B. vor der ersten Extraktion): regelmäßig nachsehen
+            if (!watchOf_.count(root_) && now - lastReconcile >= kMissingRootRetryMs) {
+                reconcile(root_);
+                lastReconcile = now;
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kPollMs));
+            now = nowMs();
+            if (now - lastReconcile >= options_.fallbackRescanSeconds * 1000LL) {
+                reconcile(root_);
+                lastReconcile = now;
+                lastEvent = 0;
+            }
+        }
+
+        if (pending_.empty() && movedFrom_.empty()) {
+            pendingSince = 0;
+            continue;
+        }
+        if (pendingSince == 0) pendingSince = now;
+        if (now - lastEvent >= options_.debounceMs || now - pendingSince >= options_.maxBatchDelayMs) {
+            flush();
+            pendingSince = 0;
+        }
+    }
+
+    // Offene Änderungen nicht verlieren
+    flush();
+    if (inotifyFd_ >= 0) ::close(inotifyFd_);
+    inotifyFd_ = -1;
+    watchPaths_.clear();
+    watchOf_.clear();
+}
+
+void LibraryWatcher::processEvents(const char* buffer, size_t length) {
+    bool overflow = false;
+
+    for (size_t offset = 0; offset < length;) {
+        const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+        offset += sizeof(inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW) {
+            overflow = true;
+            continue;
+        }
+        auto watch = watchPaths_.find(event->wd);
+        if (watch == watchPaths_.end()) continue;
+        const std::string dir = watch->second;
+
+        if (event->mask & IN_IGNORED) {
+            auto it = watchOf_.find(dir);
+            if (it != watchOf_.end() && it->second == event->wd) watchOf_.erase(it);
+            watchPaths_.erase(watch);
+            continue;
+        }
+        if (event->len == 0) continue;
+
+        const std::string name = event->name;
+        const std::string path = dir + "/" + name;
+
+        if (event->mask & IN_ISDIR) {
+            if (event->mask & IN_CREATE) {
+                journal_[dir].subdirs.insert(name);
+                reconcile(path);
+            } else if (event->mask & IN_MOVED_TO) {
+                journal_[dir].subdirs.insert(name);
+                auto from = movedFrom_.find(event->cookie);
+                if (from != movedFrom_.end() && journal_.count(from->second)) {
+                    moveDir(from->second, path);
+                    movedFrom_.erase(from);
+                }
+                reconcile(path);
+            } else if (event->mask & IN_MOVED_FROM) {
+                // Paarung mit IN_MOVED_TO folgt; sonst entfernt flush() das Verzeichnis
+                journal_[dir].subdirs.erase(name);
+                movedFrom_[event->cookie] = path;
+            } else if (event->mask & IN_DELETE) {
+                journal_[dir].subdirs.erase(name);
+                forgetDir(path, true);
+            }
+            journalDirty_ = true;
+            continue;
+        }
+
+        if (!matchesExtension(name)) continue;
+
+        if (event->mask & IN_CLOSE_WRITE) {
+            queueUpsert(path);
+        } else if (event->mask & IN_MOVED_TO) {
+            auto from = movedFrom_.find(event->cookie);
+            if (from != movedFrom_.end()) {
+                // Umbenannt: Eintrag (samt Analyse) verschieben statt neu anlegen
+                pending_.erase(from->second);
+                pending_[path] = Pending{Pending::Move, from->second};
+                journal_[dir].files.insert(name);
+                journalDirty_ = true;
+                movedFrom_.erase(from);
+            } else {
+                queueUpsert(path);
+            }
+        } else if (event->mask & IN_MOVED_FROM) {
+            queueRemove(path);
+            movedFrom_[event->cookie] = path;
+        } else if (event->mask & IN_DELETE) {
+            queueRemove(path);
+        }
+    }
+
+    if (overflow) {
+        // Events verloren: geänderte Verzeichnisse über das Journal finden
+        std::cerr << "[LibraryWatcher] ⚠️ inotify-Überlauf, gleiche mit Journal ab\n";
+        reconcile(root_);
+    }
+}
+
+bool LibraryWatcher::flush() {
+    // Aus dem Baum verschobene Verzeichnisse (kein passendes IN_MOVED_TO)
+    for (const auto& [cookie, path] : movedFrom_) {
+        if (journal_.count(path)) forgetDir(path, true);
+    }
+    movedFrom_.clear();
+
+    if (pending_.empty()) {
+        if (journalDirty_) saveJournal();
+        return false;
+    }
+
+    std::vector<std::string> removals;
+    std::vector<std::pair<std::string, std::string>> moves;
+    std::vector<std::string> upserts;
+    std::unordered_set<std::string> unverified;
+    for (const auto& [path, change] : pending_) {
+        switch (change.kind) {
+            case Pending::Remove: removals.push_back(path); break;
+            case Pending::Move: moves.emplace_back(change.from, path); break;
+            case Pending::Upsert:
+                upserts.push_back(path);
+                if (!change.verifyContent) unverified.insert(path);
+                break;
+        }
+    }
+    pending_.clear();
+
+    Changes changes;
+    MediaDatabase::WriteBatch batch(db_);
+    for (const auto& path : removals) {
+        if (batch.remove(path)) changes.removed++;
+    }
+    for (const auto& [from, to] : moves) {
+        if (batch.move(from, to)) {
+            changes.moved++;
+        } else {
+            upserts.push_back(to);  // Alter Pfad war nicht in der DB
+        }
+    }
+    batch.commit();
+    if (batch.failed() > 0) {
+        changes.removed = changes.moved = 0;  // Zurückgerollt, nichts geändert
+    }
+    const size_t failedBefore = batch.failed();
+
+    // Neue und geänderte Dateien: Content-Hashes parallel berechnen, bevor die
+    // Schreib-Transaktion beginnt. Auch bekannte Pfade werden gehasht (außer beim
+    // Erstabgleich) - innerhalb des Debounce-Fensters überschriebene oder gelöscht
+    // und neu angelegte Dateien haben neuen Inhalt, ihre Zeile wird dann ersetzt.
+    std::unordered_map<std::string, std::string> stored;   // Pfad → gespeicherter Hash
+    for (size_t start = 0; start < upserts.size(); start += kLookupChunk) {
+        size_t end = std::min(upserts.size(), start + kLookupChunk);
+        MediaDatabase::MediaQuery query;
+        query.columns = MediaDatabase::ColUsage;
+        query.where = "filepath IN (";
+        for (size_t i = start; i < end; ++i) {
+            query.where += i > start ? ",?" : "?";
+            query.params.push_back(upserts[i]);
+        }
+        query.where += ")";
+        for (const auto& meta : db_.getPage(query)) stored[meta.filepath] = meta.fileHash;
+    }
+    upserts.erase(std::remove_if(upserts.begin(), upserts.end(),
+                                 [&](const std::string& path) {
+                                     return unverified.count(path) && stored.count(path);
+                                 }),
+                  upserts.end());
+
+    std::vector<std::string> hashes(upserts.size());
+    if (upserts.size() > 1) {
+        WorkStealingPool pool;
+        pool.run(upserts.size(), [&](size_t idx, size_t) {
+            hashes[idx] = FileHasher::hashFile(upserts[idx]);
+        });
+    } else if (!upserts.empty()) {
+        hashes[0] = FileHasher::hashFile(upserts[0]);
+    }
+    for (size_t i = 0; i < upserts.size(); ++i) {
+        if (hashes[i].empty()) continue;  // Inzwischen gelöscht oder unlesbar
+        auto known = stored.find(upserts[i]);
+        if (known == stored.end()) {
+            if (batch.add(options_.makeMetadata(upserts[i], hashes[i]))) changes.added++;
+        } else if (known->second != hashes[i]) {
+            // Neuer Inhalt unter bekanntem Pfad: Hash und Metadaten ersetzen (ID bleibt), Analyse neu
+            if (batch.update(options_.makeMetadata(upserts[i], hashes[i]))) changes.updated++;
+        }
+    }
+    batch.commit();
+    if (batch.failed() > failedBefore) changes.added = changes.updated = 0;
+
+    if (journalDirty_) saveJournal();
+    if (changes.any()) {
+        std::cout << "[LibraryWatcher] 🔄 +" << changes.added << " ~" << changes.updated << " -"
+                  << changes.removed << " ↷" << changes.moved << "\n";
+        if (onChanges_) onChanges_(changes);
+    }
+    return changes.any();
+}
+
+void LibraryWatcher::reconcile(const std::string& dir) {
+    // Watch vor dem Lesen setzen: was danach entsteht, meldet inotify
+    addWatch(dir);
+
+    struct stat st;
+    if (::stat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        forgetDir(dir, true);
+        return;
+    }
+    const int64_t mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+
+    auto known = journal_.find(dir);
+    if (known != journal_.end() && known->second.mtimeNs == mtime) {
+        // Keine Einträge hinzugekommen/entfernt: nur Unterverzeichnisse prüfen
+        std::vector<std::string> subdirs(known->second.subdirs.begin(), known->second.subdirs.end());
+        for (const auto& sub : subdirs) reconcile(dir + "/" + sub);
+        return;
+    }
+
+    DirState fresh;
+    fresh.mtimeNs = mtime;
+    DIR* handle = ::opendir(dir.c_str());
+    if (!handle) return;
+    while (dirent* entry = ::readdir(handle)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") continue;
+
+        bool isDir = entry->d_type == DT_DIR;
+        bool isFile = entry->d_type == DT_REG;
+        if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
+            struct stat entryStat;
+            if (::stat((dir + "/" + name).c_str(), &entryStat) == 0) {
+                isDir = S_ISDIR(entryStat.st_mode);
+                isFile = S_ISREG(entryStat.st_mode);
+            }
+        }
+        if (isDir) {
+            fresh.subdirs.insert(name);
+        } else if (isFile && matchesExtension(name)) {
+            fresh.files.insert(name);
+        }
+    }
+    ::closedir(handle);
+
+    DirState previous;
+    if (known != journal_.end()) previous = std::move(known->second);
+    for (const auto& name : fresh.files) {
+        if (!previous.files.count(name) && !pending_.count(dir + "/" + name)) {
+            // Verzeichnis zum ersten Mal gesehen: bekannte Einträge (z.B. importiert) nicht neu hashen
+            pending_[dir + "/" + name] = Pending{Pending::Upsert, "", known != journal_.end()};
+        }
+    }
+    for (const auto& name : previous.files) {
+        if (!fresh.files.count(name)) pending_[dir + "/" + name] = Pending{Pending::Remove, ""};
+    }
+    for (const auto& sub : previous.subdirs) {
+        if (!fresh.subdirs.count(sub)) forgetDir(dir + "/" + sub, true);
+    }
+
+    std::vector<std::string> subdirs(fresh.subdirs.begin(), fresh.subdirs.end());
+    journal_[dir] = std::move(fresh);
+    journalDirty_ = true;
+    for (const auto& sub : subdirs) reconcile(dir + "/" + sub);
+}
+
+void LibraryWatcher::forgetDir(const std::string& dir, bool queueRemovals) {
+    auto it = journal_.lower_bound(dir);
+    while (it != journal_.end() && (it->first == dir || isWithin(it->first, dir))) {
+        if (queueRemovals) {
+            for (const auto& name : it->second.files) {
+                pending_[it->first + "/" + name] = Pending{Pending::Remove, ""};
+            }
+        }
+        auto watch = watchOf_.find(it->first);
+        if (watch != watchOf_.end()) {
+            if (inotifyFd_ >= 0) inotify_rm_watch(inotifyFd_, watch->second);
+            watchPaths_.erase(watch->second);
+            watchOf_.erase(watch);
+        }
+        it = journal_.erase(it);
+        journalDirty_ = true;
+    }
+}
+
+void LibraryWatcher::moveDir(const std::string& from, const std::string& to) {
+    // Journal, Watches und DB-Einträge unter dem alten Präfix umhängen
+    std::vector<std::pair<std::string, DirState>> moved;
+    auto it = journal_.lower_bound(from);
+    while (it != journal_.end() && (it->first == from || isWithin(it->first, from))) {
+        moved.emplace_back(to + it->first.substr(from.size()), std::move(it->second));
+        for (const auto& name : moved.back().second.files) {
+            pending_[moved.back().first + "/" + name] = Pending{Pending::Move, it->first + "/" + name};
+        }
+        auto watch = watchOf_.find(it->first);
+        if (watch != watchOf_.end()) {
+            int wd = watch->second;
+            watchOf_.erase(watch);
+            watchOf_[moved.back().first] = wd;
+            watchPaths_[wd] = moved.back().first;
+        }
+        it = journal_.erase(it);
+    }
+    for (auto& [dir, state] : moved) journal_[dir] = std::move(state);
+    journalDirty_ = true;
+}
+
+bool LibraryWatcher::addWatch(const std::string& dir) {
+    if (inotifyFd_ < 0) return false;
+    int wd = inotify_add_watch(inotifyFd_, dir.c_str(), kWatchMask);
+    if (wd < 0) {
+        if (errno == ENOSPC) disableInotify("Watch-Limit erreicht (fs.inotify.max_user_watches)");
+        return false;
+    }
+    auto previous = watchOf_.find(dir);
+    if (previous != watchOf_.end() && previous->second != wd) watchPaths_.erase(previous->second);
+    watchOf_[dir] = wd;
+    watchPaths_[wd] = dir;
+    return true;
+}
+
+void LibraryWatcher::disableInotify(const char* reason) {
+    std::cerr << "[LibraryWatcher] ⚠️ inotify nicht verfügbar (" << reason << "), gleiche alle "
+              << options_.fallbackRescanSeconds << " s mit dem Journal ab\n";
+    if (inotifyFd_ >= 0) ::close(inotifyFd_);
+    inotifyFd_ = -1;
+    watchPaths_.clear();
+    watchOf_.clear();
+}
+
+void LibraryWatcher::queueUpsert(const std::string& path) {
+    auto it = pending_.find(path);
+    if (it != pending_.end() && it->second.kind == Pending::Move) return;  // Move legt Ziel schon an
+    pending_[path] = Pending{Pending::Upsert, ""};
+    journal_[parentOf(path)].files.insert(nameOf(path));
+    journalDirty_ = true;
+}
+
+void LibraryWatcher::queueRemove(const std::string& path) {
+    auto it = pending_.find(path);
+    if (it != pending_.end() && it->second.kind == Pending::Move) {
+        // Verschobene Datei wieder gelöscht: Quelle entfernen
+        pending_[it->second.from] = Pending{Pending::Remove, ""};
+    }
+    pending_[path] = Pending{Pending::Remove, ""};
+    auto dir = journal_.find(parentOf(path));
+    if (dir != journal_.end()) dir->second.files.erase(nameOf(path));
+    journalDirty_ = true;
+}
+
+bool LibraryWatcher::matchesExtension(const std::string& name) const {
+    size_t dot = name.find_last_of('.');
+    if (dot == std::string::npos) return false;
+    std::string ext = name.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return std::find(options_.extensions.begin(), options_.extensions.end(), ext) != options_.extensions.end();
+}
+
+// Format: Kopfzeile, dann pro Verzeichnis "D <mtime> <pfad>" gefolgt von "F <name>"-Zeilen
+bool LibraryWatcher::loadJournal() {
+    std::ifstream file(options_.journalPath);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    if (!std::getline(file, line) || line != kJournalHeader) return false;
+
+    DirState* current = nullptr;
+    while (std::getline(file, line)) {
+        if (line.size() < 3 || line[1] != ' ') continue;
+        if (line[0] == 'D') {
+            size_t space = line.find(' ', 2);
+            if (space == std::string::npos) continue;
+            DirState& state = journal_[line.substr(space + 1)];
+            state.mtimeNs = std::strtoll(line.c_str() + 2, nullptr, 10);
+            current = &state;
+        } else if (line[0] == 'F' && current) {
+            current->files.insert(line.substr(2));
+        }
+    }
+
+    // Unterverzeichnisse ergeben sich aus den Pfaden
+    for (const auto& [dir, state] : journal_) {
+        if (dir == root_) continue;
+        auto parent = journal_.find(parentOf(dir));
+        if (parent != journal_.end()) parent->second.subdirs.insert(nameOf(dir));
+    }
+    journalDirty_ = false;
+    return true;
+}
+
+bool LibraryWatcher::saveJournal() {
+    std::string tempPath = options_.journalPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file.is_open()) return false;
+        file << kJournalHeader << "\n";
+        for (const auto& [dir, state] : journal_) {
+            if (state.mtimeNs < 0) continue;  // Nie gelesen (nur durch Events bekannt)
+            file << "D " << state.mtimeNs << " " << dir << "\n";
+            for (const auto& name : state.files) {
+                if (name.find('\n') == std::string::npos) file << "F " << name << "\n";
+            }
+        }
+        if (!file.good()) return false;
+    }
+    if (std::rename(tempPath.c_str(), options_.journalPath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    journalDirty_ = false;
+    return true;
+}
@@ -0,0 +1,172 @@
+#include "MFCCKernel.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SONGGEN_SIMD_AVX2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SONGGEN_SIMD_NEON 1
+#endif
+
+namespace simd {
+
+const char* backendName() {
+#if defined(SONGGEN_SIMD_AVX2)
+    return "AVX2";
+#elif defined(SONGGEN_SIMD_NEON)
+    return "NEON";
+#else
+    return "Scalar";
+#endif
+}
+
+float dot(const float* a, const float* b, size_t n) {
+    size_t i = 0;
+    float sum = 0.0f;
+
+#if defined(SONGGEN_SIMD_AVX2)
+    __m256 acc = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+#if defined(__FMA__)
+        acc = _mm256_fmadd_ps(va, vb, acc);
+#else
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(va, vb));
+#endif
+    }
+    __m128 lo = _mm256_castps256_ps128(acc);
+    __m128 hi = _mm256_extractf128_ps(acc, 1);
+    lo = _mm_add_ps(lo, hi);
+    lo = _mm_hadd_ps(lo, lo);
+    lo = _mm_hadd_ps(lo, lo);
+    sum = _mm_cvtss_f32(lo);
+#elif defined(SONGGEN_SIMD_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) {
+        acc = vfmaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    sum = vaddvq_f32(acc);
+#endif
+
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+void complexPower(const std::complex<float>* bins, float* power, float* magnitude, size_t n) {
+    // std::complex<float> ist als {re, im} hintereinander gespeichert
+    const float* in = reinterpret_cast<const float*>(bins);
+    size_t k = 0;
+
+#if defined(SONGGEN_SIMD_AVX2)
+    for (; k + 8 <= n; k += 8) {
+        __m256 a = _mm256_loadu_ps(in + 2 * k);       // re0 im0 .. re3 im3
+        __m256 b = _mm256_loadu_ps(in + 2 * k + 8);   // re4 im4 .. re7 im7
+        a = _mm256_mul_ps(a, a);
+        b = _mm256_mul_ps(b, b);
+        // hadd: [p0 p1 p4 p5 | p2 p3 p6 p7] -> 64-Bit-Blöcke in Reihenfolge bringen
+        __m256 h = _mm256_hadd_ps(a, b);
+        __m256 p = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(h), 0xD8));
+        _mm256_storeu_ps(power + k, p);
+        if (magnitude) _mm256_storeu_ps(magnitude + k, _mm256_sqrt_ps(p));
+    }
+#elif defined(SONGGEN_SIMD_NEON)
+    for (; k + 4 <= n; k += 4) {
+        float32x4x2_t c = vld2q_f32(in + 2 * k);       // Deinterleave re/im
+        float32x4_t p = vmulq_f32(c.val[0], c.val[0]);
+        p = vfmaq_f32(p, c.val[1], c.val[1]);
+        vst1q_f32(power + k, p);
+        if (magnitude) vst1q_f32(magnitude + k, vsqrtq_f32(p));
+    }
+#endif
+
+    for (; k < n; ++k) {
+        float re = in[2 * k], im = in[2 * k + 1];
+        power[k] = re * re + im * im;
+        if (magnitude) magnitude[k] = std::sqrt(power[k]);
+    }
+}
+
+} // namespace simd
+
+float MelFilterbank::hzToMel(float hz) {
+    return 2595.0f * std::log10(1.0f + hz / 700.0f);
+}
+
+float MelFilterbank::melToHz(float mel) {
+    return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+MelFilterbank::MelFilterbank(int sampleRate, size_t fftSize, size_t numFilters,
+                             float minFreq, float maxFreq) {
+    if (sampleRate <= 0 || fftSize < 2 || numFilters == 0) return;
+
+    numBins_ = fftSize / 2 + 1;
+    const float nyquist = sampleRate * 0.5f;
+    if (maxFreq <= 0.0f || maxFreq > nyquist) maxFreq = nyquist;
+    minFreq = std::max(0.0f, std::min(minFreq, maxFreq));
+
+    // numFilters+2 gleichverteilte Punkte auf der Mel-Skala (Filter-Ecken) in Bin-Einheiten
+    const float melMin = hzToMel(minFreq);
+    const float melMax = hzToMel(maxFreq);
+    const float binPerHz = static_cast<float>(fftSize) / sampleRate;
+    std::vector<float> edges(numFilters + 2);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        float mel = melMin + (melMax - melMin) * i / (numFilters + 1);
+        edges[i] = melToHz(mel) * binPerHz;
+    }
+
+    filters_.resize(numFilters);
+    for (size_t m = 0; m < numFilters; ++m) {
+        const float left = edges[m], center = edges[m + 1], right = edges[m + 2];
+        size_t first = static_cast<size_t>(std::ceil(left));
+        size_t last = std::min(static_cast<size_t>(std::floor(right)), numBins_ - 1);
+
+        Filter& filter = filters_[m];
+        filter.startBin = std::min(first, numBins_ - 1);
+        for (size_t k = first; k <= last; ++k) {
+            float w = k <= center ? (k - left) / std::max(center - left, 1e-6f)
+                                  : (right - k) / std::max(right - center, 1e-6f);
+            filter.weights.push_back(std::max(0.0f, w));
+        }
+
+        // Sehr schmale Filter (tiefe Frequenzen, kleine FFT): mindestens den nächsten Bin nehmen
+        if (filter.weights.empty()) {
+            filter.startBin = std::min(static_cast<size_t>(std::lround(center)), numBins_ - 1);
+            filter.weights.push_back(1.0f);
+        }
+    }
+}
+
+void MelFilterbank::apply(const float* power, float* melOut) const {
+    for (size_t m = 0; m < filters_.size(); ++m) {
+        const Filter& filter = filters_[m];
+        melOut[m] = simd::dot(filter.weights.data(), power + filter.startBin, filter.weights.size());
+    }
+}
+
+MFCCKernel::MFCCKernel(size_t numFilters, size_t numCoeffs)
+    : numFilters_(numFilters), numCoeffs_(std::min(numCoeffs, numFilters)) {
+    // Orthonormale DCT-II: c[i] = s_i * sum_j x[j] * cos(pi * i * (j + 0.5) / N)
+    const double pi = 3.14159265358979323846;
+    dctMatrix_.resize(numCoeffs_ * numFilters_);
+    for (size_t i = 0; i < numCoeffs_; ++i) {
+        double scale = std::sqrt((i == 0 ? 1.0 : 2.0) / numFilters_);
+        for (size_t j = 0; j < numFilters_; ++j) {
+            dctMatrix_[i * numFilters_ + j] =
+                static_cast<float>(scale * std::cos(pi * i * (j + 0.5) / numFilters_));
+        }
+    }
+    logMel_.resize(numFilters_);
+}
+
+void MFCCKernel::compute(const float* melEnergies, float* mfccOut) const {
+    for (size_t j = 0; j < numFilters_; ++j) {
+        logMel_[j] = std::log(melEnergies[j] + kLogFloor);
+    }
+    for (size_t i = 0; i < numCoeffs_; ++i) {
+        mfccOut[i] = simd::dot(dctMatrix_.data() + i * numFilters_, logMel_.data(), numFilters_);
+    }
+}
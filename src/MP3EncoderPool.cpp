@@ -0,0 +1,326 @@
+#include "MP3EncoderPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <lame/lame.h>
+
+namespace {
+
+int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double toSeconds(uint64_t nanos) {
+    return static_cast<double>(nanos) / 1e9;
+}
+
+} // namespace
+
+// Zustand eines Ausgabe-Streams. Producer-Seite: current, allocated, opened.
+// Encoder-Seite: lame, file, mp3Buffer, ok.
+class MP3EncoderPool::Stream {
+public:
+    explicit Stream(size_t ringBlocks) : filled(ringBlocks), free(ringBlocks) {}
+
+    ~Stream() {
+        if (file) fclose(file);
+        if (lame) lame_close(lame);
+    }
+
+    std::string path;
+    int channels = 2;
+    lame_t lame = nullptr;
+    FILE* file = nullptr;
+    std::vector<unsigned char> mp3Buffer;
+    bool ok = true;
+
+    SPSCRingBuffer<Block> filled;   // Emulator → Encoder
+    SPSCRingBuffer<Block> free;     // Encoder → Emulator (Freiliste)
+    Block current;
+    size_t allocated = 0;
+    int64_t opened = 0;
+
+    Worker* worker = nullptr;
+    std::atomic<bool> finishing{false};
+    std::atomic<bool> done{false};
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+};
+
+MP3EncoderPool::MP3EncoderPool(unsigned int threads, size_t ringBlocks)
+    : ringBlocks_(std::max<size_t>(2, ringBlocks)) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency() / 4);
+    }
+    epochNanos_ = nowNanos();
+
+    for (unsigned int i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (auto& worker : workers_) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w]() { workerLoop(*w); });
+    }
+}
+
+MP3EncoderPool::~MP3EncoderPool() {
+    stop_ = true;
+    for (auto& worker : workers_) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+        }
+        worker->wake.notify_all();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+std::shared_ptr<MP3EncoderPool::Stream> MP3EncoderPool::open(const std::string& mp3Path, int sampleRate,
+                                                             int channels, int bitrate) {
+    auto stream = std::make_shared<Stream>(ringBlocks_);
+    stream->path = mp3Path;
+    stream->channels = channels;
+    stream->opened = nowNanos();
+
+    stream->lame = lame_init();
+    if (!stream->lame) return nullptr;
+    lame_set_in_samplerate(stream->lame, sampleRate);
+    lame_set_num_channels(stream->lame, channels);
+    lame_set_brate(stream->lame, bitrate);
+    lame_set_quality(stream->lame, 5);  // 0=best, 9=worst (5=good balance)
+    if (lame_init_params(stream->lame) < 0) return nullptr;
+
+    stream->file = fopen(mp3Path.c_str(), "wb");
+    if (!stream->file) return nullptr;
+
+    // LAME: Worst-Case 1.25 * Samples + 7200 Bytes
+    stream->mp3Buffer.resize(kBlockFrames * 5 / 4 + 7200);
+    sampleRate_ = sampleRate;
+
+    // Encoder mit den wenigsten offenen Streams
+    Worker* target = nullptr;
+    size_t fewest = 0;
+    size_t start = nextWorker_++ % workers_.size();
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        Worker* candidate = workers_[(start + i) % workers_.size()].get();
+        std::lock_guard<std::mutex> lock(candidate->mutex);
+        if (!target || candidate->streams.size() < fewest) {
+            target = candidate;
+            fewest = candidate->streams.size();
+        }
+    }
+    stream->worker = target;
+    {
+        std::lock_guard<std::mutex> lock(target->mutex);
+        target->streams.push_back(stream);
+    }
+    streams_++;
+    return stream;
+}
+
+void MP3EncoderPool::signal(Stream& stream) {
+    stream.worker->pending++;
+    stream.worker->wake.notify_one();
+}
+
+bool MP3EncoderPool::submit(Stream& stream) {
+    // Backpressure: Emulator wartet, bis der Encoder einen Block abgenommen hat
+    if (!stream.filled.tryPush(std::move(stream.current))) {
+        int64_t waitStart = nowNanos();
+        while (!stream.filled.tryPush(std::move(stream.current))) {
+            if (stop_) return false;
+            signal(stream);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        backpressureNanos_ += nowNanos() - waitStart;
+    }
+    signal(stream);
+
+    // Nächster Block aus der Freiliste, sonst neu
+    stream.current = Block();
+    if (!stream.free.tryPop(stream.current)) {
+        stream.allocated++;
+    }
+    stream.current.frames = 0;
+    stream.current.pcm.resize(kBlockFrames * stream.channels);
+    return true;
+}
+
+bool MP3EncoderPool::push(Stream& stream, const int16_t* pcm, size_t frames) {
+    if (stream.current.pcm.empty()) {
+        stream.current.pcm.resize(kBlockFrames * stream.channels);
+        stream.allocated++;
+    }
+
+    framesPushed_ += frames;
+    while (frames > 0) {
+        size_t count = std::min(frames, kBlockFrames - stream.current.frames);
+        std::memcpy(stream.current.pcm.data() + stream.current.frames * stream.channels, pcm,
+                    count * stream.channels * sizeof(int16_t));
+        stream.current.frames += count;
+        pcm += count * stream.channels;
+        frames -= count;
+
+        if (stream.current.frames == kBlockFrames && !submit(stream)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MP3EncoderPool::finish(Stream& stream) {
+    if (stream.current.frames > 0 && !submit(stream)) {
+        return false;
+    }
+
+    int64_t waitStart = nowNanos();
+    stream.finishing.store(true, std::memory_order_release);
+    signal(stream);
+    {
+        std::unique_lock<std::mutex> lock(stream.doneMutex);
+        stream.doneCv.wait(lock, [&]() { return stream.done.load() || stop_.load(); });
+    }
+    int64_t end = nowNanos();
+    finishWaitNanos_ += end - waitStart;
+    producerNanos_ += end - stream.opened;
+    return stream.done && stream.ok;
+}
+
+bool MP3EncoderPool::drain(Worker& worker, Stream& stream) {
+    if (stream.done.load(std::memory_order_acquire)) return false;
+
+    // finishing vor dem Leeren lesen: danach kommt garantiert nichts mehr nach
+    bool finishing = stream.finishing.load(std::memory_order_acquire);
+    bool worked = false;
+    int64_t start = nowNanos();
+
+    Block block;
+    while (stream.filled.tryPop(block)) {
+        worked = true;
+        if (stream.ok) {
+            int mp3Bytes = lame_encode_buffer_interleaved(stream.lame, block.pcm.data(),
+                                                          static_cast<int>(block.frames),
+                                                          stream.mp3Buffer.data(),
+                                                          static_cast<int>(stream.mp3Buffer.size()));
+            if (mp3Bytes < 0) {
+                std::cerr << "[MP3Pool] ⚠️ LAME encoding error: " << mp3Bytes << "\n";
+                stream.ok = false;
+            } else if (mp3Bytes > 0 &&
+                       fwrite(stream.mp3Buffer.data(), 1, mp3Bytes, stream.file) != static_cast<size_t>(mp3Bytes)) {
+                stream.ok = false;
+            }
+        }
+        framesEncoded_ += block.frames;
+        block.frames = 0;
+        stream.free.tryPush(std::move(block));  // Freiliste voll → Block verwerfen
+        block = Block();
+    }
+
+    if (finishing) {
+        worked = true;
+        int mp3Bytes = lame_encode_flush(stream.lame, stream.mp3Buffer.data(),
+                                         static_cast<int>(stream.mp3Buffer.size()));
+        if (mp3Bytes > 0) {
+            fwrite(stream.mp3Buffer.data(), 1, mp3Bytes, stream.file);
+        } else if (mp3Bytes < 0) {
+            std::cerr << "[MP3Pool] ⚠️ LAME flush error: " << mp3Bytes << "\n";
+            stream.ok = false;
+        }
+        if (fclose(stream.file) != 0) stream.ok = false;
+        stream.file = nullptr;
+        lame_close(stream.lame);
+        stream.lame = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(stream.doneMutex);
+            stream.done.store(true, std::memory_order_release);
+        }
+        stream.doneCv.notify_all();
+    }
+
+    if (worked) worker.busyNanos += nowNanos() - start;
+    return worked;
+}
+
+void MP3EncoderPool::workerLoop(Worker& worker) {
+    std::vector<std::shared_ptr<Stream>> streams;
+    while (true) {
+        worker.pending = 0;
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            streams = worker.streams;
+        }
+
+        bool worked = false;
+        for (auto& stream : streams) {
+            worked |= drain(worker, *stream);
+        }
+
+        if (worked) {
+            // Fertige Streams austragen
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.streams.erase(std::remove_if(worker.streams.begin(), worker.streams.end(),
+                                                [](const std::shared_ptr<Stream>& s) { return s->done.load(); }),
+                                 worker.streams.end());
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        if (stop_) break;
+        worker.wake.wait_for(lock, std::chrono::milliseconds(5),
+                             [&]() { return worker.pending.load() > 0 || stop_.load(); });
+    }
+    streams.clear();
+}
+
+MP3EncoderPool::Metrics MP3EncoderPool::metrics() const {
+    Metrics m;
+    m.streams = streams_;
+    m.framesPushed = framesPushed_;
+    m.framesEncoded = framesEncoded_;
+    m.producerSeconds = toSeconds(producerNanos_);
+    m.backpressureSeconds = toSeconds(backpressureNanos_);
+    m.finishWaitSeconds = toSeconds(finishWaitNanos_);
+    for (const auto& worker : workers_) {
+        m.encoderBusySeconds += toSeconds(worker->busyNanos);
+    }
+    m.wallSeconds = toSeconds(static_cast<uint64_t>(nowNanos() - epochNanos_));
+    return m;
+}
+
+void MP3EncoderPool::resetMetrics() {
+    streams_ = 0;
+    framesPushed_ = 0;
+    framesEncoded_ = 0;
+    producerNanos_ = 0;
+    backpressureNanos_ = 0;
+    finishWaitNanos_ = 0;
+    for (auto& worker : workers_) worker->busyNanos = 0;
+    epochNanos_ = nowNanos();
+}
+
+void MP3EncoderPool::printMetrics(const char* label) const {
+    Metrics m = metrics();
+    if (m.streams == 0) return;
+
+    const double audioPushed = static_cast<double>(m.framesPushed) / sampleRate_;
+    const double audioEncoded = static_cast<double>(m.framesEncoded) / sampleRate_;
+    const double renderSeconds = m.producerSeconds - m.backpressureSeconds - m.finishWaitSeconds;
+    const double encoderCapacity = m.wallSeconds * workers_.size();
+
+    std::cout << "📊 " << label << ": " << m.streams << " Streams, " << workers_.size() << " Encoder\n"
+              << std::fixed << std::setprecision(1)
+              << "   Emulation: " << (renderSeconds > 0.0 ? audioPushed / renderSeconds : 0.0) << "x Echtzeit/Kern"
+              << ", Backpressure " << m.backpressureSeconds << " s"
+              << " (" << (m.producerSeconds > 0.0 ? 100.0 * m.backpressureSeconds / m.producerSeconds : 0.0)
+              << "%), Restwartezeit " << m.finishWaitSeconds << " s\n"
+              << "   Encoder: " << (m.encoderBusySeconds > 0.0 ? audioEncoded / m.encoderBusySeconds : 0.0)
+              << "x Echtzeit/Kern, Auslastung "
+              << (encoderCapacity > 0.0 ? 100.0 * m.encoderBusySeconds / encoderCapacity : 0.0) << "%\n"
+              << std::defaultfloat;
+}
@@ -0,0 +1,270 @@
+#include "MeasuredLengthCache.h"
+#include "FileHasher.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Log: 8 Byte Magic, danach Records; ein abgeschnittener oder kaputter
+// Record (Absturz beim Schreiben) beendet das Einlesen
+constexpr char kLogMagic[8] = {'S', 'G', 'M', 'L', 'E', 'N', '1', '\0'};
+constexpr size_t kInitialCapacity = 64;
+
+struct LogRecord {
+    uint64_t key;
+    int32_t seconds;
+    uint32_t check;
+};
+static_assert(sizeof(LogRecord) == 16, "LogRecord muss 16 Byte groß sein");
+
+uint32_t checkOf(uint64_t key, int32_t seconds) {
+    uint64_t mixed = (key ^ static_cast<uint32_t>(seconds)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<uint32_t>(mixed >> 32) ^ 0x5347u;
+}
+
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, p, size);
+        if (written <= 0) return false;
+        p += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+MeasuredLengthCache::MeasuredLengthCache(const std::string& logPath, size_t shardCount)
+    : logPath_(logPath) {
+    size_t count = 1;
+    while (count < shardCount) count <<= 1;
+    shards_ = std::vector<Shard>(count);
+    shardMask_ = count - 1;
+
+    for (auto& shard : shards_) {
+        shard.tables.push_back(std::make_unique<Table>(kInitialCapacity));
+        shard.table.store(shard.tables.back().get(), std::memory_order_release);
+    }
+
+    if (logPath_.empty()) return;
+    std::lock_guard<std::mutex> lock(logMutex_);
+    // Fehlendes/kaputtes Log oder viele überholte Records → gleich neu schreiben
+    bool clean = loadLog();
+    if (!clean || logRecords_ > 2 * size() + 1024) {
+        compactLocked();
+    } else {
+        openLog();
+    }
+}
+
+MeasuredLengthCache::~MeasuredLengthCache() {
+    if (logFd_ >= 0) ::close(logFd_);
+}
+
+uint64_t MeasuredLengthCache::keyOf(const std::string& sidPath, int subtune) {
+    std::string key = sidPath + ":" + std::to_string(subtune);
+    uint64_t hash = FileHasher::hashBytes(key.data(), key.size());
+    return hash ? hash : 1;  // 0 markiert leere Slots
+}
+
+int MeasuredLengthCache::get(const std::string& sidPath, int subtune) const {
+    const uint64_t key = keyOf(sidPath, subtune);
+    const Table* table = shards_[shardIndex(key)].table.load(std::memory_order_acquire);
+
+    for (size_t i = key & table->mask;; i = (i + 1) & table->mask) {
+        uint64_t slotKey = table->slots[i].key.load(std::memory_order_acquire);
+        if (slotKey == key) return table->slots[i].seconds.load(std::memory_order_relaxed);
+        if (slotKey == 0) return 0;
+    }
+}
+
+bool MeasuredLengthCache::store(uint64_t key, int32_t seconds, bool log) {
+    Shard& shard = shards_[shardIndex(key)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!storeLocked(shard, key, seconds)) return false;
+
+    // Record noch unter dem Shard-Lock anhängen: konkurrierende put()/erase()
+    // desselben Schlüssels landen in derselben Reihenfolge im Log wie in der
+    // Tabelle, beim Laden gewinnt so der zuletzt gespeicherte Wert
+    if (log) append(key, seconds);
+    return true;
+}
+
+// Erwartet gesperrten shard.mutex
+bool MeasuredLengthCache::storeLocked(Shard& shard, uint64_t key, int32_t seconds) {
+    Table* table = shard.table.load(std::memory_order_relaxed);
+
+    size_t i = key & table->mask;
+    for (;; i = (i + 1) & table->mask) {
+        uint64_t slotKey = table->slots[i].key.load(std::memory_order_relaxed);
+        if (slotKey == key) {
+            int32_t previous = table->slots[i].seconds.exchange(seconds, std::memory_order_relaxed);
+            if (previous == seconds) return false;
+            if (previous == 0) count_++;
+            else if (seconds == 0) count_--;
+            return true;
+        }
+        if (slotKey == 0) break;
+    }
+    if (seconds == 0) return false;  // Entfernen eines unbekannten Schlüssels
+
+    // Wert vor dem Schlüssel veröffentlichen: Leser sehen nie einen halben Slot
+    table->slots[i].seconds.store(seconds, std::memory_order_relaxed);
+    table->slots[i].key.store(key, std::memory_order_release);
+    table->used++;
+    count_++;
+
+    // Füllgrad > 1/2: neue Tabelle mit doppelter Kapazität veröffentlichen
+    if (table->used * 2 > table->mask + 1) {
+        auto grown = std::make_unique<Table>((table->mask + 1) * 2);
+        for (size_t j = 0; j <= table->mask; ++j) {
+            uint64_t slotKey = table->slots[j].key.load(std::memory_order_relaxed);
+            if (slotKey == 0) continue;
+            size_t k = slotKey & grown->mask;
+            while (grown->slots[k].key.load(std::memory_order_relaxed) != 0) k = (k + 1) & grown->mask;
+            grown->slots[k].seconds.store(table->slots[j].seconds.load(std::memory_order_relaxed),
+                                          std::memory_order_relaxed);
+            grown->slots[k].key.store(slotKey, std::memory_order_relaxed);
+            grown->used++;
+        }
+        shard.table.store(grown.get(), std::memory_order_release);
+        shard.tables.push_back(std::move(grown));
+    }
+    return true;
+}
+
+void MeasuredLengthCache::put(const std::string& sidPath, int subtune, int seconds) {
+    if (seconds <= 0) return;
+    const uint64_t key = keyOf(sidPath, subtune);
+    store(key, seconds, true);
+}
+
+void MeasuredLengthCache::erase(const std::string& sidPath, int subtune) {
+    const uint64_t key = keyOf(sidPath, subtune);
+    store(key, 0, true);
+}
+
+void MeasuredLengthCache::append(uint64_t key, int32_t seconds) {
+    if (logPath_.empty()) return;
+    std::lock_guard<std::mutex> lock(logMutex_);
+    if (logFd_ < 0) return;
+
+    LogRecord record{key, seconds, checkOf(key, seconds)};
+    if (!writeAll(logFd_, &record, sizeof(record))) {
+        std::cerr << "[LengthCache] ⚠️ Schreiben fehlgeschlagen: " << logPath_ << "\n";
+        return;
+    }
+    logRecords_++;
+
+    // Periodisch verdichten, sobald das Log doppelt so viele Records wie Einträge hat
+    if (logRecords_ > 2 * size() + 1024) {
+        compactLocked();
+    }
+}
+
+// true wenn das Log vollständig lesbar war (sonst muss es neu geschrieben werden)
+bool MeasuredLengthCache::loadLog() {
+    std::ifstream file(logPath_, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    char magic[sizeof(kLogMagic)];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, kLogMagic, sizeof(kLogMagic)) != 0) {
+        std::cerr << "[LengthCache] ⚠️ Ungültiges Log, wird neu angelegt: " << logPath_ << "\n";
+        return false;
+    }
+
+    bool clean = true;
+    LogRecord record;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.key == 0 || record.check != checkOf(record.key, record.seconds)) {
+            clean = false;
+            break;
+        }
+        store(record.key, record.seconds, false);
+        logRecords_++;
+    }
+    // Abgeschnittener letzter Record
+    if (file.gcount() != 0) clean = false;
+
+    if (size() > 0) {
+        std::cout << "[LengthCache] 📦 Geladen: " << size() << " Einträge\n";
+    }
+    return clean;
+}
+
+bool MeasuredLengthCache::openLog() {
+    if (logFd_ >= 0) ::close(logFd_);
+    logFd_ = ::open(logPath_.c_str(), O_WRONLY | O_APPEND, 0644);
+    if (logFd_ < 0) {
+        std::cerr << "[LengthCache] ⚠️ Kann Log nicht öffnen: " << logPath_ << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool MeasuredLengthCache::compact() {
+    if (logPath_.empty()) return false;
+    std::lock_guard<std::mutex> lock(logMutex_);
+    return compactLocked();
+}
+
+// Erwartet gesperrten logMutex_. Einträge, die während des Schreibens in
+// die Tabellen kommen, hängen danach ihren Record an das neue Log an.
+bool MeasuredLengthCache::compactLocked() {
+    std::vector<LogRecord> records;
+    records.reserve(size());
+    for (const auto& shard : shards_) {
+        const Table* table = shard.table.load(std::memory_order_acquire);
+        for (size_t i = 0; i <= table->mask; ++i) {
+            uint64_t key = table->slots[i].key.load(std::memory_order_acquire);
+            int32_t seconds = table->slots[i].seconds.load(std::memory_order_relaxed);
+            if (key != 0 && seconds != 0) records.push_back(LogRecord{key, seconds, checkOf(key, seconds)});
+        }
+    }
+
+    std::string tempPath = logPath_ + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "[LengthCache] ⚠️ Kann Log nicht schreiben: " << tempPath << "\n";
+        return false;
+    }
+    bool ok = writeAll(fd, kLogMagic, sizeof(kLogMagic)) &&
+              (records.empty() || writeAll(fd, records.data(), records.size() * sizeof(LogRecord)));
+    ok = (::close(fd) == 0) && ok;
+    if (!ok || std::rename(tempPath.c_str(), logPath_.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        std::cerr << "[LengthCache] ⚠️ Verdichten fehlgeschlagen: " << logPath_ << "\n";
+        return false;
+    }
+
+    logRecords_ = records.size();
+    return openLog();
+}
+
+size_t MeasuredLengthCache::importText(const std::string& textPath) {
+    std::ifstream file(textPath);
+    if (!file.is_open()) return 0;
+
+    std::string line;
+    size_t imported = 0;
+    while (std::getline(file, line)) {
+        size_t sep = line.find('=');
+        size_t colon = line.rfind(':', sep);
+        if (sep == std::string::npos || colon == std::string::npos) continue;
+        try {
+            int subtune = std::stoi(line.substr(colon + 1, sep - colon - 1));
+            int seconds = std::stoi(line.substr(sep + 1));
+            put(line.substr(0, colon), subtune, seconds);
+            imported++;
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+    return imported;
+}
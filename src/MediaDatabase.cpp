@@ -1,4 +1,7 @@
 #include "MediaDatabase.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <filesystem>
 #include <cstring>
 #include <ctime>
@@ -7,12 +10,326 @@
 
 namespace fs = std::filesystem;
 
+namespace {
+
+// Float-Vektor als BLOB (native Byte-Reihenfolge, leer = NULL)
+void bindFloatBlob(sqlite3_stmt* stmt, int index, const std::vector<float>& values) {
+    if (values.empty()) {
+        sqlite3_bind_null(stmt, index);
+    } else {
+        sqlite3_bind_blob(stmt, index, values.data(),
+                          static_cast<int>(values.size() * sizeof(float)), SQLITE_TRANSIENT);
+    }
+}
+
+std::vector<float> columnFloatBlob(sqlite3_stmt* stmt, int column) {
+    std::vector<float> values;
+    if (column < 0) return values;
+    const void* blob = sqlite3_column_blob(stmt, column);
+    int bytes = sqlite3_column_bytes(stmt, column);
+    if (blob && bytes >= static_cast<int>(sizeof(float))) {
+        values.resize(bytes / sizeof(float));
+        std::memcpy(values.data(), blob, values.size() * sizeof(float));
+    }
+    return values;
+}
+
+std::string columnString(sqlite3_stmt* stmt, int column) {
+    const unsigned char* text = sqlite3_column_text(stmt, column);
+    return text ? reinterpret_cast<const char*>(text) : std::string();
+}
+
+// Für Writer und Reader: 256 MB mmap, 64 MB Page-Cache, Temp-Tabellen im RAM
+const std::vector<std::string> kConnectionPragmas = {
+    "PRAGMA mmap_size = 268435456",
+    "PRAGMA cache_size = -65536",
+    "PRAGMA temp_store = MEMORY"
+};
+
+constexpr size_t kReaderConnections = 4;
+
+double elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+// Spaltenliste für INSERT/Upsert (Reihenfolge = bindMediaColumns)
+#define MEDIA_WRITE_COLUMNS \
+    "INSERT INTO media (" \
+    "filepath, title, artist, bpm, duration, genre, subgenre, intensity, bassLevel, mood, " \
+    "instruments, melodySignature, rhythmPattern, spectralCentroid, spectralRolloff, " \
+    "zeroCrossingRate, mfccHash, addedTimestamp, analyzed, mfccMean, mfccVariance, fileHash" \
+    ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) "
+
+// Neuer Eintrag; vorhandener Pfad ist kein Fehler, sondern "nicht hinzugefügt"
+constexpr const char* kInsertMediaSql = MEDIA_WRITE_COLUMNS "ON CONFLICT(filepath) DO NOTHING";
+
+// Update-oder-Insert in einem Statement (addedTimestamp bleibt beim Update erhalten)
+constexpr const char* kUpsertMediaSql = MEDIA_WRITE_COLUMNS R"(ON CONFLICT(filepath) DO UPDATE SET
+    title = excluded.title, artist = excluded.artist, bpm = excluded.bpm, duration = excluded.duration,
+    genre = excluded.genre, subgenre = excluded.subgenre, intensity = excluded.intensity,
+    bassLevel = excluded.bassLevel, mood = excluded.mood, instruments = excluded.instruments,
+    melodySignature = excluded.melodySignature, rhythmPattern = excluded.rhythmPattern,
+    spectralCentroid = excluded.spectralCentroid, spectralRolloff = excluded.spectralRolloff,
+    zeroCrossingRate = excluded.zeroCrossingRate, mfccHash = excluded.mfccHash,
+    analyzed = excluded.analyzed, mfccMean = excluded.mfccMean, mfccVariance = excluded.mfccVariance,
+    fileHash = COALESCE(excluded.fileHash, media.fileHash))";
+
+#undef MEDIA_WRITE_COLUMNS
+
+void bindMediaColumns(sqlite3_stmt* stmt, const MediaMetadata& meta) {
+    int64_t timestamp = meta.addedTimestamp ? meta.addedTimestamp : std::time(nullptr);
+    
+    sqlite3_bind_text(stmt, 1, meta.filepath.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, meta.title.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, meta.artist.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_double(stmt, 4, meta.bpm);
+    sqlite3_bind_double(stmt, 5, meta.duration);
+    sqlite3_bind_text(stmt, 6, meta.genre.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 7, meta.subgenre.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 8, meta.intensity.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 9, meta.bassLevel.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 10, meta.mood.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 11, meta.instruments.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 12, meta.melodySignature.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 13, meta.rhythmPattern.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_double(stmt, 14, meta.spectralCentroid);
+    sqlite3_bind_double(stmt, 15, meta.spectralRolloff);
+    sqlite3_bind_double(stmt, 16, meta.zeroCrossingRate);
+    sqlite3_bind_double(stmt, 17, meta.mfccHash);
+    sqlite3_bind_int64(stmt, 18, timestamp);
+    sqlite3_bind_int(stmt, 19, meta.analyzed ? 1 : 0);
+    bindFloatBlob(stmt, 20, meta.mfccMean);
+    bindFloatBlob(stmt, 21, meta.mfccVariance);
+    if (meta.fileHash.empty()) {
+        sqlite3_bind_null(stmt, 22);
+    } else {
+        sqlite3_bind_text(stmt, 22, meta.fileHash.c_str(), -1, SQLITE_TRANSIENT);
+    }
+}
+
+// Spaltenindex per Name (SELECT * hängt von der Migrations-Historie ab)
+int columnIndex(sqlite3_stmt* stmt, const char* name) {
+    int count = sqlite3_column_count(stmt);
+    for (int i = 0; i < count; ++i) {
+        const char* col = sqlite3_column_name(stmt, i);
+        if (col && std::strcmp(col, name) == 0) return i;
+    }
+    return -1;
+}
+
+std::string columnText(sqlite3_stmt* stmt, int column) {
+    return column >= 0 ? columnString(stmt, column) : std::string();
+}
+
+double columnReal(sqlite3_stmt* stmt, int column) {
+    return column >= 0 ? sqlite3_column_double(stmt, column) : 0.0;
+}
+
+int64_t columnInteger(sqlite3_stmt* stmt, int column) {
+    return column >= 0 ? sqlite3_column_int64(stmt, column) : 0;
+}
+
+/**
+ * media-Zeile über Spaltennamen lesen (SELECT * oder Projektion).
+ * Positionen hängen von der Migrations-Historie ab (z.B. genreTags bei
+ * neuen DBs mitten in der Tabelle, bei alten am Ende); nicht selektierte
+ * Spalten bleiben auf dem Default.
+ */
+struct MediaRowReader {
+    int id, filepath, title, artist, bpm, duration, genre, subgenre, genreTags;
+    int intensity, bassLevel, mood, instruments, melodySignature, rhythmPattern;
+    int spectralCentroid, spectralRolloff, zeroCrossingRate, mfccHash;
+    int addedTimestamp, lastUsed, useCount, analyzed, mfccMean, mfccVariance, fileHash;
+    
+    explicit MediaRowReader(sqlite3_stmt* stmt)
+        : id(columnIndex(stmt, "id")), filepath(columnIndex(stmt, "filepath")),
+          title(columnIndex(stmt, "title")), artist(columnIndex(stmt, "artist")),
+          bpm(columnIndex(stmt, "bpm")), duration(columnIndex(stmt, "duration")),
+          genre(columnIndex(stmt, "genre")), subgenre(columnIndex(stmt, "subgenre")),
+          genreTags(columnIndex(stmt, "genreTags")), intensity(columnIndex(stmt, "intensity")),
+          bassLevel(columnIndex(stmt, "bassLevel")), mood(columnIndex(stmt, "mood")),
+          instruments(columnIndex(stmt, "instruments")), melodySignature(columnIndex(stmt, "melodySignature")),
+          rhythmPattern(columnIndex(stmt, "rhythmPattern")), spectralCentroid(columnIndex(stmt, "spectralCentroid")),
+          spectralRolloff(columnIndex(stmt, "spectralRolloff")), zeroCrossingRate(columnIndex(stmt, "zeroCrossingRate")),
+          mfccHash(columnIndex(stmt, "mfccHash")), addedTimestamp(columnIndex(stmt, "addedTimestamp")),
+          lastUsed(columnIndex(stmt, "lastUsed")), useCount(columnIndex(stmt, "useCount")),
+          analyzed(columnIndex(stmt, "analyzed")), mfccMean(columnIndex(stmt, "mfccMean")),
+          mfccVariance(columnIndex(stmt, "mfccVariance")), fileHash(columnIndex(stmt, "fileHash")) {}
+    
+    MediaMetadata read(sqlite3_stmt* stmt) const {
+        MediaMetadata meta;
+        meta.id = columnInteger(stmt, id);
+        meta.filepath = columnText(stmt, filepath);
+        meta.title = columnText(stmt, title);
+        meta.artist = columnText(stmt, artist);
+        meta.bpm = columnReal(stmt, bpm);
+        meta.duration = columnReal(stmt, duration);
+        meta.genre = columnText(stmt, genre);
+        meta.subgenre = columnText(stmt, subgenre);
+        meta.genreTags = columnText(stmt, genreTags);
+        meta.intensity = columnText(stmt, intensity);
+        meta.bassLevel = columnText(stmt, bassLevel);
+        meta.mood = columnText(stmt, mood);
+        meta.instruments = columnText(stmt, instruments);
+        meta.melodySignature = columnText(stmt, melodySignature);
+        meta.rhythmPattern = columnText(stmt, rhythmPattern);
+        meta.spectralCentroid = columnReal(stmt, spectralCentroid);
+        meta.spectralRolloff = columnReal(stmt, spectralRolloff);
+        meta.zeroCrossingRate = columnReal(stmt, zeroCrossingRate);
+        meta.mfccHash = columnReal(stmt, mfccHash);
+        meta.addedTimestamp = columnInteger(stmt, addedTimestamp);
+        meta.lastUsed = columnInteger(stmt, lastUsed);
+        meta.useCount = static_cast<int>(columnInteger(stmt, useCount));
+        meta.analyzed = columnInteger(stmt, analyzed) != 0;
+        meta.mfccMean = columnFloatBlob(stmt, mfccMean);
+        meta.mfccVariance = columnFloatBlob(stmt, mfccVariance);
+        meta.fileHash = columnText(stmt, fileHash);
+        return meta;
+    }
+};
+
+// SELECT-Liste für eine Spalten-Projektion (id und filepath immer)
+std::string projectionColumns(uint32_t columns) {
+    std::string list = "id, filepath";
+    if (columns & MediaDatabase::ColTags) list += ", title, artist, genre, subgenre, genreTags";
+    if (columns & MediaDatabase::ColStyle) list += ", intensity, bassLevel, mood, instruments, melodySignature, rhythmPattern";
+    if (columns & MediaDatabase::ColAnalysis) list += ", bpm, duration, spectralCentroid, spectralRolloff, zeroCrossingRate, mfccHash, analyzed";
+    if (columns & MediaDatabase::ColMfcc) list += ", mfccMean, mfccVariance";
+    if (columns & MediaDatabase::ColUsage) list += ", addedTimestamp, lastUsed, useCount, fileHash";
+    return list;
+}
+
+void bindTextParams(sqlite3_stmt* stmt, const std::vector<std::string>& params) {
+    for (size_t i = 0; i < params.size(); ++i) {
+        sqlite3_bind_text(stmt, static_cast<int>(i + 1), params[i].c_str(), -1, SQLITE_TRANSIENT);
+    }
+}
+
+// ORDER BY / LIMIT / OFFSET einer MediaQuery (ohne orderBy: Relevanz bei Volltextsuche)
+std::string orderAndLimit(const MediaDatabase::MediaQuery& query, bool ranked) {
+    std::string sql;
+    if (!query.orderBy.empty()) {
+        sql += " ORDER BY " + query.orderBy;
+    } else if (ranked) {
+        sql += " ORDER BY fts.ftsRank";
+    }
+    if (query.limit > 0) sql += " LIMIT " + std::to_string(query.limit);
+    if (query.offset > 0) sql += (query.limit > 0 ? " OFFSET " : " LIMIT -1 OFFSET ") + std::to_string(query.offset);
+    return sql;
+}
+
+// Obergrenze für "id IN (...)"-Listen (SQLITE_MAX_VARIABLE_NUMBER älterer Versionen: 999)
+constexpr size_t kMaxIdsPerStatement = 500;
+
+// Volltextindex als External-Content-Tabelle: speichert nur die Tokens,
+// die Trigger halten ihn bei jedem INSERT/UPDATE/DELETE synchron
+const char* const kFullTextSchema = R"(
+    CREATE VIRTUAL TABLE IF NOT EXISTS media_fts USING fts5(
+        title, artist, genre, genreTags, mood, instruments,
+        content = 'media', content_rowid = 'id',
+        tokenize = 'unicode61 remove_diacritics 2'
+    );
+    
+    CREATE TRIGGER IF NOT EXISTS media_fts_insert AFTER INSERT ON media BEGIN
+        INSERT INTO media_fts(rowid, title, artist, genre, genreTags, mood, instruments)
+        VALUES (new.id, new.title, new.artist, new.genre, new.genreTags, new.mood, new.instruments);
+    END;
+    
+    CREATE TRIGGER IF NOT EXISTS media_fts_delete AFTER DELETE ON media BEGIN
+        INSERT INTO media_fts(media_fts, rowid, title, artist, genre, genreTags, mood, instruments)
+        VALUES ('delete', old.id, old.title, old.artist, old.genre, old.genreTags, old.mood, old.instruments);
+    END;
+    
+    CREATE TRIGGER IF NOT EXISTS media_fts_update
+    AFTER UPDATE OF title, artist, genre, genreTags, mood, instruments ON media BEGIN
+        INSERT INTO media_fts(media_fts, rowid, title, artist, genre, genreTags, mood, instruments)
+        VALUES ('delete', old.id, old.title, old.artist, old.genre, old.genreTags, old.mood, old.instruments);
+        INSERT INTO media_fts(rowid, title, artist, genre, genreTags, mood, instruments)
+        VALUES (new.id, new.title, new.artist, new.genre, new.genreTags, new.mood, new.instruments);
+    END;
+)";
+
+// BM25-Gewichte in Spaltenreihenfolge: Titel > Artist > Genre/Tags > Mood/Instrumente
+const char* const kFullTextRank = "bm25(media_fts, 10.0, 5.0, 2.0, 2.0, 1.0, 1.0)";
+
+// LIKE-Fallback ohne FTS5: ein Wort muss in einer dieser Spalten vorkommen
+const char* const kFullTextLikeCondition =
+    "(title LIKE ? ESCAPE '\\' OR artist LIKE ? ESCAPE '\\' OR genre LIKE ? ESCAPE '\\' OR "
+    "genreTags LIKE ? ESCAPE '\\' OR mood LIKE ? ESCAPE '\\' OR instruments LIKE ? ESCAPE '\\')";
+constexpr size_t kFullTextLikeParams = 6;
+
+// Suchwörter: Trennung an ASCII-Satzzeichen/Leerzeichen, UTF-8-Bytes bleiben im Wort
+std::vector<std::string> searchWords(const std::string& text) {
+    std::vector<std::string> words;
+    std::string word;
+    for (char c : text) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (byte >= 0x80 || std::isalnum(byte)) {
+            word += c;
+        } else if (!word.empty()) {
+            words.push_back(word);
+            word.clear();
+        }
+    }
+    if (!word.empty()) words.push_back(word);
+    return words;
+}
+
+// Projektion für die Duplikatserkennung (kein SELECT *)
+const char* const kDuplicateCandidateColumns =
+    "SELECT id, filepath, title, artist, duration, bpm, mfccHash, spectralCentroid, mfccMean, analyzed";
+
+DuplicateDetector::Track readDuplicateTrack(sqlite3_stmt* stmt) {
+    DuplicateDetector::Track track;
+    track.id = sqlite3_column_int64(stmt, 0);
+    track.filepath = columnString(stmt, 1);
+    track.title = columnString(stmt, 2);
+    track.artist = columnString(stmt, 3);
+    // bindMediaColumns speichert fehlende Tags als '' (nicht NULL), wie toDuplicateTrack
+    track.hasTitleArtist = !track.title.empty() && !track.artist.empty();
+    track.duration = sqlite3_column_double(stmt, 4);
+    track.bpm = sqlite3_column_double(stmt, 5);
+    track.mfccHash = sqlite3_column_double(stmt, 6);
+    track.spectralCentroid = sqlite3_column_double(stmt, 7);
+    track.mfccMean = columnFloatBlob(stmt, 8);
+    track.analyzed = sqlite3_column_int(stmt, 9) != 0;
+    return track;
+}
+
+DuplicateDetector::Track toDuplicateTrack(const MediaMetadata& meta) {
+    DuplicateDetector::Track track;
+    track.id = meta.id;
+    track.filepath = meta.filepath;
+    track.title = meta.title;
+    track.artist = meta.artist;
+    // Leere Felder gelten als unbekannt (wie NULL in der Tabelle), sonst matchen alle Tracks ohne Tags
+    track.hasTitleArtist = !meta.title.empty() && !meta.artist.empty();
+    track.duration = meta.duration;
+    track.bpm = meta.bpm;
+    track.mfccHash = meta.mfccHash;
+    track.spectralCentroid = meta.spectralCentroid;
+    track.mfccMean = meta.mfccMean;
+    track.analyzed = meta.analyzed;
+    return track;
+}
+
+} // namespace
+
 MediaDatabase::MediaDatabase(const std::string& dbPath) : dbPath_(expandPath(dbPath)) {
 }
 
 MediaDatabase::~MediaDatabase() {
+    if (indexTrainer_.joinable()) indexTrainer_.join();
     if (db_) {
+        printQueryStats();
+        // Reader zuerst schließen: der Writer als letzte Verbindung checkpointet das WAL
+        readers_.close();
+        finalizeCachedStatements();
         sqlite3_close(db_);
+        // Nach dem Schließen speichern: Snapshot ist dann neuer als die DB-Datei
+        if (!similarityIndex_.save(similarityIndexPath())) {
+            std::cerr << "⚠️ Ähnlichkeits-Index konnte nicht gespeichert werden" << std::endl;
+        }
     }
 }
 
@@ -41,6 +358,15 @@ bool MediaDatabase::initialize() {
         return false;
     }
     
+    // WAL: Leser blockieren den Schreiber nicht (und umgekehrt);
+    // synchronous=NORMAL ist im WAL-Modus crash-sicher (nur fsync beim Checkpoint)
+    sqlite3_busy_timeout(db_, 5000);
+    executeSQL("PRAGMA journal_mode = WAL");
+    executeSQL("PRAGMA synchronous = NORMAL");
+    for (const auto& pragma : kConnectionPragmas) {
+        executeSQL(pragma);
+    }
+    
     // Erstelle Tabelle
     const char* sql = R"(
         CREATE TABLE IF NOT EXISTS media (
@@ -80,13 +406,17 @@ bool MediaDatabase::initialize() {
             outroStart REAL DEFAULT 0.0,
             outroDuration REAL DEFAULT 0.0,
             structurePattern TEXT,
-            energyCurve TEXT
+            energyCurve TEXT,
+            mfccMean BLOB,
+            mfccVariance BLOB,
+            fileHash TEXT
         );
         
         CREATE INDEX IF NOT EXISTS idx_genre ON media(genre);
         CREATE INDEX IF NOT EXISTS idx_intensity ON media(intensity);
         CREATE INDEX IF NOT EXISTS idx_bpm ON media(bpm);
         CREATE INDEX IF NOT EXISTS idx_analyzed ON media(analyzed);
+        CREATE INDEX IF NOT EXISTS idx_duration ON media(duration);
         
         CREATE TABLE IF NOT EXISTS training_decisions (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
@@ -110,22 +440,64 @@ bool MediaDatabase::initialize() {
         return false;
     }
     
-    // Migrate existing database - add new columns if they don't exist
-    const char* migrationSQL = R"(
-        ALTER TABLE training_decisions ADD COLUMN answered INTEGER DEFAULT 0;
-        ALTER TABLE training_decisions ADD COLUMN audioFile TEXT;
-        ALTER TABLE media ADD COLUMN genreTags TEXT;
-    )";
+    // Migrate existing database - add new columns if they don't exist.
+    // Jedes ALTER einzeln ausführen: sqlite3_exec bricht sonst beim ersten
+    // "duplicate column name" ab und spätere Spalten würden nie angelegt.
+    const char* migrations[] = {
+        "ALTER TABLE training_decisions ADD COLUMN answered INTEGER DEFAULT 0",
+        "ALTER TABLE training_decisions ADD COLUMN audioFile TEXT",
+        "ALTER TABLE media ADD COLUMN genreTags TEXT",
+        "ALTER TABLE media ADD COLUMN mfccMean BLOB",
+        "ALTER TABLE media ADD COLUMN mfccVariance BLOB",
+        "ALTER TABLE media ADD COLUMN fileHash TEXT",
+        // Index erst nach dem ALTER anlegen (Spalte fehlt in alten DBs)
+        "CREATE INDEX IF NOT EXISTS idx_filehash ON media(fileHash)"
+    };
+    
+    for (const char* migrationSQL : migrations) {
+        char* errMsg = nullptr;
+        sqlite3_exec(db_, migrationSQL, nullptr, nullptr, &errMsg);
+        if (errMsg) {
+            // Ignore "duplicate column name" errors
+            sqlite3_free(errMsg);
+        }
+    }
+    
+    fullTextAvailable_ = initializeFullTextIndex();
+    
+    loadSimilarityIndex();
+    
+    // Read-only Verbindungen erst nach Schema/Migrationen öffnen
+    if (!readers_.open(dbPath_, kReaderConnections, kConnectionPragmas)) {
+        std::cerr << "⚠️ Kein Reader-Pool, Lesezugriffe laufen über die Schreibverbindung" << std::endl;
+    }
+    
+    std::cout << "✅ Database initialized: " << dbPath_ << std::endl;
+    return true;
+}
+
+bool MediaDatabase::initializeFullTextIndex() {
+    // Neu angelegter Index (erster Start / alte DB) wird einmal aus media gefüllt
+    bool exists = false;
+    if (sqlite3_stmt* stmt = prepareStatement("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'media_fts'")) {
+        exists = sqlite3_step(stmt) == SQLITE_ROW;
+        sqlite3_finalize(stmt);
+    }
     
-    // Execute migration (ignore errors if columns already exist)
     char* errMsg = nullptr;
-    sqlite3_exec(db_, migrationSQL, nullptr, nullptr, &errMsg);
-    if (errMsg) {
-        // Ignore "duplicate column name" errors
+    if (sqlite3_exec(db_, kFullTextSchema, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "⚠️ Kein FTS5-Volltextindex (" << (errMsg ? errMsg : "unbekannter Fehler")
+                  << "), Suche läuft über LIKE" << std::endl;
         sqlite3_free(errMsg);
+        return false;
     }
     
-    std::cout << "✅ Database initialized: " << dbPath_ << std::endl;
+    if (!exists) {
+        std::cout << "🔤 Baue Volltextindex auf..." << std::endl;
+        if (!executeSQL("INSERT INTO media_fts(media_fts) VALUES('rebuild')")) {
+            return false;
+        }
+    }
     return true;
 }
 
@@ -141,122 +513,638 @@ bool MediaDatabase::executeSQL(const std::string& sql) {
 }
 
 sqlite3_stmt* MediaDatabase::prepareStatement(const std::string& sql) {
+    return prepareStatement(db_, sql);
+}
+
+sqlite3_stmt* MediaDatabase::prepareStatement(sqlite3* connection, const std::string& sql) {
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(connection, sql.c_str(), -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(connection) << std::endl;
+        return nullptr;
+    }
+    return stmt;
+}
+
+sqlite3_stmt* MediaDatabase::cachedStatement(const char* sql) {
+    auto it = statementCache_.find(sql);
+    if (it != statementCache_.end()) {
+        sqlite3_reset(it->second);
+        sqlite3_clear_bindings(it->second);
+        return it->second;
+    }
+    
     sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v3(db_, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
     if (rc != SQLITE_OK) {
         std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db_) << std::endl;
         return nullptr;
     }
+    statementCache_.emplace(sql, stmt);
     return stmt;
 }
 
+void MediaDatabase::finalizeCachedStatements() {
+    for (auto& entry : statementCache_) {
+        sqlite3_finalize(entry.second);
+    }
+    statementCache_.clear();
+}
+
+// ===== VERBINDUNGEN & QUERY-STATISTIK =====
+
+thread_local MediaDatabase::QueryScope* MediaDatabase::QueryScope::innermost_ = nullptr;
+
+MediaDatabase::QueryScope::QueryScope(MediaDatabase& db, const char* label, Mode mode, WriteBatch* batch)
+    : db_(db), label_(label), outer_(innermost_), start_(std::chrono::steady_clock::now()) {
+    // Äußerer Scope dieses Threads auf derselben Datenbank (Aufruf aus einem Callback)
+    const QueryScope* held = outer_;
+    while (held && &held->db_ != &db_) held = held->outer_;
+    
+    if (held && (held->writer_ || mode == Read)) {
+        // Verbindung übernehmen: erneutes acquire()/lock() würde auf uns selbst warten
+        connection_ = held->connection_;
+        writer_ = held->writer_;
+    } else if (mode == Read && !db_.readers_.empty()) {
+        connection_ = db_.readers_.acquire();
+        pooled_ = connection_ != nullptr;
+    }
+    if (!connection_) {
+        // Schreibzugriff (oder kein Pool): exklusiv über die Writer-Verbindung
+        lock_ = std::unique_lock<std::mutex>(db_.dbMutex_);
+        connection_ = db_.db_;
+        writer_ = true;
+    }
+    // Fremde Schreibzugriffe nie in die Transaktion eines Batches falten
+    if (mode == Write && db_.openBatch_ && db_.openBatch_ != batch) {
+        db_.openBatch_->commitLocked();
+    }
+    innermost_ = this;
+    acquired_ = std::chrono::steady_clock::now();
+}
+
+MediaDatabase::QueryScope::~QueryScope() {
+    auto end = std::chrono::steady_clock::now();
+    innermost_ = outer_;
+    if (pooled_) db_.readers_.release(connection_);
+    if (lock_.owns_lock()) lock_.unlock();
+    db_.recordQuery(label_, elapsedMs(start_, acquired_), elapsedMs(acquired_, end));
+}
+
+void MediaDatabase::recordQuery(const char* label, double waitMs, double execMs) {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    QueryStats& stats = queryStats_[label];
+    if (stats.label.empty()) stats.label = label;
+    stats.calls++;
+    stats.totalMs += execMs;
+    stats.maxMs = std::max(stats.maxMs, execMs);
+    stats.waitMs += waitMs;
+}
+
+std::vector<MediaDatabase::QueryStats> MediaDatabase::getQueryStats() {
+    std::vector<QueryStats> result;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        result.reserve(queryStats_.size());
+        for (const auto& entry : queryStats_) result.push_back(entry.second);
+    }
+    // Teuerste zuerst (Ausführung + Wartezeit)
+    std::sort(result.begin(), result.end(), [](const QueryStats& a, const QueryStats& b) {
+        return a.totalMs + a.waitMs > b.totalMs + b.waitMs;
+    });
+    return result;
+}
+
+void MediaDatabase::resetQueryStats() {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    queryStats_.clear();
+}
+
+void MediaDatabase::printQueryStats(size_t maxEntries) {
+    auto stats = getQueryStats();
+    if (stats.empty()) return;
+    
+    std::cout << "📊 DB-Abfragen (Ausführung / Warten auf Verbindung):" << std::endl;
+    for (size_t i = 0; i < stats.size() && i < maxEntries; ++i) {
+        const auto& q = stats[i];
+        std::cout << "   " << q.label << ": " << q.calls << "x, "
+                  << static_cast<int64_t>(q.totalMs) << " ms (max "
+                  << static_cast<int64_t>(q.maxMs) << " ms), Warten "
+                  << static_cast<int64_t>(q.waitMs) << " ms" << std::endl;
+    }
+}
+
 bool MediaDatabase::addMedia(const MediaMetadata& meta) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "addMedia", QueryScope::Write);
+    return insertMediaLocked(meta);
+}
+
+bool MediaDatabase::insertMediaLocked(const MediaMetadata& meta) {
+    // Byte-identische Datei unter anderem Pfad (idx_filehash, O(1))
+    if (!meta.fileHash.empty() && findIdByHash(meta.fileHash) != 0) {
+        return false;
+    }
     
-    // Prüfe ob Datei bereits existiert (Duplikat-Vermeidung)
-    const char* checkSql = "SELECT COUNT(*) FROM media WHERE filepath = ?";
-    sqlite3_stmt* checkStmt = prepareStatement(checkSql);
-    if (!checkStmt) return false;
+    // Pfad-Duplikate fängt ON CONFLICT ab (kein separates SELECT COUNT(*))
+    sqlite3_stmt* stmt = cachedStatement(kInsertMediaSql);
+    if (!stmt) return false;
     
-    sqlite3_bind_text(checkStmt, 1, meta.filepath.c_str(), -1, SQLITE_TRANSIENT);
+    bindMediaColumns(stmt, meta);
+    int rc = sqlite3_step(stmt);
+    int changedRows = sqlite3_changes(db_);
+    sqlite3_reset(stmt);
     
-    bool exists = false;
-    if (sqlite3_step(checkStmt) == SQLITE_ROW) {
-        exists = (sqlite3_column_int(checkStmt, 0) > 0);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "❌ SQLite Fehler beim INSERT: " << sqlite3_errmsg(db_) << " (Code: " << rc << ")" << std::endl;
+        return false;
+    }
+    if (changedRows == 0) {
+        return false;  // Duplikat gefunden, nicht hinzugefügt
     }
-    sqlite3_finalize(checkStmt);
     
-    if (exists) {
-        return false;  // Duplikat gefunden, nicht hinzufügen
+    updateSimilarityIndex(sqlite3_last_insert_rowid(db_), meta);
+    return true;
+}
+
+bool MediaDatabase::upsertMediaLocked(const MediaMetadata& meta) {
+    sqlite3_stmt* stmt = cachedStatement(kUpsertMediaSql);
+    if (!stmt) {
+        std::cerr << "❌ Fehler beim Vorbereiten des UPDATE Statements!" << std::endl;
+        return false;
     }
     
-    const char* sql = R"(
-        INSERT INTO media (
-            filepath, title, artist, bpm, duration, genre, subgenre, intensity, bassLevel, mood,
-            instruments, melodySignature, rhythmPattern, spectralCentroid, spectralRolloff,
-            zeroCrossingRate, mfccHash, addedTimestamp, analyzed
-        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-    )";
+    bindMediaColumns(stmt, meta);
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
     
-    sqlite3_stmt* stmt = prepareStatement(sql);
-    if (!stmt) return false;
+    if (rc != SQLITE_DONE) {
+        std::cerr << "❌ SQLite Fehler beim UPDATE: " << sqlite3_errmsg(db_) << " (Code: " << rc << ")" << std::endl;
+        return false;
+    }
     
-    int64_t timestamp = meta.addedTimestamp ? meta.addedTimestamp : std::time(nullptr);
+    // last_insert_rowid gilt beim Update-Zweig nicht, daher per Pfad nachschlagen
+    int64_t id = meta.id;
+    if (id <= 0) {
+        sqlite3_stmt* idStmt = cachedStatement("SELECT id FROM media WHERE filepath = ?");
+        if (idStmt) {
+            sqlite3_bind_text(idStmt, 1, meta.filepath.c_str(), -1, SQLITE_TRANSIENT);
+            if (sqlite3_step(idStmt) == SQLITE_ROW) id = sqlite3_column_int64(idStmt, 0);
+            sqlite3_reset(idStmt);
+        }
+    }
+    updateSimilarityIndex(id, meta);
+    return true;
+}
+
+size_t MediaDatabase::addMediaBatch(const std::vector<MediaMetadata>& items, size_t chunkSize) {
+    WriteBatch batch(*this, chunkSize);
+    for (const auto& meta : items) {
+        batch.add(meta);
+    }
+    batch.commit();
+    return batch.written();
+}
+
+size_t MediaDatabase::updateMediaBatch(const std::vector<MediaMetadata>& items, size_t chunkSize) {
+    WriteBatch batch(*this, chunkSize);
+    for (const auto& meta : items) {
+        batch.update(meta);
+    }
+    batch.commit();
+    return batch.written();
+}
+
+// ===== WRITE BATCH =====
+
+MediaDatabase::WriteBatch::WriteBatch(MediaDatabase& db, size_t chunkSize, int maxOpenMs)
+    : db_(db), chunkSize_(chunkSize > 0 ? chunkSize : 1), maxOpen_(std::max(0, maxOpenMs)) {
+}
+
+MediaDatabase::WriteBatch::~WriteBatch() {
+    commit();
+}
+
+bool MediaDatabase::WriteBatch::add(const MediaMetadata& meta) {
+    QueryScope query(db_, "WriteBatch.add", QueryScope::Write, this);
+    beginIfNeeded();
+    bool ok = db_.insertMediaLocked(meta);
+    finishOperation(ok);
+    return ok;
+}
+
+bool MediaDatabase::WriteBatch::update(const MediaMetadata& meta) {
+    QueryScope query(db_, "WriteBatch.update", QueryScope::Write, this);
+    beginIfNeeded();
+    bool ok = db_.upsertMediaLocked(meta);
+    finishOperation(ok);
+    return ok;
+}
+
+bool MediaDatabase::WriteBatch::remove(const std::string& filepath) {
+    QueryScope query(db_, "WriteBatch.remove", QueryScope::Write, this);
+    beginIfNeeded();
+    bool ok = db_.deleteByPathLocked(filepath);
+    finishOperation(ok);
+    return ok;
+}
+
+bool MediaDatabase::WriteBatch::move(const std::string& oldPath, const std::string& newPath) {
+    QueryScope query(db_, "WriteBatch.move", QueryScope::Write, this);
+    beginIfNeeded();
+    bool ok = db_.movePathLocked(oldPath, newPath);
+    finishOperation(ok);
+    return ok;
+}
+
+bool MediaDatabase::WriteBatch::commit() {
+    std::lock_guard<std::mutex> lock(db_.dbMutex_);
+    return commitLocked();
+}
+
+void MediaDatabase::WriteBatch::beginIfNeeded() {
+    if (ownsTransaction_ || !db_.db_) return;
+    openedAt_ = std::chrono::steady_clock::now();
+    // Explizite Transaktion außerhalb eines Batches: mitschreiben, deren Besitzer committet
+    if (!sqlite3_get_autocommit(db_.db_)) return;
+    ownsTransaction_ = db_.executeSQL("BEGIN IMMEDIATE");
+    if (ownsTransaction_) db_.openBatch_ = this;
+}
+
+void MediaDatabase::WriteBatch::finishOperation(bool ok) {
+    if (ok) pendingWritten_++;
+    if (!ownsTransaction_) {
+        // Autocommit (BEGIN fehlgeschlagen) oder fremde Transaktion: nichts offen zu halten
+        commitLocked();
+        return;
+    }
+    if (++pending_ >= chunkSize_ || std::chrono::steady_clock::now() - openedAt_ >= maxOpen_) {
+        commitLocked();
+    }
+}
+
+bool MediaDatabase::WriteBatch::commitLocked() {
+    size_t rows = pendingWritten_;
+    pending_ = 0;
+    pendingWritten_ = 0;
+    if (!ownsTransaction_) {
+        written_ += rows;
+        return true;
+    }
+    ownsTransaction_ = false;
+    if (db_.openBatch_ == this) db_.openBatch_ = nullptr;
     
-    sqlite3_bind_text(stmt, 1, meta.filepath.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, meta.title.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, meta.artist.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 4, meta.bpm);
-    sqlite3_bind_double(stmt, 5, meta.duration);
-    sqlite3_bind_text(stmt, 6, meta.genre.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 7, meta.subgenre.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 8, meta.intensity.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 9, meta.bassLevel.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 10, meta.mood.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 11, meta.instruments.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 12, meta.melodySignature.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 13, meta.rhythmPattern.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 14, meta.spectralCentroid);
-    sqlite3_bind_double(stmt, 15, meta.spectralRolloff);
-    sqlite3_bind_double(stmt, 16, meta.zeroCrossingRate);
-    sqlite3_bind_double(stmt, 17, meta.mfccHash);
-    sqlite3_bind_int64(stmt, 18, timestamp);
-    sqlite3_bind_int(stmt, 19, meta.analyzed ? 1 : 0);
+    if (!db_.executeSQL("COMMIT")) {
+        db_.executeSQL("ROLLBACK");
+        failed_ += rows;
+        std::cerr << "❌ WriteBatch: COMMIT fehlgeschlagen, " << rows << " Einträge verworfen" << std::endl;
+        return false;
+    }
+    written_ += rows;
+    return true;
+}
+
+std::vector<MediaMetadata> MediaDatabase::getAll() {
+    MediaQuery query;
+    query.orderBy = "addedTimestamp DESC";
+    return getPage(query);
+}
+
+// ===== CURSOR / PAGING =====
+
+std::string MediaDatabase::querySource(const MediaQuery& query, std::vector<std::string>& params, bool& ranked) const {
+    std::string source = " FROM media";
+    std::string where;
+    ranked = false;
+    
+    std::vector<std::string> words = searchWords(query.search);
+    if (!words.empty() && fullTextAvailable_) {
+        // Treffer + Rang aus dem FTS-Index; die Unterabfrage exponiert nur
+        // ftsRowid/ftsRank, Spaltennamen in where/orderBy bleiben eindeutig
+        source += std::string(" JOIN (SELECT rowid AS ftsRowid, ") + kFullTextRank +
+                  " AS ftsRank FROM media_fts WHERE media_fts MATCH ?) AS fts ON fts.ftsRowid = media.id";
+        params.push_back(fullTextQuery(query.search));
+        ranked = true;
+    }
     
-    int rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    if (!query.where.empty()) {
+        where = "(" + query.where + ")";
+        params.insert(params.end(), query.params.begin(), query.params.end());
+    }
     
-    return rc == SQLITE_DONE;
+    if (!words.empty() && !fullTextAvailable_) {
+        for (const auto& word : words) {
+            if (!where.empty()) where += " AND ";
+            where += kFullTextLikeCondition;
+            params.insert(params.end(), kFullTextLikeParams, likePattern(word));
+        }
+    }
+    
+    if (!where.empty()) source += " WHERE " + where;
+    return source;
 }
 
-std::vector<MediaMetadata> MediaDatabase::getAll() {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+size_t MediaDatabase::iterate(const MediaQuery& query, const RowCallback& callback) {
+    QueryScope scope(*this, query.search.empty() ? "iterate" : "search", QueryScope::Read);
+    
+    std::vector<std::string> params;
+    bool ranked = false;
+    std::string sql = "SELECT " + projectionColumns(query.columns) + querySource(query, params, ranked);
+    sql += orderAndLimit(query, ranked);
+    
+    sqlite3_stmt* stmt = prepareStatement(scope.connection(), sql);
+    if (!stmt) return 0;
+    bindTextParams(stmt, params);
+    
+    MediaRowReader reader(stmt);
+    size_t rows = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        rows++;
+        if (!callback(reader.read(stmt))) break;
+    }
     
+    sqlite3_finalize(stmt);
+    return rows;
+}
+
+std::vector<MediaMetadata> MediaDatabase::getPage(const MediaQuery& query) {
     std::vector<MediaMetadata> results;
-    const char* sql = "SELECT * FROM media ORDER BY addedTimestamp DESC";
+    if (query.limit > 0) results.reserve(query.limit);
+    iterate(query, [&results](const MediaMetadata& meta) {
+        results.push_back(meta);
+        return true;
+    });
+    return results;
+}
+
+std::vector<int64_t> MediaDatabase::queryIds(const MediaQuery& query) {
+    QueryScope scope(*this, "queryIds", QueryScope::Read);
     
-    sqlite3_stmt* stmt = prepareStatement(sql);
-    if (!stmt) return results;
+    std::vector<std::string> params;
+    bool ranked = false;
+    std::string sql = "SELECT media.id" + querySource(query, params, ranked) + orderAndLimit(query, ranked);
+    
+    std::vector<int64_t> ids;
+    sqlite3_stmt* stmt = prepareStatement(scope.connection(), sql);
+    if (!stmt) return ids;
+    bindTextParams(stmt, params);
     
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        MediaMetadata meta;
-        meta.id = sqlite3_column_int64(stmt, 0);
-        meta.filepath = (const char*)sqlite3_column_text(stmt, 1);
-        meta.title = (const char*)sqlite3_column_text(stmt, 2);
-        meta.artist = (const char*)sqlite3_column_text(stmt, 3);
-        meta.bpm = sqlite3_column_double(stmt, 4);
-        meta.duration = sqlite3_column_double(stmt, 5);
-        meta.genre = (const char*)sqlite3_column_text(stmt, 6);
-        meta.subgenre = (const char*)sqlite3_column_text(stmt, 7);
-        meta.intensity = (const char*)sqlite3_column_text(stmt, 8);
-        meta.bassLevel = (const char*)sqlite3_column_text(stmt, 9);
-        meta.mood = (const char*)sqlite3_column_text(stmt, 10);
-        meta.instruments = (const char*)sqlite3_column_text(stmt, 11);
-        meta.melodySignature = (const char*)sqlite3_column_text(stmt, 12);
-        meta.rhythmPattern = (const char*)sqlite3_column_text(stmt, 13);
-        meta.spectralCentroid = sqlite3_column_double(stmt, 14);
-        meta.spectralRolloff = sqlite3_column_double(stmt, 15);
-        meta.zeroCrossingRate = sqlite3_column_double(stmt, 16);
-        meta.mfccHash = sqlite3_column_double(stmt, 17);
-        meta.addedTimestamp = sqlite3_column_int64(stmt, 18);
-        meta.lastUsed = sqlite3_column_int64(stmt, 19);
-        meta.useCount = sqlite3_column_int(stmt, 20);
-        meta.analyzed = sqlite3_column_int(stmt, 21) != 0;
+        ids.push_back(sqlite3_column_int64(stmt, 0));
+    }
+    
+    sqlite3_finalize(stmt);
+    return ids;
+}
+
+std::vector<MediaMetadata> MediaDatabase::getByIds(const std::vector<int64_t>& ids, uint32_t columns) {
+    QueryScope scope(*this, "getByIds", QueryScope::Read);
+    std::vector<MediaMetadata> results(ids.size());
+    
+    // Zielposition je ID (IDs können mehrfach angefragt werden)
+    std::unordered_multimap<int64_t, size_t> positions;
+    positions.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) positions.emplace(ids[i], i);
+    
+    for (size_t start = 0; start < ids.size(); start += kMaxIdsPerStatement) {
+        size_t end = std::min(ids.size(), start + kMaxIdsPerStatement);
+        std::string sql = "SELECT " + projectionColumns(columns) + " FROM media WHERE id IN (?";
+        for (size_t i = start + 1; i < end; ++i) sql += ", ?";
+        sql += ")";
         
-        results.push_back(meta);
+        sqlite3_stmt* stmt = prepareStatement(scope.connection(), sql);
+        if (!stmt) break;
+        for (size_t i = start; i < end; ++i) {
+            sqlite3_bind_int64(stmt, static_cast<int>(i - start + 1), ids[i]);
+        }
+        
+        MediaRowReader reader(stmt);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            MediaMetadata meta = reader.read(stmt);
+            auto range = positions.equal_range(meta.id);
+            for (auto it = range.first; it != range.second; ++it) results[it->second] = meta;
+        }
+        
+        sqlite3_finalize(stmt);
+    }
+    
+    return results;
+}
+
+size_t MediaDatabase::countWhere(const std::string& where, const std::vector<std::string>& params) {
+    QueryScope scope(*this, "countWhere", QueryScope::Read);
+    
+    std::string sql = "SELECT COUNT(*) FROM media";
+    if (!where.empty()) sql += " WHERE " + where;
+    
+    sqlite3_stmt* stmt = prepareStatement(scope.connection(), sql);
+    if (!stmt) return 0;
+    bindTextParams(stmt, params);
+    
+    size_t count = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        count = static_cast<size_t>(sqlite3_column_int64(stmt, 0));
+    }
+    
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+size_t MediaDatabase::count(const MediaQuery& query) {
+    QueryScope scope(*this, "count", QueryScope::Read);
+    
+    std::vector<std::string> params;
+    bool ranked = false;
+    std::string sql = "SELECT COUNT(*)" + querySource(query, params, ranked);
+    
+    sqlite3_stmt* stmt = prepareStatement(scope.connection(), sql);
+    if (!stmt) return 0;
+    bindTextParams(stmt, params);
+    
+    size_t count = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        count = static_cast<size_t>(sqlite3_column_int64(stmt, 0));
     }
     
     sqlite3_finalize(stmt);
+    return count;
+}
+
+std::map<std::string, size_t> MediaDatabase::countGroupedBy(const std::string& column, const std::string& where,
+                                                           const std::vector<std::string>& params) {
+    QueryScope scope(*this, "countGroupedBy", QueryScope::Read);
+    std::map<std::string, size_t> counts;
+    
+    std::string sql = "SELECT " + column + ", COUNT(*) FROM media";
+    if (!where.empty()) sql += " WHERE " + where;
+    sql += " GROUP BY " + column;
+    
+    sqlite3_stmt* stmt = prepareStatement(scope.connection(), sql);
+    if (!stmt) return counts;
+    bindTextParams(stmt, params);
+    
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        counts[columnString(stmt, 0)] = static_cast<size_t>(sqlite3_column_int64(stmt, 1));
+    }
+    
+    sqlite3_finalize(stmt);
+    return counts;
+}
+
+std::string MediaDatabase::likePattern(const std::string& text) {
+    // Für "LIKE ? ESCAPE '\'": Platzhalter im Suchtext wörtlich nehmen
+    std::string pattern = "%";
+    for (char c : text) {
+        if (c == '%' || c == '_' || c == '\\') pattern += '\\';
+        pattern += c;
+    }
+    pattern += '%';
+    return pattern;
+}
+
+std::string MediaDatabase::fullTextQuery(const std::string& text) {
+    // Jedes Wort als Phrase mit Präfix-Stern; Leerzeichen = implizites AND
+    std::string match;
+    for (const auto& word : searchWords(text)) {
+        if (!match.empty()) match += ' ';
+        match += '"' + word + "\"*";
+    }
+    return match;
+}
+
+std::vector<MediaMetadata> MediaDatabase::search(const std::string& text, size_t limit, size_t offset) {
+    if (searchWords(text).empty()) return {};
+    
+    MediaQuery query;
+    query.search = text;
+    query.limit = limit;
+    query.offset = offset;
+    return getPage(query);
+}
+
+MediaMetadata MediaDatabase::getById(int64_t id) {
+    QueryScope query(*this, "getById", QueryScope::Read);
+    return fetchById(query.connection(), id);
+}
+
+MediaMetadata MediaDatabase::fetchById(sqlite3* connection, int64_t id) {
+    MediaMetadata meta;
+    sqlite3_stmt* stmt = prepareStatement(connection, "SELECT * FROM media WHERE id = ?");
+    if (!stmt) return meta;
+    
+    sqlite3_bind_int64(stmt, 1, id);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        meta = MediaRowReader(stmt).read(stmt);
+    }
+    
+    sqlite3_finalize(stmt);
+    return meta;
+}
+
+// === Ähnlichkeits-Index ===
+
+void MediaDatabase::loadSimilarityIndex() {
+    // Snapshot nur verwenden, wenn er nach dem letzten DB-Schreibzugriff gespeichert wurde
+    // (sonst z.B. Absturz nach Änderungen -> aus der DB neu aufbauen)
+    std::error_code ec;
+    std::string snapshot = similarityIndexPath();
+    bool fresh = fs::exists(snapshot, ec);
+    if (fresh) {
+        auto snapshotTime = fs::last_write_time(snapshot, ec);
+        for (const std::string& file : {dbPath_, dbPath_ + "-wal"}) {
+            if (fs::exists(file, ec) && fs::last_write_time(file, ec) > snapshotTime) {
+                fresh = false;
+            }
+        }
+    }
+    
+    if (fresh && similarityIndex_.load(snapshot)) {
+        std::cout << "🔎 Ähnlichkeits-Index geladen: " << similarityIndex_.size() << " Tracks" << std::endl;
+        return;
+    }
+    rebuildSimilarityIndex();
+}
+
+void MediaDatabase::rebuildSimilarityIndex() {
+    similarityIndex_.clear();
+    
+    // Nur die Feature-Spalten lesen (kein SELECT *)
+    sqlite3_stmt* stmt = prepareStatement(
+        "SELECT id, bpm, spectralCentroid, spectralRolloff, zeroCrossingRate, mfccMean, mfccVariance "
+        "FROM media WHERE analyzed = 1");
+    if (!stmt) return;
+    
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        MediaMetadata meta;
+        meta.bpm = sqlite3_column_double(stmt, 1);
+        meta.spectralCentroid = sqlite3_column_double(stmt, 2);
+        meta.spectralRolloff = sqlite3_column_double(stmt, 3);
+        meta.zeroCrossingRate = sqlite3_column_double(stmt, 4);
+        meta.mfccMean = columnFloatBlob(stmt, 5);
+        meta.mfccVariance = columnFloatBlob(stmt, 6);
+        similarityIndex_.upsert(sqlite3_column_int64(stmt, 0), SimilarityIndex::featureVector(meta));
+    }
+    sqlite3_finalize(stmt);
+    
+    similarityIndex_.train();
+    std::cout << "🔎 Ähnlichkeits-Index aufgebaut: " << similarityIndex_.size() << " Tracks" << std::endl;
+}
+
+void MediaDatabase::updateSimilarityIndex(int64_t id, const MediaMetadata& meta) {
+    if (id <= 0) return;
+    if (meta.analyzed) {
+        similarityIndex_.upsert(id, SimilarityIndex::featureVector(meta));
+        if (!indexTraining_ && similarityIndex_.needsTraining()) scheduleIndexTraining();
+    } else {
+        similarityIndex_.remove(id);
+    }
+}
+
+void MediaDatabase::scheduleIndexTraining() {
+    // Vorheriger Lauf ist fertig (indexTraining_ == false), nur noch aufräumen
+    if (indexTrainer_.joinable()) indexTrainer_.join();
+    indexTraining_ = true;
+    
+    auto job = std::make_shared<SimilarityIndex::TrainingJob>(similarityIndex_.prepareTraining());
+    indexTrainer_ = std::thread([this, job]() {
+        SimilarityIndex::runTraining(*job);
+        std::lock_guard<std::mutex> lock(dbMutex_);
+        similarityIndex_.applyTraining(*job);
+        indexTraining_ = false;
+    });
+}
+
+std::vector<MediaMetadata> MediaDatabase::findSimilar(const MediaMetadata& reference, int limit) {
+    std::vector<MediaMetadata> results;
+    if (limit <= 0) return results;
+    
+    // Index-Suche unter dem Writer-Lock (Index wird von Schreibzugriffen gepflegt),
+    // die Zeilen selbst über eine Reader-Verbindung
+    std::vector<SimilarityIndex::Hit> hits;
+    {
+        QueryScope query(*this, "findSimilar.index", QueryScope::WriterRead);
+        hits = similarityIndex_.search(SimilarityIndex::featureVector(reference),
+                                       static_cast<size_t>(limit),
+                                       reference.id > 0 ? reference.id : -1);
+    }
+    
+    // Alle Treffer mit einer Abfrage (WHERE id IN ...), Reihenfolge der Distanz
+    std::vector<int64_t> ids;
+    ids.reserve(hits.size());
+    for (const auto& hit : hits) ids.push_back(hit.id);
+    results.reserve(hits.size());
+    for (auto& meta : getByIds(ids)) {
+        if (meta.id != 0) results.push_back(std::move(meta));
+    }
     return results;
 }
 
 std::vector<MediaMetadata> MediaDatabase::searchByGenre(const std::string& genre) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "searchByGenre", QueryScope::Read);
     
     std::vector<MediaMetadata> results;
     const char* sql = "SELECT * FROM media WHERE genre = ? ORDER BY bpm";
     
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return results;
     
     sqlite3_bind_text(stmt, 1, genre.c_str(), -1, SQLITE_TRANSIENT);
@@ -279,12 +1167,12 @@ std::vector<MediaMetadata> MediaDatabase::searchByGenre(const std::string& genre
 }
 
 std::vector<MediaMetadata> MediaDatabase::getUnanalyzed() {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "getUnanalyzed", QueryScope::Read);
     
     std::vector<MediaMetadata> results;
     const char* sql = "SELECT * FROM media WHERE analyzed = 0";
     
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return results;
     
     while (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -300,10 +1188,10 @@ std::vector<MediaMetadata> MediaDatabase::getUnanalyzed() {
 }
 
 size_t MediaDatabase::getTotalCount() {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "getTotalCount", QueryScope::Read);
     
     const char* sql = "SELECT COUNT(*) FROM media";
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return 0;
     
     size_t count = 0;
@@ -315,13 +1203,17 @@ size_t MediaDatabase::getTotalCount() {
     return count;
 }
 
+size_t MediaDatabase::getCountByGenre(const std::string& genre) {
+    return countWhere("genre = ?", {genre});
+}
+
 std::vector<std::string> MediaDatabase::getAllGenres() {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "getAllGenres", QueryScope::Read);
     
     std::vector<std::string> genres;
     const char* sql = "SELECT DISTINCT genre FROM media WHERE genre != '' ORDER BY genre";
     
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return genres;
     
     while (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -333,64 +1225,19 @@ std::vector<std::string> MediaDatabase::getAllGenres() {
 }
 
 bool MediaDatabase::updateMedia(const MediaMetadata& meta) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
-    
-    const char* sql = R"(
-        UPDATE media SET
-            title = ?, artist = ?, bpm = ?, duration = ?, genre = ?, subgenre = ?,
-            intensity = ?, bassLevel = ?, mood = ?, instruments = ?, melodySignature = ?,
-            rhythmPattern = ?, spectralCentroid = ?, spectralRolloff = ?, zeroCrossingRate = ?,
-            mfccHash = ?, analyzed = ?
-        WHERE filepath = ?
-    )";
+    QueryScope query(*this, "updateMedia", QueryScope::Write);
     
-    sqlite3_stmt* stmt = prepareStatement(sql);
-    if (!stmt) {
-        std::cerr << "❌ Fehler beim Vorbereiten des UPDATE Statements!" << std::endl;
-        return false;
-    }
-    
-    sqlite3_bind_text(stmt, 1, meta.title.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, meta.artist.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 3, meta.bpm);
-    sqlite3_bind_double(stmt, 4, meta.duration);
-    sqlite3_bind_text(stmt, 5, meta.genre.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 6, meta.subgenre.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 7, meta.intensity.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 8, meta.bassLevel.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 9, meta.mood.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 10, meta.instruments.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 11, meta.melodySignature.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 12, meta.rhythmPattern.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 13, meta.spectralCentroid);
-    sqlite3_bind_double(stmt, 14, meta.spectralRolloff);
-    sqlite3_bind_double(stmt, 15, meta.zeroCrossingRate);
-    sqlite3_bind_double(stmt, 16, meta.mfccHash);
-    sqlite3_bind_int(stmt, 17, meta.analyzed ? 1 : 0);
-    sqlite3_bind_text(stmt, 18, meta.filepath.c_str(), -1, SQLITE_TRANSIENT);
-    
-    int rc = sqlite3_step(stmt);
-    
-    if (rc != SQLITE_DONE) {
-        std::cerr << "❌ SQLite Fehler beim UPDATE: " << sqlite3_errmsg(db_) << " (Code: " << rc << ")" << std::endl;
-        sqlite3_finalize(stmt);
+    // Upsert: fehlt die Datei noch, wird sie angelegt
+    if (!upsertMediaLocked(meta)) {
         return false;
     }
     
-    int changedRows = sqlite3_changes(db_);
-    sqlite3_finalize(stmt);
-    
-    if (changedRows == 0) {
-        std::cout << "⚠️ Keine Zeilen geändert - Datei noch nicht in Datenbank. Füge hinzu..." << std::endl;
-        return addMedia(meta);
-    }
-    
     std::cout << "✅ Erfolgreich aktualisiert: " << meta.filepath << std::endl;
     return true;
 }
 
 bool MediaDatabase::deleteMedia(int64_t id) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "deleteMedia", QueryScope::Write);
     
     const char* sql = "DELETE FROM media WHERE id = ?";
     sqlite3_stmt* stmt = prepareStatement(sql);
@@ -400,35 +1247,85 @@ bool MediaDatabase::deleteMedia(int64_t id) {
     int rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
     
+    if (rc == SQLITE_DONE) similarityIndex_.remove(id);
     return rc == SQLITE_DONE;
 }
 
+bool MediaDatabase::deleteByPathLocked(const std::string& filepath) {
+    sqlite3_stmt* find = cachedStatement("SELECT id FROM media WHERE filepath = ? LIMIT 1");
+    if (!find) return false;
+    
+    sqlite3_bind_text(find, 1, filepath.c_str(), -1, SQLITE_TRANSIENT);
+    int64_t id = (sqlite3_step(find) == SQLITE_ROW) ? sqlite3_column_int64(find, 0) : 0;
+    sqlite3_reset(find);
+    if (id == 0) return false;
+    
+    sqlite3_stmt* stmt = cachedStatement("DELETE FROM media WHERE id = ?");
+    if (!stmt) return false;
+    
+    sqlite3_bind_int64(stmt, 1, id);
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    
+    if (rc != SQLITE_DONE) return false;
+    similarityIndex_.remove(id);
+    return true;
+}
+
+bool MediaDatabase::movePathLocked(const std::string& oldPath, const std::string& newPath) {
+    // Zielpfad schon belegt → UNIQUE-Konflikt, Eintrag bleibt unverändert
+    sqlite3_stmt* stmt = cachedStatement("UPDATE OR IGNORE media SET filepath = ? WHERE filepath = ?");
+    if (!stmt) return false;
+    
+    sqlite3_bind_text(stmt, 1, newPath.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, oldPath.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(stmt);
+    int changedRows = sqlite3_changes(db_);
+    sqlite3_reset(stmt);
+    
+    return rc == SQLITE_DONE && changedRows > 0;
+}
+
 bool MediaDatabase::existsByPath(const std::string& filepath) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "existsByPath", QueryScope::WriterRead);
     
-    const char* sql = "SELECT COUNT(*) FROM media WHERE filepath = ?";
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = cachedStatement("SELECT 1 FROM media WHERE filepath = ? LIMIT 1");
     if (!stmt) return false;
     
     sqlite3_bind_text(stmt, 1, filepath.c_str(), -1, SQLITE_TRANSIENT);
+    bool exists = (sqlite3_step(stmt) == SQLITE_ROW);
+    sqlite3_reset(stmt);
+    return exists;
+}
+
+bool MediaDatabase::existsByHash(const std::string& fileHash) {
+    if (fileHash.empty()) return false;
+    QueryScope query(*this, "existsByHash", QueryScope::WriterRead);
+    return findIdByHash(fileHash) != 0;
+}
+
+int64_t MediaDatabase::findIdByHash(const std::string& fileHash) {
+    sqlite3_stmt* stmt = cachedStatement("SELECT id FROM media WHERE fileHash = ? LIMIT 1");
+    if (!stmt) return 0;
     
-    bool exists = false;
+    sqlite3_bind_text(stmt, 1, fileHash.c_str(), -1, SQLITE_TRANSIENT);
+    int64_t id = 0;
     if (sqlite3_step(stmt) == SQLITE_ROW) {
-        exists = (sqlite3_column_int(stmt, 0) > 0);
+        id = sqlite3_column_int64(stmt, 0);
     }
     
-    sqlite3_finalize(stmt);
-    return exists;
+    sqlite3_reset(stmt);
+    return id;
 }
 
 // ===== SORTIERTE & ABSPIELFERTIGE ABFRAGEN =====
 
 std::vector<MediaMetadata> MediaDatabase::getAllSortedByGenre() {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "getAllSortedByGenre", QueryScope::Read);
     std::vector<MediaMetadata> results;
     
     const char* sql = "SELECT * FROM media WHERE analyzed = 1 ORDER BY genre, bpm";
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return results;
     
     while (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -453,11 +1350,11 @@ std::vector<MediaMetadata> MediaDatabase::getAllSortedByGenre() {
 }
 
 std::vector<MediaMetadata> MediaDatabase::getAllSortedByBPM() {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "getAllSortedByBPM", QueryScope::Read);
     std::vector<MediaMetadata> results;
     
     const char* sql = "SELECT * FROM media WHERE analyzed = 1 ORDER BY bpm, genre";
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return results;
     
     while (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -475,11 +1372,11 @@ std::vector<MediaMetadata> MediaDatabase::getAllSortedByBPM() {
 }
 
 std::vector<MediaMetadata> MediaDatabase::getAllSortedByMood() {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "getAllSortedByMood", QueryScope::Read);
     std::vector<MediaMetadata> results;
     
     const char* sql = "SELECT * FROM media WHERE analyzed = 1 AND mood != '' ORDER BY mood, genre";
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return results;
     
     while (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -497,12 +1394,12 @@ std::vector<MediaMetadata> MediaDatabase::getAllSortedByMood() {
 }
 
 std::vector<MediaMetadata> MediaDatabase::getPlayableByCategory(const std::string& category) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "getPlayableByCategory", QueryScope::Read);
     std::vector<MediaMetadata> results;
     
     // Suche nach Genre oder Mood-Tag
     const char* sql = "SELECT * FROM media WHERE analyzed = 1 AND (genre LIKE ? OR mood LIKE ?) ORDER BY bpm";
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return results;
     
     std::string pattern = "%" + category + "%";
@@ -572,96 +1469,107 @@ std::vector<MediaDatabase::DuplicateInfo> MediaDatabase::findDuplicates(float th
 }
 
 std::vector<MediaDatabase::DuplicateInfo> MediaDatabase::findIdenticalFiles() {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "findIdenticalFiles", QueryScope::Read);
+    
+    // Gleicher Titel + Artist + Dauer: Gruppierung im Speicher statt Self-Join
+    DuplicateDetector detector;
+    loadDuplicateCandidates(query.connection(), detector, "");
+    return toDuplicateInfo(detector, detector.findIdentical());
+}
+
+std::vector<MediaDatabase::DuplicateInfo> MediaDatabase::findAudioDuplicates(float mfccThreshold) {
+    QueryScope query(*this, "findAudioDuplicates", QueryScope::Read);
+    
+    // Ähnliche Audio-Features (MFCC, Spectral Centroid) innerhalb ±2 s Dauer / ±2 BPM,
+    // Kandidaten per LSH-Buckets statt O(n²)-Self-Join
+    DuplicateDetector detector;
+    loadDuplicateCandidates(query.connection(), detector, "WHERE analyzed = 1");
+    return toDuplicateInfo(detector, detector.findAudioDuplicates(mfccThreshold));
+}
+
+std::vector<MediaDatabase::DuplicateInfo> MediaDatabase::checkDuplicate(const MediaMetadata& meta, float mfccThreshold) {
+    QueryScope query(*this, "checkDuplicate", QueryScope::Read);
     std::vector<DuplicateInfo> duplicates;
     
-    // Finde Dateien mit identischem Pfad (sollte nicht vorkommen, aber sicher ist sicher)
-    // Oder gleicher Dauer + BPM + Titel
-    std::string sql = R"(
-        SELECT m1.id, m2.id, m1.filepath, m2.filepath, m1.title, m1.duration, m1.bpm
-        FROM media m1
-        JOIN media m2 ON m1.id < m2.id
-        WHERE (m1.title = m2.title AND m1.artist = m2.artist AND ABS(m1.duration - m2.duration) < 0.1)
-           OR (m1.filepath = m2.filepath)
-        ORDER BY m1.id
-    )";
+    DuplicateDetector::Track track = toDuplicateTrack(meta);
     
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    // Nur Bereichs-Kandidaten über idx_duration lesen (kein Voll-Scan)
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), std::string(kDuplicateCandidateColumns) +
+        " FROM media WHERE duration > ? AND duration < ? AND filepath != ?");
     if (!stmt) return duplicates;
     
+    sqlite3_bind_double(stmt, 1, meta.duration - DuplicateDetector::kMaxDurationDiff);
+    sqlite3_bind_double(stmt, 2, meta.duration + DuplicateDetector::kMaxDurationDiff);
+    sqlite3_bind_text(stmt, 3, meta.filepath.c_str(), -1, SQLITE_TRANSIENT);
+    
     while (sqlite3_step(stmt) == SQLITE_ROW) {
+        DuplicateDetector::Track other = readDuplicateTrack(stmt);
+        
         DuplicateInfo dup;
-        dup.id1 = sqlite3_column_int64(stmt, 0);
-        dup.id2 = sqlite3_column_int64(stmt, 1);
-        dup.filepath1 = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        dup.filepath2 = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        dup.similarity = 1.0f;
-        dup.reason = "identical_metadata";
+        dup.id1 = other.id;
+        dup.id2 = meta.id;
+        dup.filepath1 = other.filepath;
+        dup.filepath2 = meta.filepath;
         
-        duplicates.push_back(dup);
+        if (track.hasTitleArtist && other.hasTitleArtist &&
+            track.title == other.title && track.artist == other.artist &&
+            std::abs(track.duration - other.duration) < DuplicateDetector::kIdenticalDurationDiff) {
+            dup.similarity = 1.0f;
+            dup.reason = "identical_metadata";
+            duplicates.push_back(dup);
+        } else if (meta.analyzed && other.analyzed &&
+                   DuplicateDetector::withinAudioWindow(track, other)) {
+            float similarity = DuplicateDetector::audioSimilarity(track, other);
+            if (similarity >= mfccThreshold) {
+                dup.similarity = similarity;
+                dup.reason = "similar_audio";
+                duplicates.push_back(dup);
+            }
+        }
     }
     
     sqlite3_finalize(stmt);
     return duplicates;
 }
 
-std::vector<MediaDatabase::DuplicateInfo> MediaDatabase::findAudioDuplicates(float mfccThreshold) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
-    std::vector<DuplicateInfo> duplicates;
-    
-    // Finde Dateien mit ähnlichen Audio-Features
-    // MFCC-Hash, Spectral Centroid, Duration, BPM
-    std::string sql = R"(
-        SELECT m1.id, m2.id, m1.filepath, m2.filepath,
-               m1.mfccHash, m2.mfccHash,
-               m1.spectralCentroid, m2.spectralCentroid,
-               m1.duration, m2.duration, m1.bpm, m2.bpm
-        FROM media m1
-        JOIN media m2 ON m1.id < m2.id
-        WHERE m1.analyzed = 1 AND m2.analyzed = 1
-          AND ABS(m1.duration - m2.duration) < 2.0
-          AND ABS(m1.bpm - m2.bpm) < 2.0
-        ORDER BY m1.id
-    )";
-    
-    sqlite3_stmt* stmt = prepareStatement(sql);
-    if (!stmt) return duplicates;
+void MediaDatabase::loadDuplicateCandidates(sqlite3* connection, DuplicateDetector& detector,
+                                            const std::string& where) {
+    sqlite3_stmt* stmt = prepareStatement(connection, std::string(kDuplicateCandidateColumns) + " FROM media " + where);
+    if (!stmt) return;
     
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int64_t id1 = sqlite3_column_int64(stmt, 0);
-        int64_t id2 = sqlite3_column_int64(stmt, 1);
-        std::string path1 = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        std::string path2 = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        
-        float mfcc1 = sqlite3_column_double(stmt, 4);
-        float mfcc2 = sqlite3_column_double(stmt, 5);
-        float sc1 = sqlite3_column_double(stmt, 6);
-        float sc2 = sqlite3_column_double(stmt, 7);
-        
-        // Berechne Ähnlichkeit
-        float mfccSim = 1.0f - std::abs(mfcc1 - mfcc2) / std::max(std::abs(mfcc1), std::abs(mfcc2));
-        float scSim = 1.0f - std::abs(sc1 - sc2) / std::max(sc1, sc2);
-        float similarity = (mfccSim * 0.7f + scSim * 0.3f);
+        detector.add(readDuplicateTrack(stmt));
+    }
+    sqlite3_finalize(stmt);
+}
+
+std::vector<MediaDatabase::DuplicateInfo> MediaDatabase::toDuplicateInfo(
+    const DuplicateDetector& detector, const std::vector<DuplicateDetector::Match>& matches) {
+    std::vector<DuplicateInfo> duplicates;
+    duplicates.reserve(matches.size());
+    
+    const auto& tracks = detector.tracks();
+    for (const auto& match : matches) {
+        DuplicateInfo dup;
+        dup.id1 = tracks[match.first].id;
+        dup.id2 = tracks[match.second].id;
+        dup.filepath1 = tracks[match.first].filepath;
+        dup.filepath2 = tracks[match.second].filepath;
+        dup.similarity = match.similarity;
+        dup.reason = match.reason;
         
-        if (similarity >= mfccThreshold) {
-            DuplicateInfo dup;
-            dup.id1 = id1;
-            dup.id2 = id2;
-            dup.filepath1 = path1;
-            dup.filepath2 = path2;
-            dup.similarity = similarity;
-            dup.reason = "similar_audio";
-            
-            duplicates.push_back(dup);
+        // Niedrigere ID zuerst (wie bisher m1.id < m2.id)
+        if (dup.id1 > dup.id2) {
+            std::swap(dup.id1, dup.id2);
+            std::swap(dup.filepath1, dup.filepath2);
         }
+        duplicates.push_back(dup);
     }
-    
-    sqlite3_finalize(stmt);
     return duplicates;
 }
 
 bool MediaDatabase::removeDuplicate(int64_t keepId, int64_t removeId) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "removeDuplicate", QueryScope::Write);
     
     std::string sql = "DELETE FROM media WHERE id = ?";
     sqlite3_stmt* stmt = prepareStatement(sql);
@@ -671,13 +1579,23 @@ bool MediaDatabase::removeDuplicate(int64_t keepId, int64_t removeId) {
     int rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
     
+    if (rc == SQLITE_DONE) similarityIndex_.remove(removeId);
     return rc == SQLITE_DONE;
 }
 
 // === Training-Dataset Verwaltung ===
 
 MediaDatabase::TrainingStats MediaDatabase::getTrainingStats() {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    TrainingStats stats = queryTrainingStats();
+    
+    // Estimate duplicates (eigene Verbindung, nicht innerhalb der obigen Abfrage)
+    stats.duplicates = findIdenticalFiles().size();
+    
+    return stats;
+}
+
+MediaDatabase::TrainingStats MediaDatabase::queryTrainingStats() {
+    QueryScope query(*this, "getTrainingStats", QueryScope::Read);
     TrainingStats stats;
     stats.totalFiles = 0;
     stats.analyzedFiles = 0;
@@ -687,7 +1605,7 @@ MediaDatabase::TrainingStats MediaDatabase::getTrainingStats() {
     stats.filesWithoutGenre = 0;
     
     // Total Count
-    sqlite3_stmt* stmt = prepareStatement("SELECT COUNT(*), SUM(analyzed), AVG(bpm), AVG(duration) FROM media");
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), "SELECT COUNT(*), SUM(analyzed), AVG(bpm), AVG(duration) FROM media");
     if (stmt && sqlite3_step(stmt) == SQLITE_ROW) {
         stats.totalFiles = sqlite3_column_int(stmt, 0);
         stats.analyzedFiles = sqlite3_column_int(stmt, 1);
@@ -697,7 +1615,7 @@ MediaDatabase::TrainingStats MediaDatabase::getTrainingStats() {
     sqlite3_finalize(stmt);
     
     // Genre Distribution
-    stmt = prepareStatement("SELECT genre, COUNT(*) FROM media WHERE genre != '' GROUP BY genre ORDER BY COUNT(*) DESC");
+    stmt = prepareStatement(query.connection(), "SELECT genre, COUNT(*) FROM media WHERE genre != '' GROUP BY genre ORDER BY COUNT(*) DESC");
     if (stmt) {
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             std::string genre = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
@@ -708,7 +1626,7 @@ MediaDatabase::TrainingStats MediaDatabase::getTrainingStats() {
     }
     
     // Intensity Distribution
-    stmt = prepareStatement("SELECT intensity, COUNT(*) FROM media WHERE intensity != '' GROUP BY intensity");
+    stmt = prepareStatement(query.connection(), "SELECT intensity, COUNT(*) FROM media WHERE intensity != '' GROUP BY intensity");
     if (stmt) {
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             std::string intensity = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
@@ -719,20 +1637,17 @@ MediaDatabase::TrainingStats MediaDatabase::getTrainingStats() {
     }
     
     // Files without genre
-    stmt = prepareStatement("SELECT COUNT(*) FROM media WHERE genre = '' OR genre IS NULL");
+    stmt = prepareStatement(query.connection(), "SELECT COUNT(*) FROM media WHERE genre = '' OR genre IS NULL");
     if (stmt && sqlite3_step(stmt) == SQLITE_ROW) {
         stats.filesWithoutGenre = sqlite3_column_int(stmt, 0);
     }
     sqlite3_finalize(stmt);
     
-    // Estimate duplicates
-    stats.duplicates = findIdenticalFiles().size();
-    
     return stats;
 }
 
 std::vector<MediaMetadata> MediaDatabase::getTrainingSet(const std::string& genre, size_t maxSamples) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "getTrainingSet", QueryScope::Read);
     std::vector<MediaMetadata> results;
     
     std::string sql = "SELECT * FROM media WHERE analyzed = 1";
@@ -744,14 +1659,19 @@ std::vector<MediaMetadata> MediaDatabase::getTrainingSet(const std::string& genr
         sql += " LIMIT " + std::to_string(maxSamples);
     }
     
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return results;
     
+    const int mfccMeanCol = columnIndex(stmt, "mfccMean");
+    const int mfccVarianceCol = columnIndex(stmt, "mfccVariance");
+    
     while (sqlite3_step(stmt) == SQLITE_ROW) {
         MediaMetadata meta;
         meta.id = sqlite3_column_int64(stmt, 0);
         meta.filepath = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
         meta.analyzed = sqlite3_column_int(stmt, 21);
+        meta.mfccMean = columnFloatBlob(stmt, mfccMeanCol);
+        meta.mfccVariance = columnFloatBlob(stmt, mfccVarianceCol);
         // ... weitere Felder laden
         results.push_back(meta);
     }
@@ -791,7 +1711,7 @@ bool MediaDatabase::balanceDataset() {
 
 // Interaktive Training-Entscheidungen
 bool MediaDatabase::saveDecision(const TrainingDecision& decision) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "saveDecision", QueryScope::Write);
     
     // Konvertiere options-Vector zu JSON-String
     std::string optionsJson = "[";
@@ -826,7 +1746,7 @@ bool MediaDatabase::saveDecision(const TrainingDecision& decision) {
 }
 
 std::vector<MediaDatabase::TrainingDecision> MediaDatabase::getDecisionHistory(size_t limit) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "getDecisionHistory", QueryScope::Read);
     std::vector<TrainingDecision> decisions;
     
     std::string sql = "SELECT id, question, options, userAnswer, confidence, context, timestamp, decisionType "
@@ -835,7 +1755,7 @@ std::vector<MediaDatabase::TrainingDecision> MediaDatabase::getDecisionHistory(s
         sql += " LIMIT " + std::to_string(limit);
     }
     
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return decisions;
     
     while (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -875,7 +1795,7 @@ std::vector<MediaDatabase::TrainingDecision> MediaDatabase::findSimilarDecisions
     const std::string& context, float threshold) {
     // Für jetzt: Finde Entscheidungen mit gleichem decisionType
     // TODO: Implementiere Context-Similarity-Matching (JSON parsing + Vergleich)
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "findSimilarDecisions", QueryScope::Read);
     std::vector<TrainingDecision> decisions;
     
     // Extrahiere decisionType aus context (vereinfachte Version)
@@ -891,7 +1811,7 @@ std::vector<MediaDatabase::TrainingDecision> MediaDatabase::findSimilarDecisions
     const char* sql = "SELECT id, question, options, userAnswer, confidence, context, timestamp, decisionType "
                      "FROM training_decisions WHERE decisionType = ? ORDER BY timestamp DESC LIMIT 10";
     
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return decisions;
     
     sqlite3_bind_text(stmt, 1, type.c_str(), -1, SQLITE_TRANSIENT);
@@ -929,13 +1849,13 @@ std::vector<MediaDatabase::TrainingDecision> MediaDatabase::findSimilarDecisions
 }
 
 std::vector<MediaDatabase::TrainingDecision> MediaDatabase::getUnansweredQuestions() {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "getUnansweredQuestions", QueryScope::Read);
     std::vector<TrainingDecision> questions;
     
     const char* sql = "SELECT id, question, options, userAnswer, confidence, context, timestamp, decisionType, audioFile "
                      "FROM training_decisions WHERE answered = 0 ORDER BY timestamp DESC";
     
-    sqlite3_stmt* stmt = prepareStatement(sql);
+    sqlite3_stmt* stmt = prepareStatement(query.connection(), sql);
     if (!stmt) return questions;
     
     while (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -977,7 +1897,7 @@ std::vector<MediaDatabase::TrainingDecision> MediaDatabase::getUnansweredQuestio
 }
 
 bool MediaDatabase::markQuestionAsAnswered(int64_t id, const std::string& answer) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "markQuestionAsAnswered", QueryScope::Write);
     
     const char* sql = "UPDATE training_decisions SET answered = 1, userAnswer = ? WHERE id = ?";
     sqlite3_stmt* stmt = prepareStatement(sql);
@@ -993,7 +1913,7 @@ bool MediaDatabase::markQuestionAsAnswered(int64_t id, const std::string& answer
 }
 
 bool MediaDatabase::deleteDecision(int64_t id) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    QueryScope query(*this, "deleteDecision", QueryScope::Write);
     
     const char* sql = "DELETE FROM training_decisions WHERE id = ?";
     sqlite3_stmt* stmt = prepareStatement(sql);
@@ -0,0 +1,165 @@
+#include "MediaListModel.h"
+#include <string>
+
+struct _MediaListModel {
+    GObject parent_instance;
+    MediaPager* pager;
+    gint stamp;
+};
+
+static void media_list_model_tree_model_init(GtkTreeModelIface* iface);
+
+G_DEFINE_TYPE_WITH_CODE(MediaListModel, media_list_model, G_TYPE_OBJECT,
+                        G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_MODEL, media_list_model_tree_model_init))
+
+// Iter = Zeilenindex in user_data; stamp macht Iter alter Models ungültig
+static inline size_t iterIndex(GtkTreeIter* iter) {
+    return GPOINTER_TO_SIZE(iter->user_data);
+}
+
+static inline void setIter(MediaListModel* model, GtkTreeIter* iter, size_t index) {
+    iter->stamp = model->stamp;
+    iter->user_data = GSIZE_TO_POINTER(index);
+    iter->user_data2 = nullptr;
+    iter->user_data3 = nullptr;
+}
+
+static GtkTreeModelFlags media_list_model_get_flags(GtkTreeModel*) {
+    return static_cast<GtkTreeModelFlags>(GTK_TREE_MODEL_LIST_ONLY | GTK_TREE_MODEL_ITERS_PERSIST);
+}
+
+static gint media_list_model_get_n_columns(GtkTreeModel*) {
+    return MEDIA_LIST_N_COLUMNS;
+}
+
+static GType media_list_model_get_column_type(GtkTreeModel*, gint) {
+    return G_TYPE_STRING;
+}
+
+static gboolean media_list_model_get_iter(GtkTreeModel* treeModel, GtkTreeIter* iter, GtkTreePath* path) {
+    MediaListModel* model = MEDIA_LIST_MODEL(treeModel);
+    if (gtk_tree_path_get_depth(path) != 1) return FALSE;
+
+    gint index = gtk_tree_path_get_indices(path)[0];
+    if (index < 0 || static_cast<size_t>(index) >= model->pager->size()) return FALSE;
+
+    setIter(model, iter, static_cast<size_t>(index));
+    return TRUE;
+}
+
+static GtkTreePath* media_list_model_get_path(GtkTreeModel* treeModel, GtkTreeIter* iter) {
+    g_return_val_if_fail(iter->stamp == MEDIA_LIST_MODEL(treeModel)->stamp, nullptr);
+    return gtk_tree_path_new_from_indices(static_cast<gint>(iterIndex(iter)), -1);
+}
+
+static void media_list_model_get_value(GtkTreeModel* treeModel, GtkTreeIter* iter, gint column, GValue* value) {
+    MediaListModel* model = MEDIA_LIST_MODEL(treeModel);
+    g_value_init(value, G_TYPE_STRING);
+    g_return_if_fail(iter->stamp == model->stamp);
+
+    // Lädt bei Bedarf die Seite der Zeile; gelöschte Einträge bleiben leer
+    const MediaMetadata* meta = model->pager->at(iterIndex(iter));
+    if (!meta) return;
+
+    switch (column) {
+        case MEDIA_LIST_COL_PLAY:
+            g_value_set_string(value, "▶️");
+            break;
+        case MEDIA_LIST_COL_TITLE:
+            g_value_set_string(value, meta->title.c_str());
+            break;
+        case MEDIA_LIST_COL_ARTIST:
+            g_value_set_string(value, meta->artist.c_str());
+            break;
+        case MEDIA_LIST_COL_GENRE:
+            g_value_set_string(value, meta->genre.c_str());
+            break;
+        case MEDIA_LIST_COL_DURATION:
+            g_value_set_string(value, (std::to_string(meta->duration) + "s").c_str());
+            break;
+        case MEDIA_LIST_COL_FILEPATH:
+            g_value_set_string(value, meta->filepath.c_str());
+            break;
+        default:
+            break;
+    }
+}
+
+static gboolean media_list_model_iter_next(GtkTreeModel* treeModel, GtkTreeIter* iter) {
+    MediaListModel* model = MEDIA_LIST_MODEL(treeModel);
+    size_t next = iterIndex(iter) + 1;
+    if (next >= model->pager->size()) {
+        iter->stamp = 0;
+        return FALSE;
+    }
+    setIter(model, iter, next);
+    return TRUE;
+}
+
+static gboolean media_list_model_iter_previous(GtkTreeModel* treeModel, GtkTreeIter* iter) {
+    MediaListModel* model = MEDIA_LIST_MODEL(treeModel);
+    size_t index = iterIndex(iter);
+    if (index == 0) {
+        iter->stamp = 0;
+        return FALSE;
+    }
+    setIter(model, iter, index - 1);
+    return TRUE;
+}
+
+static gboolean media_list_model_iter_nth_child(GtkTreeModel* treeModel, GtkTreeIter* iter,
+                                                GtkTreeIter* parent, gint n) {
+    MediaListModel* model = MEDIA_LIST_MODEL(treeModel);
+    if (parent || n < 0 || static_cast<size_t>(n) >= model->pager->size()) return FALSE;
+    setIter(model, iter, static_cast<size_t>(n));
+    return TRUE;
+}
+
+static gboolean media_list_model_iter_children(GtkTreeModel* treeModel, GtkTreeIter* iter, GtkTreeIter* parent) {
+    return media_list_model_iter_nth_child(treeModel, iter, parent, 0);
+}
+
+static gboolean media_list_model_iter_has_child(GtkTreeModel*, GtkTreeIter*) {
+    return FALSE;
+}
+
+static gint media_list_model_iter_n_children(GtkTreeModel* treeModel, GtkTreeIter* iter) {
+    if (iter) return 0;
+    return static_cast<gint>(MEDIA_LIST_MODEL(treeModel)->pager->size());
+}
+
+static gboolean media_list_model_iter_parent(GtkTreeModel*, GtkTreeIter*, GtkTreeIter*) {
+    return FALSE;
+}
+
+static void media_list_model_tree_model_init(GtkTreeModelIface* iface) {
+    iface->get_flags = media_list_model_get_flags;
+    iface->get_n_columns = media_list_model_get_n_columns;
+    iface->get_column_type = media_list_model_get_column_type;
+    iface->get_iter = media_list_model_get_iter;
+    iface->get_path = media_list_model_get_path;
+    iface->get_value = media_list_model_get_value;
+    iface->iter_next = media_list_model_iter_next;
+    iface->iter_previous = media_list_model_iter_previous;
+    iface->iter_children = media_list_model_iter_children;
+    iface->iter_has_child = media_list_model_iter_has_child;
+    iface->iter_n_children = media_list_model_iter_n_children;
+    iface->iter_nth_child = media_list_model_iter_nth_child;
+    iface->iter_parent = media_list_model_iter_parent;
+}
+
+static void media_list_model_class_init(MediaListModelClass*) {
+}
+
+static void media_list_model_init(MediaListModel* model) {
+    model->pager = nullptr;
+    do {
+        model->stamp = static_cast<gint>(g_random_int());
+    } while (model->stamp == 0);
+}
+
+MediaListModel* media_list_model_new(MediaPager* pager) {
+    MediaListModel* model = MEDIA_LIST_MODEL(g_object_new(MEDIA_TYPE_LIST_MODEL, nullptr));
+    model->pager = pager;
+    return model;
+}
@@ -0,0 +1,72 @@
+#include "MediaPager.h"
+#include <algorithm>
+
+MediaPager::MediaPager(MediaDatabase& db, uint32_t columns)
+    : db_(db), columns_(columns) {}
+
+void MediaPager::setQuery(const MediaDatabase::MediaQuery& query) {
+    query_ = query;
+    query_.limit = 0;
+    query_.offset = 0;
+    refresh();
+}
+
+void MediaPager::refresh() {
+    ids_ = db_.queryIds(query_);
+    pages_.clear();
+}
+
+void MediaPager::invalidateRows() {
+    pages_.clear();
+}
+
+const MediaMetadata* MediaPager::at(size_t index) {
+    if (index >= ids_.size()) return nullptr;
+
+    Page& page = loadPage(index / kPageSize);
+    size_t offset = index % kPageSize;
+    if (offset >= page.rows.size() || page.rows[offset].id == 0) return nullptr;
+    return &page.rows[offset];
+}
+
+void MediaPager::prefetch(size_t first, size_t last) {
+    last = std::min(last, ids_.size());
+    if (first >= last) return;
+
+    // Sichtbarer Bereich darf nicht verdrängt werden, auch wenn er den Cache übersteigt
+    size_t firstPage = first / kPageSize;
+    size_t lastPage = (last - 1) / kPageSize;
+    for (size_t page = firstPage; page <= lastPage && page - firstPage < kMaxCachedPages; ++page) {
+        loadPage(page);
+    }
+}
+
+MediaPager::Page& MediaPager::loadPage(size_t page) {
+    auto it = pages_.find(page);
+    if (it != pages_.end()) {
+        it->second.lastUse = ++useCounter_;
+        return it->second;
+    }
+
+    evictPages(kMaxCachedPages - 1);
+
+    size_t begin = page * kPageSize;
+    size_t end = std::min(ids_.size(), begin + kPageSize);
+    std::vector<int64_t> pageIds(ids_.begin() + begin, ids_.begin() + end);
+
+    Page& loaded = pages_[page];
+    loaded.rows = db_.getByIds(pageIds, columns_);
+    loaded.lastUse = ++useCounter_;
+    pageLoads_++;
+    return loaded;
+}
+
+void MediaPager::evictPages(size_t keep) {
+    while (pages_.size() > keep) {
+        auto oldest = pages_.begin();
+        for (auto it = pages_.begin(); it != pages_.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+        }
+        pages_.erase(oldest);
+    }
+}
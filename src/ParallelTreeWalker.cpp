@@ -0,0 +1,236 @@
+#include "ParallelTreeWalker.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+std::string joinPath(const std::string& dir, const char* name) {
+    return dir == "/" ? "/" + std::string(name) : dir + "/" + name;
+}
+
+bool isDotEntry(const char* name) {
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+/**
+ * Ruft onEntry(name, d_type) für jeden Eintrag des geöffneten Verzeichnisses auf
+ * @return 0 oder errno
+ */
+template <typename OnEntry>
+int readEntries(int fd, OnEntry&& onEntry) {
+#ifdef __linux__
+    // Blockweise wie readdir intern, aber ohne DIR-Allokation und mit großem Puffer
+    alignas(8) char buffer[64 * 1024];
+    while (true) {
+        long bytes = ::syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+        if (bytes < 0) return errno;
+        if (bytes == 0) return 0;
+        for (long offset = 0; offset < bytes;) {
+            const auto* entry = reinterpret_cast<const struct dirent64*>(buffer + offset);
+            offset += entry->d_reclen;
+            if (!isDotEntry(entry->d_name)) onEntry(entry->d_name, entry->d_type);
+        }
+    }
+#else
+    int copy = ::dup(fd);
+    DIR* dir = copy >= 0 ? ::fdopendir(copy) : nullptr;
+    if (!dir) {
+        int error = errno;
+        if (copy >= 0) ::close(copy);
+        return error;
+    }
+    errno = 0;
+    while (dirent* entry = ::readdir(dir)) {
+        if (!isDotEntry(entry->d_name)) onEntry(entry->d_name, entry->d_type);
+    }
+    int error = errno;
+    ::closedir(dir);
+    return error;
+#endif
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+ParallelTreeWalker::ParallelTreeWalker(const Options& options) : options_(options) {
+    for (auto& ext : options_.extensions) {
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    }
+}
+
+unsigned int ParallelTreeWalker::defaultThreads() {
+    // Latenzgebunden (NAS/SMB): mehr Threads als Kerne, aber begrenzt
+    unsigned int hw = std::max(1u, std::thread::hardware_concurrency());
+    return std::min(64u, std::max(4u, 2 * hw));
+}
+
+bool ParallelTreeWalker::matches(const char* name) const {
+    if (options_.extensions.empty()) return true;
+    const char* dot = std::strrchr(name, '.');
+    if (!dot) return false;
+    for (const auto& ext : options_.extensions) {
+        if (ext.size() == std::strlen(dot) && strncasecmp(dot, ext.c_str(), ext.size()) == 0) return true;
+    }
+    return false;
+}
+
+std::vector<std::string> ParallelTreeWalker::collect(const std::string& root) {
+    const auto start = std::chrono::steady_clock::now();
+    errors_.clear();
+    stats_ = Stats();
+
+    std::string base = root;
+    while (base.size() > 1 && base.back() == '/') base.pop_back();
+
+    std::vector<std::string> files;
+    struct stat rootStat;
+    if (::stat(base.c_str(), &rootStat) != 0) {
+        errors_.push_back(base + ": " + std::strerror(errno));
+        stats_.errors = 1;
+        return files;
+    }
+    if (!S_ISDIR(rootStat.st_mode)) {
+        if (S_ISREG(rootStat.st_mode) && matches(base.c_str())) files.push_back(base);
+        stats_.files = files.size();
+        return files;
+    }
+
+    // Gemeinsamer Stapel offener Verzeichnisse; outstanding = gestapelt + in Arbeit
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::string> pending{base};
+    size_t outstanding = 1;
+
+    auto worker = [&]() {
+        std::vector<std::string> localFiles;
+        std::vector<std::string> localErrors;
+        std::vector<std::string> subdirs;
+        size_t directories = 0;
+
+        while (true) {
+            std::string dir;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return !pending.empty() || outstanding == 0; });
+                if (pending.empty()) break;
+                dir = std::move(pending.back());
+                pending.pop_back();
+            }
+
+            subdirs.clear();
+            if (!options_.stopFlag || !options_.stopFlag->load()) {
+                directories++;
+                int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                if (fd < 0) {
+                    // Wie skip_permission_denied: verweigerte Verzeichnisse still überspringen
+                    if (errno != EACCES) localErrors.push_back(dir + ": " + std::strerror(errno));
+                } else {
+                    int error = readEntries(fd, [&](const char* name, unsigned char type) {
+                        if (type == DT_UNKNOWN) {
+                            struct stat st;
+                            if (::fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) return;
+                            type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG
+                                 : S_ISLNK(st.st_mode) ? DT_LNK : DT_UNKNOWN;
+                        }
+                        if (type == DT_DIR) {
+                            subdirs.push_back(joinPath(dir, name));
+                        } else if (type == DT_REG) {
+                            if (matches(name)) localFiles.push_back(joinPath(dir, name));
+                        } else if (type == DT_LNK && matches(name)) {
+                            // Symlink auf Datei zählt, auf Verzeichnis nicht (keine Zyklen)
+                            struct stat st;
+                            if (::fstatat(fd, name, &st, 0) == 0 && S_ISREG(st.st_mode)) {
+                                localFiles.push_back(joinPath(dir, name));
+                            }
+                        }
+                    });
+                    if (error != 0 && error != EACCES) localErrors.push_back(dir + ": " + std::strerror(error));
+                    ::close(fd);
+                }
+            }
+
+            bool finished;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto& sub : subdirs) pending.push_back(std::move(sub));
+                outstanding += subdirs.size();
+                finished = --outstanding == 0;
+            }
+            if (finished) {
+                wake.notify_all();
+            } else if (!subdirs.empty()) {
+                subdirs.size() > 1 ? wake.notify_all() : wake.notify_one();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        files.insert(files.end(), std::make_move_iterator(localFiles.begin()),
+                     std::make_move_iterator(localFiles.end()));
+        errors_.insert(errors_.end(), localErrors.begin(), localErrors.end());
+        stats_.directories += directories;
+    };
+
+    unsigned int threads = options_.threads > 0 ? options_.threads : defaultThreads();
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threads; ++i) workers.emplace_back(worker);
+    worker();
+    for (auto& thread : workers) thread.join();
+
+    std::sort(files.begin(), files.end());
+    stats_.files = files.size();
+    stats_.errors = errors_.size();
+    stats_.seconds = secondsSince(start);
+    return files;
+}
+
+ParallelTreeWalker::Listing ParallelTreeWalker::listNames(const std::string& dir) {
+    Listing listing;
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        listing.exists = (errno != ENOENT && errno != ENOTDIR);
+        return listing;
+    }
+    listing.exists = true;
+    int error = readEntries(fd, [&](const char* name, unsigned char) { listing.names.insert(name); });
+    listing.readable = (error == 0);
+    ::close(fd);
+    return listing;
+}
+
+std::unordered_map<std::string, ParallelTreeWalker::Listing> ParallelTreeWalker::listDirectories(
+    const std::vector<std::string>& dirs, unsigned int threads) {
+    std::vector<std::string> unique(dirs);
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+    std::vector<Listing> listings(unique.size());
+    WorkStealingPool pool(threads > 0 ? threads : defaultThreads());
+    pool.run(unique.size(), [&](size_t idx, size_t) {
+        listings[idx] = listNames(unique[idx]);
+    });
+
+    std::unordered_map<std::string, Listing> result;
+    result.reserve(unique.size());
+    for (size_t i = 0; i < unique.size(); ++i) {
+        result.emplace(std::move(unique[i]), std::move(listings[i]));
+    }
+    return result;
+}
@@ -0,0 +1,107 @@
+#include "../include/RenderGraph.h"
+#include <algorithm>
+#include <cmath>
+
+namespace SongGen {
+
+void VoiceNode::play(uint64_t start, std::vector<float> samples, float gain) {
+    if (samples.empty()) return;
+    voices_.push_back({start, std::move(samples), gain});
+}
+
+void VoiceNode::render(uint64_t frame, std::vector<float>& block) {
+    const uint64_t blockEnd = frame + block.size();
+
+    // Schedule everything that starts inside this block
+    while (!exhausted_ && cursor_ < blockEnd) {
+        uint64_t before = cursor_;
+        exhausted_ = !advance() || cursor_ == before;
+    }
+
+    for (const auto& voice : voices_) {
+        uint64_t from = std::max(frame, voice.start);
+        uint64_t to = std::min(blockEnd, voice.start + voice.samples.size());
+        for (uint64_t i = from; i < to; ++i) {
+            block[i - frame] += voice.samples[i - voice.start] * voice.gain;
+        }
+    }
+
+    voices_.erase(std::remove_if(voices_.begin(), voices_.end(),
+                                 [blockEnd](const Voice& voice) {
+                                     return voice.start + voice.samples.size() <= blockEnd;
+                                 }),
+                  voices_.end());
+}
+
+RenderGraph::RenderGraph(int sampleRate) : sampleRate_(sampleRate) {}
+
+void RenderGraph::addSource(std::unique_ptr<RenderNode> node) {
+    sources_.push_back(std::move(node));
+}
+
+float RenderGraph::fillBlock(uint64_t frame, std::vector<float>& block) {
+    std::fill(block.begin(), block.end(), 0.0f);
+    for (auto& source : sources_) {
+        source->render(frame, block);
+    }
+    effects_.process(block, static_cast<float>(sampleRate_));
+
+    float peak = 0.0f;
+    for (float sample : block) {
+        peak = std::max(peak, std::abs(sample));
+    }
+    return peak;
+}
+
+float RenderGraph::requiredGain(float peak) const {
+    return peak > 0.0f ? std::min(maxGain, peakTarget / peak) : maxGain;
+}
+
+bool RenderGraph::render(uint64_t frames, const std::function<bool(const std::vector<float>&)>& sink,
+                         const std::function<void(float)>& progress) {
+    gain_ = 1.0f;
+    outputPeak_ = 0.0f;
+    if (frames == 0) return true;
+
+    const float release = std::pow(2.0f, kBlockFrames / (sampleRate_ * std::max(0.01f, releaseSeconds)));
+    const uint64_t fadeFrames = static_cast<uint64_t>(fadeInSeconds * sampleRate_);
+
+    // One block of look-ahead: the gain ramps down before a peak arrives
+    std::vector<float> current(std::min<uint64_t>(kBlockFrames, frames));
+    std::vector<float> next;
+    next.reserve(kBlockFrames);
+    float currentPeak = fillBlock(0, current);
+
+    for (uint64_t frame = 0; frame < frames;) {
+        const uint64_t nextFrame = frame + current.size();
+        float nextPeak = currentPeak;
+        if (nextFrame < frames) {
+            next.resize(std::min<uint64_t>(kBlockFrames, frames - nextFrame));
+            nextPeak = fillBlock(nextFrame, next);
+        }
+
+        // Both ends of the ramp stay below what this block needs, so no sample exceeds peakTarget
+        const float needed = requiredGain(currentPeak);
+        const float startGain = std::min(gain_, needed);
+        const float endGain = std::min({needed, requiredGain(nextPeak), gain_ * release});
+        const float step = (endGain - startGain) / current.size();
+        for (size_t i = 0; i < current.size(); ++i) {
+            float sample = current[i] * (startGain + step * (i + 1));
+            uint64_t position = frame + i;
+            if (position < fadeFrames) sample *= static_cast<float>(position) / fadeFrames;
+            current[i] = sample;
+            outputPeak_ = std::max(outputPeak_, std::abs(sample));
+        }
+        gain_ = endGain;
+
+        if (!sink(current)) return false;
+        if (progress) progress(static_cast<float>(nextFrame) / frames);
+
+        std::swap(current, next);
+        currentPeak = nextPeak;
+        frame = nextFrame;
+    }
+    return true;
+}
+
+} // namespace SongGen
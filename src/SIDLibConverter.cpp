@@ -1,5 +1,11 @@
 #include "SIDLibConverter.h"
 #include "SonglengthsDB.h"
+#include "SonglengthsIndex.h"
+#include "MeasuredLengthCache.h"
+#include "SIDRenderCache.h"
+#include "SIDRenderScheduler.h"
+#include "TrackEndDetector.h"
+#include "MP3EncoderPool.h"
 #include <iostream>
 #include <fstream>
 #include <cstring>
@@ -7,9 +13,6 @@
 #include <algorithm>
 #include <filesystem>
 #include <vector>
-#include <map>
-#include <spawn.h>
-#include <sys/wait.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <iomanip>
@@ -18,25 +21,82 @@
 #include <thread>
 #include <random>
 #include <atomic>
+#include <chrono>
+#include <memory>
 #include <lame/lame.h>
 
-extern char **environ;
+namespace {
 
-// Helper: Shell-escape a string for safe command execution
-static std::string shell_escape(const std::string& str) {
-    std::string result = "'";
-    for (char c : str) {
-        if (c == '\'') {
-            result += "'\\''";
-        } else {
-            result += c;
+// C64-ROMs (optional, nur für RSID/BASIC-Tunes nötig), einmal pro Prozess geladen
+struct RomImages {
+    std::vector<uint8_t> kernal;
+    std::vector<uint8_t> basic;
+    std::vector<uint8_t> chargen;
+};
+
+std::vector<uint8_t> readRom(const std::string& path, size_t expectedSize) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return {};
+    std::vector<uint8_t> data(expectedSize);
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(expectedSize));
+    if (file.gcount() != static_cast<std::streamsize>(expectedSize)) return {};
+    return data;
+}
+
+const RomImages& sharedRoms(const std::string& romPath) {
+    static RomImages roms;
+    static std::once_flag once;
+    std::call_once(once, [&]() {
+        roms.kernal = readRom(romPath + "/kernal", 8192);
+        roms.basic = readRom(romPath + "/basic", 8192);
+        roms.chargen = readRom(romPath + "/chargen", 4096);
+        if (!roms.kernal.empty()) {
+            std::cout << "[SIDLib] ✅ C64-ROMs geladen: " << romPath << "\n";
         }
-    }
-    result += "'";
-    return result;
+    });
+    return roms;
+}
+
+// Songlengths (HVSC + eigene Messungen) und Fallback-Cache, von allen Threads geteilt
+struct LengthState {
+    // HVSC-Index: unveränderlich und gemappt, Lookups ohne Lock (atomic_load)
+    std::shared_ptr<const SonglengthsIndex> index;
+    std::mutex indexMutex;                      // nur für Prüfen/Neuaufbau
+    std::atomic<int64_t> nextIndexCheck{0};     // steady_clock ms
+    bool warnedMissing = false;
+    
+    // Eigene Messungen, geschützt durch mutex
+    std::mutex mutex;
+    SonglengthsDB* custom = nullptr;
+};
+
+LengthState& lengthState() {
+    static LengthState state;
+    return state;
 }
 
-extern char **environ;
+std::string songgenPath(const std::string& file) {
+    const char* home = getenv("HOME");
+    return std::string(home ? home : "/tmp") + "/.songgen/" + file;
+}
+
+// Cache für Fallback-Längen (SID-Pfad + Subtune → Länge), lock-frei lesbar
+MeasuredLengthCache& measurementCache() {
+    static MeasuredLengthCache* cache = []() {
+        std::string logPath = songgenPath("measured_lengths.bin");
+        std::string textPath = songgenPath("measured_lengths.cache");
+        bool migrate = !std::filesystem::exists(logPath) && std::filesystem::exists(textPath);
+        auto* created = new MeasuredLengthCache(logPath);
+        if (migrate) {
+            size_t imported = created->importText(textPath);
+            std::cout << "[SIDLib] 📦 Measurement cache migrated: " << imported << " entries\n";
+        }
+        return created;
+    }();
+    return *cache;
+}
+
+} // namespace
 
 SIDLibConverter::SIDLibConverter() : engine(nullptr), tune(nullptr), builder(nullptr) {
     engine = new sidplayfp();
@@ -65,16 +125,18 @@ SIDLibConverter::SIDLibConverter() : engine(nullptr), tune(nullptr), builder(nul
         return;
     }
     
-    builder->filter(true);  // Aktiviere Filter
-    builder->filter6581Curve(0.5);  // Standard filter curve
-    builder->filter8580Curve(0.5);
+    // Alle klangrelevanten Werte aus engineSettings() (auch Render-Cache-Schlüssel)
+    const EngineSettings& settings = engineSettings();
+    builder->filter(settings.filter);
+    builder->filter6581Curve(settings.filter6581Curve);
+    builder->filter8580Curve(settings.filter8580Curve);
     
     // Pre-konfiguriere Engine EINMAL (nicht bei jeder Konvertierung!)
     SidConfig config;
-    config.frequency = 44100;
-    config.playback = SidConfig::STEREO;
-    config.samplingMethod = SidConfig::RESAMPLE_INTERPOLATE;
-    config.fastSampling = false;  // False für Stabilität
+    config.frequency = kSampleRate;
+    config.playback = kChannels == 2 ? SidConfig::STEREO : SidConfig::MONO;
+    config.samplingMethod = settings.interpolate ? SidConfig::RESAMPLE_INTERPOLATE : SidConfig::INTERPOLATE;
+    config.fastSampling = settings.fastSampling;
     config.sidEmulation = builder;  // WICHTIG: Builder setzen!
     
     if (!engine->config(config)) {
@@ -83,7 +145,10 @@ SIDLibConverter::SIDLibConverter() : engine(nullptr), tune(nullptr), builder(nul
         delete engine;
         builder = nullptr;
         engine = nullptr;
+        return;
     }
+    
+    loadROMs(songgenPath("roms"));
 }
 
 SIDLibConverter::~SIDLibConverter() {
@@ -93,17 +158,38 @@ SIDLibConverter::~SIDLibConverter() {
 }
 
 bool SIDLibConverter::loadROMs(const std::string& romPath) {
-    // Lade Kernal, Basic, Character ROMs falls vorhanden
-    std::string kernalPath = romPath + "/kernal";
-    std::string basicPath = romPath + "/basic";
-    std::string charPath = romPath + "/chargen";
-    
-    // Optional: ROMs laden wenn vorhanden
-    // engine->setRoms(...);
+    // Kernal, Basic, Character ROMs falls vorhanden (Dateien werden nur einmal gelesen)
+    const RomImages& roms = sharedRoms(romPath);
+    if (roms.kernal.empty()) return false;
     
+    engine->setRoms(roms.kernal.data(),
+                    roms.basic.empty() ? nullptr : roms.basic.data(),
+                    roms.chargen.empty() ? nullptr : roms.chargen.data());
     return true;
 }
 
+SIDLibConverter& SIDLibConverter::forThread() {
+    thread_local SIDLibConverter converter;
+    return converter;
+}
+
+bool SIDLibConverter::loadTune(const std::string& sidPath, int subtune) {
+    if (!engine) return false;
+    
+    // SidTune-Objekt wiederverwenden, nur den Inhalt tauschen
+    if (!tune) {
+        tune = new SidTune(sidPath.c_str());
+    } else {
+        tune->load(sidPath.c_str());
+    }
+    if (!tune->getStatus()) return false;
+    
+    tune->selectSong(subtune);
+    
+    // Engine/Builder bleiben konfiguriert, load() setzt nur den C64 zurück
+    return engine->load(tune);
+}
+
 int SIDLibConverter::getSubtuneCount(const std::string& sidPath) {
     // Lese SID-Header: Bytes 0x0E-0x0F enthalten die Anzahl der Songs (Big Endian)
     std::ifstream file(sidPath, std::ios::binary);
@@ -126,197 +212,144 @@ int SIDLibConverter::getSubtuneCount(const std::string& sidPath) {
     return (songs > 0) ? songs : 1;
 }
 
-// Misst die tatsächliche Länge eines Tracks durch Loop-Detection
-int SIDLibConverter::measureTrackLength(const std::string& sidPath, int subtune, int maxSeconds) {
-    if (!engine) return 0;
-    
-    // Lade SID-Datei
-    SidTune* measureTune = new SidTune(sidPath.c_str());
-    if (!measureTune || !measureTune->getStatus()) {
-        if (measureTune) delete measureTune;
-        return 0;
-    }
+int SIDLibConverter::getStartSong(const std::string& sidPath) {
+    // SID-Header: Bytes 0x10-0x11 enthalten den Start-Song (Big Endian, 1-basiert)
+    std::ifstream file(sidPath, std::ios::binary);
+    if (!file.is_open()) return 1;
     
-    measureTune->selectSong(subtune);
-    if (!engine->load(measureTune)) {
-        delete measureTune;
-        return 0;
+    unsigned char header[0x12] = {0};
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (file.gcount() != static_cast<std::streamsize>(sizeof(header)) ||
+        (std::memcmp(header, "PSID", 4) != 0 && std::memcmp(header, "RSID", 4) != 0)) {
+        return 1;
     }
     
-    // Rendere Audio und sammle Fingerprints (Hash pro 2 Sekunden)
-    const int bufferSize = 8192;
-    short buffer[bufferSize];
-    const int sampleRate = 44100;
-    const int chunkSeconds = 2;  // 2-Sekunden-Chunks für Fingerprints
-    const int samplesPerChunk = sampleRate * chunkSeconds * 2;  // Stereo
-    
-    std::vector<uint64_t> fingerprints;
-    std::vector<short> chunkBuffer;
-    chunkBuffer.reserve(samplesPerChunk);
+    int songs = (header[0x0E] << 8) | header[0x0F];
+    int start = (header[0x10] << 8) | header[0x11];
+    return (start >= 1 && (songs <= 0 || start <= songs)) ? start : 1;
+}
+
+// Misst die tatsächliche Länge eines Tracks (Stille- und Loop-Erkennung)
+int SIDLibConverter::measureTrackLength(const std::string& sidPath, int subtune, int maxSeconds) {
+    if (!loadTune(sidPath, subtune)) return 0;
     
-    int totalFrames = maxSeconds * sampleRate;
-    int framesRendered = 0;
-    bool loopFound = false;
-    int loopStartSecond = 0;
+    TrackEndDetector detector(kSampleRate, kChannels);
+    const size_t bufferFrames = 8192;
+    std::vector<short> buffer(bufferFrames * kChannels);
+    const size_t totalFrames = static_cast<size_t>(std::max(0, maxSeconds)) * kSampleRate;
+    size_t framesRendered = 0;
     
-    while (framesRendered < totalFrames && !loopFound) {
-        int framesToRender = std::min(bufferSize / 2, totalFrames - framesRendered);
-        int samplesRendered = engine->play(buffer, framesToRender * 2);
-        
+    while (framesRendered < totalFrames) {
+        size_t framesToRender = std::min(bufferFrames, totalFrames - framesRendered);
+        uint_least32_t samplesRendered = engine->play(buffer.data(), framesToRender * kChannels);
         if (samplesRendered == 0) break;
         
-        // Sammle in Chunk-Buffer
-        for (int i = 0; i < samplesRendered; i++) {
-            chunkBuffer.push_back(buffer[i]);
-        }
-        
-        // Wenn Chunk voll: Berechne Fingerprint
-        if (chunkBuffer.size() >= samplesPerChunk) {
-            // Einfacher Hash: XOR aller Samples in 4KB-Blöcken
-            uint64_t hash = 0;
-            for (size_t i = 0; i < samplesPerChunk; i += 2048) {
-                uint64_t blockHash = 0;
-                for (size_t j = 0; j < 2048 && (i + j) < chunkBuffer.size(); j++) {
-                    blockHash = (blockHash * 31) + chunkBuffer[i + j];
-                }
-                hash ^= blockHash;
-            }
-            
-            fingerprints.push_back(hash);
-            
-            // Prüfe auf Loop: Suche identischen Hash in Historie
-            if (fingerprints.size() > 10) {  // Min. 20 Sekunden vor Loop-Check
-                for (size_t i = 0; i < fingerprints.size() - 5; i++) {
-                    // Prüfe ob 3 aufeinanderfolgende Chunks matchen
-                    bool match = true;
-                    for (int j = 0; j < 3 && match; j++) {
-                        if (i + j >= fingerprints.size() - 3 - j) {
-                            match = false;
-                        } else if (fingerprints[i + j] != fingerprints[fingerprints.size() - 3 + j]) {
-                            match = false;
-                        }
-                    }
-                    
-                    if (match) {
-                        loopFound = true;
-                        loopStartSecond = (fingerprints.size() - 3) * chunkSeconds;
-                        break;
-                    }
-                }
-            }
-            
-            chunkBuffer.clear();
-        }
-        
-        framesRendered += samplesRendered / 2;
+        if (detector.push(buffer.data(), samplesRendered / kChannels)) break;
+        framesRendered += samplesRendered / kChannels;
     }
     
-    delete measureTune;
-    
-    // Wenn Loop gefunden: Gebe Loop-Start zurück, sonst 0 (= kein Loop erkannt)
-    return loopFound ? loopStartSecond : 0;
+    // Ende gefunden: aufrunden auf volle Sekunden (Songlengths-Auflösung), sonst 0
+    if (!detector.finished() || detector.endFrame() == 0) return 0;
+    return static_cast<int>(std::ceil(detector.endSeconds()));
 }
 
-int SIDLibConverter::getTrackLength(const std::string& sidPath, int subtune) {
-    // Statische Instanz der Songlengths-Datenbank
-    static SonglengthsDB* db = nullptr;
-    static bool dbInitialized = false;
-    static std::filesystem::file_time_type lastModTime;
-    
-    // Cache für gemessene Längen (SID-Pfad + Subtune → Länge)
-    static std::map<std::string, int> measurementCache;
-    static std::string cacheFilePath = std::string(getenv("HOME")) + "/.songgen/measured_lengths.cache";
-    static bool cacheLoaded = false;
-    
-    std::string dbPath = std::string(getenv("HOME")) + "/.songgen/hvsc/C64Music/DOCUMENTS/Songlengths.md5";
-    std::string customDbPath = std::string(getenv("HOME")) + "/.songgen/custom_songlengths.md5";
-    
-    // Lade Cache beim ersten Aufruf
-    if (!cacheLoaded) {
-        cacheLoaded = true;
-        if (std::filesystem::exists(cacheFilePath)) {
-            std::ifstream cacheFile(cacheFilePath);
-            std::string line;
-            int loaded = 0;
-            while (std::getline(cacheFile, line)) {
-                size_t sep = line.find('=');
-                if (sep != std::string::npos) {
-                    std::string key = line.substr(0, sep);
-                    int length = std::stoi(line.substr(sep + 1));
-                    measurementCache[key] = length;
-                    loaded++;
+// Aktueller HVSC-Index; prüft höchstens alle paar Sekunden, ob Songlengths.md5
+// sich geändert hat, und baut den Index dann neu
+static std::shared_ptr<const SonglengthsIndex> currentIndex(LengthState& state) {
+    const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (now >= state.nextIndexCheck.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(state.indexMutex);
+        if (now >= state.nextIndexCheck.load(std::memory_order_relaxed)) {
+            std::string dbPath = songgenPath("hvsc/C64Music/DOCUMENTS/Songlengths.md5");
+            auto index = std::atomic_load(&state.index);
+            
+            if (!std::filesystem::exists(dbPath)) {
+                if (!state.warnedMissing) {
+                    state.warnedMissing = true;
+                    std::cerr << "[SIDLib] ⚠️ Songlengths.md5 nicht gefunden: " << dbPath << "\n";
+                }
+            } else if (!index || !index->matchesSource(dbPath)) {
+                bool reload = static_cast<bool>(index);
+                auto fresh = SonglengthsIndex::openOrBuild(dbPath, songgenPath("songlengths.idx"));
+                if (fresh) {
+                    std::atomic_store(&state.index, fresh);
+                    std::cout << "[SIDLib] ✅ Songlengths-Index " << (reload ? "neu geladen" : "geladen")
+                              << ": " << fresh->entryCount() << " Einträge\n";
+                } else {
+                    std::cerr << "[SIDLib] ⚠️ Konnte Songlengths-Index nicht erstellen\n";
                 }
             }
-            if (loaded > 0) {
-                std::cout << "[SIDLib] 📦 Measurement cache loaded: " << loaded << " entries\n";
-            }
+            state.nextIndexCheck.store(now + 5000, std::memory_order_relaxed);
         }
     }
-    
-    // Prüfe ob Datenbank neu geladen werden muss
-    bool needsReload = false;
-    if (std::filesystem::exists(dbPath)) {
-        auto currentModTime = std::filesystem::last_write_time(dbPath);
-        if (!dbInitialized || currentModTime != lastModTime) {
-            needsReload = true;
-            lastModTime = currentModTime;
+    return std::atomic_load(&state.index);
+}
+
+// Erwartet gesperrten state.mutex
+static void ensureCustomLoaded(LengthState& state) {
+    if (state.custom) return;
+    state.custom = new SonglengthsDB();
+    
+    // Lade Custom-Datenbank (eigene Messungen)
+    std::string customDbPath = songgenPath("custom_songlengths.md5");
+    if (std::filesystem::exists(customDbPath)) {
+        if (state.custom->load(customDbPath, true)) {
+            std::cout << "[SIDLib] ✅ Custom DB geladen\n";
         }
     }
+}
+
+int SIDLibConverter::getKnownTrackLength(const std::string& sidPath, int subtune) {
+    LengthState& state = lengthState();
     
-    if (!dbInitialized || needsReload) {
-        dbInitialized = true;
-        
-        if (!db) {
-            db = new SonglengthsDB();
-        }
-        
-        // Lade/Reload HVSC-Datenbank
-        if (std::filesystem::exists(dbPath)) {
-            if (db->load(dbPath)) {
-                std::cout << "[SIDLib] ✅ Songlengths.md5 " 
-                          << (needsReload ? "neu geladen" : "geladen") << "\n";
-            } else {
-                std::cerr << "[SIDLib] ⚠️ Konnte Songlengths.md5 nicht laden\n";
-            }
-        } else {
-            std::cerr << "[SIDLib] ⚠️ Songlengths.md5 nicht gefunden: " << dbPath << "\n";
-        }
-        
-        // Lade Custom-Datenbank (eigene Messungen)
-        if (std::filesystem::exists(customDbPath)) {
-            if (db->load(customDbPath)) {
-                std::cout << "[SIDLib] ✅ Custom DB geladen\n";
-            }
-        }
+    // HVSC zuerst (lock-frei), danach eigene Messungen
+    if (auto index = currentIndex(state)) {
+        int length = index->getLength(sidPath, subtune);
+        if (length > 0) return length;
     }
     
+    std::lock_guard<std::mutex> lock(state.mutex);
+    ensureCustomLoaded(state);
+    return state.custom->getLength(sidPath, subtune);
+}
+
+void SIDLibConverter::songlengthsChanged() {
+    lengthState().nextIndexCheck.store(0, std::memory_order_relaxed);
+}
+
+bool SIDLibConverter::recordMeasuredLength(const std::string& sidPath, int subtune, int seconds) {
+    LengthState& state = lengthState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    ensureCustomLoaded(state);
+    
+    // Sofort anhängen, damit die Messung auch einen Absturz übersteht
+    if (!state.custom->addCustomLength(sidPath, subtune, seconds, songgenPath("custom_songlengths.md5"))) {
+        return false;
+    }
+    measurementCache().erase(sidPath, subtune);
+    return true;
+}
+
+int SIDLibConverter::getTrackLength(const std::string& sidPath, int subtune) {
     // Versuche Länge aus Datenbank zu holen (HVSC + Custom)
-    if (db) {
-        int length = db->getLength(sidPath, subtune);
-        if (length > 0) {
-            return length;
-        }
+    int length = getKnownTrackLength(sidPath, subtune);
+    if (length > 0) {
+        return length;
     }
     
-    // Prüfe Measurement-Cache
-    std::string cacheKey = sidPath + ":" + std::to_string(subtune);
-    auto it = measurementCache.find(cacheKey);
-    if (it != measurementCache.end()) {
-        return it->second;
+    // Prüfe Measurement-Cache (lock-frei)
+    MeasuredLengthCache& cache = measurementCache();
+    int cached = cache.get(sidPath, subtune);
+    if (cached > 0) {
+        return cached;
     }
     
-    // DEAKTIVIERT: Automatische Messung führt zu Segfaults
-    // TODO: Loop-Detection später in convertToMP3 integrieren
-    
-    // Letzter Fallback: 180 Sekunden (speichere im Cache)
-    measurementCache[cacheKey] = 180;
-    
-    // Speichere im Cache
-    std::ofstream cacheFile(cacheFilePath, std::ios::app);
-    if (cacheFile.is_open()) {
-        cacheFile << cacheKey << "=" << 180 << "\n";
-    }
+    // Keine Messung beim Nachschlagen: das Rendern endet per TrackEndDetector
+    // früher und trägt die gemessene Länge in die Custom-DB ein
     
+    // Letzter Fallback: 180 Sekunden (landet im Append-Log des Caches)
+    cache.put(sidPath, subtune, 180);
     return 180;
 }
 
@@ -353,74 +386,175 @@ SIDLibConverter::Timing SIDLibConverter::getTiming(const std::string& sidPath) {
 }
 
 bool SIDLibConverter::isAudible(const std::string& sidPath, int subtune) {
-    // Erstelle temporäre Test-WAV (5 Sekunden)
-    std::string tempPath = "/tmp/sid_test_" + std::to_string(getpid()) + ".wav";
-    
-    // Schnelle 5s-Konvertierung
-    std::string cmd = "/usr/bin/sidplayfp -t5";
-    
-    Timing timing = getTiming(sidPath);
-    if (timing == PAL) cmd += " -vp";
-    else if (timing == NTSC) cmd += " -vn";
-    
-    if (subtune > 1) cmd += " -o" + std::to_string(subtune);
-    
-    cmd += " -w" + tempPath;
-    cmd += " \"" + sidPath + "\"";
-    cmd += " >/dev/null 2>&1";
+    if (!loadTune(sidPath, subtune)) return false;
     
-    int result = system(cmd.c_str());
+    // Max. 5 Sekunden in 100-ms-Blöcken; der erste hörbare Block beendet den Test
+    const int blockFrames = kSampleRate / 10;
+    const int maxBlocks = 5 * 10;
+    short buffer[blockFrames * kChannels];
     
-    // Prüfe ob Datei erstellt wurde
-    std::error_code ec;
-    if (!std::filesystem::exists(tempPath, ec) || ec) {
-        return false;
-    }
+    // Schwellwert: RMS > 0.001 bedeutet hörbares Audio
+    // (Stille wäre < 0.0001)
+    const double SILENCE_THRESHOLD = 0.001;
+    double maxRms = 0.0;
     
-    auto fileSize = std::filesystem::file_size(tempPath, ec);
-    if (ec || fileSize < 10000) {
-        std::filesystem::remove(tempPath, ec);
-        return false;
+    for (int block = 0; block < maxBlocks; ++block) {
+        uint_least32_t samplesRendered = engine->play(buffer, blockFrames * kChannels);
+        if (samplesRendered == 0) break;
+        
+        double sumSquares = 0.0;
+        for (uint_least32_t i = 0; i < samplesRendered; ++i) {
+            double normalized = buffer[i] / 32768.0;
+            sumSquares += normalized * normalized;
+        }
+        double rms = std::sqrt(sumSquares / samplesRendered);
+        if (rms > SILENCE_THRESHOLD) return true;
+        maxRms = std::max(maxRms, rms);
     }
     
-    // Analysiere Audio-Inhalt (einfache RMS-Berechnung)
-    std::ifstream file(tempPath, std::ios::binary);
-    if (!file.is_open()) {
-        std::filesystem::remove(tempPath, ec);
-        return false;
+    std::cerr << "[SIDLib] 🔇 Silent track (RMS=" << maxRms << "): " << sidPath << " subtune=" << subtune << "\n";
+    return false;
+}
+
+const SIDLibConverter::EngineSettings& SIDLibConverter::engineSettings() {
+    static const EngineSettings settings;
+    return settings;
+}
+
+std::string SIDLibConverter::EngineSettings::key() const {
+    std::ostringstream key;
+    key << "residfp;rate=" << kSampleRate << ";channels=" << kChannels
+        << ";sampling=" << (interpolate ? "resample_interpolate" : "interpolate")
+        << ";fast=" << fastSampling << ";filter=" << filter
+        << ";curve6581=" << filter6581Curve << ";curve8580=" << filter8580Curve;
+    return key.str();
+}
+
+bool SIDLibConverter::renderPCM(const std::string& sidPath, int subtune, int seconds,
+                                std::vector<int16_t>& pcm, bool useCache) {
+    pcm.clear();
+    if (seconds > 0) pcm.reserve(static_cast<size_t>(seconds) * kSampleRate * kChannels);
+    bool ok = renderPCM(sidPath, subtune, seconds, [&pcm](const int16_t* block, size_t frames) {
+        pcm.insert(pcm.end(), block, block + frames * kChannels);
+        return true;
+    }, useCache);
+    if (!ok) pcm.clear();
+    return ok && !pcm.empty();
+}
+
+bool SIDLibConverter::renderPCM(const std::string& sidPath, int subtune, int seconds,
+                                const PCMSink& sink, bool useCache) {
+    if (seconds <= 0) return false;
+    const size_t frames = static_cast<size_t>(seconds) * kSampleRate;
+    
+    std::string cacheKey;
+    if (useCache) {
+        std::string md5 = calculateMD5(sidPath);
+        if (md5.empty()) return false;
+        cacheKey = SIDRenderCache::makeKey(md5, subtune, engineSettings().key());
+        // Fehlt der Eintrag, wurde noch nichts weitergegeben: dann rendern
+        bool delivered = false;
+        if (SIDRenderCache::shared().read(cacheKey, frames, kChannels, kSampleRate,
+                                          [&](const int16_t* block, size_t count) {
+                                              delivered = true;
+                                              return sink(block, count);
+                                          })) {
+            return true;
+        }
+        if (delivered) return false;
     }
     
-    // Überspringe WAV-Header (44 bytes)
-    file.seekg(44);
-    
-    // Lese erste 50000 Samples (ca. 1 Sekunde bei 44.1kHz stereo)
-    const size_t samplesToCheck = 50000;
-    std::vector<int16_t> samples(samplesToCheck);
-    file.read(reinterpret_cast<char*>(samples.data()), samplesToCheck * sizeof(int16_t));
-    size_t samplesRead = file.gcount() / sizeof(int16_t);
-    file.close();
+    if (!loadTune(sidPath, subtune)) return false;
     
-    // Berechne RMS (Root Mean Square)
-    double sumSquares = 0.0;
-    for (size_t i = 0; i < samplesRead; ++i) {
-        double normalized = samples[i] / 32768.0;
-        sumSquares += normalized * normalized;
+    // Fester Blockpuffer; der Cache-Eintrag entsteht nebenher in einer Temp-Datei
+    std::unique_ptr<SIDRenderCache::Writer> writer;
+    if (useCache) {
+        writer = std::make_unique<SIDRenderCache::Writer>(SIDRenderCache::shared(), cacheKey, kChannels, kSampleRate);
+    }
+    const size_t blockFrames = 32768;
+    std::vector<int16_t> block(blockFrames * kChannels);
+    size_t rendered = 0;
+    while (rendered < frames) {
+        size_t request = std::min(blockFrames, frames - rendered);
+        uint_least32_t got = engine->play(block.data(), static_cast<uint_least32_t>(request * kChannels));
+        size_t framesGot = got / kChannels;
+        if (framesGot == 0) break;
+        if (writer) writer->append(block.data(), framesGot);
+        if (!sink(block.data(), framesGot)) return false;
+        rendered += framesGot;
     }
-    double rms = std::sqrt(sumSquares / samplesRead);
-    
-    // Cleanup
-    std::filesystem::remove(tempPath, ec);
     
-    // Schwellwert: RMS > 0.001 bedeutet hörbares Audio
-    // (Stille wäre < 0.0001)
-    const double SILENCE_THRESHOLD = 0.001;
-    bool audible = rms > SILENCE_THRESHOLD;
+    if (rendered == 0) return false;
+    if (writer && rendered == frames) writer->commit();
+    return true;
+}
+
+bool SIDLibConverter::renderUntilEnd(int seconds, std::vector<int16_t>& pcm, TrackEndDetector* detector,
+                                     const PCMSink& sink) {
+    pcm.clear();
+    const size_t totalFrames = static_cast<size_t>(std::max(0, seconds)) * kSampleRate;
+    const size_t blockFrames = 32768;  // ~0.74s @ 44.1kHz
+    size_t framesRendered = 0;
+    
+    // Mit sink: pcm hält nur den noch nicht weitergegebenen Rest ab Frame base
+    size_t base = 0;
+    auto emitUpTo = [&](size_t frame) {
+        if (!sink || frame <= base) return true;
+        size_t count = frame - base;
+        bool accepted = sink(pcm.data(), count);
+        pcm.erase(pcm.begin(), pcm.begin() + count * kChannels);
+        base = frame;
+        return accepted;
+    };
     
-    if (!audible) {
-        std::cerr << "[SIDLib] 🔇 Silent track (RMS=" << rms << "): " << sidPath << " subtune=" << subtune << "\n";
+    while (framesRendered < totalFrames) {
+        size_t framesToRender = std::min(blockFrames, totalFrames - framesRendered);
+        size_t offset = pcm.size();
+        pcm.resize(offset + framesToRender * kChannels);
+        
+        // engine->play() nimmt Anzahl SAMPLES (nicht Frames!)
+        uint_least32_t samplesRendered = engine->play(pcm.data() + offset, framesToRender * kChannels);
+        size_t framesGot = samplesRendered / kChannels;
+        pcm.resize(offset + framesGot * kChannels);
+        if (framesGot == 0) break;
+        framesRendered += framesGot;
+        
+        // Stille/Loop: Rest verwerfen und aufhören
+        if (detector && detector->push(pcm.data() + offset, framesGot)) {
+            size_t keep = detector->endFrame() > base ? detector->endFrame() - base : 0;
+            pcm.resize(std::min(pcm.size(), keep * kChannels));
+            break;
+        }
+        
+        // Was die Ende-Erkennung nicht mehr abschneiden kann, schon weitergeben
+        if (!emitUpTo(detector ? detector->committedFrames() : framesRendered)) return false;
     }
     
-    return audible;
+    size_t endFrame = base + pcm.size() / kChannels;
+    if (!emitUpTo(endFrame)) return false;
+    return endFrame > 0;
+}
+
+bool SIDLibConverter::renderTrack(const std::string& sidPath, int seconds, std::vector<int16_t>& pcm,
+                                  const PCMSink& sink) {
+    // Bekannte Länge (Songlengths) ist verbindlich: keine Ende-Erkennung, sonst
+    // würden längere Pausen im Song als Ende gelten. Unbekannte Länge: Stille-
+    // und Loop-Erkennung, ein erkanntes Ende wird als Messung in die Custom-DB eingetragen.
+    int song = static_cast<int>(tune->getInfo()->currentSong());
+    bool knownLength = getKnownTrackLength(sidPath, song) > 0;
+    
+    TrackEndDetector detector(kSampleRate, kChannels);
+    
+    bool rendered = renderUntilEnd(seconds, pcm, knownLength ? nullptr : &detector, sink);
+    
+    if (!knownLength && detector.finished() && detector.endFrame() > 0) {
+        int measured = static_cast<int>(std::ceil(detector.endSeconds()));
+        recordMeasuredLength(sidPath, song, measured);
+        std::cout << "[SIDLib] ⏱️ Länge gemessen: " << measured << "s ("
+                  << (detector.reason() == TrackEndDetector::Reason::Loop ? "Loop" : "Stille") << ", "
+                  << std::filesystem::path(sidPath).filename().string() << " #" << song << ")\n";
+    }
+    return rendered;
 }
 
 size_t SIDLibConverter::calculateExpectedSize(int timeoutSec, const std::string& format, int bitrate) {
@@ -438,21 +572,18 @@ bool SIDLibConverter::convertToWAV(const std::string& sidPath, const std::string
     
     std::filesystem::create_directories(std::filesystem::path(wavPath).parent_path());
     
-    // Lade SID-Datei
-    tune = new SidTune(sidPath.c_str());
-    if (!tune || !tune->getStatus()) {
-        if (tune) delete tune;
-        tune = nullptr;
-        return false;
-    }
+    // Tune tauschen (Engine und Builder bleiben bestehen)
+    if (!loadTune(sidPath, subtune)) return false;
     
-    // Wähle Subtune
-    tune->selectSong(subtune);
+    // Rendern bis timeoutSec oder bis Stille/Loop erkannt wird
+    std::vector<int16_t> pcm;
+    renderTrack(sidPath, timeoutSec, pcm);
+    
+    const int bitsPerSample = 16;
+    int dataSize = static_cast<int>(pcm.size() * sizeof(int16_t));
     
-    // Lade Tune in Engine
-    if (!engine->load(tune)) {
-        delete tune;
-        tune = nullptr;
+    // Validiere Ausgabe (stumm oder zu kurz)
+    if (dataSize < 10000) {
         return false;
     }
     
@@ -462,87 +593,24 @@ bool SIDLibConverter::convertToWAV(const std::string& sidPath, const std::string
         return false;
     }
     
-    // Schreibe WAV-Header (wird später aktualisiert)
-    const int sampleRate = 44100;
-    const int channels = 2;
-    const int bitsPerSample = 16;
-    int dataSize = 0;
-    writeWAVHeader(wavFile, dataSize, sampleRate, channels, bitsPerSample);
-    
-    // Rendere Audio mit größerem Buffer für bessere Performance
-    // bufferSize = Anzahl der short-Werte (für Stereo: 32768 Frames = 65536 Samples)
-    const int bufferSize = 65536;  // 65536 shorts = 32768 stereo frames (~0.74s @ 44.1kHz)
-    short buffer[bufferSize];
-    
-    // totalFrames = Anzahl der Stereo-Frames (1 Frame = L+R = 2 samples)
-    int totalFrames = timeoutSec * sampleRate;
-    int framesRendered = 0;
-    
-    while (framesRendered < totalFrames) {
-        // Berechne wie viele Frames noch fehlen
-        int framesToRender = std::min(bufferSize / channels, totalFrames - framesRendered);
-        
-        // engine->play() nimmt Buffer und Anzahl SAMPLES (nicht Frames!)
-        // Für Stereo: framesToRender * 2 = Anzahl samples
-        int samplesRequested = framesToRender * channels;
-        int samplesRendered = engine->play(buffer, samplesRequested);
-        
-        if (samplesRendered == 0) break;
-        
-        // Schreibe alle gerenderten samples zur WAV-Datei
-        wavFile.write(reinterpret_cast<char*>(buffer), samplesRendered * sizeof(short));
-        dataSize += samplesRendered * sizeof(short);
-        
-        // Update frame counter (samples / channels)
-        framesRendered += samplesRendered / channels;
-    }
-    
-    // Aktualisiere WAV-Header mit korrekter Größe
-    wavFile.seekp(0);
-    writeWAVHeader(wavFile, dataSize, sampleRate, channels, bitsPerSample);
+    writeWAVHeader(wavFile, dataSize, kSampleRate, kChannels, bitsPerSample);
+    wavFile.write(reinterpret_cast<const char*>(pcm.data()), dataSize);
     wavFile.close();
     
-    // Cleanup
-    delete tune;
-    tune = nullptr;
-    
-    // Validiere Ausgabe
-    if (dataSize < 10000) {
-        std::filesystem::remove(wavPath);
-        return false;
-    }
-    
     return true;
 }
 
-bool SIDLibConverter::convertToMP3(const std::string& sidPath, const std::string& mp3Path, int timeoutSec, int subtune, int bitrate) {
-    if (!engine) return false;
-    
-    std::filesystem::create_directories(std::filesystem::path(mp3Path).parent_path());
-    
-    // Lade SID-Datei
-    tune = new SidTune(sidPath.c_str());
-    if (!tune || !tune->getStatus()) {
-        if (tune) delete tune;
-        tune = nullptr;
-        return false;
-    }
+bool SIDLibConverter::encodeMP3(const std::string& sidPath, const std::string& mp3Path, int timeoutSec, int bitrate) {
+    // Rendern bis timeoutSec oder bis Stille/Loop erkannt wird; erst danach
+    // encodieren, damit ein erkannter Loop nicht schon im MP3 steckt
+    std::vector<int16_t> pcm;
+    renderTrack(sidPath, timeoutSec, pcm);
     
-    // Wähle Subtune
-    tune->selectSong(subtune);
-    
-    // Lade Tune in Engine
-    if (!engine->load(tune)) {
-        delete tune;
-        tune = nullptr;
-        return false;
-    }
+    if (pcm.empty()) return false;
     
     // Initialisiere LAME für MP3 Encoding (viel schneller als ffmpeg-Prozess)
     lame_t lame = lame_init();
     if (!lame) {
-        delete tune;
-        tune = nullptr;
         return false;
     }
     
@@ -554,8 +622,6 @@ bool SIDLibConverter::convertToMP3(const std::string& sidPath, const std::string
     
     if (lame_init_params(lame) < 0) {
         lame_close(lame);
-        delete tune;
-        tune = nullptr;
         return false;
     }
     
@@ -563,84 +629,23 @@ bool SIDLibConverter::convertToMP3(const std::string& sidPath, const std::string
     FILE* mp3File = fopen(mp3Path.c_str(), "wb");
     if (!mp3File) {
         lame_close(lame);
-        delete tune;
-        tune = nullptr;
         return false;
     }
     
-    // Rendere Audio und encode direkt zu MP3
-    const int pcmBufferSize = 65536;  // PCM buffer: 32768 stereo frames
-    short pcmBuffer[pcmBufferSize];
-    unsigned char mp3Buffer[pcmBufferSize + 10000];  // MP3 buffer needs extra space
-    
-    const int sampleRate = 44100;
-    int totalFrames = timeoutSec * sampleRate;
-    int framesRendered = 0;
-    
-    // Loop-Detection: Speichere Audio-Fingerprints
-    const int FINGERPRINT_SIZE = 8192;  // ~185ms bei 44.1kHz
-    const int CHECK_INTERVAL = 44100 * 2;  // Prüfe alle 2 Sekunden
-    const int MIN_LENGTH = 44100 * 15;  // Mindestens 15 Sekunden spielen
-    std::vector<std::vector<short>> fingerprints;
-    int framesSinceLastCheck = 0;
+    const int framesPerChunk = 32768;
+    std::vector<unsigned char> mp3Buffer(framesPerChunk * 5 / 4 + 7200);  // LAME: 1.25 * n + 7200
+    const size_t totalFrames = pcm.size() / kChannels;
     
-    while (framesRendered < totalFrames) {
-        int framesToRender = std::min(pcmBufferSize / 2, totalFrames - framesRendered);
-        int samplesRequested = framesToRender * 2;
-        int samplesRendered = engine->play(pcmBuffer, samplesRequested);
-        
-        if (samplesRendered == 0) break;
-        
-        // Loop-Detection: Speichere Fingerprint alle 2 Sekunden (nach 15s Minimum)
-        framesSinceLastCheck += samplesRendered / 2;
-        if (framesRendered >= MIN_LENGTH && framesSinceLastCheck >= CHECK_INTERVAL) {
-            framesSinceLastCheck = 0;
-            
-            // Erstelle Fingerprint (erste FINGERPRINT_SIZE samples)
-            std::vector<short> fingerprint;
-            int fpSize = std::min(FINGERPRINT_SIZE, samplesRendered);
-            fingerprint.assign(pcmBuffer, pcmBuffer + fpSize);
-            
-            // Prüfe gegen vorherige Fingerprints
-            bool loopDetected = false;
-            for (const auto& prevFp : fingerprints) {
-                if (prevFp.size() != fingerprint.size()) continue;
-                
-                // Vergleiche mit Toleranz (90% Übereinstimmung)
-                int matches = 0;
-                for (size_t i = 0; i < fingerprint.size(); ++i) {
-                    int diff = std::abs(fingerprint[i] - prevFp[i]);
-                    if (diff < 500) matches++;  // Toleranz: 500 von 32767
-                }
-                
-                float similarity = (float)matches / fingerprint.size();
-                if (similarity > 0.90f) {
-                    loopDetected = true;
-                    break;
-                }
-            }
-            
-            if (loopDetected) {
-                // Loop erkannt, stoppe früher
-                break;
-            }
-            
-            fingerprints.push_back(fingerprint);
-            
-            // Behalte nur die letzten 10 Fingerprints (20 Sekunden Historie)
-            if (fingerprints.size() > 10) {
-                fingerprints.erase(fingerprints.begin());
-            }
-        }
+    for (size_t frame = 0; frame < totalFrames; frame += framesPerChunk) {
+        int framesInBuffer = static_cast<int>(std::min<size_t>(framesPerChunk, totalFrames - frame));
         
         // Encode PCM → MP3 (interleaved stereo)
-        int framesInBuffer = samplesRendered / 2;
         int mp3Bytes = lame_encode_buffer_interleaved(
             lame,
-            pcmBuffer,
+            pcm.data() + frame * kChannels,
             framesInBuffer,
-            mp3Buffer,
-            sizeof(mp3Buffer)
+            mp3Buffer.data(),
+            static_cast<int>(mp3Buffer.size())
         );
         
         if (mp3Bytes < 0) {
@@ -650,16 +655,14 @@ bool SIDLibConverter::convertToMP3(const std::string& sidPath, const std::string
         
         // Schreibe MP3-Daten direkt in Datei
         if (mp3Bytes > 0) {
-            fwrite(mp3Buffer, 1, mp3Bytes, mp3File);
+            fwrite(mp3Buffer.data(), 1, mp3Bytes, mp3File);
         }
-        
-        framesRendered += samplesRendered / 2;
     }
     
     // Flush final MP3 frames
-    int mp3Bytes = lame_encode_flush(lame, mp3Buffer, sizeof(mp3Buffer));
+    int mp3Bytes = lame_encode_flush(lame, mp3Buffer.data(), static_cast<int>(mp3Buffer.size()));
     if (mp3Bytes > 0) {
-        fwrite(mp3Buffer, 1, mp3Bytes, mp3File);
+        fwrite(mp3Buffer.data(), 1, mp3Bytes, mp3File);
     } else if (mp3Bytes < 0) {
         std::cerr << "[SIDLib] ⚠️ LAME flush error: " << mp3Bytes << "\n";
     }
@@ -668,10 +671,41 @@ bool SIDLibConverter::convertToMP3(const std::string& sidPath, const std::string
     fflush(mp3File);  // Force write to disk
     fclose(mp3File);
     lame_close(lame);
+    return true;
+}
+
+bool SIDLibConverter::encodeMP3Pipelined(const std::string& sidPath, const std::string& mp3Path,
+                                         int timeoutSec, int bitrate) {
+    auto stream = encoderPool_->open(mp3Path, kSampleRate, kChannels, bitrate);
+    if (!stream) return false;
+    
+    // Bestätigte Blöcke gehen sofort an den Encoder; nur der Teil, den die
+    // Ende-Erkennung noch abschneiden könnte, bleibt hier im Speicher
+    std::vector<int16_t> pending;
+    bool rendered = renderTrack(sidPath, timeoutSec, pending, [&](const int16_t* pcm, size_t frames) {
+        return encoderPool_->push(*stream, pcm, frames);
+    });
+    
+    bool encoded = encoderPool_->finish(*stream);
+    return rendered && encoded;
+}
+
+bool SIDLibConverter::convertToMP3(const std::string& sidPath, const std::string& mp3Path, int timeoutSec, int subtune, int bitrate) {
+    if (!engine) return false;
     
-    // Cleanup
-    delete tune;
-    tune = nullptr;
+    std::filesystem::create_directories(std::filesystem::path(mp3Path).parent_path());
+    
+    // Tune tauschen (Engine und Builder bleiben bestehen)
+    if (!loadTune(sidPath, subtune)) return false;
+    
+    // Encoding im Encoder-Pool (parallel zur Emulation) oder im eigenen Thread
+    bool encoded = encoderPool_ ? encodeMP3Pipelined(sidPath, mp3Path, timeoutSec, bitrate)
+                                : encodeMP3(sidPath, mp3Path, timeoutSec, bitrate);
+    if (!encoded) {
+        std::error_code removeEc;
+        std::filesystem::remove(mp3Path, removeEc);
+        return false;
+    }
     
     // Prüfe MP3
     std::error_code ec;
@@ -818,84 +852,30 @@ std::vector<std::string> SIDLibConverter::convertBatchParallel(
 ) {
     std::vector<std::string> successFiles;
     std::mutex resultMutex;
-    std::atomic<int> completed(0);
-    
-    // Thread-Pool mit pre-allocated capacity
-    std::vector<std::thread> threadPool;
-    threadPool.reserve(threads);
-    std::atomic<size_t> currentIndex(0);
-    
-    auto worker = [&]() {
-        // Jeder Thread hat seine eigene Engine!
-        SIDLibConverter converter;
-        
-        // Batch-Sammlung für weniger Lock-Contention
-        std::vector<std::string> localSuccesses;
-        localSuccesses.reserve(100);
-        
-        try {
-            while (true) {
-                size_t idx = currentIndex.fetch_add(1, std::memory_order_relaxed);
-                if (idx >= sidFiles.size()) break;
-                
-                const std::string& sidPath = sidFiles[idx];
-                std::string filename = std::filesystem::path(sidPath).stem().string();
-                std::string wavPath = outputDir + "/" + filename + ".wav";
-                
-                // Konvertiere
-                if (converter.convertToWAV(sidPath, wavPath, timeoutSec)) {
-                    localSuccesses.push_back(wavPath);
-                    
-                    // Flush batch alle 50 Erfolge für weniger Mutex-Overhead
-                    if (localSuccesses.size() >= 50) {
-                        std::lock_guard<std::mutex> lock(resultMutex);
-                        successFiles.insert(successFiles.end(), 
-                                          localSuccesses.begin(), localSuccesses.end());
-                        localSuccesses.clear();
-                    }
-                }
-                
-                // Progress - alle 50 Dateien für besseres Feedback
-                int done = completed.fetch_add(1, std::memory_order_relaxed) + 1;
-                if (progressCallback && (done % 50 == 0 || done == (int)sidFiles.size())) {
-                    progressCallback(done, sidFiles.size());
-                }
-            }
-            
-            // Flush remaining batch
-            if (!localSuccesses.empty()) {
-                std::lock_guard<std::mutex> lock(resultMutex);
-                successFiles.insert(successFiles.end(), 
-                                  localSuccesses.begin(), localSuccesses.end());
-            }
-        } catch (...) {
-            // Verhindere Zombie-Threads bei Exceptions
-            if (!localSuccesses.empty()) {
-                std::lock_guard<std::mutex> lock(resultMutex);
-                successFiles.insert(successFiles.end(), 
-                                  localSuccesses.begin(), localSuccesses.end());
-            }
-        }
-    };
     
-    // Starte Threads - nutze Hardware-Concurrency optimal
-    int effectiveThreads = std::min(threads, (int)sidFiles.size());
-    threadPool.reserve(effectiveThreads);
-    for (int i = 0; i < effectiveThreads; i++) {
-        threadPool.emplace_back(worker);
+    // Ein Job pro Datei (Start-Song), Länge aus Songlengths, begrenzt auf timeoutSec.
+    // Der Scheduler startet die längsten zuerst und gleicht per Work-Stealing aus.
+    SIDRenderScheduler scheduler(static_cast<unsigned int>(std::max(1, std::min(threads, (int)sidFiles.size()))));
+    for (const auto& sidPath : sidFiles) {
+        std::string filename = std::filesystem::path(sidPath).stem().string();
+        scheduler.add(sidPath, 0, outputDir + "/" + filename + ".wav", timeoutSec, timeoutSec);
     }
     
-    // Warte auf Fertigstellung - mit Timeout-Schutz
-    for (auto& t : threadPool) {
-        if (t.joinable()) {
-            t.join();
+    const int total = static_cast<int>(sidFiles.size());
+    scheduler.run([&](const SIDRenderScheduler::Job& job, SIDLibConverter& converter, size_t) {
+        if (!converter.convertToWAV(job.sidPath, job.outputPath, job.seconds, job.subtune)) {
+            return false;
         }
-    }
-    
-    // Final Progress Update
-    if (progressCallback) {
-        progressCallback(completed.load(), sidFiles.size());
-    }
+        std::lock_guard<std::mutex> lock(resultMutex);
+        successFiles.push_back(job.outputPath);
+        return true;
+    }, [&](size_t done, size_t) {
+        // Progress - alle 50 Dateien für besseres Feedback
+        if (progressCallback && (done % 50 == 0 || (int)done == total)) {
+            progressCallback(static_cast<int>(done), total);
+        }
+    });
     
+    scheduler.printUtilization();
     return successFiles;
 }
@@ -0,0 +1,214 @@
+#include "SIDRenderCache.h"
+#include "FileHasher.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Header jeder Cache-Datei, danach frames * channels int16-Samples
+struct CacheHeader {
+    char magic[8];          // "SGPCM01"
+    uint32_t sampleRate;
+    uint32_t channels;
+    uint64_t frames;
+};
+
+const char kMagic[8] = {'S', 'G', 'P', 'C', 'M', '0', '1', '\0'};
+
+bool readHeader(std::ifstream& file, CacheHeader& header) {
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    return file.gcount() == static_cast<std::streamsize>(sizeof(header)) &&
+           std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+} // namespace
+
+SIDRenderCache::SIDRenderCache(const std::string& directory, uint64_t maxBytes)
+    : directory_(directory), maxBytes_(maxBytes) {
+    if (directory_.empty()) {
+        const char* home = getenv("HOME");
+        directory_ = std::string(home ? home : "/tmp") + "/.songgen/render_cache";
+    }
+}
+
+SIDRenderCache& SIDRenderCache::shared() {
+    static SIDRenderCache cache;
+    return cache;
+}
+
+std::string SIDRenderCache::makeKey(const std::string& sidMd5, int subtune, const std::string& settings) {
+    // Einstellungen nur als Hash im Dateinamen
+    uint64_t settingsHash = FileHasher::hashBytes(settings.data(), settings.size());
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "-%d-%08x", subtune, static_cast<unsigned>(settingsHash & 0xFFFFFFFFu));
+    return sidMd5 + suffix;
+}
+
+std::string SIDRenderCache::pathFor(const std::string& key) const {
+    std::string shard = key.size() >= 2 ? key.substr(0, 2) : "00";
+    return directory_ + "/" + shard + "/" + key + ".pcm";
+}
+
+bool SIDRenderCache::load(const std::string& key, size_t frames, int channels, int sampleRate,
+                          std::vector<int16_t>& pcm) {
+    pcm.clear();
+    pcm.reserve(frames * channels);
+    bool ok = read(key, frames, channels, sampleRate, [&pcm, channels](const int16_t* block, size_t count) {
+        pcm.insert(pcm.end(), block, block + count * channels);
+        return true;
+    });
+    if (!ok) pcm.clear();
+    return ok;
+}
+
+bool SIDRenderCache::read(const std::string& key, size_t frames, int channels, int sampleRate,
+                          const BlockSink& sink, size_t blockFrames) {
+    std::string path = pathFor(key);
+    std::ifstream file(path, std::ios::binary);
+    CacheHeader header;
+    if (!file.is_open() || !readHeader(file, header) ||
+        header.channels != static_cast<uint32_t>(channels) ||
+        header.sampleRate != static_cast<uint32_t>(sampleRate) ||
+        header.frames < frames) {
+        misses_++;
+        return false;
+    }
+
+    std::vector<int16_t> block(std::max<size_t>(1, blockFrames) * channels);
+    for (size_t done = 0; done < frames;) {
+        size_t count = std::min(block.size() / channels, frames - done);
+        std::streamsize bytes = static_cast<std::streamsize>(count * channels * sizeof(int16_t));
+        file.read(reinterpret_cast<char*>(block.data()), bytes);
+        if (file.gcount() != bytes) {
+            misses_++;
+            return false;
+        }
+        if (!sink(block.data(), count)) return false;
+        done += count;
+    }
+
+    // mtime = letzter Zugriff (LRU für prune)
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    hits_++;
+    return true;
+}
+
+bool SIDRenderCache::store(const std::string& key, const std::vector<int16_t>& pcm, int channels, int sampleRate) {
+    if (pcm.empty() || channels <= 0) return false;
+    Writer writer(*this, key, channels, sampleRate);
+    return writer.append(pcm.data(), pcm.size() / channels) && writer.commit();
+}
+
+SIDRenderCache::Writer::Writer(SIDRenderCache& cache, const std::string& key, int channels, int sampleRate)
+    : cache_(cache), path_(cache.pathFor(key)), channels_(channels), sampleRate_(sampleRate) {
+    if (channels_ <= 0) return;
+    std::error_code ec;
+    fs::create_directories(fs::path(path_).parent_path(), ec);
+
+    // Eindeutige Temp-Datei im selben Verzeichnis; Header wird in commit() vervollständigt
+    tempPath_ = path_ + ".tmp" + std::to_string(getpid()) + "_" +
+                std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    file_.open(tempPath_, std::ios::binary | std::ios::trunc);
+    CacheHeader header{};
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ok_ = static_cast<bool>(file_);
+}
+
+SIDRenderCache::Writer::~Writer() {
+    if (file_.is_open()) file_.close();
+    if (!tempPath_.empty()) {
+        std::error_code ec;
+        fs::remove(tempPath_, ec);
+    }
+}
+
+bool SIDRenderCache::Writer::append(const int16_t* pcm, size_t frames) {
+    if (!ok_) return false;
+    file_.write(reinterpret_cast<const char*>(pcm), static_cast<std::streamsize>(frames * channels_ * sizeof(int16_t)));
+    frames_ += frames;
+    ok_ = static_cast<bool>(file_);
+    return ok_;
+}
+
+bool SIDRenderCache::Writer::commit() {
+    if (!ok_ || frames_ == 0) return false;
+    ok_ = false;
+
+    // Längeren vorhandenen Eintrag nicht durch einen kürzeren ersetzen
+    CacheHeader existing;
+    std::ifstream current(path_, std::ios::binary);
+    if (current.is_open() && readHeader(current, existing) &&
+        existing.frames * existing.channels >= frames_ * static_cast<uint64_t>(channels_)) {
+        return true;
+    }
+    current.close();
+
+    CacheHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.sampleRate = static_cast<uint32_t>(sampleRate_);
+    header.channels = static_cast<uint32_t>(channels_);
+    header.frames = frames_;
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_.close();
+    if (!file_) return false;
+
+    std::error_code ec;
+    fs::rename(tempPath_, path_, ec);
+    if (ec) return false;
+    tempPath_.clear();
+
+    uint64_t written = cache_.bytesSincePrune_ += frames_ * channels_ * sizeof(int16_t);
+    if (written > cache_.maxBytes_ / 8) {
+        cache_.bytesSincePrune_ = 0;
+        cache_.prune();
+    }
+    return true;
+}
+
+void SIDRenderCache::prune() {
+    std::lock_guard<std::mutex> lock(pruneMutex_);
+
+    struct Entry {
+        fs::path path;
+        uint64_t size;
+        fs::file_time_type lastUse;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec) || it->path().extension() != ".pcm") continue;
+        uint64_t size = it->file_size(ec);
+        if (ec) continue;
+        entries.push_back({it->path(), size, it->last_write_time(ec)});
+        total += size;
+    }
+    if (total <= maxBytes_) return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.lastUse < b.lastUse;
+    });
+
+    size_t removed = 0;
+    for (const auto& entry : entries) {
+        if (total <= maxBytes_) break;
+        if (fs::remove(entry.path, ec)) {
+            total -= entry.size;
+            removed++;
+        }
+    }
+    std::cout << "[SIDLib] 🧹 Render-Cache: " << removed << " alte Einträge entfernt\n";
+}
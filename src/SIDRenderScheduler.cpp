@@ -0,0 +1,138 @@
+#include "SIDRenderScheduler.h"
+#include "SIDLibConverter.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+SIDRenderScheduler::SIDRenderScheduler(unsigned int threads) : pool_(threads) {}
+
+SIDRenderScheduler::~SIDRenderScheduler() = default;
+
+SIDRenderScheduler::Job SIDRenderScheduler::makeJob(const std::string& sidPath, int subtune,
+                                                    const std::string& outputPath, int maxSeconds,
+                                                    int fallbackSeconds) {
+    Job job;
+    job.sidPath = sidPath;
+    job.subtune = subtune;
+    job.outputPath = outputPath;
+    // Nur nachschlagen: getTrackLength würde für unbekannte Tunes schon beim Planen
+    // 180 s in den Mess-Cache schreiben. Subtune 0 = Start-Song aus dem Header.
+    int song = subtune > 0 ? subtune : SIDLibConverter::getStartSong(sidPath);
+    job.seconds = SIDLibConverter::getKnownTrackLength(sidPath, song);
+    if (job.seconds <= 0) job.seconds = fallbackSeconds;
+    if (maxSeconds > 0) job.seconds = std::min(job.seconds, maxSeconds);
+    return job;
+}
+
+void SIDRenderScheduler::add(const std::string& sidPath, int subtune, const std::string& outputPath,
+                             int maxSeconds, int fallbackSeconds) {
+    jobs_.push_back(makeJob(sidPath, subtune, outputPath, maxSeconds, fallbackSeconds));
+}
+
+void SIDRenderScheduler::add(Job job) {
+    jobs_.push_back(std::move(job));
+}
+
+void SIDRenderScheduler::push(const std::string& sidPath, int subtune, const std::string& outputPath,
+                              int maxSeconds, int fallbackSeconds) {
+    // Songlengths-Lookup außerhalb des Locks
+    push(makeJob(sidPath, subtune, outputPath, maxSeconds, fallbackSeconds));
+}
+
+void SIDRenderScheduler::push(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(streamMutex_);
+        stream_.push(std::move(job));
+        streamPushed_++;
+    }
+    streamReady_.notify_one();
+}
+
+void SIDRenderScheduler::close() {
+    {
+        std::lock_guard<std::mutex> lock(streamMutex_);
+        streamClosed_ = true;
+    }
+    streamReady_.notify_all();
+}
+
+size_t SIDRenderScheduler::pushed() const {
+    std::lock_guard<std::mutex> lock(streamMutex_);
+    return streamPushed_;
+}
+
+size_t SIDRenderScheduler::run(const JobFunction& function, const ProgressCallback& progress,
+                               const std::atomic<bool>* stopFlag) {
+    if (jobs_.empty()) return 0;
+
+    // Längste zuerst; der Pool verteilt reihum und Diebe nehmen die kurzen vom Ende
+    std::stable_sort(jobs_.begin(), jobs_.end(), [](const Job& a, const Job& b) {
+        return a.seconds > b.seconds;
+    });
+
+    // Ein Converter pro Worker (lazy, Engine lebt über alle Jobs des Workers)
+    std::vector<std::unique_ptr<SIDLibConverter>> converters(pool_.threadCount());
+    std::atomic<size_t> completed{0};
+    std::atomic<size_t> succeeded{0};
+    const size_t total = jobs_.size();
+
+    pool_.run(total, [&](size_t index, size_t worker) {
+        if (!converters[worker]) {
+            converters[worker] = std::make_unique<SIDLibConverter>();
+        }
+        if (function(jobs_[index], *converters[worker], worker)) {
+            succeeded++;
+        }
+        size_t done = ++completed;
+        if (progress) progress(done, total);
+    }, stopFlag);
+
+    return succeeded.load();
+}
+
+size_t SIDRenderScheduler::runStreaming(const JobFunction& function, const ProgressCallback& progress,
+                                        const std::atomic<bool>* stopFlag) {
+    std::vector<std::unique_ptr<SIDLibConverter>> converters(pool_.threadCount());
+    std::atomic<size_t> completed{0};
+    std::atomic<size_t> succeeded{0};
+    auto stopped = [stopFlag]() { return stopFlag && stopFlag->load(); };
+
+    // Ein Verbraucher pro Worker; jeder holt sich den längsten wartenden Job
+    pool_.run(pool_.threadCount(), [&](size_t, size_t worker) {
+        while (true) {
+            Job job;
+            size_t total;
+            {
+                std::unique_lock<std::mutex> lock(streamMutex_);
+                // Stop-Flag wird gepollt, es gibt kein Notify von außen
+                while (stream_.empty() && !streamClosed_ && !stopped()) {
+                    streamReady_.wait_for(lock, std::chrono::milliseconds(200));
+                }
+                if (stream_.empty() || stopped()) return;
+                job = stream_.top();
+                stream_.pop();
+                total = streamPushed_;
+            }
+
+            if (!converters[worker]) {
+                converters[worker] = std::make_unique<SIDLibConverter>();
+            }
+            if (function(job, *converters[worker], worker)) {
+                succeeded++;
+            }
+            size_t done = ++completed;
+            if (progress) progress(done, total);
+        }
+    }, stopFlag);
+
+    // Für den nächsten Lauf zurücksetzen (nach Stop liegen evtl. noch Jobs an)
+    std::lock_guard<std::mutex> lock(streamMutex_);
+    stream_ = decltype(stream_)();
+    streamPushed_ = 0;
+    streamClosed_ = false;
+    return succeeded.load();
+}
+
+void SIDRenderScheduler::printUtilization(bool perWorker) const {
+    pool_.printUtilization("SID-Rendering", perWorker);
+}
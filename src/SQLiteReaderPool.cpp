@@ -0,0 +1,58 @@
+#include "SQLiteReaderPool.h"
+#include <iostream>
+
+SQLiteReaderPool::~SQLiteReaderPool() {
+    close();
+}
+
+bool SQLiteReaderPool::open(const std::string& path, size_t connections, const std::vector<std::string>& pragmas) {
+    close();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (size_t i = 0; i < connections; ++i) {
+        sqlite3* connection = nullptr;
+        int rc = sqlite3_open_v2(path.c_str(), &connection,
+                                 SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+        if (rc != SQLITE_OK) {
+            std::cerr << "⚠️ Reader-Verbindung fehlgeschlagen: " << sqlite3_errmsg(connection) << std::endl;
+            sqlite3_close(connection);
+            break;
+        }
+        sqlite3_busy_timeout(connection, 5000);
+        for (const auto& pragma : pragmas) {
+            sqlite3_exec(connection, pragma.c_str(), nullptr, nullptr, nullptr);
+        }
+        connections_.push_back(connection);
+    }
+
+    idle_ = connections_;
+    return !connections_.empty();
+}
+
+void SQLiteReaderPool::close() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Erst schließen, wenn alle verliehenen Verbindungen zurück sind
+    available_.wait(lock, [this]() { return idle_.size() == connections_.size(); });
+    for (sqlite3* connection : connections_) {
+        sqlite3_close(connection);
+    }
+    connections_.clear();
+    idle_.clear();
+}
+
+sqlite3* SQLiteReaderPool::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_.wait(lock, [this]() { return !idle_.empty() || connections_.empty(); });
+    if (idle_.empty()) return nullptr;
+    sqlite3* connection = idle_.back();
+    idle_.pop_back();
+    return connection;
+}
+
+void SQLiteReaderPool::release(sqlite3* connection) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(connection);
+    }
+    available_.notify_all();
+}
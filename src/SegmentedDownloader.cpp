@@ -0,0 +1,566 @@
+#include "SegmentedDownloader.h"
+#include <curl/curl.h>
+#include <openssl/evp.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char* kStateMagic = "SGDOWNLOAD 1";
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+// Antwort-Header des Vorab-Requests (bei Redirects zählt nur die letzte Antwort)
+struct HeaderState {
+    int64_t contentLength = -1;
+    int64_t rangeTotal = -1;        // Aus "Content-Range: bytes a-b/N"
+    std::string etag;
+    std::string lastModified;
+};
+
+size_t collectHeader(char* buffer, size_t size, size_t nitems, void* userdata) {
+    auto* state = static_cast<HeaderState*>(userdata);
+    const size_t length = size * nitems;
+    std::string line(buffer, length);
+
+    if (line.compare(0, 5, "HTTP/") == 0) {
+        *state = HeaderState();
+        return length;
+    }
+    size_t colon = line.find(':');
+    if (colon == std::string::npos) return length;
+    std::string name = toLower(trim(line.substr(0, colon)));
+    std::string value = trim(line.substr(colon + 1));
+
+    if (name == "content-length") {
+        state->contentLength = std::strtoll(value.c_str(), nullptr, 10);
+    } else if (name == "content-range") {
+        size_t slash = value.find('/');
+        if (slash != std::string::npos && value[slash + 1] != '*') {
+            state->rangeTotal = std::strtoll(value.c_str() + slash + 1, nullptr, 10);
+        }
+    } else if (name == "etag") {
+        state->etag = value;
+    } else if (name == "last-modified") {
+        state->lastModified = value;
+    }
+    return length;
+}
+
+// Body des Vorab-Requests nicht laden (bei 200 statt 206 käme sonst die ganze Datei)
+size_t abortBody(char*, size_t, size_t, void*) {
+    return 0;
+}
+
+void setCommonOptions(CURL* curl, long connectTimeoutSec) {
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, connectTimeoutSec);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, "SongGen/1.0");
+}
+
+} // namespace
+
+struct SegmentedDownloader::ServerInfo {
+    std::string effectiveUrl;       // Nach Redirects; Segmente gehen direkt dorthin
+    uint64_t size = 0;              // 0 = unbekannt
+    bool ranges = false;
+    std::string validator;          // ETag, sonst Last-Modified
+};
+
+struct SegmentedDownloader::Segment {
+    uint64_t start = 0;
+    uint64_t end = 0;               // Inklusiv; bei openEnded ohne Bedeutung
+    uint64_t done = 0;
+    int retries = 0;
+    bool openEnded = false;         // Server ohne Range: ein Stream unbekannter Länge
+
+    // Laufzeit
+    CURL* handle = nullptr;
+    int fd = -1;
+    uint64_t* sessionBytes = nullptr;
+    bool badStatus = false;
+    int writeError = 0;             // errno des fehlgeschlagenen pwrite
+
+    uint64_t length() const { return end - start + 1; }
+    bool complete() const { return !openEnded && done >= length(); }
+    uint64_t remaining() const { return openEnded ? 0 : length() - done; }
+};
+
+SegmentedDownloader::SegmentedDownloader(const Options& options) : options_(options) {
+    if (options_.segments == 0) options_.segments = 1;
+}
+
+bool SegmentedDownloader::queryServer(const std::string& url, ServerInfo& info) {
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        error_ = "curl_easy_init fehlgeschlagen";
+        return false;
+    }
+
+    // Range 0-0 statt HEAD: viele Server melden Accept-Ranges nur bei GET zuverlässig
+    HeaderState headers;
+    setCommonOptions(curl, options_.connectTimeoutSec);
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_RANGE, "0-0");
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, collectHeader);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, abortBody);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, options_.connectTimeoutSec * 2);
+
+    CURLcode res = curl_easy_perform(curl);
+    long status = 0;
+    char* effective = nullptr;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &effective);
+    info.effectiveUrl = effective ? effective : url;
+    curl_easy_cleanup(curl);
+
+    if (res != CURLE_OK && res != CURLE_WRITE_ERROR) {
+        error_ = std::string("Server nicht erreichbar: ") + curl_easy_strerror(res);
+        return false;
+    }
+    if (status == 206 && headers.rangeTotal > 0) {
+        info.ranges = true;
+        info.size = static_cast<uint64_t>(headers.rangeTotal);
+    } else if (status == 200) {
+        info.ranges = false;
+        info.size = headers.contentLength > 0 ? static_cast<uint64_t>(headers.contentLength) : 0;
+    } else {
+        error_ = "HTTP " + std::to_string(status) + " für " + url;
+        return false;
+    }
+    info.validator = !headers.etag.empty() ? headers.etag : headers.lastModified;
+    return true;
+}
+
+bool SegmentedDownloader::loadState(const std::string& statePath, const std::string& url, const ServerInfo& info,
+                                    std::deque<Segment>& segments) const {
+    std::ifstream in(statePath);
+    std::string line;
+    if (!in.is_open() || !std::getline(in, line) || line != kStateMagic) return false;
+
+    std::string stateUrl, validator;
+    uint64_t size = 0;
+    std::deque<Segment> loaded;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+        if (key == "url") {
+            std::getline(fields >> std::ws, stateUrl);
+        } else if (key == "size") {
+            fields >> size;
+        } else if (key == "validator") {
+            std::getline(fields >> std::ws, validator);
+        } else if (key == "segment") {
+            Segment segment;
+            if (!(fields >> segment.start >> segment.end >> segment.done)) return false;
+            if (segment.end < segment.start || segment.done > segment.length()) return false;
+            loaded.push_back(segment);
+        }
+    }
+    if (validator == "-") validator.clear();
+
+    // Nur fortsetzen, wenn es sicher dieselbe Datei ist
+    if (stateUrl != url || size != info.size || validator != info.validator || loaded.empty()) return false;
+    segments = std::move(loaded);
+    return true;
+}
+
+bool SegmentedDownloader::saveState(const std::string& statePath, const std::string& url, const ServerInfo& info,
+                                    const std::deque<Segment>& segments) const {
+    std::string tempPath = statePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::trunc);
+        if (!out.is_open()) return false;
+        out << kStateMagic << "\n";
+        out << "url " << url << "\n";
+        out << "size " << info.size << "\n";
+        out << "validator " << (info.validator.empty() ? "-" : info.validator) << "\n";
+        for (const auto& segment : segments) {
+            out << "segment " << segment.start << " " << segment.end << " " << segment.done << "\n";
+        }
+        if (!out.good()) return false;
+    }
+    return std::rename(tempPath.c_str(), statePath.c_str()) == 0;
+}
+
+bool SegmentedDownloader::download(const std::string& url, const std::string& targetPath) {
+    error_.clear();
+    sha256_.clear();
+    resumedBytes_ = 0;
+
+    ServerInfo info;
+    if (!queryServer(url, info)) return false;
+
+    const std::string partPath = targetPath + ".part";
+    const std::string statePath = partPath + ".state";
+    std::deque<Segment> segments;
+
+    struct stat partStat;
+    bool resume = info.ranges && info.size > 0 && ::stat(partPath.c_str(), &partStat) == 0 &&
+                  static_cast<uint64_t>(partStat.st_size) == info.size &&
+                  loadState(statePath, url, info, segments);
+
+    int fd = ::open(partPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error_ = partPath + ": " + std::strerror(errno);
+        return false;
+    }
+
+    if (resume) {
+        for (const auto& segment : segments) resumedBytes_ += segment.done;
+    } else {
+        segments.clear();
+        if (::ftruncate(fd, 0) != 0) {
+            error_ = partPath + ": " + std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        if (info.ranges && info.size > 0) {
+            // Platz vorab reservieren: Segmente schreiben an beliebige Offsets
+            if (posix_fallocate(fd, 0, static_cast<off_t>(info.size)) != 0 &&
+                ::ftruncate(fd, static_cast<off_t>(info.size)) != 0) {
+                error_ = partPath + ": " + std::strerror(errno);
+                ::close(fd);
+                return false;
+            }
+            uint64_t count = std::max<uint64_t>(1, std::min<uint64_t>(options_.segments,
+                                                                      info.size / options_.minSegmentSize));
+            uint64_t chunk = info.size / count;
+            for (uint64_t i = 0; i < count; ++i) {
+                Segment segment;
+                segment.start = i * chunk;
+                segment.end = (i + 1 == count) ? info.size - 1 : (i + 1) * chunk - 1;
+                segments.push_back(segment);
+            }
+        } else {
+            Segment segment;
+            segment.openEnded = true;
+            segments.push_back(segment);
+        }
+        if (info.ranges) saveState(statePath, url, info, segments);
+    }
+
+    bool ok = transfer(url, info, fd, segments, statePath);
+    if (ok && ::fsync(fd) != 0) {
+        error_ = partPath + ": " + std::strerror(errno);
+        ok = false;
+    }
+    ::close(fd);
+    if (!ok) return false;
+
+    sha256_ = sha256File(partPath);
+    if (!options_.expectedSha256.empty() && toLower(options_.expectedSha256) != sha256_) {
+        // Kaputter Stand: beim nächsten Mal von vorne
+        error_ = "Prüfsumme stimmt nicht (erwartet " + options_.expectedSha256 + ", erhalten " + sha256_ + ")";
+        std::remove(partPath.c_str());
+        std::remove(statePath.c_str());
+        return false;
+    }
+    if (std::rename(partPath.c_str(), targetPath.c_str()) != 0) {
+        error_ = targetPath + ": " + std::strerror(errno);
+        return false;
+    }
+    std::remove(statePath.c_str());
+    return true;
+}
+
+size_t SegmentedDownloader::writeSegment(char* data, size_t size, size_t nmemb, void* userdata) {
+    auto* segment = static_cast<Segment*>(userdata);
+    const size_t bytes = size * nmemb;
+
+    // Auf einen Range-Request muss 206 kommen, sonst landet der Dateianfang am falschen Offset
+    if (!segment->openEnded) {
+        long status = 0;
+        curl_easy_getinfo(segment->handle, CURLINFO_RESPONSE_CODE, &status);
+        if (status != 206) {
+            segment->badStatus = true;
+            return 0;
+        }
+    }
+
+    // Nach einer Teilung ist das Segment kürzer als der laufende Request
+    size_t accepted = bytes;
+    if (!segment->openEnded) accepted = static_cast<size_t>(std::min<uint64_t>(bytes, segment->remaining()));
+
+    size_t written = 0;
+    while (written < accepted) {
+        ssize_t result = ::pwrite(segment->fd, data + written, accepted - written,
+                                  static_cast<off_t>(segment->start + segment->done + written));
+        if (result <= 0) {
+            if (result < 0 && errno == EINTR) continue;
+            segment->writeError = result < 0 ? errno : ENOSPC;
+            return 0;
+        }
+        written += static_cast<size_t>(result);
+    }
+    segment->done += accepted;
+    *segment->sessionBytes += accepted;
+    return accepted == bytes ? bytes : 0;
+}
+
+bool SegmentedDownloader::transfer(const std::string& url, const ServerInfo& info, int fd,
+                                   std::deque<Segment>& segments, const std::string& statePath) {
+    CURLM* multi = curl_multi_init();
+    if (!multi) {
+        error_ = "curl_multi_init fehlgeschlagen";
+        return false;
+    }
+
+    uint64_t sessionBytes = 0;
+    unsigned int active = 0;
+    const int64_t startMs = nowMs();
+    int64_t nextProgressMs = 0;
+    int64_t nextStateMs = startMs + 1000;
+
+    auto start = [&](Segment& segment) {
+        segment.handle = curl_easy_init();
+        segment.fd = fd;
+        segment.sessionBytes = &sessionBytes;
+        segment.badStatus = false;
+        segment.writeError = 0;
+        if (segment.openEnded) {
+            // Ohne Range kein Fortsetzen: neu beginnen
+            segment.done = 0;
+            if (::ftruncate(fd, 0) != 0) segment.writeError = errno;
+        }
+
+        CURL* curl = segment.handle;
+        setCommonOptions(curl, options_.connectTimeoutSec);
+        curl_easy_setopt(curl, CURLOPT_URL, info.effectiveUrl.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeSegment);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &segment);
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, &segment);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1024L);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, options_.lowSpeedTimeSec);
+        if (!segment.openEnded) {
+            std::string range = std::to_string(segment.start + segment.done) + "-" + std::to_string(segment.end);
+            curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
+        }
+        curl_multi_add_handle(multi, curl);
+        active++;
+    };
+
+    auto finish = [&](Segment& segment) {
+        curl_multi_remove_handle(multi, segment.handle);
+        curl_easy_cleanup(segment.handle);
+        segment.handle = nullptr;
+        active--;
+    };
+
+    // Freie Verbindung übernimmt die hintere Hälfte des größten Rests
+    auto split = [&]() {
+        Segment* largest = nullptr;
+        for (auto& segment : segments) {
+            if (segment.handle && !segment.openEnded && (!largest || segment.remaining() > largest->remaining())) {
+                largest = &segment;
+            }
+        }
+        if (!largest || largest->remaining() < 2 * options_.minSegmentSize) return;
+        Segment tail;
+        tail.end = largest->end;
+        largest->end = largest->start + largest->done + largest->remaining() / 2 - 1;
+        tail.start = largest->end + 1;
+        segments.push_back(tail);
+        start(segments.back());
+    };
+
+    for (auto& segment : segments) {
+        if (!segment.complete()) start(segment);
+    }
+
+    bool ok = true;
+    while (active > 0) {
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        CURLMsg* message;
+        int queued = 0;
+        while (ok && (message = curl_multi_info_read(multi, &queued))) {
+            if (message->msg != CURLMSG_DONE) continue;
+            Segment* segment = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&segment));
+            CURLcode result = message->data.result;
+            finish(*segment);
+
+            const bool streamDone = segment->openEnded && result == CURLE_OK && segment->writeError == 0 &&
+                                    (info.size == 0 || segment->done == info.size);
+            if (segment->complete() || streamDone) {
+                if (segment->openEnded) segment->end = segment->done > 0 ? segment->done - 1 : 0;
+                split();
+            } else if (segment->badStatus) {
+                error_ = "Server ignoriert Range-Anfragen";
+                ok = false;
+            } else if (segment->writeError != 0) {
+                error_ = std::string("Schreiben fehlgeschlagen: ") + std::strerror(segment->writeError);
+                ok = false;
+            } else if (++segment->retries > options_.maxRetries) {
+                error_ = std::string("Download fehlgeschlagen: ") + curl_easy_strerror(result);
+                ok = false;
+            } else {
+                start(*segment);    // Setzt beim bisherigen Stand fort
+            }
+        }
+
+        if (ok && options_.stopFlag && options_.stopFlag->load()) {
+            error_ = "abgebrochen";
+            ok = false;
+        }
+        if (!ok) break;
+
+        int64_t now = nowMs();
+        if (info.ranges && now >= nextStateMs) {
+            saveState(statePath, url, info, segments);
+            nextStateMs = now + 1000;
+        }
+        if (options_.onProgress && now >= nextProgressMs) {
+            nextProgressMs = now + options_.progressIntervalMs;
+            Progress progress;
+            for (const auto& segment : segments) progress.bytesDone += segment.done;
+            progress.bytesTotal = info.size;
+            progress.activeSegments = active;
+            double seconds = (now - startMs) / 1000.0;
+            progress.bytesPerSecond = seconds > 0 ? sessionBytes / seconds : 0.0;
+            options_.onProgress(progress);
+        }
+
+        if (active > 0) curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+    }
+
+    for (auto& segment : segments) {
+        if (segment.handle) finish(segment);
+    }
+    curl_multi_cleanup(multi);
+
+    if (info.ranges) saveState(statePath, url, info, segments);
+    if (ok && options_.onProgress) {
+        Progress progress;
+        for (const auto& segment : segments) progress.bytesDone += segment.done;
+        progress.bytesTotal = info.size > 0 ? info.size : progress.bytesDone;
+        double seconds = (nowMs() - startMs) / 1000.0;
+        progress.bytesPerSecond = seconds > 0 ? sessionBytes / seconds : 0.0;
+        options_.onProgress(progress);
+    }
+    return ok;
+}
+
+std::vector<SegmentedDownloader::ProbeResult> SegmentedDownloader::probe(const std::vector<std::string>& urls,
+                                                                         size_t probeBytes, long timeoutMs) {
+    struct Probe {
+        ProbeResult result;
+        size_t limit = 0;
+        CURL* handle = nullptr;
+    };
+    std::vector<Probe> probes(urls.size());
+
+    // Zählt nur mit; bricht ab, falls der Server die Range ignoriert und mehr schickt
+    auto countBody = [](char*, size_t size, size_t nmemb, void* userdata) -> size_t {
+        auto* probe = static_cast<Probe*>(userdata);
+        probe->result.bytes += size * nmemb;
+        return probe->result.bytes >= probe->limit ? 0 : size * nmemb;
+    };
+
+    CURLM* multi = curl_multi_init();
+    std::string range = "0-" + std::to_string(probeBytes > 0 ? probeBytes - 1 : 0);
+    for (size_t i = 0; i < urls.size(); ++i) {
+        Probe& probe = probes[i];
+        probe.result.url = urls[i];
+        probe.limit = std::max<size_t>(1, probeBytes);
+        probe.handle = curl_easy_init();
+        setCommonOptions(probe.handle, std::max(1L, timeoutMs / 1000));
+        curl_easy_setopt(probe.handle, CURLOPT_URL, urls[i].c_str());
+        curl_easy_setopt(probe.handle, CURLOPT_RANGE, range.c_str());
+        curl_easy_setopt(probe.handle, CURLOPT_WRITEFUNCTION, +countBody);
+        curl_easy_setopt(probe.handle, CURLOPT_WRITEDATA, &probe);
+        curl_easy_setopt(probe.handle, CURLOPT_PRIVATE, &probe);
+        curl_easy_setopt(probe.handle, CURLOPT_TIMEOUT_MS, timeoutMs);
+        curl_multi_add_handle(multi, probe.handle);
+    }
+
+    int running = 1;
+    while (running > 0) {
+        curl_multi_perform(multi, &running);
+        CURLMsg* message;
+        int queued = 0;
+        while ((message = curl_multi_info_read(multi, &queued))) {
+            if (message->msg != CURLMSG_DONE) continue;
+            Probe* probe = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&probe));
+            long status = 0;
+            curl_off_t micros = 0;
+            curl_easy_getinfo(probe->handle, CURLINFO_RESPONSE_CODE, &status);
+            curl_easy_getinfo(probe->handle, CURLINFO_TOTAL_TIME_T, &micros);
+            CURLcode result = message->data.result;
+            probe->result.ok = (result == CURLE_OK || result == CURLE_WRITE_ERROR) &&
+                               (status == 200 || status == 206) && probe->result.bytes > 0;
+            if (probe->result.ok && micros > 0) {
+                probe->result.bytesPerSecond = probe->result.bytes / (micros / 1e6);
+            }
+        }
+        if (running > 0) curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+    }
+
+    std::vector<ProbeResult> results;
+    for (auto& probe : probes) {
+        curl_multi_remove_handle(multi, probe.handle);
+        curl_easy_cleanup(probe.handle);
+        results.push_back(probe.result);
+    }
+    curl_multi_cleanup(multi);
+    return results;
+}
+
+std::string SegmentedDownloader::sha256File(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return "";
+
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    if (!ctx || EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr) != 1) {
+        EVP_MD_CTX_free(ctx);
+        return "";
+    }
+    std::vector<char> buffer(1024 * 1024);
+    while (in) {
+        in.read(buffer.data(), buffer.size());
+        if (in.gcount() > 0) EVP_DigestUpdate(ctx, buffer.data(), static_cast<size_t>(in.gcount()));
+    }
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    bool ok = !in.bad() && EVP_DigestFinal_ex(ctx, digest, &length) == 1;
+    EVP_MD_CTX_free(ctx);
+    if (!ok) return "";
+
+    static const char* hex = "0123456789abcdef";
+    std::string result;
+    for (unsigned int i = 0; i < length; ++i) {
+        result += hex[digest[i] >> 4];
+        result += hex[digest[i] & 0x0f];
+    }
+    return result;
+}
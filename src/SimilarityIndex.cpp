@@ -0,0 +1,354 @@
+#include "SimilarityIndex.h"
+#include "MediaDatabase.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <queue>
+
+namespace {
+
+const char kSnapshotMagic[4] = {'S', 'G', 'V', 'I'};
+const uint32_t kSnapshotVersion = 1;
+
+inline float squaredDistance(const float* a, const float* b) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < SimilarityIndex::kDimensions; ++i) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+template <typename T>
+void writePod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readPod(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+SimilarityIndex::Vector SimilarityIndex::featureVector(const MediaMetadata& meta) {
+    Vector v(kDimensions, 0.0f);
+
+    // Skalierung so, dass typische Unterschiede in allen Dimensionen ~1 sind
+    for (size_t i = 0; i < 13 && i < meta.mfccMean.size(); ++i) {
+        v[i] = meta.mfccMean[i] / 20.0f;
+    }
+    for (size_t i = 0; i < 13 && i < meta.mfccVariance.size(); ++i) {
+        v[13 + i] = std::sqrt(std::max(0.0f, meta.mfccVariance[i])) / 10.0f;
+    }
+    v[26] = meta.spectralCentroid / 5000.0f;
+    v[27] = meta.spectralRolloff / 10000.0f;
+    v[28] = meta.zeroCrossingRate / 0.5f;
+    v[29] = meta.bpm / 100.0f;
+    return v;
+}
+
+float SimilarityIndex::similarityFromDistance(float distance) {
+    return 1.0f / (1.0f + std::max(0.0f, distance));
+}
+
+void SimilarityIndex::clear() {
+    ids_.clear();
+    vectors_.clear();
+    freeSlots_.clear();
+    slotById_.clear();
+    centroids_.clear();
+    lists_.clear();
+    listPosition_.clear();
+    trainedSize_ = 0;
+}
+
+size_t SimilarityIndex::nearestList(const float* vector, const std::vector<float>& centroids) {
+    const size_t listCount = centroids.size() / kDimensions;
+    size_t best = 0;
+    float bestDist = std::numeric_limits<float>::max();
+    for (size_t l = 0; l < listCount; ++l) {
+        float d = squaredDistance(vector, centroids.data() + l * kDimensions);
+        if (d < bestDist) {
+            bestDist = d;
+            best = l;
+        }
+    }
+    return best;
+}
+
+void SimilarityIndex::assignSlot(uint32_t slot) {
+    if (lists_.empty()) lists_.resize(1);
+    uint32_t list = static_cast<uint32_t>(nearestList(slotVector(slot)));
+    listPosition_[slot] = {list, static_cast<uint32_t>(lists_[list].size())};
+    lists_[list].push_back(slot);
+}
+
+void SimilarityIndex::unassignSlot(uint32_t slot) {
+    auto [list, pos] = listPosition_[slot];
+    std::vector<uint32_t>& members = lists_[list];
+    uint32_t moved = members.back();
+    members[pos] = moved;
+    listPosition_[moved].second = pos;
+    members.pop_back();
+}
+
+void SimilarityIndex::upsert(int64_t id, const Vector& vector) {
+    if (vector.size() != kDimensions) return;
+
+    auto it = slotById_.find(id);
+    if (it != slotById_.end()) {
+        uint32_t slot = it->second;
+        unassignSlot(slot);
+        std::copy(vector.begin(), vector.end(), vectors_.begin() + static_cast<size_t>(slot) * kDimensions);
+        assignSlot(slot);
+        return;
+    }
+
+    uint32_t slot;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+        ids_[slot] = id;
+        std::copy(vector.begin(), vector.end(), vectors_.begin() + static_cast<size_t>(slot) * kDimensions);
+    } else {
+        slot = static_cast<uint32_t>(ids_.size());
+        ids_.push_back(id);
+        vectors_.insert(vectors_.end(), vector.begin(), vector.end());
+        listPosition_.emplace_back(0, 0);
+    }
+    slotById_[id] = slot;
+    assignSlot(slot);
+}
+
+void SimilarityIndex::remove(int64_t id) {
+    auto it = slotById_.find(id);
+    if (it == slotById_.end()) return;
+
+    uint32_t slot = it->second;
+    unassignSlot(slot);
+    ids_[slot] = -1;
+    freeSlots_.push_back(slot);
+    slotById_.erase(it);
+}
+
+void SimilarityIndex::train() {
+    TrainingJob job = prepareTraining();
+    runTraining(job);
+    applyTraining(job);
+}
+
+SimilarityIndex::TrainingJob SimilarityIndex::prepareTraining() const {
+    std::vector<uint32_t> active;
+    active.reserve(slotById_.size());
+    for (const auto& entry : slotById_) active.push_back(entry.second);
+    std::sort(active.begin(), active.end());  // Deterministisch (unabhängig von Hash-Reihenfolge)
+
+    TrainingJob job;
+    job.ids.reserve(active.size());
+    job.vectors.reserve(active.size() * kDimensions);
+    for (uint32_t slot : active) {
+        job.ids.push_back(ids_[slot]);
+        job.vectors.insert(job.vectors.end(), slotVector(slot), slotVector(slot) + kDimensions);
+    }
+    return job;
+}
+
+void SimilarityIndex::runTraining(TrainingJob& job) {
+    const size_t n = job.ids.size();
+    auto vectorOf = [&job](size_t i) { return job.vectors.data() + i * kDimensions; };
+    job.centroids.clear();
+    job.assignment.assign(n, 0);
+    if (n <= kBruteForceLimit) return;
+
+    const size_t listCount = std::min<size_t>(4096, static_cast<size_t>(std::sqrt(static_cast<double>(n))));
+
+    // k-Means (Lloyd) auf einer gleichmäßigen Stichprobe
+    const size_t sampleCount = std::min(n, listCount * 64);
+    std::vector<size_t> sample(sampleCount);
+    for (size_t i = 0; i < sampleCount; ++i) sample[i] = i * n / sampleCount;
+
+    job.centroids.resize(listCount * kDimensions);
+    for (size_t l = 0; l < listCount; ++l) {
+        const float* src = vectorOf(sample[l * sampleCount / listCount]);
+        std::copy(src, src + kDimensions, job.centroids.begin() + l * kDimensions);
+    }
+
+    std::vector<double> sums(listCount * kDimensions);
+    std::vector<size_t> counts(listCount);
+    for (int iteration = 0; iteration < 10; ++iteration) {
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (size_t index : sample) {
+            const float* v = vectorOf(index);
+            size_t l = nearestList(v, job.centroids);
+            counts[l]++;
+            for (size_t d = 0; d < kDimensions; ++d) sums[l * kDimensions + d] += v[d];
+        }
+        for (size_t l = 0; l < listCount; ++l) {
+            if (counts[l] == 0) continue;  // Leerer Cluster behält seinen Zentroiden
+            for (size_t d = 0; d < kDimensions; ++d) {
+                job.centroids[l * kDimensions + d] = static_cast<float>(sums[l * kDimensions + d] / counts[l]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        job.assignment[i] = static_cast<uint32_t>(nearestList(vectorOf(i), job.centroids));
+    }
+}
+
+void SimilarityIndex::applyTraining(const TrainingJob& job) {
+    centroids_ = job.centroids;
+    lists_.assign(std::max<size_t>(1, centroids_.size() / kDimensions), {});
+    trainedSize_ = job.ids.size();
+
+    std::unordered_map<int64_t, size_t> trained;
+    trained.reserve(job.ids.size());
+    for (size_t i = 0; i < job.ids.size(); ++i) trained.emplace(job.ids[i], i);
+
+    std::vector<uint32_t> active;
+    active.reserve(slotById_.size());
+    for (const auto& entry : slotById_) active.push_back(entry.second);
+    std::sort(active.begin(), active.end());
+
+    for (uint32_t slot : active) {
+        // Seit prepareTraining() unverändert: vorberechnete Liste, sonst neu zuordnen
+        auto it = trained.find(ids_[slot]);
+        if (it != trained.end() &&
+            std::equal(slotVector(slot), slotVector(slot) + kDimensions,
+                       job.vectors.begin() + it->second * kDimensions)) {
+            uint32_t list = job.assignment[it->second];
+            listPosition_[slot] = {list, static_cast<uint32_t>(lists_[list].size())};
+            lists_[list].push_back(slot);
+        } else {
+            assignSlot(slot);
+        }
+    }
+}
+
+std::vector<SimilarityIndex::Hit> SimilarityIndex::search(const Vector& query, size_t k,
+                                                          int64_t excludeId, size_t probes) const {
+    std::vector<Hit> hits;
+    if (query.size() != kDimensions || k == 0 || lists_.empty()) return hits;
+
+    // Zu durchsuchende Listen: die probes nächsten Zentroiden
+    std::vector<size_t> probeLists;
+    const size_t listCount = centroids_.size() / kDimensions;
+    if (listCount <= 1) {
+        probeLists.push_back(0);
+    } else {
+        std::vector<std::pair<float, size_t>> ranked(listCount);
+        for (size_t l = 0; l < listCount; ++l) {
+            ranked[l] = {squaredDistance(query.data(), centroids_.data() + l * kDimensions), l};
+        }
+        size_t take = std::min(std::max<size_t>(probes, 1), listCount);
+        std::partial_sort(ranked.begin(), ranked.begin() + take, ranked.end());
+        for (size_t i = 0; i < take; ++i) probeLists.push_back(ranked[i].second);
+    }
+
+    // Max-Heap der besten k (größte Distanz oben)
+    auto worse = [](const Hit& a, const Hit& b) { return a.distance < b.distance; };
+    std::priority_queue<Hit, std::vector<Hit>, decltype(worse)> best(worse);
+    for (size_t list : probeLists) {
+        for (uint32_t slot : lists_[list]) {
+            if (ids_[slot] == excludeId) continue;
+            float d = squaredDistance(query.data(), slotVector(slot));
+            if (best.size() < k) {
+                best.push({ids_[slot], d});
+            } else if (d < best.top().distance) {
+                best.pop();
+                best.push({ids_[slot], d});
+            }
+        }
+    }
+
+    hits.resize(best.size());
+    for (size_t i = hits.size(); i-- > 0;) {
+        hits[i] = best.top();
+        hits[i].distance = std::sqrt(hits[i].distance);
+        best.pop();
+    }
+    return hits;
+}
+
+bool SimilarityIndex::save(const std::string& path) const {
+    std::string tmpPath = path + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    const uint32_t dims = kDimensions;
+    const uint64_t count = size();
+    const uint32_t listCount = static_cast<uint32_t>(centroids_.size() / kDimensions);
+
+    out.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+    writePod(out, kSnapshotVersion);
+    writePod(out, dims);
+    writePod(out, count);
+    writePod(out, listCount);
+    out.write(reinterpret_cast<const char*>(centroids_.data()), centroids_.size() * sizeof(float));
+
+    for (uint32_t list = 0; list < lists_.size(); ++list) {
+        for (uint32_t slot : lists_[list]) {
+            writePod(out, ids_[slot]);
+            writePod(out, list);
+            out.write(reinterpret_cast<const char*>(slotVector(slot)), kDimensions * sizeof(float));
+        }
+    }
+
+    out.close();
+    if (!out) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool SimilarityIndex::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    uint32_t version = 0, dims = 0, listCount = 0;
+    uint64_t count = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0 ||
+        !readPod(in, version) || version != kSnapshotVersion ||
+        !readPod(in, dims) || dims != kDimensions ||
+        !readPod(in, count) || !readPod(in, listCount)) {
+        return false;
+    }
+
+    clear();
+    centroids_.resize(static_cast<size_t>(listCount) * kDimensions);
+    if (!in.read(reinterpret_cast<char*>(centroids_.data()), centroids_.size() * sizeof(float))) {
+        clear();
+        return false;
+    }
+    lists_.assign(std::max<uint32_t>(listCount, 1), {});
+
+    ids_.reserve(count);
+    vectors_.reserve(count * kDimensions);
+    listPosition_.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        int64_t id;
+        uint32_t list;
+        float vector[kDimensions];
+        if (!readPod(in, id) || !readPod(in, list) || list >= lists_.size() ||
+            !in.read(reinterpret_cast<char*>(vector), sizeof(vector))) {
+            clear();
+            return false;
+        }
+        uint32_t slot = static_cast<uint32_t>(ids_.size());
+        ids_.push_back(id);
+        vectors_.insert(vectors_.end(), vector, vector + kDimensions);
+        listPosition_.emplace_back(list, static_cast<uint32_t>(lists_[list].size()));
+        lists_[list].push_back(slot);
+        slotById_[id] = slot;
+    }
+
+    trainedSize_ = ids_.size();
+    return true;
+}
@@ -4,6 +4,8 @@
 #include <fstream>
 #include <iostream>
 #include <functional>
+#include <algorithm>
+#include <filesystem>
 #include <lame/lame.h>
 
 #ifdef WITH_OPENVINO
@@ -98,46 +100,47 @@ bool SongGenerator::generate(
         return false;
     }
     
+    // Render-Graph statt Gesamtpuffer: jede Phase hängt nur Knoten ein, gerendert wird
+    // blockweise direkt in den Encoder (konstanter Speicher, auch bei 30 Minuten)
     int sampleRate = 44100;
-    size_t numSamples = params.duration * sampleRate;
-    std::vector<float> samples(numSamples, 0.0f);
+    uint64_t numFrames = static_cast<uint64_t>(params.duration) * sampleRate;
+    SongGen::RenderGraph graph(sampleRate);
     
-    // Phase 1: Melodie generieren
-    if (progressCallback) progressCallback("Generating melody...", 0.2f);
-    generateMelody(params, samples);
+    // Phase 1: Melodie
+    if (progressCallback) progressCallback("Generating melody...", 0.02f);
+    generateMelody(params, graph);
     
     // Phase 2: Rhythmus
-    if (progressCallback) progressCallback("Generating rhythm...", 0.4f);
-    generateRhythm(params, samples);
+    if (progressCallback) progressCallback("Generating rhythm...", 0.04f);
+    generateRhythm(params, graph);
     
     // Phase 3: Bass
-    if (progressCallback) progressCallback("Generating bass...", 0.6f);
-    generateBass(params, samples);
+    if (progressCallback) progressCallback("Generating bass...", 0.06f);
+    generateBass(params, graph);
     
     // Phase 4: Instrumente
-    if (progressCallback) progressCallback("Layering instruments...", 0.75f);
-    layerInstruments(params, samples);
+    if (progressCallback) progressCallback("Layering instruments...", 0.08f);
+    layerInstruments(params, graph);
     
     // Phase 5: Vocals
     if (params.useVocals) {
-        if (progressCallback) progressCallback("Adding vocals...", 0.85f);
-        addVocals(params, samples);
+        if (progressCallback) progressCallback("Adding vocals...", 0.09f);
+        addVocals(params, graph);
     }
     
-    // Phase 6: Mixing & Mastering
-    if (progressCallback) progressCallback("Mixing and mastering...", 0.95f);
-    mixAndMaster(samples);
+    // Phase 6: Mixing & Mastering (läuft pro Block beim Rendern)
+    mixAndMaster(graph);
     
-    // Fade-In am Anfang (100ms) um Rauschen zu vermeiden
-    int fadeInSamples = static_cast<int>(sampleRate * 0.1f);  // 100ms
-    for (int i = 0; i < fadeInSamples && i < static_cast<int>(samples.size()); ++i) {
-        float fadeGain = static_cast<float>(i) / fadeInSamples;
-        samples[i] *= fadeGain;
-    }
-    
-    // Export als MP3
-    if (progressCallback) progressCallback("Exporting to MP3...", 0.99f);
-    bool success = exportMP3(outputPath, samples, sampleRate, 192);
+    // Rendern und gleichzeitig als MP3 exportieren
+    int lastPercent = -1;
+    bool success = exportMP3(outputPath, graph, numFrames, sampleRate, 192,
+        [&](float fraction) {
+            int percent = static_cast<int>(fraction * 100.0f);
+            if (progressCallback && percent != lastPercent) {
+                lastPercent = percent;
+                progressCallback("Rendering and encoding...", 0.1f + fraction * 0.89f);
+            }
+        });
     
     if (progressCallback) progressCallback("Done!", 1.0f);
     
@@ -171,13 +174,325 @@ std::vector<MediaMetadata> SongGenerator::selectSourceSamples(const GenerationPa
 }
 
 bool SongGenerator::validateParams(const GenerationParams& params) {
-    if (params.duration <= 0 || params.duration > 600) return false;
+    if (params.duration <= 0 || params.duration > 1800) return false;
     if (params.bpm < 60.0f || params.bpm > 200.0f) return false;
     if (params.energy < 0.0f || params.energy > 1.0f) return false;
     return true;
 }
 
-bool SongGenerator::generateMelody(const GenerationParams& params, std::vector<float>& samples) {
+namespace {
+
+const float PI = 3.14159265358979323846f;
+
+bool applyEnvelope(std::vector<float>& samples, float attack, float decay, float sustain, float release) {
+    size_t attackSamples = static_cast<size_t>(attack * samples.size());
+    size_t decaySamples = static_cast<size_t>(decay * samples.size());
+    size_t releaseSamples = static_cast<size_t>(release * samples.size());
+    
+    for (size_t i = 0; i < samples.size(); ++i) {
+        float envelope = 1.0f;
+        
+        if (i < attackSamples) {
+            envelope = static_cast<float>(i) / attackSamples;
+        } else if (i < attackSamples + decaySamples) {
+            float t = static_cast<float>(i - attackSamples) / decaySamples;
+            envelope = 1.0f - (1.0f - sustain) * t;
+        } else if (i > samples.size() - releaseSamples) {
+            float t = static_cast<float>(samples.size() - i) / releaseSamples;
+            envelope = sustain * t;
+        } else {
+            envelope = sustain;
+        }
+        
+        samples[i] *= envelope;
+    }
+    
+    return true;
+}
+
+bool synthesizeTone(float frequency, float duration, int sampleRate, std::vector<float>& output) {
+    size_t numSamples = static_cast<size_t>(duration * sampleRate);
+    output.resize(numSamples);
+    
+    for (size_t i = 0; i < numSamples; ++i) {
+        float t = static_cast<float>(i) / sampleRate;
+        output[i] = std::sin(2 * PI * frequency * t);
+    }
+    
+    // Envelope (ADSR) - längeres Attack für weicheren Start
+    applyEnvelope(output, 0.02f, 0.1f, 0.7f, 0.25f);
+    
+    return true;
+}
+
+// ML-Melodie: Feature-Vektor steuert die Frequenz jeder 16tel-Note
+class FeatureMelodyNode : public SongGen::VoiceNode {
+public:
+    FeatureMelodyNode(std::vector<float> features, float noteDuration, float level, int sampleRate)
+        : features_(std::move(features)), noteDuration_(noteDuration), level_(level), sampleRate_(sampleRate),
+          samplesPerNote_(static_cast<size_t>(noteDuration * sampleRate)) {}
+
+protected:
+    bool advance() override {
+        float baseFreq = 440.0f;  // A4 Grundfrequenz
+        size_t featureIdx = (cursor_ / samplesPerNote_) % features_.size();
+        float freqMultiplier = 1.0f + (features_[featureIdx] * 0.3f);  // ±30% Variation
+        
+        std::vector<float> tone;
+        synthesizeTone(baseFreq * freqMultiplier, noteDuration_, sampleRate_, tone);
+        play(cursor_, std::move(tone), level_);
+        
+        cursor_ += samplesPerNote_;
+        return true;
+    }
+
+private:
+    std::vector<float> features_;
+    float noteDuration_;
+    float level_;
+    int sampleRate_;
+    size_t samplesPerNote_;
+};
+
+// Instrument-Melodie aus vorab gewählten Phrasen
+class PhraseMelodyNode : public SongGen::VoiceNode {
+public:
+    PhraseMelodyNode(std::shared_ptr<InstrumentModel> instrument, std::vector<float> scale,
+                     std::vector<std::vector<size_t>> phrases, std::vector<float> noteLengths,
+                     float beatDuration, float energy, int sampleRate, std::mt19937 gen)
+        : instrument_(std::move(instrument)), scale_(std::move(scale)), phrases_(std::move(phrases)),
+          noteLengths_(std::move(noteLengths)), beatDuration_(beatDuration), energy_(energy),
+          sampleRate_(sampleRate), gen_(gen) {}
+
+protected:
+    bool advance() override {
+        // Wähle Phrase (wechsle alle 4 Noten)
+        if (noteInPhrase_ >= 4) {
+            noteInPhrase_ = 0;
+            // Wechsle Phrase mit Wahrscheinlichkeit
+            std::uniform_int_distribution<int> phraseDist(0, 100);
+            if (phraseDist(gen_) < 40) {  // 40% Chance für neue Phrase
+                phraseIndex_ = (phraseIndex_ + 1) % phrases_.size();
+            }
+        }
+        
+        size_t scaleIndex = phrases_[phraseIndex_][noteInPhrase_];
+        float frequency = scale_[scaleIndex];
+        float noteDuration = noteLengths_[noteInPhrase_] * beatDuration_;
+        
+        size_t samplesPerNote = static_cast<size_t>(noteDuration * sampleRate_);
+        
+        // ✨ Nutze Instrument-Modell für realistischen Klang!
+        float velocity = 0.6f + (energy_ * 0.3f) + (static_cast<float>(noteInPhrase_) / 10.0f);
+        velocity = std::clamp(velocity, 0.3f, 1.0f);
+        
+        play(cursor_, instrument_->synthesize(frequency, noteDuration, velocity, sampleRate_), 0.5f);  // 50% Mix-Level für Lead
+        
+        cursor_ += samplesPerNote;
+        noteInPhrase_++;
+        return true;
+    }
+
+private:
+    std::shared_ptr<InstrumentModel> instrument_;
+    std::vector<float> scale_;
+    std::vector<std::vector<size_t>> phrases_;
+    std::vector<float> noteLengths_;
+    float beatDuration_;
+    float energy_;
+    int sampleRate_;
+    std::mt19937 gen_;
+    size_t phraseIndex_ = 0;
+    int noteInPhrase_ = 0;
+};
+
+// Drums: ein Ereignis pro Beat
+class RhythmNode : public SongGen::VoiceNode {
+public:
+    RhythmNode(std::shared_ptr<InstrumentModel> kick, std::shared_ptr<InstrumentModel> snare,
+               std::shared_ptr<InstrumentModel> hihat, const GenerationParams& params, int sampleRate,
+               std::mt19937 gen)
+        : kick_(std::move(kick)), snare_(std::move(snare)), hihat_(std::move(hihat)),
+          genre_(params.genre), hard_(params.intensity == "hart"), sampleRate_(sampleRate),
+          samplesPerBeat_(static_cast<size_t>(60.0f / params.bpm * sampleRate)), gen_(gen) {}
+
+protected:
+    bool advance() override {
+        std::uniform_int_distribution<int> fillDist(0, 100);
+        
+        // Kick Drum (Beat 1 und 3 in 4/4, manchmal auch Variationen)
+        bool playKick = (beat_ % 4 == 0 || beat_ % 4 == 2);
+        
+        // Gelegentlich zusätzliche Kicks (Fills)
+        if (!playKick && (beat_ % 16 >= 12) && fillDist(gen_) < 30) {
+            playKick = true;
+        }
+        
+        if (playKick) {
+            // ✨ Nutze Kick-Drum-Modell
+            float kickFreq = 60.0f;  // Standard Kick-Frequenz
+            float kickDuration = 0.15f;
+            float velocity = hard_ ? 0.9f : 0.7f;
+            play(cursor_, kick_->synthesize(kickFreq, kickDuration, velocity, sampleRate_), 0.8f);
+        }
+        
+        // Snare (Beat 2 und 4)
+        if (beat_ % 4 == 1 || beat_ % 4 == 3) {
+            // ✨ Nutze Snare-Drum-Modell
+            float snareFreq = 200.0f;
+            float snareDuration = 0.12f;
+            float velocity = 0.8f;
+            play(cursor_, snare_->synthesize(snareFreq, snareDuration, velocity, sampleRate_), 0.6f);
+        }
+        
+        // Hi-Hat (Off-beats für Techno/Trap)
+        if (genre_ == "Techno" || genre_ == "Trap" || genre_ == "Trance") {
+            if (beat_ % 2 == 1) {
+                // ✨ Nutze HiHat-Modell
+                float hihatFreq = 10000.0f;
+                float hihatDuration = 0.05f;
+                float velocity = 0.4f + (fillDist(gen_) % 20) * 0.01f;  // Leichte Variation
+                play(cursor_, hihat_->synthesize(hihatFreq, hihatDuration, velocity, sampleRate_), 0.3f);
+            }
+        }
+        
+        // Clap für Trap
+        if (genre_ == "Trap" && beat_ % 8 == 4) {
+            std::vector<float> clap;
+            synthesizeTone(1000.0f, 0.05f, sampleRate_, clap);
+            play(cursor_, std::move(clap), 0.3f);
+        }
+        
+        beat_++;
+        cursor_ += samplesPerBeat_;
+        return true;
+    }
+
+private:
+    std::shared_ptr<InstrumentModel> kick_;
+    std::shared_ptr<InstrumentModel> snare_;
+    std::shared_ptr<InstrumentModel> hihat_;
+    std::string genre_;
+    bool hard_;
+    int sampleRate_;
+    size_t samplesPerBeat_;
+    std::mt19937 gen_;
+    size_t beat_ = 0;
+};
+
+// Bass-Line mit gelegentlichem Pattern-Wechsel
+class BassNode : public SongGen::VoiceNode {
+public:
+    BassNode(std::vector<float> bassNotes, float beatDuration, float level, int sampleRate, std::mt19937 gen)
+        : bassNotes_(std::move(bassNotes)), beatDuration_(beatDuration), level_(level), sampleRate_(sampleRate),
+          gen_(gen) {}
+
+protected:
+    bool advance() override {
+        float frequency = bassNotes_[noteIndex_ % bassNotes_.size()];
+        
+        // Notenlänge: meistens ganze oder halbe Beats
+        float noteDuration = (noteIndex_ % 4 == 0) ? beatDuration_ * 2.0f : beatDuration_;
+        size_t samplesPerNote = static_cast<size_t>(noteDuration * sampleRate_);
+        
+        std::vector<float> bassNote;
+        synthesizeTone(frequency, noteDuration, sampleRate_, bassNote);
+        play(cursor_, std::move(bassNote), level_);
+        
+        cursor_ += samplesPerNote;
+        noteIndex_++;
+        
+        // Gelegentlich Pattern wechseln
+        if (noteIndex_ % 16 == 0) {
+            std::shuffle(bassNotes_.begin(), bassNotes_.end(), gen_);
+        }
+        return true;
+    }
+
+private:
+    std::vector<float> bassNotes_;
+    float beatDuration_;
+    float level_;
+    int sampleRate_;
+    std::mt19937 gen_;
+    int noteIndex_ = 0;
+};
+
+// Vocal-Phrasen (Formant-Synthese) alle 2 Takte
+class VocalNode : public SongGen::VoiceNode {
+public:
+    VocalNode(float beatDuration, size_t measures, int sampleRate, std::mt19937 gen)
+        : beatDuration_(beatDuration), measures_(measures), sampleRate_(sampleRate), gen_(gen) {}
+
+protected:
+    bool advance() override {
+        if (measure_ >= measures_) return false;
+        
+        // Nur alle 2 Takte
+        if (measure_ % 2 == 0) {
+            // Vocal-Formant-Frequenzen (A, E, I, O, U)
+            static const std::vector<std::vector<float>> formants = {
+                {730, 1090, 2440},  // A
+                {270, 2290, 3010},  // E
+                {390, 1990, 2550},  // I
+                {570, 840, 2410},   // O
+                {440, 1020, 2240}   // U
+            };
+            std::uniform_int_distribution<size_t> formantDist(0, formants.size() - 1);
+            const auto& formant = formants[formantDist(gen_)];
+            
+            // Synthese mit mehreren Formanten
+            std::vector<float> vocal(static_cast<size_t>(beatDuration_ * 2 * sampleRate_), 0.0f);
+            
+            for (float freq : formant) {
+                std::vector<float> formantTone;
+                synthesizeTone(freq, beatDuration_ * 2, sampleRate_, formantTone);
+                
+                for (size_t i = 0; i < vocal.size() && i < formantTone.size(); ++i) {
+                    vocal[i] += formantTone[i] * 0.2f;
+                }
+            }
+            play(cursor_, std::move(vocal), 0.15f);
+        }
+        
+        measure_++;
+        cursor_ = static_cast<uint64_t>(measure_ * beatDuration_ * 4 * sampleRate_);
+        return true;
+    }
+
+private:
+    float beatDuration_;
+    size_t measures_;
+    int sampleRate_;
+    std::mt19937 gen_;
+    size_t measure_ = 0;
+};
+
+// Source-Sample aus der Datenbank, blockweise von der Platte gelesen
+class WavLayerNode : public SongGen::RenderNode {
+public:
+    WavLayerNode(std::ifstream file, float mixLevel) : file_(std::move(file)), mixLevel_(mixLevel) {}
+
+    void render(uint64_t /*frame*/, std::vector<float>& block) override {
+        if (!file_.is_open()) return;
+        buffer_.resize(block.size());
+        file_.read(reinterpret_cast<char*>(buffer_.data()), buffer_.size() * sizeof(short));
+        size_t count = static_cast<size_t>(file_.gcount()) / sizeof(short);
+        for (size_t i = 0; i < count; ++i) {
+            block[i] += buffer_[i] / 32768.0f * mixLevel_;
+        }
+        if (count < block.size()) file_.close();  // Datei zu Ende
+    }
+
+private:
+    std::ifstream file_;
+    float mixLevel_;
+    std::vector<short> buffer_;
+};
+
+} // namespace
+
+bool SongGenerator::generateMelody(const GenerationParams& params, SongGen::RenderGraph& graph) {
     // Versuche ML-basierte Generierung
     if (mlModel_ && mlModel_->isModelLoaded()) {
         try {
@@ -194,34 +509,17 @@ bool SongGenerator::generateMelody(const GenerationParams& params, std::vector<f
             // ML-Inferenz mit NPU/GPU - returns normalized feature vector
             auto featureVector = mlModel_->generate(latentVector, params.genre, params.bpm);
             
-            // Konvertiere Features zu Audio-Samples
-            int sampleRate = 44100;
-            size_t position = 0;
-            
-            // Nutze Feature-Vektor für Synthese (erste 13 Werte sind MFCC-ähnlich)
-            float baseFreq = 440.0f;  // A4 Grundfrequenz
-            float noteDuration = 60.0f / params.bpm / 4.0f;  // 16tel-Noten
-            
-            while (position < samples.size()) {
-                size_t samplesPerNote = static_cast<size_t>(noteDuration * sampleRate);
-                
-                // Nutze Features für Frequenz-Variation
-                size_t featureIdx = (position / samplesPerNote) % featureVector.size();
-                float freqMultiplier = 1.0f + (featureVector[featureIdx] * 0.3f);  // ±30% Variation
-                
-                std::vector<float> tone;
-                synthesizeTone(baseFreq * freqMultiplier, noteDuration, sampleRate, tone);
-                
+            if (!featureVector.empty()) {
+                // Nutze Feature-Vektor für Synthese (erste 13 Werte sind MFCC-ähnlich)
+                float noteDuration = 60.0f / params.bpm / 4.0f;  // 16tel-Noten
                 float level = 0.2f + (params.energy * 0.3f);
-                for (size_t j = 0; j < tone.size() && (position + j) < samples.size(); ++j) {
-                    samples[position + j] += tone[j] * level;
-                }
+                graph.addSource(std::make_unique<FeatureMelodyNode>(
+                    std::move(featureVector), noteDuration, level, graph.sampleRate()));
                 
-                position += samplesPerNote;
+                std::cout << "🎵 ML-basierte Melodie generiert mit " << acceleratorDevice_ << std::endl;
+                return true;
             }
-            
-            std::cout << "🎵 ML-basierte Melodie generiert mit " << acceleratorDevice_ << std::endl;
-            return true;
+            std::cerr << "⚠️ ML-Modell lieferte keine Features, nutze Fallback" << std::endl;
             
         } catch (const std::exception& e) {
             std::cerr << "⚠️ ML-Generierung fehlgeschlagen: " << e.what() << ", nutze Fallback" << std::endl;
@@ -323,12 +621,6 @@ bool SongGenerator::generateMelody(const GenerationParams& params, std::vector<f
         phrases.push_back(phrase);
     }
     
-    int sampleRate = 44100;
-    float beatDuration = 60.0f / params.bpm;
-    size_t position = 0;
-    int phraseIndex = 0;
-    int noteInPhrase = 0;
-    
     // Notenlängen basierend auf Genre
     std::vector<float> noteLengths;
     if (params.genre == "Techno" || params.genre == "House") {
@@ -339,43 +631,15 @@ bool SongGenerator::generateMelody(const GenerationParams& params, std::vector<f
         noteLengths = {0.5f, 0.25f, 0.5f, 0.75f};  // Mixed
     }
     
-    // Generiere Melodie mit strukturierter Variation
-    while (position < samples.size()) {
-        // Wähle Phrase (wechsle alle 4 Noten)
-        if (noteInPhrase >= 4) {
-            noteInPhrase = 0;
-            // Wechsle Phrase mit Wahrscheinlichkeit
-            std::uniform_int_distribution<int> phraseDist(0, 100);
-            if (phraseDist(gen) < 40) {  // 40% Chance für neue Phrase
-                phraseIndex = (phraseIndex + 1) % phrases.size();
-            }
-        }
-        
-        size_t scaleIndex = phrases[phraseIndex][noteInPhrase];
-        float frequency = scale[scaleIndex];
-        float noteDuration = noteLengths[noteInPhrase] * beatDuration;
-        
-        size_t samplesPerNote = static_cast<size_t>(noteDuration * sampleRate);
-        
-        // ✨ Nutze Instrument-Modell für realistischen Klang!
-        float velocity = 0.6f + (params.energy * 0.3f) + (static_cast<float>(noteInPhrase) / 10.0f);
-        velocity = std::clamp(velocity, 0.3f, 1.0f);
-        
-        std::vector<float> tone = leadInstrument->synthesize(frequency, noteDuration, velocity, sampleRate);
-        
-        // Mix in Main-Buffer
-        for (size_t j = 0; j < tone.size() && (position + j) < samples.size(); ++j) {
-            samples[position + j] += tone[j] * 0.5f;  // 50% Mix-Level für Lead
-        }
-        
-        position += samplesPerNote;
-        noteInPhrase++;
-    }
+    // Noten werden erst erzeugt, wenn der Render-Graph sie erreicht
+    float beatDuration = 60.0f / params.bpm;
+    graph.addSource(std::make_unique<PhraseMelodyNode>(leadInstrument, std::move(scale), std::move(phrases),
+        std::move(noteLengths), beatDuration, params.energy, graph.sampleRate(), gen));
     
     return true;
 }
 
-bool SongGenerator::generateRhythm(const GenerationParams& params, std::vector<float>& samples) {
+bool SongGenerator::generateRhythm(const GenerationParams& params, SongGen::RenderGraph& graph) {
     std::cout << "🥁 Generiere Rhythmus mit Drum-Modellen..." << std::endl;
     
     // Check for learned rhythm patterns
@@ -401,92 +665,19 @@ bool SongGenerator::generateRhythm(const GenerationParams& params, std::vector<f
         return false;
     }
     
-    int sampleRate = 44100;
-    float beatDuration = 60.0f / params.bpm;
-    size_t samplesPerBeat = static_cast<size_t>(beatDuration * sampleRate);
-    
     // Seed für Variation
     std::random_device rd;
     unsigned int seed = rd() ^ static_cast<unsigned int>(params.bpm * 456);
     std::mt19937 rhythmGen(seed);
-    std::uniform_int_distribution<int> fillDist(0, 100);
-    
-    // If we have learned patterns, use them occasionally
-    std::uniform_int_distribution<size_t> patternDist(0, rhythmPatterns.size() > 0 ? rhythmPatterns.size() - 1 : 0);
-    bool useLearnedPattern = !rhythmPatterns.empty() && (fillDist(rhythmGen) < 40);
     
-    // Genre-spezifische Rhythmus-Pattern
-    for (size_t beat = 0; beat * samplesPerBeat < samples.size(); ++beat) {
-        size_t position = beat * samplesPerBeat;
-        
-        // Kick Drum (Beat 1 und 3 in 4/4, manchmal auch Variationen)
-        bool playKick = (beat % 4 == 0 || beat % 4 == 2);
-        
-        // Gelegentlich zusätzliche Kicks (Fills)
-        if (!playKick && (beat % 16 >= 12) && fillDist(rhythmGen) < 30) {
-            playKick = true;
-        }
-        
-        if (playKick) {
-            // ✨ Nutze Kick-Drum-Modell
-            float kickFreq = 60.0f;  // Standard Kick-Frequenz
-            float kickDuration = 0.15f;
-            float velocity = (params.intensity == "hart") ? 0.9f : 0.7f;
-            
-            auto kick = kickDrum->synthesize(kickFreq, kickDuration, velocity, sampleRate);
-            
-            for (size_t j = 0; j < kick.size() && (position + j) < samples.size(); ++j) {
-                samples[position + j] += kick[j] * 0.8f;
-            }
-        }
-        
-        // Snare (Beat 2 und 4)
-        if (beat % 4 == 1 || beat % 4 == 3) {
-            // ✨ Nutze Snare-Drum-Modell
-            float snareFreq = 200.0f;
-            float snareDuration = 0.12f;
-            float velocity = 0.8f;
-            
-            auto snare = snareDrum->synthesize(snareFreq, snareDuration, velocity, sampleRate);
-            
-            for (size_t j = 0; j < snare.size() && (position + j) < samples.size(); ++j) {
-                samples[position + j] += snare[j] * 0.6f;
-            }
-        }
-        
-        // Hi-Hat (Off-beats für Techno/Trap)
-        if (params.genre == "Techno" || params.genre == "Trap" || params.genre == "Trance") {
-            if (beat % 2 == 1) {
-                // ✨ Nutze HiHat-Modell
-                float hihatFreq = 10000.0f;
-                float hihatDuration = 0.05f;
-                float velocity = 0.4f + (fillDist(rhythmGen) % 20) * 0.01f;  // Leichte Variation
-                
-                auto hihatSample = hihat->synthesize(hihatFreq, hihatDuration, velocity, sampleRate);
-                
-                for (size_t j = 0; j < hihatSample.size() && (position + j) < samples.size(); ++j) {
-                    samples[position + j] += hihatSample[j] * 0.3f;
-                }
-            }
-        }
-        
-        // Clap für Trap
-        if (params.genre == "Trap" && beat % 8 == 4) {
-            std::vector<float> clap;
-            synthesizeTone(1000.0f, 0.05f, sampleRate, clap);
-            
-            for (size_t j = 0; j < clap.size() && (position + j) < samples.size(); ++j) {
-                samples[position + j] += clap[j] * 0.3f;
-            }
-        }
-    }
+    // Genre-spezifische Rhythmus-Pattern, Beat für Beat beim Rendern
+    graph.addSource(std::make_unique<RhythmNode>(kickDrum, snareDrum, hihat, params, graph.sampleRate(), rhythmGen));
     
     return true;
 }
 
-bool SongGenerator::generateBass(const GenerationParams& params, std::vector<float>& samples) {
+bool SongGenerator::generateBass(const GenerationParams& params, SongGen::RenderGraph& graph) {
     // Bass-Line mit Variation
-    int sampleRate = 44100;
     float beatDuration = 60.0f / params.bpm;
     
     // Seed für reproduzierbare Variation
@@ -504,44 +695,18 @@ bool SongGenerator::generateBass(const GenerationParams& params, std::vector<flo
         bassNotes = {65.4f, 69.3f, 73.4f, 65.4f};  // C2, C#2, D2, C2
     }
     
-    std::uniform_int_distribution<size_t> noteDist(0, bassNotes.size() - 1);
+    // Mix Level
+    float bassLevel = 0.4f;
+    if (params.bassLevel == "basslastig") bassLevel = 0.6f;
+    else if (params.bassLevel == "soft") bassLevel = 0.2f;
     
-    size_t position = 0;
-    int noteIndex = 0;
-    
-    // Generiere Bass-Pattern
-    while (position < samples.size()) {
-        float frequency = bassNotes[noteIndex % bassNotes.size()];
-        
-        // Notenlänge: meistens ganze oder halbe Beats
-        float noteDuration = (noteIndex % 4 == 0) ? beatDuration * 2.0f : beatDuration;
-        size_t samplesPerNote = static_cast<size_t>(noteDuration * sampleRate);
-        
-        std::vector<float> bassNote;
-        synthesizeTone(frequency, noteDuration, sampleRate, bassNote);
-        
-        // Mix Level
-        float bassLevel = 0.4f;
-        if (params.bassLevel == "basslastig") bassLevel = 0.6f;
-        else if (params.bassLevel == "soft") bassLevel = 0.2f;
-        
-        for (size_t j = 0; j < bassNote.size() && (position + j) < samples.size(); ++j) {
-            samples[position + j] += bassNote[j] * bassLevel;
-        }
-        
-        position += samplesPerNote;
-        noteIndex++;
-        
-        // Gelegentlich Pattern wechseln
-        if (noteIndex % 16 == 0) {
-            std::shuffle(bassNotes.begin(), bassNotes.end(), gen);
-        }
-    }
+    graph.addSource(std::make_unique<BassNode>(std::move(bassNotes), beatDuration, bassLevel,
+                                               graph.sampleRate(), gen));
     
     return true;
 }
 
-bool SongGenerator::layerInstruments(const GenerationParams& params, std::vector<float>& samples) {
+bool SongGenerator::layerInstruments(const GenerationParams& params, SongGen::RenderGraph& graph) {
     // Lade passende Source-Samples aus Datenbank
     auto sourceSamples = selectSourceSamples(params, 10);
     
@@ -549,150 +714,49 @@ bool SongGenerator::layerInstruments(const GenerationParams& params, std::vector
         return true;  // Keine Samples verfügbar, verwende nur Synthese
     }
     
-    int sampleRate = 44100;
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_int_distribution<size_t> sampleDist(0, sourceSamples.size() - 1);
     
-    // Lade und mixe zufällige Samples
+    // Mixe zufällige Samples (gelesen wird blockweise beim Rendern)
     for (int layer = 0; layer < static_cast<int>(params.complexity * 5); ++layer) {
         const auto& meta = sourceSamples[sampleDist(gen)];
         
-        // Lade Audio
         std::ifstream file(meta.filepath, std::ios::binary);
         if (!file.is_open()) continue;
         
         // Einfaches WAV-Loading
         file.seekg(44);  // Skip header
         
-        std::vector<float> sourceAudio;
-        short sample;
-        while (file.read(reinterpret_cast<char*>(&sample), sizeof(short))) {
-            sourceAudio.push_back(sample / 32768.0f);
-        }
-        file.close();
-        
-        if (sourceAudio.empty()) continue;
-        
         // Mix mit reduziertem Level
         float mixLevel = 0.1f / (layer + 1);  // Weniger Level für mehr Layer
-        
-        for (size_t i = 0; i < std::min(samples.size(), sourceAudio.size()); ++i) {
-            samples[i] += sourceAudio[i] * mixLevel;
-        }
+        graph.addSource(std::make_unique<WavLayerNode>(std::move(file), mixLevel));
     }
     
     return true;
 }
 
-bool SongGenerator::addVocals(const GenerationParams& params, std::vector<float>& samples) {
+bool SongGenerator::addVocals(const GenerationParams& params, SongGen::RenderGraph& graph) {
     // Einfache Vocal-Simulation mit Formant-Synthese
-    
-    int sampleRate = 44100;
     float beatDuration = 60.0f / params.bpm;
     
     std::random_device rd;
     std::mt19937 gen(rd());
     
-    // Vocal-Formant-Frequenzen (A, E, I, O, U)
-    std::vector<std::vector<float>> formants = {
-        {730, 1090, 2440},  // A
-        {270, 2290, 3010},  // E
-        {390, 1990, 2550},  // I
-        {570, 840, 2410},   // O
-        {440, 1020, 2240}   // U
-    };
-    
-    std::uniform_int_distribution<size_t> formantDist(0, formants.size() - 1);
-    
-    // Generiere Vocal-Phrasen an wichtigen Stellen
-    for (size_t measure = 0; measure < static_cast<size_t>(params.duration / (beatDuration * 4)); ++measure) {
-        size_t position = static_cast<size_t>(measure * beatDuration * 4 * sampleRate);
-        
-        if (position >= samples.size()) break;
-        
-        // Nur alle 2 Takte
-        if (measure % 2 != 0) continue;
-        
-        const auto& formant = formants[formantDist(gen)];
-        
-        // Synthese mit mehreren Formanten
-        std::vector<float> vocal(static_cast<size_t>(beatDuration * 2 * sampleRate), 0.0f);
-        
-        for (float freq : formant) {
-            std::vector<float> formantTone;
-            synthesizeTone(freq, beatDuration * 2, sampleRate, formantTone);
-            
-            for (size_t i = 0; i < vocal.size() && i < formantTone.size(); ++i) {
-                vocal[i] += formantTone[i] * 0.2f;
-            }
-        }
-        
-        // Mix Vocals
-        for (size_t i = 0; i < vocal.size() && (position + i) < samples.size(); ++i) {
-            samples[position + i] += vocal[i] * 0.15f;
-        }
-    }
-    
-    return true;
-}
-
-bool SongGenerator::mixAndMaster(std::vector<float>& samples) {
-    // Normalisiere Audio
-    float maxAmplitude = 0.0f;
-    for (float sample : samples) {
-        maxAmplitude = std::max(maxAmplitude, std::abs(sample));
-    }
-    
-    if (maxAmplitude > 0) {
-        float scale = 0.9f / maxAmplitude;  // 90% max um Clipping zu vermeiden
-        for (float& sample : samples) {
-            sample *= scale;
-        }
-    }
-    
-    return true;
-}
-
-bool SongGenerator::synthesizeTone(float frequency, float duration, int sampleRate, std::vector<float>& output) {
-    size_t numSamples = static_cast<size_t>(duration * sampleRate);
-    output.resize(numSamples);
-    
-    const float pi = 3.14159265358979323846f;
-    
-    for (size_t i = 0; i < numSamples; ++i) {
-        float t = static_cast<float>(i) / sampleRate;
-        output[i] = std::sin(2 * pi * frequency * t);
-    }
-    
-    // Envelope (ADSR) - längeres Attack für weicheren Start
-    applyEnvelope(output, 0.02f, 0.1f, 0.7f, 0.25f);
+    // Vocal-Phrasen an wichtigen Stellen
+    size_t measures = static_cast<size_t>(params.duration / (beatDuration * 4));
+    graph.addSource(std::make_unique<VocalNode>(beatDuration, measures, graph.sampleRate(), gen));
     
     return true;
 }
 
-bool SongGenerator::applyEnvelope(std::vector<float>& samples, float attack, float decay, float sustain, float release) {
-    size_t attackSamples = static_cast<size_t>(attack * samples.size());
-    size_t decaySamples = static_cast<size_t>(decay * samples.size());
-    size_t releaseSamples = static_cast<size_t>(release * samples.size());
+bool SongGenerator::mixAndMaster(SongGen::RenderGraph& graph) {
+    // Statt Normalisierung über den ganzen Song (braucht alle Samples vorab):
+    // Look-Ahead-Limiter auf 90% Peak, um Clipping zu vermeiden
+    graph.peakTarget = 0.9f;
     
-    for (size_t i = 0; i < samples.size(); ++i) {
-        float envelope = 1.0f;
-        
-        if (i < attackSamples) {
-            envelope = static_cast<float>(i) / attackSamples;
-        } else if (i < attackSamples + decaySamples) {
-            float t = static_cast<float>(i - attackSamples) / decaySamples;
-            envelope = 1.0f - (1.0f - sustain) * t;
-        } else if (i > samples.size() - releaseSamples) {
-            float t = static_cast<float>(samples.size() - i) / releaseSamples;
-            envelope = sustain * t;
-        } else {
-            envelope = sustain;
-        }
-        
-        samples[i] *= envelope;
-    }
+    // Fade-In am Anfang (100ms) um Rauschen zu vermeiden
+    graph.fadeInSeconds = 0.1f;
     
     return true;
 }
@@ -702,7 +766,9 @@ bool SongGenerator::applyFilter(std::vector<float>& samples, const std::string&
     return true;
 }
 
-bool SongGenerator::exportWAV(const std::string& path, const std::vector<float>& samples, int sampleRate) {
+namespace {
+
+bool createOutputDirectory(const std::string& path) {
     // Erstelle Ausgabe-Verzeichnis falls nicht vorhanden
     std::filesystem::path outputPath(path);
     std::filesystem::path dir = outputPath.parent_path();
@@ -715,6 +781,16 @@ bool SongGenerator::exportWAV(const std::string& path, const std::vector<float>&
             return false;
         }
     }
+    return true;
+}
+
+} // namespace
+
+bool SongGenerator::exportWAV(const std::string& path, SongGen::RenderGraph& graph, uint64_t frames,
+                              int sampleRate, std::function<void(float)> progress) {
+    if (!createOutputDirectory(path)) {
+        return false;
+    }
     
     std::ofstream file(path, std::ios::binary);
     if (!file.is_open()) {
@@ -722,12 +798,12 @@ bool SongGenerator::exportWAV(const std::string& path, const std::vector<float>&
         return false;
     }
     
-    // WAV-Header schreiben
+    // WAV-Header schreiben (Länge steht vorab fest)
     int numChannels = 1;  // Mono
     int bitsPerSample = 16;
     int byteRate = sampleRate * numChannels * bitsPerSample / 8;
     int blockAlign = numChannels * bitsPerSample / 8;
-    int dataSize = samples.size() * bitsPerSample / 8;
+    int dataSize = static_cast<int>(frames * bitsPerSample / 8);
     
     // RIFF-Header
     file.write("RIFF", 4);
@@ -751,28 +827,24 @@ bool SongGenerator::exportWAV(const std::string& path, const std::vector<float>&
     file.write("data", 4);
     file.write(reinterpret_cast<const char*>(&dataSize), 4);
     
-    // Samples schreiben
-    for (float sample : samples) {
-        short intSample = static_cast<short>(sample * 32767.0f);
-        file.write(reinterpret_cast<const char*>(&intSample), 2);
-    }
+    // Samples blockweise schreiben, sobald der Graph sie liefert
+    std::vector<short> pcmBuffer(SongGen::RenderGraph::kBlockFrames);
+    bool success = graph.render(frames, [&](const std::vector<float>& block) {
+        for (size_t i = 0; i < block.size(); ++i) {
+            pcmBuffer[i] = static_cast<short>(block[i] * 32767.0f);
+        }
+        file.write(reinterpret_cast<const char*>(pcmBuffer.data()), block.size() * sizeof(short));
+        return file.good();
+    }, progress);
     
     file.close();
-    return true;
+    return success;
 }
 
-bool SongGenerator::exportMP3(const std::string& path, const std::vector<float>& samples, int sampleRate, int bitrate) {
-    // Erstelle Ausgabe-Verzeichnis falls nicht vorhanden
-    std::filesystem::path outputPath(path);
-    std::filesystem::path dir = outputPath.parent_path();
-    
-    if (!dir.empty() && !std::filesystem::exists(dir)) {
-        std::error_code ec;
-        std::filesystem::create_directories(dir, ec);
-        if (ec) {
-            std::cerr << "❌ Konnte Verzeichnis nicht erstellen: " << dir << " - " << ec.message() << "\n";
-            return false;
-        }
+bool SongGenerator::exportMP3(const std::string& path, SongGen::RenderGraph& graph, uint64_t frames,
+                              int sampleRate, int bitrate, std::function<void(float)> progress) {
+    if (!createOutputDirectory(path)) {
+        return false;
     }
     
     // Initialisiere LAME für MP3 Encoding
@@ -802,51 +874,53 @@ bool SongGenerator::exportMP3(const std::string& path, const std::vector<float>&
         return false;
     }
     
-    // Konvertiere float samples zu short
-    std::vector<short> pcmBuffer(samples.size());
-    for (size_t i = 0; i < samples.size(); ++i) {
-        // Clamp und konvertiere zu 16-bit PCM
-        float sample = std::max(-1.0f, std::min(1.0f, samples[i]));
-        pcmBuffer[i] = static_cast<short>(sample * 32767.0f);
-    }
-    
-    // Encode zu MP3
-    const int MP3_SIZE = samples.size() + 10000;
-    unsigned char* mp3Buffer = new unsigned char[MP3_SIZE];
-    
-    int mp3Bytes = lame_encode_buffer(
-        lame,
-        pcmBuffer.data(),  // left channel (mono)
-        nullptr,           // right channel (mono = nullptr)
-        pcmBuffer.size(),
-        mp3Buffer,
-        MP3_SIZE
-    );
-    
-    if (mp3Bytes < 0) {
-        std::cerr << "❌ LAME Encoding fehlgeschlagen: " << mp3Bytes << "\n";
-        delete[] mp3Buffer;
-        fclose(mp3File);
-        lame_close(lame);
-        return false;
-    }
+    // Puffer für einen Block (LAME-Empfehlung: 1.25 * Samples + 7200)
+    const size_t blockFrames = SongGen::RenderGraph::kBlockFrames;
+    std::vector<short> pcmBuffer(blockFrames);
+    std::vector<unsigned char> mp3Buffer(blockFrames * 5 / 4 + 7200);
     
-    // Schreibe MP3-Daten
-    if (mp3Bytes > 0) {
-        fwrite(mp3Buffer, 1, mp3Bytes, mp3File);
-    }
+    // Encode zu MP3, Block für Block während der Graph rendert
+    bool success = graph.render(frames, [&](const std::vector<float>& block) {
+        for (size_t i = 0; i < block.size(); ++i) {
+            // Clamp und konvertiere zu 16-bit PCM
+            float sample = std::max(-1.0f, std::min(1.0f, block[i]));
+            pcmBuffer[i] = static_cast<short>(sample * 32767.0f);
+        }
+        
+        int mp3Bytes = lame_encode_buffer(
+            lame,
+            pcmBuffer.data(),  // left channel (mono)
+            nullptr,           // right channel (mono = nullptr)
+            static_cast<int>(block.size()),
+            mp3Buffer.data(),
+            static_cast<int>(mp3Buffer.size())
+        );
+        
+        if (mp3Bytes < 0) {
+            std::cerr << "❌ LAME Encoding fehlgeschlagen: " << mp3Bytes << "\n";
+            return false;
+        }
+        
+        // Schreibe MP3-Daten
+        return mp3Bytes == 0 || fwrite(mp3Buffer.data(), 1, mp3Bytes, mp3File) == static_cast<size_t>(mp3Bytes);
+    }, progress);
     
     // Flush final MP3 frames
-    mp3Bytes = lame_encode_flush(lame, mp3Buffer, MP3_SIZE);
-    if (mp3Bytes > 0) {
-        fwrite(mp3Buffer, 1, mp3Bytes, mp3File);
+    if (success) {
+        int mp3Bytes = lame_encode_flush(lame, mp3Buffer.data(), static_cast<int>(mp3Buffer.size()));
+        if (mp3Bytes > 0) {
+            fwrite(mp3Buffer.data(), 1, mp3Bytes, mp3File);
+        }
     }
     
     // Cleanup
-    delete[] mp3Buffer;
     fclose(mp3File);
     lame_close(lame);
     
+    if (!success) {
+        return false;
+    }
+    
     std::cout << "✅ MP3 generiert: " << path << "\n";
     return true;
 }
@@ -13,7 +13,7 @@
 
 SonglengthsDB::SonglengthsDB() {}
 
-bool SonglengthsDB::load(const std::string& dbPath) {
+bool SonglengthsDB::load(const std::string& dbPath, bool custom) {
     std::ifstream file(dbPath);
     if (!file.is_open()) {
         std::cerr << "[SonglengthsDB] ❌ Kann nicht öffnen: " << dbPath << "\n";
@@ -63,6 +63,7 @@ bool SonglengthsDB::load(const std::string& dbPath) {
         
         if (!times.empty()) {
             lengths_[md5] = times;
+            if (custom) customMD5s_.insert(md5);
             // Speichere auch Pfad→MD5 Mapping
             if (!lastCommentPath.empty()) {
                 pathToMD5_[lastCommentPath] = md5;
@@ -75,26 +76,24 @@ bool SonglengthsDB::load(const std::string& dbPath) {
     return true;
 }
 
-int SonglengthsDB::getLength(const std::string& sidPath, int subtune) {
+std::string SonglengthsDB::relativePathOf(const std::string& sidPath) {
     // Extrahiere relativen Pfad (alles nach /C64Music/)
     size_t pos = sidPath.find("/C64Music/");
-    std::string relativePath;
-    
     if (pos != std::string::npos) {
-        relativePath = sidPath.substr(pos + 9); // +9 für "/C64Music"
-    } else {
-        // Versuche nur den Dateinamen
-        pos = sidPath.find_last_of('/');
-        if (pos != std::string::npos) {
-            relativePath = sidPath.substr(pos);
-        } else {
-            relativePath = sidPath;
-        }
+        return sidPath.substr(pos + 9); // +9 für "/C64Music"
     }
     
+    // Außerhalb von HVSC kein Pfad-Schlüssel: gleichnamige Dateien würden
+    // kollidieren, diese Einträge werden nur über den MD5 gefunden
+    return "";
+}
+
+int SonglengthsDB::getLength(const std::string& sidPath, int subtune) {
+    std::string relativePath = relativePathOf(sidPath);
+    
     // Suche MD5 über Pfad
     std::string md5;
-    auto pathIt = pathToMD5_.find(relativePath);
+    auto pathIt = relativePath.empty() ? pathToMD5_.end() : pathToMD5_.find(relativePath);
     if (pathIt != pathToMD5_.end()) {
         md5 = pathIt->second;
     } else {
@@ -179,17 +178,94 @@ int SonglengthsDB::parseTime(const std::string& timeStr) {
 
 int SonglengthsDB::measureActualLength(const std::string& sidPath, int subtune, int maxSeconds) {
     // DEAKTIVIERT: Messung verursacht zu viele hängende Prozesse
-    // Tracks ohne DB-Eintrag bekommen 180s default
+    // Gemessen wird jetzt beim Rendern (SIDLibConverter + TrackEndDetector),
+    // die Ergebnisse landen über addCustomLength in der Custom-DB
     return 0;
 }
 
-void SonglengthsDB::addCustomLength(const std::string& sidPath, int subtune, int lengthSeconds) {
-    // Deaktiviert
+std::string SonglengthsDB::formatEntry(const std::string& md5, const std::vector<int>& times) {
+    std::ostringstream line;
+    line << md5 << "=";
+    for (size_t i = 0; i < times.size(); ++i) {
+        if (i > 0) line << " ";
+        line << (times[i] / 60) << ":" << std::setfill('0') << std::setw(2) << (times[i] % 60);
+    }
+    return line.str();
+}
+
+bool SonglengthsDB::addCustomLength(const std::string& sidPath, int subtune, int lengthSeconds,
+                                    const std::string& appendPath) {
+    if (subtune < 1 || lengthSeconds <= 0) return false;
+    
+    std::string md5 = calculateSidMD5(sidPath);
+    if (md5.empty()) {
+        std::cerr << "[CustomDB] ❌ Kann MD5 nicht berechnen für " << sidPath << "\n";
+        return false;
+    }
+    std::string relativePath = relativePathOf(sidPath);
+    
+    // Unbekannte Subtunes bleiben 0:00 (= nicht in Datenbank)
+    auto& times = lengths_[md5];
+    if ((int)times.size() < subtune) {
+        times.resize(subtune, 0);
+    }
+    times[subtune - 1] = lengthSeconds;
+    if (!relativePath.empty()) pathToMD5_[relativePath] = md5;
+    customMD5s_.insert(md5);
+    
+    if (appendPath.empty()) return true;
+    
+    // Append-Log: die zuletzt geschriebene Zeile eines MD5 gewinnt beim Laden
+    std::ofstream file(appendPath, std::ios::app);
+    if (!file.is_open()) {
+        std::cerr << "[CustomDB] ❌ Kann nicht schreiben: " << appendPath << "\n";
+        return false;
+    }
+    if (!relativePath.empty()) file << "; " << relativePath << "\n";
+    file << formatEntry(md5, times) << "\n";
+    return static_cast<bool>(file);
 }
 
 bool SonglengthsDB::saveCustomDB(const std::string& customDbPath) {
-    // Deaktiviert
-    return false;
+    // Invertiere pathToMD5_ für Kommentarzeilen
+    std::unordered_map<std::string, std::string> md5ToPath;
+    for (const auto& [path, md5] : pathToMD5_) {
+        if (customMD5s_.count(md5)) md5ToPath[md5] = path;
+    }
+    
+    // Erst temporär schreiben, dann ersetzen (Datei ist auch Append-Log)
+    std::string tempPath = customDbPath + ".tmp";
+    std::ofstream file(tempPath, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "[CustomDB] ❌ Kann nicht schreiben: " << customDbPath << "\n";
+        return false;
+    }
+    
+    file << "; Custom SongGen Songlengths Database\n";
+    file << "; Generated by automatic length measurement\n";
+    file << "; Format: MD5=M:SS M:SS M:SS ...\n\n";
+    
+    int count = 0;
+    for (const auto& md5 : customMD5s_) {
+        auto it = lengths_.find(md5);
+        if (it == lengths_.end()) continue;
+        auto pathIt = md5ToPath.find(md5);
+        if (pathIt != md5ToPath.end()) {
+            file << "; " << pathIt->second << "\n";
+        }
+        file << formatEntry(md5, it->second) << "\n";
+        count++;
+    }
+    file.close();
+    
+    std::error_code ec;
+    std::filesystem::rename(tempPath, customDbPath, ec);
+    if (ec) {
+        std::cerr << "[CustomDB] ❌ Kann nicht ersetzen: " << customDbPath << "\n";
+        return false;
+    }
+    std::cout << "[CustomDB] ✅ Gespeichert: " << count << " Einträge in " << customDbPath << "\n";
+    return true;
 }
 
 // Unten die alte Implementierung als Kommentar für später:
@@ -311,78 +387,3 @@ int SonglengthsDB::measureActualLength_OLD(const std::string& sidPath, int subtu
     return lengthSeconds;
 }
 */
-
-/*
-void SonglengthsDB::addCustomLength_OLD(const std::string& sidPath, int subtune, int lengthSeconds) {
-    std::string md5 = calculateSidMD5(sidPath);
-    if (md5.empty()) {
-        std::cerr << "[CustomDB] ❌ Kann MD5 nicht berechnen für " << sidPath << "\n";
-        return;
-    }
-    
-    // Extrahiere relativen Pfad
-    size_t pos = sidPath.find("/C64Music/");
-    std::string relativePath;
-    if (pos != std::string::npos) {
-        relativePath = sidPath.substr(pos + 9);
-    } else {
-        pos = sidPath.find_last_of('/');
-        relativePath = (pos != std::string::npos) ? sidPath.substr(pos) : sidPath;
-    }
-    
-    // Füge zur Datenbank hinzu
-    auto& times = lengths_[md5];
-    if ((int)times.size() < subtune) {
-        times.resize(subtune, 0);
-    }
-    times[subtune - 1] = lengthSeconds;
-    
-    pathToMD5_[relativePath] = md5;
-    
-    std::cout << "[CustomDB] ➕ Hinzugefügt: " << relativePath 
-              << " Subtune " << subtune << " = " << lengthSeconds << "s\n";
-}
-
-
-bool SonglengthsDB::saveCustomDB_OLD(const std::string& customDbPath) {
-    std::ofstream file(customDbPath);
-    if (!file.is_open()) {
-        std::cerr << "[CustomDB] ❌ Kann nicht schreiben: " << customDbPath << "\n";
-        return false;
-    }
-    
-    file << "; Custom SongGen Songlengths Database\n";
-    file << "; Generated by automatic length measurement\n";
-    file << "; Format: MD5=M:SS M:SS M:SS ...\n\n";
-    
-    // Invertiere pathToMD5_ für Ausgabe
-    std::unordered_map<std::string, std::string> md5ToPath;
-    for (const auto& [path, md5] : pathToMD5_) {
-        md5ToPath[md5] = path;
-    }
-    
-    int count = 0;
-    for (const auto& [md5, times] : lengths_) {
-        // Schreibe Kommentar mit Pfad (falls vorhanden)
-        auto pathIt = md5ToPath.find(md5);
-        if (pathIt != md5ToPath.end()) {
-            file << "; " << pathIt->second << "\n";
-        }
-        
-        // Schreibe MD5=Zeiten
-        file << md5 << "=";
-        for (size_t i = 0; i < times.size(); ++i) {
-            if (i > 0) file << " ";
-            int mins = times[i] / 60;
-            int secs = times[i] % 60;
-            file << mins << ":" << std::setfill('0') << std::setw(2) << secs;
-        }
-        file << "\n";
-        count++;
-    }
-    
-    file.close();
-    std::cout << "[CustomDB] ✅ Gespeichert: " << count << " Einträge in " << customDbPath << "\n";
-    return true;
-}
-*/
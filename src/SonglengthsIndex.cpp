@@ -0,0 +1,426 @@
+#include "SonglengthsIndex.h"
+#include "SonglengthsDB.h"
+#include "FileHasher.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Dateiformat (little endian, alle Abschnitte 8-Byte-ausgerichtet):
+//   Header | Entry[entryCount] | uint32 Millisekunden[lengthCount]
+//   | uint32 Seed[bucketCount] | PathSlot[slotCount]
+struct SonglengthsIndex::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t lengthCount;
+    uint32_t pathCount;
+    uint32_t bucketCount;
+    uint32_t slotCount;
+    uint64_t sourceSize;
+    int64_t sourceMtimeNs;
+    uint64_t entriesOffset;
+    uint64_t lengthsOffset;
+    uint64_t seedsOffset;
+    uint64_t slotsOffset;
+    uint64_t fileSize;
+};
+
+struct SonglengthsIndex::Entry {
+    uint8_t md5[16];
+    uint32_t lengthOffset;
+    uint32_t lengthCount;
+};
+
+struct SonglengthsIndex::PathSlot {
+    uint64_t fingerprint;   // hashBytes(Pfad, 0) gegen Fehltreffer
+    uint32_t entry;         // kNoEntry = leer
+    uint32_t reserved;
+};
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'G', 'S', 'L', 'I', 'D', 'X', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kNoEntry = 0xFFFFFFFFu;
+constexpr uint32_t kMaxSeed = 1u << 24;
+
+size_t align8(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+bool statSource(const std::string& path, uint64_t& size, int64_t& mtimeNs) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) return false;
+    size = static_cast<uint64_t>(st.st_size);
+    mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+}
+
+bool parseMD5(const std::string& hex, uint8_t out[16]) {
+    if (hex.size() != 32) return false;
+    for (size_t i = 0; i < 16; ++i) {
+        int value = 0;
+        for (size_t j = 0; j < 2; ++j) {
+            char c = static_cast<char>(std::tolower(static_cast<unsigned char>(hex[i * 2 + j])));
+            int digit;
+            if (c >= '0' && c <= '9') digit = c - '0';
+            else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+            else return false;
+            value = value * 16 + digit;
+        }
+        out[i] = static_cast<uint8_t>(value);
+    }
+    return true;
+}
+
+// Format: M:SS, M:SS.mmm oder nur Sekunden; Anhängsel wie "(G)" werden ignoriert
+uint32_t parseMillis(const std::string& timeStr) {
+    const char* p = timeStr.c_str();
+    char* end = nullptr;
+    long first = std::strtol(p, &end, 10);
+    long seconds = first;
+    if (*end == ':') {
+        seconds = first * 60 + std::strtol(end + 1, &end, 10);
+    }
+    long millis = 0;
+    if (*end == '.') {
+        int digits = 0;
+        for (++end; std::isdigit(static_cast<unsigned char>(*end)) && digits < 3; ++end, ++digits) {
+            millis = millis * 10 + (*end - '0');
+        }
+        for (; digits < 3; ++digits) millis *= 10;
+    }
+    if (seconds < 0) return 0;
+    return static_cast<uint32_t>(seconds * 1000 + millis);
+}
+
+uint64_t hashPath(const std::string& path, uint64_t seed) {
+    return FileHasher::hashBytes(path.data(), path.size(), seed);
+}
+
+} // namespace
+
+bool SonglengthsIndex::build(const std::string& md5Path, const std::string& indexPath) {
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!statSource(md5Path, sourceSize, sourceMtime)) return false;
+
+    std::ifstream file(md5Path);
+    if (!file.is_open()) {
+        std::cerr << "[SonglengthsIndex] ❌ Kann nicht öffnen: " << md5Path << "\n";
+        return false;
+    }
+
+    // Wie SonglengthsDB::load: spätere Zeilen mit demselben MD5/Pfad gewinnen
+    struct Record {
+        uint8_t md5[16];
+        std::vector<uint32_t> millis;
+    };
+    std::vector<Record> records;
+    std::unordered_map<std::string, size_t> recordOf;       // MD5-Hex → records
+    std::unordered_map<std::string, size_t> pathRecord;     // Pfad → records
+
+    std::string line;
+    std::string lastCommentPath;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+
+        if (line[0] == ';') {
+            size_t pathStart = line.find('/');
+            if (pathStart != std::string::npos) {
+                lastCommentPath = line.substr(pathStart);
+                while (!lastCommentPath.empty() && std::isspace(static_cast<unsigned char>(lastCommentPath.back()))) {
+                    lastCommentPath.pop_back();
+                }
+            }
+            continue;
+        }
+
+        size_t pos = line.find('=');
+        if (pos == std::string::npos) continue;
+
+        std::string md5 = line.substr(0, pos);
+        Record record;
+        if (!parseMD5(md5, record.md5)) continue;
+
+        size_t cursor = pos + 1;
+        while (cursor < line.size()) {
+            while (cursor < line.size() && std::isspace(static_cast<unsigned char>(line[cursor]))) cursor++;
+            size_t tokenEnd = cursor;
+            while (tokenEnd < line.size() && !std::isspace(static_cast<unsigned char>(line[tokenEnd]))) tokenEnd++;
+            if (tokenEnd > cursor) record.millis.push_back(parseMillis(line.substr(cursor, tokenEnd - cursor)));
+            cursor = tokenEnd;
+        }
+        if (record.millis.empty()) continue;
+
+        auto [it, inserted] = recordOf.emplace(md5, records.size());
+        if (inserted) {
+            records.push_back(std::move(record));
+        } else {
+            records[it->second].millis = std::move(record.millis);
+        }
+        if (!lastCommentPath.empty()) {
+            pathRecord[lastCommentPath] = it->second;
+        }
+    }
+
+    // MD5-Schlüssel sortieren (Binärsuche), Längen dicht packen
+    std::vector<uint32_t> order(records.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<uint32_t>(i);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return std::memcmp(records[a].md5, records[b].md5, 16) < 0;
+    });
+    std::vector<uint32_t> entryOf(records.size());
+    std::vector<Entry> entries(records.size());
+    std::vector<uint32_t> lengths;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Record& record = records[order[i]];
+        entryOf[order[i]] = static_cast<uint32_t>(i);
+        std::memcpy(entries[i].md5, record.md5, 16);
+        entries[i].lengthOffset = static_cast<uint32_t>(lengths.size());
+        entries[i].lengthCount = static_cast<uint32_t>(record.millis.size());
+        lengths.insert(lengths.end(), record.millis.begin(), record.millis.end());
+    }
+
+    // Perfekter Hash über die Pfade: Bucket per Seed 0, große Buckets zuerst,
+    // pro Bucket den ersten Seed suchen, der alle Pfade auf freie Slots verteilt
+    std::vector<std::pair<std::string, uint32_t>> paths;
+    paths.reserve(pathRecord.size());
+    for (const auto& [path, record] : pathRecord) {
+        paths.emplace_back(path, entryOf[record]);
+    }
+    const uint32_t pathCount = static_cast<uint32_t>(paths.size());
+    const uint32_t bucketCount = std::max<uint32_t>(1, pathCount / 4);
+    const uint32_t slotCount = std::max<uint32_t>(1, pathCount + pathCount / 4);
+
+    std::vector<std::vector<uint32_t>> buckets(bucketCount);
+    std::vector<uint64_t> fingerprints(pathCount);
+    for (uint32_t i = 0; i < pathCount; ++i) {
+        fingerprints[i] = hashPath(paths[i].first, 0);
+        buckets[fingerprints[i] % bucketCount].push_back(i);
+    }
+    std::vector<uint32_t> bucketOrder(bucketCount);
+    for (uint32_t b = 0; b < bucketCount; ++b) bucketOrder[b] = b;
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&](uint32_t a, uint32_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<uint32_t> seeds(bucketCount, 0);
+    std::vector<PathSlot> slots(slotCount, PathSlot{0, kNoEntry, 0});
+    std::vector<uint32_t> candidate;
+    for (uint32_t b : bucketOrder) {
+        const auto& bucket = buckets[b];
+        if (bucket.empty()) break;
+
+        bool placed = false;
+        for (uint32_t seed = 1; seed < kMaxSeed && !placed; ++seed) {
+            candidate.clear();
+            placed = true;
+            for (uint32_t path : bucket) {
+                uint32_t slot = static_cast<uint32_t>(hashPath(paths[path].first, seed) % slotCount);
+                if (slots[slot].entry != kNoEntry ||
+                    std::find(candidate.begin(), candidate.end(), slot) != candidate.end()) {
+                    placed = false;
+                    break;
+                }
+                candidate.push_back(slot);
+            }
+            if (placed) {
+                seeds[b] = seed;
+                for (size_t i = 0; i < bucket.size(); ++i) {
+                    slots[candidate[i]] = PathSlot{fingerprints[bucket[i]], paths[bucket[i]].second, 0};
+                }
+            }
+        }
+        if (!placed) {
+            std::cerr << "[SonglengthsIndex] ❌ Kein perfekter Hash gefunden (" << pathCount << " Pfade)\n";
+            return false;
+        }
+    }
+
+    // Layout
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.lengthCount = static_cast<uint32_t>(lengths.size());
+    header.pathCount = pathCount;
+    header.bucketCount = bucketCount;
+    header.slotCount = slotCount;
+    header.sourceSize = sourceSize;
+    header.sourceMtimeNs = sourceMtime;
+    header.entriesOffset = align8(sizeof(Header));
+    header.lengthsOffset = align8(header.entriesOffset + entries.size() * sizeof(Entry));
+    header.seedsOffset = align8(header.lengthsOffset + lengths.size() * sizeof(uint32_t));
+    header.slotsOffset = align8(header.seedsOffset + seeds.size() * sizeof(uint32_t));
+    header.fileSize = header.slotsOffset + slots.size() * sizeof(PathSlot);
+
+    std::vector<uint8_t> image(header.fileSize, 0);
+    std::memcpy(image.data(), &header, sizeof(Header));
+    if (!entries.empty()) {
+        std::memcpy(image.data() + header.entriesOffset, entries.data(), entries.size() * sizeof(Entry));
+    }
+    if (!lengths.empty()) {
+        std::memcpy(image.data() + header.lengthsOffset, lengths.data(), lengths.size() * sizeof(uint32_t));
+    }
+    std::memcpy(image.data() + header.seedsOffset, seeds.data(), seeds.size() * sizeof(uint32_t));
+    std::memcpy(image.data() + header.slotsOffset, slots.data(), slots.size() * sizeof(PathSlot));
+
+    // Temporär schreiben und umbenennen: gemappte Leser behalten die alte Datei
+    std::string tempPath = indexPath + ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "[SonglengthsIndex] ❌ Kann nicht schreiben: " << tempPath << "\n";
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!out.good()) {
+            out.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tempPath.c_str(), indexPath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    std::cout << "[SonglengthsIndex] ✅ Index erstellt: " << entries.size() << " Einträge, "
+              << pathCount << " Pfade (" << (image.size() / 1024) << " KB)\n";
+    return true;
+}
+
+std::shared_ptr<const SonglengthsIndex> SonglengthsIndex::open(const std::string& indexPath,
+                                                               const std::string& sourcePath) {
+    int fd = ::open(indexPath.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return nullptr;
+
+    std::shared_ptr<SonglengthsIndex> index(new SonglengthsIndex());
+    index->data_ = static_cast<const uint8_t*>(mapped);
+    index->size_ = size;
+
+    // Kopf und Abschnittsgrenzen prüfen, danach sind alle Lookups ohne Prüfung sicher
+    const Header* header = reinterpret_cast<const Header*>(index->data_);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion ||
+        header->fileSize != size || header->bucketCount == 0 || header->slotCount == 0) {
+        return nullptr;
+    }
+    auto fits = [&](uint64_t offset, uint64_t count, size_t itemSize) {
+        return offset % 8 == 0 && offset <= size && count <= (size - offset) / itemSize;
+    };
+    if (!fits(header->entriesOffset, header->entryCount, sizeof(Entry)) ||
+        !fits(header->lengthsOffset, header->lengthCount, sizeof(uint32_t)) ||
+        !fits(header->seedsOffset, header->bucketCount, sizeof(uint32_t)) ||
+        !fits(header->slotsOffset, header->slotCount, sizeof(PathSlot))) {
+        return nullptr;
+    }
+
+    index->header_ = header;
+    index->entries_ = reinterpret_cast<const Entry*>(index->data_ + header->entriesOffset);
+    index->lengths_ = reinterpret_cast<const uint32_t*>(index->data_ + header->lengthsOffset);
+    index->seeds_ = reinterpret_cast<const uint32_t*>(index->data_ + header->seedsOffset);
+    index->slots_ = reinterpret_cast<const PathSlot*>(index->data_ + header->slotsOffset);
+
+    for (uint32_t i = 0; i < header->entryCount; ++i) {
+        const Entry& entry = index->entries_[i];
+        if (entry.lengthOffset > header->lengthCount ||
+            entry.lengthCount > header->lengthCount - entry.lengthOffset) {
+            return nullptr;
+        }
+    }
+
+    if (!sourcePath.empty() && !index->matchesSource(sourcePath)) return nullptr;
+    return index;
+}
+
+std::shared_ptr<const SonglengthsIndex> SonglengthsIndex::openOrBuild(const std::string& md5Path,
+                                                                      const std::string& indexPath) {
+    if (auto index = open(indexPath, md5Path)) return index;
+    if (!build(md5Path, indexPath)) return nullptr;
+    return open(indexPath, md5Path);
+}
+
+SonglengthsIndex::~SonglengthsIndex() {
+    if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+bool SonglengthsIndex::matchesSource(const std::string& sourcePath) const {
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!statSource(sourcePath, sourceSize, sourceMtime)) return false;
+    return header_->sourceSize == sourceSize && header_->sourceMtimeNs == sourceMtime;
+}
+
+size_t SonglengthsIndex::entryCount() const {
+    return header_->entryCount;
+}
+
+size_t SonglengthsIndex::pathCount() const {
+    return header_->pathCount;
+}
+
+const SonglengthsIndex::Entry* SonglengthsIndex::findPath(const std::string& relativePath) const {
+    uint64_t fingerprint = hashPath(relativePath, 0);
+    uint32_t seed = seeds_[fingerprint % header_->bucketCount];
+    if (seed == 0) return nullptr;
+
+    const PathSlot& slot = slots_[hashPath(relativePath, seed) % header_->slotCount];
+    if (slot.entry >= header_->entryCount || slot.fingerprint != fingerprint) return nullptr;
+    return &entries_[slot.entry];
+}
+
+const SonglengthsIndex::Entry* SonglengthsIndex::findMD5(const uint8_t md5[16]) const {
+    const Entry* begin = entries_;
+    const Entry* end = entries_ + header_->entryCount;
+    const Entry* it = std::lower_bound(begin, end, md5, [](const Entry& entry, const uint8_t* key) {
+        return std::memcmp(entry.md5, key, 16) < 0;
+    });
+    if (it == end || std::memcmp(it->md5, md5, 16) != 0) return nullptr;
+    return it;
+}
+
+int SonglengthsIndex::lengthOf(const Entry* entry, int subtune) const {
+    // subtune ist 1-basiert; Sekunden abgerundet wie SonglengthsDB
+    if (!entry || subtune < 1 || subtune > static_cast<int>(entry->lengthCount)) return 0;
+    return static_cast<int>(lengths_[entry->lengthOffset + subtune - 1] / 1000);
+}
+
+int SonglengthsIndex::getLengthByMD5(const std::string& md5, int subtune) const {
+    uint8_t key[16];
+    if (!parseMD5(md5, key)) return 0;
+    return lengthOf(findMD5(key), subtune);
+}
+
+int SonglengthsIndex::getLength(const std::string& sidPath, int subtune) const {
+    std::string relativePath = SonglengthsDB::relativePathOf(sidPath);
+    if (const Entry* entry = relativePath.empty() ? nullptr : findPath(relativePath)) {
+        return lengthOf(entry, subtune);
+    }
+
+    // Fallback: MD5 der Datei (verschobene/umbenannte SIDs)
+    std::string md5 = SonglengthsDB::calculateSidMD5(sidPath);
+    if (md5.empty()) return 0;
+    return getLengthByMD5(md5, subtune);
+}
@@ -0,0 +1,254 @@
+#include "SpectralWorkspace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef WITH_FFTW3
+#include <fftw3.h>
+#endif
+
+namespace {
+
+#ifdef WITH_FFTW3
+// Prozessweiter Plan-Cache. FFTW-Planung ist nicht thread-safe, fftwf_execute_* schon.
+// FFTW_MEASURE (Millisekunden bis Sekunden unter planMutex) nur für die Zweierpotenzen
+// der Analyse, alle anderen Größen mit FFTW_ESTIMATE. Der Cache ist begrenzt; weitere
+// Größen bekommen einen Einmal-Plan, der nach der Ausführung wieder freigegeben wird.
+constexpr size_t kMinMeasuredSize = 256;
+constexpr size_t kMaxMeasuredSize = 16384;
+constexpr size_t kMaxCachedPlans = 32;
+
+std::mutex planMutex;
+std::unordered_map<size_t, fftwf_plan> planCache;
+bool wisdomEnabled = true;
+bool wisdomLoaded = false;
+bool wisdomDirty = false;   // Neue MEASURE-Pläne seit dem letzten Export
+
+std::string wisdomPath() {
+    const char* home = getenv("HOME");
+    if (!home) return "";
+    return std::string(home) + "/.songgen/fftw_wisdom.dat";
+}
+
+// Muss mit gehaltenem planMutex aufgerufen werden
+void loadWisdomLocked() {
+    if (wisdomLoaded) return;
+    wisdomLoaded = true;
+    if (!wisdomEnabled) return;
+
+    std::string path = wisdomPath();
+    if (!path.empty() && std::filesystem::exists(path)) {
+        if (fftwf_import_wisdom_from_filename(path.c_str())) {
+            std::cout << "[FFT] 📦 Wisdom geladen: " << path << "\n";
+        }
+    }
+}
+
+bool saveWisdomLocked() {
+    if (!wisdomEnabled) return false;
+    std::string path = wisdomPath();
+    if (path.empty()) return false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+    if (fftwf_export_wisdom_to_filename(path.c_str()) == 0) return false;
+    wisdomDirty = false;
+    return true;
+}
+
+// Wisdom einmal beim Beenden schreiben statt nach jedem neuen Plan
+struct WisdomExporter {
+    ~WisdomExporter() {
+        std::lock_guard<std::mutex> lock(planMutex);
+        if (wisdomDirty) saveWisdomLocked();
+    }
+} wisdomExporter;
+
+bool isMeasuredSize(size_t n) {
+    return n >= kMinMeasuredSize && n <= kMaxMeasuredSize && (n & (n - 1)) == 0;
+}
+
+// Liefert den Plan für n; cached == false: Aufrufer gibt ihn per releasePlan() frei
+fftwf_plan getPlan(size_t n, bool& cached) {
+    std::lock_guard<std::mutex> lock(planMutex);
+
+    auto it = planCache.find(n);
+    if (it != planCache.end()) {
+        cached = true;
+        return it->second;
+    }
+
+    loadWisdomLocked();
+
+    // Planen auf temporären Buffern: FFTW_MEASURE überschreibt die Arrays.
+    // Der Plan wird später per fftwf_execute_dft_r2c auf die Thread-Buffer angewendet
+    // (gleiche Alignment-Garantie durch fftwf_malloc).
+    const bool measure = isMeasuredSize(n);
+    float* in = fftwf_alloc_real(n);
+    fftwf_complex* out = fftwf_alloc_complex(n / 2 + 1);
+    fftwf_plan plan = fftwf_plan_dft_r2c_1d(static_cast<int>(n), in, out, measure ? FFTW_MEASURE : FFTW_ESTIMATE);
+    fftwf_free(in);
+    fftwf_free(out);
+    if (measure) wisdomDirty = true;
+
+    cached = plan && planCache.size() < kMaxCachedPlans;
+    if (cached) planCache[n] = plan;
+    return plan;
+}
+
+void releasePlan(fftwf_plan plan) {
+    std::lock_guard<std::mutex> lock(planMutex);
+    fftwf_destroy_plan(plan);
+}
+#endif
+
+void* allocAligned(size_t bytes) {
+#ifdef WITH_FFTW3
+    return fftwf_malloc(bytes);
+#else
+    const size_t alignment = 64;
+    size_t rounded = (bytes + alignment - 1) / alignment * alignment;
+    return std::aligned_alloc(alignment, rounded);
+#endif
+}
+
+void freeAligned(void* ptr) {
+    if (!ptr) return;
+#ifdef WITH_FFTW3
+    fftwf_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+} // namespace
+
+SpectralWorkspace::~SpectralWorkspace() {
+    freeAligned(input_);
+    freeAligned(output_);
+}
+
+SpectralWorkspace& SpectralWorkspace::forThisThread() {
+    thread_local SpectralWorkspace workspace;
+    return workspace;
+}
+
+size_t SpectralWorkspace::effectiveSize(size_t n) {
+#ifdef WITH_FFTW3
+    return n;
+#else
+    // Radix-2: größte Zweierpotenz <= n
+    size_t size = 1;
+    while (size * 2 <= n) size *= 2;
+    return n == 0 ? 0 : size;
+#endif
+}
+
+void SpectralWorkspace::ensureCapacity(size_t n) {
+    if (n <= capacity_) return;
+
+    freeAligned(input_);
+    freeAligned(output_);
+    input_ = static_cast<float*>(allocAligned(n * sizeof(float)));
+    output_ = static_cast<std::complex<float>*>(allocAligned((n / 2 + 1) * sizeof(std::complex<float>)));
+    capacity_ = (input_ && output_) ? n : 0;
+}
+
+SpectrumView SpectralWorkspace::forward(const float* samples, size_t n) {
+    SpectrumView view;
+    n = effectiveSize(n);
+    if (!samples || n < 2) return view;
+
+    ensureCapacity(n);
+    if (capacity_ == 0) return view;
+
+    std::memcpy(input_, samples, n * sizeof(float));
+
+#ifdef WITH_FFTW3
+    bool cached = false;
+    fftwf_plan plan = getPlan(n, cached);
+    if (!plan) return view;
+    fftwf_execute_dft_r2c(plan, input_, reinterpret_cast<fftwf_complex*>(output_));
+    if (!cached) releasePlan(plan);
+#else
+    radix2(n);
+#endif
+
+    view.bins = output_;
+    view.binCount = n / 2 + 1;
+    return view;
+}
+
+const std::vector<float>& SpectralWorkspace::magnitudes(const float* samples, size_t n) {
+    SpectrumView spectrum = forward(samples, n);
+    magnitudes_.resize(spectrum.size());
+    for (size_t i = 0; i < spectrum.size(); ++i) {
+        magnitudes_[i] = std::abs(spectrum[i]);
+    }
+    return magnitudes_;
+}
+
+void SpectralWorkspace::radix2(size_t n) {
+    // Iterative Cooley-Tukey FFT (komplex, Input reell), O(N log N)
+    if (twiddleSize_ != n) {
+        const float pi = 3.14159265358979323846f;
+        twiddles_.resize(n / 2);
+        for (size_t k = 0; k < n / 2; ++k) {
+            float angle = -2.0f * pi * k / n;
+            twiddles_[k] = std::complex<float>(std::cos(angle), std::sin(angle));
+        }
+        twiddleSize_ = n;
+    }
+
+    scratch_.resize(n);
+
+    // Bit-Reversal-Permutation
+    size_t bits = 0;
+    while ((size_t(1) << bits) < n) ++bits;
+    for (size_t i = 0; i < n; ++i) {
+        size_t rev = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            if (i & (size_t(1) << b)) rev |= size_t(1) << (bits - 1 - b);
+        }
+        scratch_[rev] = std::complex<float>(input_[i], 0.0f);
+    }
+
+    // Butterflies
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2;
+        size_t step = n / len;
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t j = 0; j < half; ++j) {
+                std::complex<float> t = twiddles_[j * step] * scratch_[i + j + half];
+                std::complex<float> u = scratch_[i + j];
+                scratch_[i + j] = u + t;
+                scratch_[i + j + half] = u - t;
+            }
+        }
+    }
+
+    std::copy(scratch_.begin(), scratch_.begin() + (n / 2 + 1), output_);
+}
+
+void SpectralWorkspace::setWisdomEnabled(bool enabled) {
+#ifdef WITH_FFTW3
+    std::lock_guard<std::mutex> lock(planMutex);
+    wisdomEnabled = enabled;
+#else
+    (void)enabled;
+#endif
+}
+
+bool SpectralWorkspace::saveWisdom() {
+#ifdef WITH_FFTW3
+    std::lock_guard<std::mutex> lock(planMutex);
+    return saveWisdomLocked();
+#else
+    return false;
+#endif
+}
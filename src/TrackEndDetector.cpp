@@ -0,0 +1,150 @@
+#include "TrackEndDetector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 20-ms-Blöcke: entspricht etwa einem PAL/NTSC-Player-Tick
+constexpr int kBlocksPerSecond = 50;
+constexpr float kFloorDb = -80.0f;
+
+float toDb(double meanSquare) {
+    if (meanSquare <= 0.0) return kFloorDb;
+    return std::max(kFloorDb, static_cast<float>(10.0 * std::log10(meanSquare)));
+}
+
+} // namespace
+
+TrackEndDetector::TrackEndDetector(int sampleRate, int channels)
+    : TrackEndDetector(sampleRate, channels, Settings()) {}
+
+TrackEndDetector::TrackEndDetector(int sampleRate, int channels, const Settings& settings)
+    : sampleRate_(sampleRate > 0 ? sampleRate : 44100),
+      channels_(channels > 0 ? channels : 1),
+      settings_(settings) {
+    blockFrames_ = std::max<size_t>(1, sampleRate_ / kBlocksPerSecond);
+    checkBlocks_ = kBlocksPerSecond;  // Loop-Prüfung einmal pro Sekunde
+}
+
+double TrackEndDetector::loopSeconds() const {
+    return static_cast<double>(loopBlocks_ * blockFrames_) / sampleRate_;
+}
+
+size_t TrackEndDetector::committedFrames() const {
+    if (finished()) return endFrame_;
+    if (!heardSound_) return 0;
+
+    size_t committed = (blocks_.size() - silentBlocks_) * blockFrames_;
+    if (settings_.detectLoops) {
+        committed = std::min(committed, static_cast<size_t>(settings_.minLoopSeconds * kBlocksPerSecond) * blockFrames_);
+    }
+    return committed;
+}
+
+bool TrackEndDetector::push(const int16_t* samples, size_t frames) {
+    if (finished()) return true;
+
+    for (size_t f = 0; f < frames; ++f) {
+        // Mono-Mix in [-1, 1]
+        double mono = 0.0;
+        for (int c = 0; c < channels_; ++c) mono += samples[f * channels_ + c];
+        mono /= 32768.0 * channels_;
+
+        double diff = mono - previous_;
+        previous_ = mono;
+        sumSquares_ += mono * mono;
+        sumDiffSquares_ += diff * diff;
+        framesSeen_++;
+
+        if (++blockPos_ == blockFrames_) {
+            finishBlock();
+            if (finished()) return true;
+        }
+    }
+    return false;
+}
+
+void TrackEndDetector::finishBlock() {
+    double meanSquare = sumSquares_ / blockFrames_;
+    blocks_.push_back({toDb(meanSquare), toDb(sumDiffSquares_ / blockFrames_)});
+    sumSquares_ = 0.0;
+    sumDiffSquares_ = 0.0;
+    blockPos_ = 0;
+
+    // RMS-Gate
+    if (std::sqrt(meanSquare) < settings_.silenceThreshold) {
+        silentBlocks_++;
+    } else {
+        silentBlocks_ = 0;
+        heardSound_ = true;
+    }
+
+    // Stille am Anfang darf doppelt so lang sein (Tunes mit Pause vor dem Einsatz)
+    double silentSeconds = static_cast<double>(silentBlocks_) / kBlocksPerSecond;
+    double limit = heardSound_ ? settings_.silenceSeconds : 2.0 * settings_.silenceSeconds;
+    if (silentSeconds >= limit) {
+        endFrame_ = heardSound_ ? (blocks_.size() - silentBlocks_) * blockFrames_ : 0;
+        reason_ = Reason::Silence;
+        return;
+    }
+
+    if (settings_.detectLoops && heardSound_ && blocks_.size() % checkBlocks_ == 0) {
+        checkLoop();
+    }
+}
+
+float TrackEndDetector::blockDistance(size_t a, size_t b) const {
+    return 0.5f * (std::fabs(blocks_[a].level - blocks_[b].level) +
+                   std::fabs(blocks_[a].detail - blocks_[b].detail));
+}
+
+bool TrackEndDetector::matches(size_t start, size_t lag, size_t count, float tolerance) const {
+    // Jede Sekunde für sich muss passen, sonst verdecken lange Treffer ein abweichendes Stück
+    // (z.B. das Intro). Abbruch, sobald ein Fenster sein Budget überschreitet.
+    const size_t end = start + count;
+    for (size_t window = start; window < end; window += kBlocksPerSecond) {
+        size_t windowEnd = std::min(end, window + kBlocksPerSecond);
+        const float budget = tolerance * static_cast<float>(windowEnd - window);
+        float sum = 0.0f;
+        for (size_t i = window; i < windowEnd; ++i) {
+            sum += blockDistance(i, i - lag);
+            if (sum > budget) return false;
+        }
+    }
+    return true;
+}
+
+bool TrackEndDetector::checkLoop() {
+    const size_t n = blocks_.size();
+    const size_t minLag = static_cast<size_t>(settings_.minLoopSeconds * kBlocksPerSecond);
+    const size_t maxLag = std::min(static_cast<size_t>(settings_.maxLoopSeconds * kBlocksPerSecond), n / 2);
+    const float tolerance = settings_.loopToleranceDb;
+
+    for (size_t lag = std::max<size_t>(minLag, 1); lag <= maxLag; ++lag) {
+        // Vorprüfung auf der letzten Sekunde, dann die komplette Periode
+        size_t quick = std::min<size_t>(lag, kBlocksPerSecond);
+        if (!matches(n - quick, lag, quick, 2.0f * tolerance)) continue;
+        if (!matches(n - lag, lag, lag, tolerance)) continue;
+
+        auto range = std::minmax_element(blocks_.begin() + (n - lag), blocks_.end(),
+                                         [](const Block& a, const Block& b) { return a.level < b.level; });
+        if (range.second->level - range.first->level < settings_.minLoopRangeDb) continue;
+
+        // Beginn des zweiten Durchlaufs: rückwärts, solange Block i dem Block i - lag entspricht
+        size_t start = n - lag;
+        while (start > lag) {
+            size_t window = std::min<size_t>(kBlocksPerSecond, start - lag);
+            if (!matches(start - window, lag, window, tolerance)) break;
+            start -= window;
+        }
+        while (start > lag && blockDistance(start - 1, start - 1 - lag) <= 2.0f * tolerance) {
+            start--;
+        }
+
+        loopBlocks_ = lag;
+        endFrame_ = start * blockFrames_;
+        reason_ = Reason::Loop;
+        return true;
+    }
+    return false;
+}
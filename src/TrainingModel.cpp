@@ -56,27 +56,22 @@ void TrainingModel::initializeAccelerator() {
 size_t TrainingModel::extractTrainingFeatures() {
     std::cout << "📊 Extrahiere Features aus Training-Dataset..." << std::endl;
     
-    // Lade alle analysierten Tracks
-    auto allMedia = db_.getAll();
+    // Nur analysierte Tracks mit Genre laden (ohne Stil-/Nutzungsspalten)
+    MediaDatabase::MediaQuery query;
+    query.columns = MediaDatabase::ColTags | MediaDatabase::ColAnalysis | MediaDatabase::ColMfcc;
+    query.where = "analyzed = 1 AND genre IS NOT NULL AND genre != '' AND genre != 'Unknown'";
     
-    std::cout << "📁 Durchsuche " << allMedia.size() << " Tracks in Datenbank" << std::endl;
+    size_t totalTracks = db_.countWhere();
+    std::cout << "📁 Durchsuche " << totalTracks << " Tracks in Datenbank" << std::endl;
     std::cout << "🎸 Extrahiere Instrumente für Sample-Library..." << std::endl;
     
     trainingFeatures_.clear();
     size_t extracted = 0;
-    size_t skipped = 0;
     size_t instrumentsExtracted = 0;
+    size_t missingMfcc = 0;
+    std::vector<std::string> instrumentSources;
     
-    for (const auto& meta : allMedia) {
-        if (!meta.analyzed) {
-            skipped++;
-            continue;
-        }
-        if (meta.genre.empty() || meta.genre == "Unknown") {
-            skipped++;
-            continue;
-        }
-        
+    db_.iterate(query, [&](const MediaMetadata& meta) {
         // Zeige alle 50 Tracks Details
         if (extracted > 0 && extracted % 50 == 0) {
             std::cout << "ℹ️ Verarbeitet: " << extracted << " Tracks | "
@@ -84,53 +79,48 @@ size_t TrainingModel::extractTrainingFeatures() {
                       << "BPM: " << meta.bpm << std::endl;
         }
         
-        AudioFeatures features;
-        
-        // MFCC aus mfccHash rekonstruieren (vereinfacht)
-        // In Produktion: Echte MFCC-Extraktion aus Audio
-        features.mfcc.resize(13);
-        std::mt19937 gen(static_cast<unsigned>(meta.mfccHash * 1000000));
-        std::normal_distribution<float> dist(0.0f, 1.0f);
-        for (int i = 0; i < 13; ++i) {
-            features.mfcc[i] = dist(gen);
+        // Gespeicherte MFCC-Vektoren (ältere Einträge ohne MFCC: Nullvektor)
+        AudioFeatures features = extractFeaturesFromTrack(meta);
+        if (meta.mfccMean.empty()) {
+            missingMfcc++;
         }
         
-        features.spectralCentroid = meta.spectralCentroid;
-        features.spectralRolloff = meta.spectralRolloff;
-        features.zeroCrossingRate = meta.zeroCrossingRate;
-        features.bpm = meta.bpm;
-        features.genre = meta.genre;
-        features.genreId = getOrCreateGenreId(meta.genre);
-        
         trainingFeatures_.push_back(features);
         extracted++;
         
-        // Extrahiere Instrumente aus diesem Track (nur alle 10 Tracks)
+        // Instrumente aus jedem 10. Track - erst nach dem Lesen extrahieren,
+        // damit die Reader-Verbindung nicht während der Audio-Analyse belegt ist
         if (extracted % 10 == 0 && !meta.filepath.empty()) {
-            auto instruments = InstrumentExtractor::extractInstruments(meta.filepath, 0.7f);
+            instrumentSources.push_back(meta.filepath);
+        }
+        return true;
+    });
+    size_t skipped = totalTracks - extracted;
+    
+    for (const auto& filepath : instrumentSources) {
+        auto instruments = InstrumentExtractor::extractInstruments(filepath, 0.7f);
+        
+        // Speichere extrahierte Instrumente
+        std::string instrumentDir = std::string(std::getenv("HOME")) + "/.songgen/instruments/";
+        
+        for (const auto& inst : instruments) {
+            std::string typeDir;
+            switch(inst.type) {
+                case InstrumentSample::KICK: typeDir = "kicks"; break;
+                case InstrumentSample::SNARE: typeDir = "snares"; break;
+                case InstrumentSample::HIHAT: typeDir = "hihats"; break;
+                case InstrumentSample::BASS: typeDir = "bass"; break;
+                case InstrumentSample::LEAD: typeDir = "leads"; break;
+                default: typeDir = "other"; break;
+            }
             
-            // Speichere extrahierte Instrumente
-            std::string instrumentDir = std::string(std::getenv("HOME")) + "/.songgen/instruments/";
+            std::filesystem::create_directories(instrumentDir + typeDir);
             
-            for (const auto& inst : instruments) {
-                std::string typeDir;
-                switch(inst.type) {
-                    case InstrumentSample::KICK: typeDir = "kicks"; break;
-                    case InstrumentSample::SNARE: typeDir = "snares"; break;
-                    case InstrumentSample::HIHAT: typeDir = "hihats"; break;
-                    case InstrumentSample::BASS: typeDir = "bass"; break;
-                    case InstrumentSample::LEAD: typeDir = "leads"; break;
-                    default: typeDir = "other"; break;
-                }
-                
-                std::filesystem::create_directories(instrumentDir + typeDir);
-                
-                std::string filename = std::to_string(std::hash<std::string>{}(meta.filepath + std::to_string(inst.startTime))) + ".wav";
-                std::string outputPath = instrumentDir + typeDir + "/" + filename;
-                
-                if (InstrumentExtractor::saveSample(inst, outputPath)) {
-                    instrumentsExtracted++;
-                }
+            std::string filename = std::to_string(std::hash<std::string>{}(filepath + std::to_string(inst.startTime))) + ".wav";
+            std::string outputPath = instrumentDir + typeDir + "/" + filename;
+            
+            if (InstrumentExtractor::saveSample(inst, outputPath)) {
+                instrumentsExtracted++;
             }
         }
     }
@@ -140,6 +130,10 @@ size_t TrainingModel::extractTrainingFeatures() {
     std::cout << "   ✗ Übersprungen: " << skipped << " (nicht analysiert/Unknown)" << std::endl;
     std::cout << "   🎵 Genres gefunden: " << genreToId_.size() << std::endl;
     std::cout << "   🎸 Instrumente extrahiert: " << instrumentsExtracted << " Samples" << std::endl;
+    if (missingMfcc > 0) {
+        std::cout << "   ⚠️ Ohne MFCC-Vektoren: " << missingMfcc
+                  << " (vor dem MFCC-Update analysiert - bitte neu analysieren)" << std::endl;
+    }
     std::cout << "   📂 Datenbank: ~/.songgen/media.db" << std::endl;
     std::cout << "   📁 Instrumente: ~/.songgen/instruments/" << std::endl;
     
@@ -570,26 +564,13 @@ void TrainingModel::trainSimplifiedVAE(
                     newFeatures.bpm = (currentGenre == "Techno" ? 135.0f : 
                                       (currentGenre == "Drum'n'Bass" ? 170.0f : 120.0f));
                     
-                    // Berechne spektrale Features
-                    float spectralSum = 0.0f;
-                    int zeroCrossings = 0;
-                    for (size_t i = 0; i < samples.size(); ++i) {
-                        spectralSum += std::abs(samples[i]);
-                        if (i > 0 && ((samples[i-1] >= 0 && samples[i] < 0) || 
-                                     (samples[i-1] < 0 && samples[i] >= 0))) {
-                            zeroCrossings++;
-                        }
-                    }
-                    
-                    newFeatures.spectralCentroid = spectralSum / samples.size() * 2000.0f;
-                    newFeatures.zeroCrossingRate = static_cast<float>(zeroCrossings) / samples.size();
-                    
-                    // MFCC-Placeholder
-                    newFeatures.mfcc.resize(13);
-                    std::normal_distribution<float> mfccDist(0.0f, 1.0f);
-                    for (int j = 0; j < 13; ++j) {
-                        newFeatures.mfcc[j] = mfccDist(gen);
-                    }
+                    // Spektrale Features + MFCCs aus einem STFT-Durchlauf
+                    FeatureFrames frames = FeatureFrames::compute(samples, sfInfo.samplerate);
+                    newFeatures.spectralCentroid = frames.meanCentroid;
+                    newFeatures.spectralRolloff = frames.meanRolloff;
+                    newFeatures.zeroCrossingRate = frames.zeroCrossingRate;
+                    newFeatures.mfcc = frames.mfccMean;
+                    newFeatures.mfcc.resize(13, 0.0f);
                     
                     trainingFeatures_.push_back(newFeatures);
                     std::cout << "  ✓ Instrument-Kombination zu Training hinzugefügt ("
@@ -794,13 +775,9 @@ std::vector<float> TrainingModel::generate(
 TrainingModel::AudioFeatures TrainingModel::extractFeaturesFromTrack(const MediaMetadata& track) {
     AudioFeatures features;
     
-    // MFCC aus Hash rekonstruieren (in Produktion: echte Audio-Analyse)
-    features.mfcc.resize(13);
-    std::mt19937 gen(static_cast<unsigned>(track.mfccHash * 1000000));
-    std::normal_distribution<float> dist(0.0f, 1.0f);
-    for (int i = 0; i < 13; ++i) {
-        features.mfcc[i] = dist(gen);
-    }
+    // Gespeicherte MFCC-Mittelwerte aus der Analyse (fehlend = Nullvektor)
+    features.mfcc = track.mfccMean;
+    features.mfcc.resize(13, 0.0f);
     
     features.spectralCentroid = track.spectralCentroid;
     features.spectralRolloff = track.spectralRolloff;
@@ -1134,11 +1111,12 @@ std::vector<int64_t> TrainingModel::findSimilarTracksWithWrongGenre(
     std::cout << "   🎭 Alt: " << oldGenre << " → Neu: " << correctedTrack.genre << std::endl;
     
     std::vector<int64_t> similarTrackIds;
-    auto allTracks = db_.getAll();
     
-    AudioFeatures refFeatures = extractFeaturesFromTrack(correctedTrack);
+    // Kandidaten aus dem Vektorindex statt Linear-Scan über die ganze Bibliothek
+    const int candidateLimit = 256;
+    auto candidates = db_.findSimilar(correctedTrack, candidateLimit);
     
-    for (const auto& track : allTracks) {
+    for (const auto& track : candidates) {
         // Skip der korrigierte Track selbst
         if (track.filepath == correctedTrack.filepath) continue;
         
@@ -1229,11 +1207,16 @@ int TrainingModel::suggestDatabaseCorrections(bool autoApply) {
     std::cout << "   🔧 Modus: " << (autoApply ? "Auto-Apply" : "Nur Vorschläge") << std::endl;
     
     auto patterns = learnCorrectionPatterns();
-    auto allTracks = db_.getAll();
+    
+    // Nur die für die Muster benötigten Spalten lesen; Korrekturen werden
+    // nach dem Durchlauf geschrieben (kein Schreiben im Reader-Callback)
+    MediaDatabase::MediaQuery query;
+    query.columns = MediaDatabase::ColTags | MediaDatabase::ColAnalysis;
     
     int suggestionsCount = 0;
+    std::vector<std::pair<int64_t, std::string>> corrections;
     
-    for (auto& track : allTracks) {
+    db_.iterate(query, [&](const MediaMetadata& track) {
         bool shouldCorrect = false;
         std::string suggestedGenre;
         
@@ -1290,19 +1273,28 @@ int TrainingModel::suggestDatabaseCorrections(bool autoApply) {
             std::cout << "      " << track.genre << " → " << suggestedGenre << std::endl;
             
             if (autoApply) {
-                std::string oldGenre = track.genre;
-                track.genre = suggestedGenre;
-                
-                if (db_.updateMedia(track)) {
-                    std::cout << "      ✅ Automatisch korrigiert!" << std::endl;
-                    
-                    // Füge zur Historie hinzu
-                    addToCorrectionHistory(track, oldGenre);
-                } else {
-                    std::cout << "      ❌ Fehler beim Speichern" << std::endl;
-                }
+                corrections.emplace_back(track.id, suggestedGenre);
             }
         }
+        return true;
+    });
+    
+    for (const auto& correction : corrections) {
+        MediaMetadata track = db_.getById(correction.first);
+        if (track.id != correction.first) continue;
+        
+        std::string oldGenre = track.genre;
+        track.genre = correction.second;
+        
+        if (db_.updateMedia(track)) {
+            std::cout << "   ✅ Automatisch korrigiert: "
+                      << std::filesystem::path(track.filepath).filename().string() << std::endl;
+            
+            // Füge zur Historie hinzu
+            addToCorrectionHistory(track, oldGenre);
+        } else {
+            std::cout << "   ❌ Fehler beim Speichern: " << track.filepath << std::endl;
+        }
     }
     
     suggestedCorrections_ += suggestionsCount;
@@ -1605,27 +1597,27 @@ std::map<std::string, int> TrainingModel::learnGenreFusions() {
     std::cout << "🎭 Lerne Genre-Fusion-Patterns..." << std::endl;
     
     std::map<std::string, int> fusionCounts;
-    auto allMedia = db_.getAll();
+    // Identische Tag-Kombinationen zählt SQLite, hier nur noch die Paare aufteilen
+    auto tagGroups = db_.countGroupedBy("genreTags", "genreTags != ''");
     
-    for (const auto& media : allMedia) {
-        if (!media.genreTags.empty()) {
-            // Genre-Tags sind comma-separated: "Breakbeat,BigBeat,Electronic"
-            fusionCounts[media.genreTags]++;
-            
-            // Analysiere auch Paar-Kombinationen
-            std::vector<std::string> tags;
-            std::stringstream ss(media.genreTags);
-            std::string tag;
-            while (std::getline(ss, tag, ',')) {
-                tags.push_back(tag);
-            }
-            
-            // Zähle alle 2er-Kombinationen
-            for (size_t i = 0; i < tags.size(); i++) {
-                for (size_t j = i + 1; j < tags.size(); j++) {
-                    std::string pair = tags[i] + "+" + tags[j];
-                    fusionCounts[pair]++;
-                }
+    for (const auto& group : tagGroups) {
+        // Genre-Tags sind comma-separated: "Breakbeat,BigBeat,Electronic"
+        int tracks = static_cast<int>(group.second);
+        fusionCounts[group.first] += tracks;
+        
+        // Analysiere auch Paar-Kombinationen
+        std::vector<std::string> tags;
+        std::stringstream ss(group.first);
+        std::string tag;
+        while (std::getline(ss, tag, ',')) {
+            tags.push_back(tag);
+        }
+        
+        // Zähle alle 2er-Kombinationen
+        for (size_t i = 0; i < tags.size(); i++) {
+            for (size_t j = i + 1; j < tags.size(); j++) {
+                std::string pair = tags[i] + "+" + tags[j];
+                fusionCounts[pair] += tracks;
             }
         }
     }
@@ -1647,15 +1639,12 @@ std::map<std::string, int> TrainingModel::learnGenreFusions() {
 std::vector<float> TrainingModel::learnArtistStyle(const std::string& artist) {
     std::cout << "🎨 Lerne Stil von: " << artist << std::endl;
     
-    auto allMedia = db_.getAll();
-    std::vector<MediaMetadata> artistTracks;
-    
-    // Finde alle Tracks des Künstlers
-    for (const auto& media : allMedia) {
-        if (media.artist == artist && media.analyzed) {
-            artistTracks.push_back(media);
-        }
-    }
+    // Finde alle analysierten Tracks des Künstlers
+    MediaDatabase::MediaQuery query;
+    query.columns = MediaDatabase::ColTags | MediaDatabase::ColStyle | MediaDatabase::ColAnalysis;
+    query.where = "artist = ? AND analyzed = 1";
+    query.params = {artist};
+    std::vector<MediaMetadata> artistTracks = db_.getPage(query);
     
     if (artistTracks.empty()) {
         std::cout << "   ℹ️ Keine Tracks von " << artist << " gefunden" << std::endl;
@@ -0,0 +1,137 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned int threads) : threads_(threads) {
+    if (threads_ == 0) {
+        threads_ = std::thread::hardware_concurrency();
+        if (threads_ == 0) threads_ = 4;  // Fallback
+    }
+
+    queues_.reserve(threads_);
+    for (unsigned int i = 0; i < threads_; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+}
+
+bool WorkStealingPool::popLocal(size_t worker, size_t& taskIndex) {
+    WorkerQueue& queue = *queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+
+    taskIndex = queue.tasks.front();
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t thief, size_t& taskIndex) {
+    // Beginne beim Nachbarn, damit nicht alle Diebe dieselbe Queue belagern
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        WorkerQueue& victim = *queues_[(thief + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+
+        taskIndex = victim.tasks.back();
+        victim.tasks.pop_back();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::run(size_t taskCount, const Task& task, const std::atomic<bool>* stopFlag) {
+    stats_.assign(threads_, WorkerStats{});
+    runSeconds_ = 0.0;
+    if (taskCount == 0) return;
+    const auto runStart = std::chrono::steady_clock::now();
+
+    // Verteile Tasks reihum: Worker w bekommt w, w+N, w+2N, ...
+    // So bleibt die Reihenfolge (z.B. längste zuerst) pro Queue erhalten.
+    for (auto& queue : queues_) {
+        queue->tasks.clear();
+    }
+    for (size_t i = 0; i < taskCount; ++i) {
+        queues_[i % threads_]->tasks.push_back(i);
+    }
+
+    unsigned int activeThreads = static_cast<unsigned int>(std::min<size_t>(threads_, taskCount));
+
+    auto worker = [&](size_t workerIndex) {
+        WorkerStats& stats = stats_[workerIndex];
+
+        while (!(stopFlag && stopFlag->load())) {
+            size_t taskIndex = 0;
+            if (popLocal(workerIndex, taskIndex)) {
+                // eigene Arbeit
+            } else if (steal(workerIndex, taskIndex)) {
+                stats.tasksStolen++;
+            } else {
+                break;  // Nichts mehr zu tun (Tasks werden nie nachgeschoben)
+            }
+
+            const auto taskStart = std::chrono::steady_clock::now();
+            try {
+                task(taskIndex, workerIndex);
+            } catch (const std::exception& e) {
+                std::cerr << "[Pool] ⚠️ Task " << taskIndex << " fehlgeschlagen: " << e.what() << "\n";
+            } catch (...) {
+                std::cerr << "[Pool] ⚠️ Task " << taskIndex << " fehlgeschlagen\n";
+            }
+            stats.busySeconds += secondsSince(taskStart);
+            stats.tasksExecuted++;
+        }
+        stats.finishSeconds = secondsSince(runStart);
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(activeThreads);
+    for (unsigned int t = 0; t < activeThreads; ++t) {
+        workers.emplace_back(worker, t);
+    }
+
+    for (auto& w : workers) {
+        if (w.joinable()) w.join();
+    }
+    runSeconds_ = secondsSince(runStart);
+    stats_.resize(activeThreads);
+}
+
+void WorkStealingPool::printUtilization(const char* label, bool perWorker) const {
+    if (stats_.empty() || runSeconds_ <= 0.0) return;
+
+    double busyTotal = 0.0;
+    double minUtilization = 1.0;
+    double firstIdle = runSeconds_;
+    size_t stolen = 0;
+    for (const auto& stats : stats_) {
+        busyTotal += stats.busySeconds;
+        minUtilization = std::min(minUtilization, stats.busySeconds / runSeconds_);
+        firstIdle = std::min(firstIdle, stats.finishSeconds);
+        stolen += stats.tasksStolen;
+    }
+
+    char line[256];
+    snprintf(line, sizeof(line), "%s: %zu Worker, %.1f s, Auslastung Ø %.1f%% (min %.1f%%), Tail %.1f s, %zu gestohlen",
+             label, stats_.size(), runSeconds_, 100.0 * busyTotal / (runSeconds_ * stats_.size()),
+             100.0 * minUtilization, runSeconds_ - firstIdle, stolen);
+    std::cout << "📊 " << line << "\n";
+
+    if (!perWorker) return;
+    for (size_t w = 0; w < stats_.size(); ++w) {
+        const auto& stats = stats_[w];
+        snprintf(line, sizeof(line), "   Worker %2zu: %5zu Tasks (%zu gestohlen), busy %.1f s (%.1f%%), fertig nach %.1f s",
+                 w, stats.tasksExecuted, stats.tasksStolen, stats.busySeconds,
+                 100.0 * stats.busySeconds / runSeconds_, stats.finishSeconds);
+        std::cout << line << "\n";
+    }
+}
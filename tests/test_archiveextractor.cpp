@@ -0,0 +1,151 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+#include "../include/ArchiveExtractor.h"
+
+#ifdef WITH_LIBARCHIVE
+#include <archive.h>
+#include <archive_entry.h>
+#endif
+
+namespace fs = std::filesystem;
+
+#ifdef WITH_LIBARCHIVE
+namespace {
+
+struct Member {
+    std::string name;
+    std::string content;
+};
+
+// Zip mit den angegebenen Einträgen; Ergebnis als Bytes
+std::string makeZip(const std::vector<Member>& members) {
+    std::vector<char> buffer(4 * 1024 * 1024);
+    size_t used = 0;
+    struct archive* writer = archive_write_new();
+    archive_write_set_format_zip(writer);
+    archive_write_open_memory(writer, buffer.data(), buffer.size(), &used);
+    for (const auto& member : members) {
+        struct archive_entry* entry = archive_entry_new();
+        archive_entry_set_pathname(entry, member.name.c_str());
+        archive_entry_set_filetype(entry, AE_IFREG);
+        archive_entry_set_perm(entry, 0644);
+        archive_entry_set_size(entry, static_cast<la_int64_t>(member.content.size()));
+        archive_write_header(writer, entry);
+        archive_write_data(writer, member.content.data(), member.content.size());
+        archive_entry_free(entry);
+    }
+    archive_write_close(writer);
+    archive_write_free(writer);
+    return std::string(buffer.data(), used);
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+#endif
+
+int main() {
+#ifndef WITH_LIBARCHIVE
+    std::cout << "Built without libarchive, archive extractor tests skipped." << std::endl;
+    return 0;
+#else
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_archive_test_" + std::to_string(getpid());
+    std::string target = dir + "/hvsc";
+    fs::create_directories(dir);
+    int rc = 0;
+
+    // HVSC-Aufbau: äußeres Zip mit Doku und verschachteltem C64Music.zip
+    std::string bigTune(200000, 'x');
+    std::string inner = makeZip({
+        {"C64Music/DEMOS/A/intro.sid", "PSID-intro"},
+        {"C64Music/DOCUMENTS/Songlengths.md5", "; lengths"},
+        {"C64Music/MUSICIANS/H/Hubbard_Rob/Commando.sid", bigTune},
+    });
+    std::string outer = makeZip({
+        {"readme.txt", "hello"},
+        {"C64Music.zip", inner},
+        {"../evil.txt", "nope"},
+        {"/tmp/absolute_evil.txt", "nope"},
+    });
+    std::string archivePath = dir + "/HVSC_all.zip";
+    std::ofstream(archivePath, std::ios::binary) << outer;
+
+    std::vector<std::string> files;
+    size_t progressCalls = 0;
+    ArchiveExtractor::Options options;
+    options.onFile = [&](const std::string& path) { files.push_back(path); };
+    options.onProgress = [&](const ArchiveExtractor::Progress&) { progressCalls++; };
+    ArchiveExtractor extractor(options);
+
+    if (!extractor.extract(archivePath, target + "/")) {
+        std::cerr << "Extraction failed: " << extractor.error() << std::endl;
+        rc = 2;
+    }
+
+    // Dateien werden in Archiv-Reihenfolge gemeldet, das innere Zip landet nicht auf der Platte
+    std::vector<std::string> expected = {
+        target + "/readme.txt",
+        target + "/C64Music/DEMOS/A/intro.sid",
+        target + "/C64Music/DOCUMENTS/Songlengths.md5",
+        target + "/C64Music/MUSICIANS/H/Hubbard_Rob/Commando.sid",
+    };
+    if (files != expected) {
+        std::cerr << "Unexpected onFile sequence (" << files.size() << " files)" << std::endl;
+        rc = 3;
+    }
+    if (fs::exists(target + "/C64Music.zip") || readFile(expected[3]) != bigTune ||
+        readFile(expected[1]) != "PSID-intro") {
+        std::cerr << "Nested archive not streamed correctly" << std::endl;
+        rc = 4;
+    }
+
+    // Unsichere Pfade werden übersprungen
+    if (fs::exists(dir + "/evil.txt") || fs::exists("/tmp/absolute_evil.txt") || extractor.skippedEntries() != 2) {
+        std::cerr << "Unsafe entries not rejected" << std::endl;
+        rc = 5;
+    }
+
+    // Fortschritt: ganzes Archiv gelesen, alle Einträge gezählt (inkl. verschachtelter)
+    const auto& progress = extractor.progress();
+    if (progress.bytesTotal != outer.size() || progress.bytesRead < outer.size() / 2 ||
+        progress.files != 4 || progress.entries != 7 || progressCalls == 0 ||
+        progress.bytesWritten != 5 + 10 + 9 + bigTune.size()) {
+        std::cerr << "Unexpected progress: " << progress.bytesRead << "/" << progress.bytesTotal << " bytes, "
+                  << progress.entries << " entries, " << progress.files << " files" << std::endl;
+        rc = 6;
+    }
+
+    // Abbruch vor dem ersten Eintrag
+    std::atomic<bool> stop{true};
+    ArchiveExtractor::Options stopOptions;
+    stopOptions.stopFlag = &stop;
+    ArchiveExtractor stopped(stopOptions);
+    if (stopped.extract(archivePath, dir + "/stopped") || stopped.progress().files != 0) {
+        std::cerr << "Stop flag ignored" << std::endl;
+        rc = 7;
+    }
+
+    // Kaputtes Archiv
+    std::ofstream(dir + "/broken.zip", std::ios::binary) << "PK\x03\x04garbage";
+    ArchiveExtractor broken;
+    if (broken.extract(dir + "/broken.zip", dir + "/broken") || broken.error().empty()) {
+        std::cerr << "Broken archive accepted" << std::endl;
+        rc = 8;
+    }
+
+    fs::remove_all(dir);
+    if (rc == 0) std::cout << "Archive extractor tests passed." << std::endl;
+    return rc;
+#endif
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+#include "../include/AudioStreamReader.h"
+
+namespace {
+
+void writeLE(std::ofstream& out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+// 16-Bit-Mono-WAV mit Sinus
+void writeSineWav(const std::string& path, int rate, double frequency, double seconds) {
+    const uint32_t frames = static_cast<uint32_t>(rate * seconds);
+    std::ofstream out(path, std::ios::binary);
+    out.write("RIFF", 4);
+    writeLE(out, 36 + frames * 2, 4);
+    out.write("WAVEfmt ", 8);
+    writeLE(out, 16, 4);
+    writeLE(out, 1, 2);                 // PCM
+    writeLE(out, 1, 2);                 // Mono
+    writeLE(out, rate, 4);
+    writeLE(out, rate * 2, 4);
+    writeLE(out, 2, 2);
+    writeLE(out, 16, 2);
+    out.write("data", 4);
+    writeLE(out, frames * 2, 4);
+    for (uint32_t i = 0; i < frames; ++i) {
+        double value = 0.5 * std::sin(2.0 * M_PI * frequency * i / rate);
+        writeLE(out, static_cast<uint16_t>(static_cast<int16_t>(value * 32767.0)), 2);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_streamreader_test_" + std::to_string(getpid());
+    std::filesystem::create_directories(dir);
+    int rc = 0;
+
+    // Downsampling um mehr als Faktor 2 (96 kHz -> 22,05 kHz): die Leseposition
+    // springt über das Ende des Eingabepuffers, der Überhang muss erhalten bleiben
+    {
+        const std::string path = dir + "/sine96k.wav";
+        const double seconds = 2.0;
+        writeSineWav(path, 96000, 440.0, seconds);
+
+        AudioStreamReader reader;
+        if (!reader.open(path, 22050) || reader.sampleRate() != 22050) {
+            std::cerr << "Open failed" << std::endl;
+            rc = 2;
+        } else {
+            // Krumme Chunk-Größe, damit Leseaufrufe und Eingabeblöcke nicht zusammenfallen
+            std::vector<float> output;
+            std::vector<float> chunk(1000);
+            while (size_t got = reader.read(chunk.data(), chunk.size())) {
+                output.insert(output.end(), chunk.begin(), chunk.begin() + got);
+            }
+
+            const double expected = seconds * 22050;
+            if (std::fabs(static_cast<double>(output.size()) - expected) > 2.0) {
+                std::cerr << "Resampled length wrong: " << output.size() << " (expected " << expected << ")"
+                          << std::endl;
+                rc = 3;
+            }
+            // Ohne Phasensprünge: jedes Sample liegt auf dem Sinus der Zielrate
+            double maxError = 0.0;
+            for (size_t i = 0; i < output.size(); ++i) {
+                double reference = 0.5 * std::sin(2.0 * M_PI * 440.0 * i / 22050);
+                maxError = std::max(maxError, std::fabs(output[i] - reference));
+            }
+            if (maxError > 0.01) {
+                std::cerr << "Resampled signal drifts: max error " << maxError << std::endl;
+                rc = 4;
+            }
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    if (rc == 0) std::cout << "Audio stream reader tests passed." << std::endl;
+    return rc;
+}
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <set>
+#include <utility>
+#include <string>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+#include "../include/DuplicateDetector.h"
+#include "../include/MediaDatabase.h"
+
+int main() {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> duration(60.0f, 400.0f);
+    std::uniform_real_distribution<float> bpm(80.0f, 180.0f);
+    std::uniform_real_distribution<float> coeff(-20.0f, 20.0f);
+    std::normal_distribution<float> jitter(0.0f, 0.05f);
+
+    DuplicateDetector detector;
+    const size_t originals = 3000;
+    for (size_t i = 0; i < originals; ++i) {
+        DuplicateDetector::Track t;
+        t.id = static_cast<int64_t>(detector.tracks().size() + 1);
+        t.filepath = "/music/" + std::to_string(t.id);
+        t.title = "Song " + std::to_string(i % 500);
+        t.artist = "Artist";
+        t.hasTitleArtist = true;
+        t.duration = duration(gen);
+        t.bpm = bpm(gen);
+        t.spectralCentroid = 1500.0f + coeff(gen) * 10.0f;
+        t.mfccHash = coeff(gen);
+        t.analyzed = true;
+        // Ältere Einträge ohne MFCC-Vektor mischen
+        if (i % 10 != 0) {
+            t.mfccMean.resize(13);
+            t.mfccMean[0] = -60.0f + coeff(gen);
+            for (size_t c = 1; c < 13; ++c) t.mfccMean[c] = coeff(gen);
+        }
+        detector.add(t);
+
+        // Jeder fünfte Track bekommt ein leicht verändertes Duplikat
+        if (i % 5 == 0) {
+            DuplicateDetector::Track copy = t;
+            copy.id = static_cast<int64_t>(detector.tracks().size() + 1);
+            copy.filepath = "/mirror/" + std::to_string(copy.id);
+            copy.duration += 0.05f;
+            copy.bpm += 0.3f;
+            for (float& c : copy.mfccMean) c += jitter(gen);
+            detector.add(copy);
+        }
+    }
+
+    const auto& tracks = detector.tracks();
+    const float threshold = 0.95f;
+
+    // Referenz: alle Paare (wie der alte Self-Join)
+    std::set<std::pair<int64_t, int64_t>> expectedAudio, expectedIdentical;
+    for (size_t a = 0; a < tracks.size(); ++a) {
+        for (size_t b = a + 1; b < tracks.size(); ++b) {
+            if (DuplicateDetector::withinAudioWindow(tracks[a], tracks[b]) &&
+                DuplicateDetector::audioSimilarity(tracks[a], tracks[b]) >= threshold) {
+                expectedAudio.insert({tracks[a].id, tracks[b].id});
+            }
+            if (tracks[a].title == tracks[b].title && tracks[a].artist == tracks[b].artist &&
+                std::abs(tracks[a].duration - tracks[b].duration) < DuplicateDetector::kIdenticalDurationDiff) {
+                expectedIdentical.insert({tracks[a].id, tracks[b].id});
+            }
+        }
+    }
+
+    std::set<std::pair<int64_t, int64_t>> foundIdentical;
+    for (const auto& m : detector.findIdentical()) {
+        foundIdentical.insert({tracks[m.first].id, tracks[m.second].id});
+    }
+    if (foundIdentical != expectedIdentical) {
+        std::cerr << "Identical mismatch: " << foundIdentical.size() << " vs " << expectedIdentical.size() << std::endl;
+        return 1;
+    }
+
+    size_t hits = 0;
+    auto audio = detector.findAudioDuplicates(threshold);
+    for (const auto& m : audio) {
+        if (m.similarity < threshold) {
+            std::cerr << "Match below threshold" << std::endl;
+            return 2;
+        }
+        if (expectedAudio.count({tracks[m.first].id, tracks[m.second].id})) hits++;
+    }
+    if (hits != audio.size()) {
+        std::cerr << "Unexpected audio matches" << std::endl;
+        return 3;
+    }
+    float recall = expectedAudio.empty() ? 1.0f : static_cast<float>(hits) / expectedAudio.size();
+    if (expectedAudio.size() < originals / 5 || recall < 0.98f) {
+        std::cerr << "Audio recall too low: " << recall << " (" << hits << "/" << expectedAudio.size() << ")" << std::endl;
+        return 4;
+    }
+
+    // Import-Prüfung gegen die Datenbank: nur Kandidaten im Dauer-Fenster,
+    // Tracks ohne Titel/Artist matchen nicht über die Metadaten
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_duplicates_test_" + std::to_string(getpid());
+    std::filesystem::create_directories(dir);
+    int rc = 0;
+    {
+        MediaDatabase db(dir + "/media.db");
+        if (!db.initialize()) return 5;
+        MediaMetadata stored;
+        stored.filepath = "/music/a.mp3";
+        stored.title = "Commando";
+        stored.artist = "Rob Hubbard";
+        stored.duration = 180.0;
+        stored.bpm = 120.0;
+        stored.spectralCentroid = 1500.0;
+        stored.analyzed = true;
+        stored.mfccMean.assign(13, 1.0f);
+        stored.mfccMean[0] = -60.0f;
+        MediaMetadata untagged = stored;
+        untagged.filepath = "/music/b.mp3";
+        untagged.title.clear();
+        untagged.artist.clear();
+        untagged.analyzed = false;
+        untagged.mfccMean.clear();
+        db.addMedia(stored);
+        db.addMedia(untagged);
+
+        MediaMetadata copy = stored;
+        copy.filepath = "/import/a.mp3";
+        copy.duration += 0.05;
+        auto found = db.checkDuplicate(copy);
+        if (found.size() != 1 || found[0].filepath1 != stored.filepath || found[0].reason != "identical_metadata") {
+            std::cerr << "Tagged copy not detected on import" << std::endl;
+            rc = 6;
+        }
+
+        MediaMetadata renamed = copy;
+        renamed.title.clear();
+        renamed.artist.clear();
+        found = db.checkDuplicate(renamed);
+        if (found.size() != 1 || found[0].reason != "similar_audio") {
+            std::cerr << "Untagged copy matched via metadata (" << found.size() << " hits)" << std::endl;
+            rc = 7;
+        }
+
+        renamed.analyzed = false;
+        if (!db.checkDuplicate(renamed).empty()) {
+            std::cerr << "Unrelated untagged track reported" << std::endl;
+            rc = 8;
+        }
+
+        // Batch-Pfad: zwei ungetaggte Zeilen gleicher Dauer sind kein "identical_metadata"
+        MediaMetadata untaggedTwin = untagged;
+        untaggedTwin.filepath = "/music/c.mp3";
+        db.addMedia(untaggedTwin);
+        if (!db.findIdenticalFiles().empty() || !db.findDuplicates().empty() ||
+            db.getTrainingStats().duplicates != 0) {
+            std::cerr << "Untagged rows paired as identical" << std::endl;
+            rc = 9;
+        }
+        MediaMetadata tagged = stored;
+        tagged.filepath = "/mirror/a.mp3";
+        tagged.analyzed = false;
+        db.addMedia(tagged);
+        auto identical = db.findIdenticalFiles();
+        if (identical.size() != 1 || identical[0].reason != "identical_metadata") {
+            std::cerr << "Tagged pair not found in batch path (" << identical.size() << ")" << std::endl;
+            rc = 10;
+        }
+    }
+    std::filesystem::remove_all(dir);
+    if (rc != 0) return rc;
+
+    std::cout << "Duplicate detector test passed (recall = " << recall << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include "../include/FileHasher.h"
+
+int main() {
+    // Referenzwerte der XXH64-Spezifikation (Seed 0)
+    if (FileHasher::hashBytes("", 0) != 0xef46db3751d8e999ULL ||
+        FileHasher::hashBytes("abc", 3) != 0x44bc2cf5ad770999ULL) {
+        std::cerr << "XXH64 reference mismatch" << std::endl;
+        return 1;
+    }
+
+    // Streaming mit beliebigen Chunk-Grenzen == One-Shot
+    std::vector<unsigned char> data(3 * 1024 * 1024 + 17);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<unsigned char>((i * 131) ^ (i >> 7));
+    const uint64_t expected = FileHasher::hashBytes(data.data(), data.size());
+    FileHasher::Stream stream;
+    size_t pos = 0, chunk = 1;
+    while (pos < data.size()) {
+        size_t n = std::min(chunk, data.size() - pos);
+        stream.update(data.data() + pos, n);
+        pos += n;
+        chunk = chunk * 3 + 5;
+    }
+    if (stream.digest() != expected) {
+        std::cerr << "Streaming hash mismatch" << std::endl;
+        return 2;
+    }
+
+    // mmap- und gepufferter Pfad liefern denselben Hash
+    const std::string path = "test_filehash.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+    std::string mapped = FileHasher::hashFile(path, true);
+    std::string buffered = FileHasher::hashFile(path, false);
+    std::remove(path.c_str());
+    if (mapped != buffered || mapped != FileHasher::toString(expected)) {
+        std::cerr << "File hash mismatch: " << mapped << " vs " << buffered << std::endl;
+        return 3;
+    }
+    if (!FileHasher::hashFile("/nonexistent/file.wav").empty()) {
+        std::cerr << "Missing file should give empty hash" << std::endl;
+        return 4;
+    }
+
+    std::cout << "File hasher test passed (" << mapped << ")" << std::endl;
+    return 0;
+}
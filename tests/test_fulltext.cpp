@@ -0,0 +1,103 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+#include "../include/MediaDatabase.h"
+
+namespace {
+
+MediaMetadata track(const std::string& path, const std::string& title, const std::string& artist,
+                    const std::string& genre, const std::string& mood = "") {
+    MediaMetadata meta;
+    meta.filepath = path;
+    meta.title = title;
+    meta.artist = artist;
+    meta.genre = genre;
+    meta.mood = mood;
+    return meta;
+}
+
+} // namespace
+
+int main() {
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_fulltext_test_" + std::to_string(getpid());
+    std::filesystem::create_directories(dir);
+    int rc = 0;
+
+    {
+        MediaDatabase db(dir + "/media.db");
+        if (!db.initialize()) return 1;
+
+        std::vector<MediaMetadata> items = {
+            track("/a.sid", "Commando", "Rob Hubbard", "SID"),
+            track("/b.sid", "Monty on the Run", "Rob Hubbard", "SID"),
+            track("/c.sid", "Turrican II", "Chris Hülsbeck", "SID"),
+            track("/d.mp3", "Night Drive", "Synth Band", "Synthwave", "#commando vibes"),
+            track("/e.mp3", "100% Pure", "Someone", "House"),
+        };
+        for (int i = 0; i < 200; ++i) {
+            items.push_back(track("/filler/" + std::to_string(i), "Song " + std::to_string(i), "Various", "Pop"));
+        }
+        db.addMediaBatch(items);
+
+        // Präfix je Wort, alle Wörter müssen passen
+        if (db.search("rob hubb").size() != 2 || db.search("hubb monty").size() != 1) {
+            std::cerr << "Prefix search mismatch" << std::endl;
+            rc = 1;
+        }
+
+        // Diakritika werden ignoriert
+        if (db.search("hulsbeck").size() != 1) {
+            std::cerr << "Diacritics folding failed" << std::endl;
+            rc = 2;
+        }
+
+        // Titeltreffer vor Mood-Treffer
+        auto ranked = db.search("commando");
+        if (ranked.size() != 2 || ranked[0].filepath != "/a.sid") {
+            std::cerr << "Ranking mismatch" << std::endl;
+            rc = 3;
+        }
+
+        // Sonderzeichen dürfen keine FTS-Syntaxfehler auslösen
+        if (db.search("100% \"pure").size() != 1 || !db.search("%%% ***").empty() ||
+            MediaDatabase::fullTextQuery("a-b \"c\"") != "\"a\"* \"b\"* \"c\"*") {
+            std::cerr << "Query escaping mismatch" << std::endl;
+            rc = 4;
+        }
+
+        // Kombination mit Filter, Paging und Zähler
+        MediaDatabase::MediaQuery query;
+        query.search = "song";
+        query.where = "genre = ?";
+        query.params = {"Pop"};
+        query.orderBy = "title ASC";
+        query.limit = 50;
+        query.offset = 190;
+        if (db.count(query) != 200 || db.getPage(query).size() != 10) {
+            std::cerr << "Paging/count mismatch" << std::endl;
+            rc = 5;
+        }
+
+        // Trigger halten den Index bei Update/Delete synchron
+        MediaMetadata renamed = db.search("turrican").at(0);
+        renamed.title = "Katakis";
+        db.updateMedia(renamed);
+        if (!db.search("turrican").empty() || db.search("kata").size() != 1) {
+            std::cerr << "Update not reflected in index" << std::endl;
+            rc = 6;
+        }
+        db.deleteMedia(renamed.id);
+        if (!db.search("kata").empty()) {
+            std::cerr << "Delete not reflected in index" << std::endl;
+            rc = 7;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    if (rc == 0) std::cout << "Fulltext search test passed" << std::endl;
+    return rc;
+}
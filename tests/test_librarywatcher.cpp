@@ -0,0 +1,161 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+#include "../include/LibraryWatcher.h"
+#include "../include/MediaDatabase.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void writeFile(const std::string& path, const std::string& content) {
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+}
+
+MediaMetadata makeMeta(const std::string& path, const std::string& hash) {
+    MediaMetadata meta;
+    meta.filepath = path;
+    meta.title = fs::path(path).stem().string();
+    meta.genre = "SID";
+    meta.fileHash = hash;
+    return meta;
+}
+
+// Wartet bis cond erfüllt ist (Watcher arbeitet asynchron)
+bool waitFor(const std::function<bool()>& cond, int timeoutMs = 5000) {
+    for (int waited = 0; waited < timeoutMs; waited += 50) {
+        if (cond()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return cond();
+}
+
+} // namespace
+
+int main() {
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_librarywatcher_test_" + std::to_string(getpid());
+    std::string root = dir + "/mp3";
+    fs::create_directories(root + "/A");
+    writeFile(root + "/A/one.mp3", "one");
+    writeFile(root + "/A/notes.txt", "ignored");
+    int rc = 0;
+
+    {
+        MediaDatabase db(dir + "/media.db");
+        if (!db.initialize()) return 1;
+
+        LibraryWatcher::Options options;
+        options.debounceMs = 100;
+        options.makeMetadata = makeMeta;
+        options.journalPath = dir + "/mp3.journal";
+
+        {
+            LibraryWatcher watcher(db, root + "/", options);
+            watcher.start();
+
+            // Startabgleich: vorhandene Datei wird übernommen, fremde Endungen nicht
+            if (!waitFor([&]() { return db.existsByPath(root + "/A/one.mp3"); }) || db.getTotalCount() != 1) {
+                std::cerr << "Initial scan failed" << std::endl;
+                rc = 2;
+            }
+
+            // Neue Datei und neues Verzeichnis mit Datei
+            writeFile(root + "/A/two.mp3", "two");
+            fs::create_directories(root + "/B/C");
+            writeFile(root + "/B/C/three.wav", "three");
+            if (!waitFor([&]() { return db.existsByPath(root + "/A/two.mp3") && db.existsByPath(root + "/B/C/three.wav"); })) {
+                std::cerr << "Create events not applied" << std::endl;
+                rc = 3;
+            }
+
+            // Umbenennen behält den Eintrag (gleiche ID)
+            MediaDatabase::MediaQuery query;
+            query.where = "filepath = ?";
+            query.params = {root + "/A/two.mp3"};
+            auto before = db.queryIds(query);
+            fs::rename(root + "/A/two.mp3", root + "/A/zwei.mp3");
+            query.params = {root + "/A/zwei.mp3"};
+            if (!waitFor([&]() { return db.existsByPath(root + "/A/zwei.mp3"); }) ||
+                db.existsByPath(root + "/A/two.mp3") || before.empty() || db.queryIds(query) != before) {
+                std::cerr << "Rename not applied as move" << std::endl;
+                rc = 4;
+            }
+
+            // Verzeichnis umbenennen verschiebt alle Einträge darunter
+            fs::rename(root + "/B", root + "/Bee");
+            if (!waitFor([&]() { return db.existsByPath(root + "/Bee/C/three.wav"); }) ||
+                db.existsByPath(root + "/B/C/three.wav")) {
+                std::cerr << "Directory rename not applied" << std::endl;
+                rc = 5;
+            }
+            // ... und der Watch folgt dem Verzeichnis
+            writeFile(root + "/Bee/C/four.mp3", "four");
+            if (!waitFor([&]() { return db.existsByPath(root + "/Bee/C/four.mp3"); })) {
+                std::cerr << "Watch lost after directory rename" << std::endl;
+                rc = 6;
+            }
+
+            // Überschreiben bzw. Löschen + Neuanlegen im Debounce-Fenster: neuer Hash, gleiche ID
+            auto hashOf = [&](const std::string& path) {
+                MediaDatabase::MediaQuery hashQuery;
+                hashQuery.columns = MediaDatabase::ColUsage;
+                hashQuery.where = "filepath = ?";
+                hashQuery.params = {path};
+                auto rows = db.getPage(hashQuery);
+                return rows.empty() ? std::string() : rows[0].fileHash;
+            };
+            std::string oldHash = hashOf(root + "/A/zwei.mp3");
+            fs::remove(root + "/A/zwei.mp3");
+            writeFile(root + "/A/zwei.mp3", "zwei, neu");
+            if (!waitFor([&]() { return !oldHash.empty() && hashOf(root + "/A/zwei.mp3") != oldHash; }) ||
+                hashOf(root + "/A/zwei.mp3").empty() || db.queryIds(query) != before) {
+                std::cerr << "Recreated file kept stale hash" << std::endl;
+                rc = 9;
+            }
+            std::string newHash = hashOf(root + "/A/zwei.mp3");
+            writeFile(root + "/A/zwei.mp3", "zwei, überschrieben");
+            if (!waitFor([&]() { return hashOf(root + "/A/zwei.mp3") != newHash; }) || db.getTotalCount() != 4) {
+                std::cerr << "Overwritten file kept stale hash" << std::endl;
+                rc = 10;
+            }
+
+            // Löschen
+            fs::remove(root + "/A/one.mp3");
+            fs::remove_all(root + "/Bee");
+            if (!waitFor([&]() { return db.getTotalCount() == 1; }) || !db.existsByPath(root + "/A/zwei.mp3")) {
+                std::cerr << "Delete events not applied: " << db.getTotalCount() << std::endl;
+                rc = 7;
+            }
+            watcher.stop();
+        }
+
+        // Änderungen während der Watcher nicht läuft: Journal-Abgleich beim Start
+        writeFile(root + "/A/five.mp3", "five");
+        fs::remove(root + "/A/zwei.mp3");
+        fs::create_directories(root + "/D");
+        writeFile(root + "/D/six.mp3", "six");
+        {
+            LibraryWatcher watcher(db, root, options);
+            watcher.start();
+            if (!waitFor([&]() {
+                    return db.existsByPath(root + "/A/five.mp3") && db.existsByPath(root + "/D/six.mp3") &&
+                           !db.existsByPath(root + "/A/zwei.mp3");
+                })) {
+                std::cerr << "Offline changes not reconciled" << std::endl;
+                rc = 8;
+            }
+        }
+    }
+
+    fs::remove_all(dir);
+    if (rc == 0) std::cout << "Library watcher tests passed." << std::endl;
+    return rc;
+}
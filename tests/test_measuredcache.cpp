@@ -0,0 +1,164 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+#include "../include/MeasuredLengthCache.h"
+
+namespace {
+
+std::string sidPath(size_t i) {
+    return "/hvsc/C64Music/MUSICIANS/T/Tester_" + std::to_string(i % 31) + "/Tune_" + std::to_string(i) + ".sid";
+}
+
+} // namespace
+
+int main() {
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_measuredcache_test_" + std::to_string(getpid());
+    std::filesystem::create_directories(dir);
+    std::string logPath = dir + "/measured_lengths.bin";
+    int rc = 0;
+
+    const size_t threads = 8;
+    const size_t perThread = 5000;
+    {
+        MeasuredLengthCache cache(logPath, 16);
+
+        // Schreiber und Leser gleichzeitig: jeder Thread trägt eigene Schlüssel
+        // ein und liest dabei fremde, gelesene Werte sind nie halb geschrieben
+        std::vector<std::thread> workers;
+        std::vector<int> errors(threads, 0);
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                for (size_t i = 0; i < perThread; ++i) {
+                    size_t id = t * perThread + i;
+                    cache.put(sidPath(id), 1 + static_cast<int>(id % 3), 60 + static_cast<int>(id % 500));
+                    size_t other = ((t + 1) % threads) * perThread + i;
+                    int seen = cache.get(sidPath(other), 1 + static_cast<int>(other % 3));
+                    if (seen != 0 && seen != 60 + static_cast<int>(other % 500)) errors[t]++;
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        for (int e : errors) {
+            if (e > 0) {
+                std::cerr << "Torn or wrong concurrent read" << std::endl;
+                rc = 1;
+            }
+        }
+        if (cache.size() != threads * perThread) {
+            std::cerr << "Wrong size: " << cache.size() << std::endl;
+            rc = 2;
+        }
+
+        cache.erase(sidPath(7), 1 + 7 % 3);
+        cache.put(sidPath(8), 1 + 8 % 3, 999);
+        if (cache.get(sidPath(7), 1 + 7 % 3) != 0 || cache.get(sidPath(8), 1 + 8 % 3) != 999 ||
+            cache.get(sidPath(8), 4) != 0) {
+            std::cerr << "Erase/overwrite failed" << std::endl;
+            rc = 3;
+        }
+    }
+
+    // Neu laden: Log liefert denselben Stand
+    {
+        MeasuredLengthCache cache(logPath);
+        if (cache.size() != threads * perThread - 1) {
+            std::cerr << "Reload size: " << cache.size() << std::endl;
+            rc = 4;
+        }
+        for (size_t id = 0; id < threads * perThread; ++id) {
+            int expected = id == 7 ? 0 : id == 8 ? 999 : 60 + static_cast<int>(id % 500);
+            if (cache.get(sidPath(id), 1 + static_cast<int>(id % 3)) != expected) {
+                std::cerr << "Reload mismatch at " << id << std::endl;
+                rc = 5;
+                break;
+            }
+        }
+
+        // Viele Überschreibungen: Log wird periodisch verdichtet
+        for (int round = 0; round < 10; ++round) {
+            for (size_t id = 0; id < 2000; ++id) cache.put(sidPath(id), 1 + static_cast<int>(id % 3), 100 + round);
+        }
+    }
+    size_t expectedBytes = 8 + (threads * perThread - 1) * 16;
+    size_t logBytes = std::filesystem::file_size(logPath);
+    if (logBytes > 2 * expectedBytes + 1100 * 16) {
+        std::cerr << "Log not compacted: " << logBytes << " bytes" << std::endl;
+        rc = 6;
+    }
+
+    // Abgeschnittener letzter Record (Absturz beim Anhängen) wird ignoriert
+    {
+        std::ofstream out(logPath, std::ios::binary | std::ios::app);
+        out.write("\x01\x02\x03", 3);
+    }
+    {
+        MeasuredLengthCache cache(logPath);
+        if (cache.get(sidPath(5), 1 + 5 % 3) != 109 || cache.get(sidPath(2500), 1 + 2500 % 3) != 60 + 2500 % 500) {
+            std::cerr << "Reload after torn write failed" << std::endl;
+            rc = 7;
+        }
+        cache.put(sidPath(1), 1, 42);
+    }
+    {
+        MeasuredLengthCache cache(logPath);
+        if (cache.get(sidPath(1), 1) != 42) {
+            std::cerr << "Append after torn write lost" << std::endl;
+            rc = 8;
+        }
+    }
+
+    // put()/erase() desselben Schlüssels aus mehreren Threads: das Log muss
+    // die Reihenfolge der Tabelle haben, sonst lädt es einen überholten Wert
+    const std::string racePath = dir + "/race.bin";
+    for (int round = 0; round < 20 && rc == 0; ++round) {
+        std::filesystem::remove(racePath);
+        std::vector<int> expected(4);
+        {
+            MeasuredLengthCache cache(racePath);
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < 4; ++t) {
+                workers.emplace_back([&, t]() {
+                    for (int i = 0; i < 2000; ++i) {
+                        size_t key = (i / 7) % 4;
+                        if (i % 3 == 2) cache.erase(sidPath(key), 1);
+                        else cache.put(sidPath(key), 1, 1 + static_cast<int>(t) * 1000 + i % 1000);
+                    }
+                });
+            }
+            for (auto& worker : workers) worker.join();
+            for (size_t key = 0; key < 4; ++key) expected[key] = cache.get(sidPath(key), 1);
+        }
+        MeasuredLengthCache cache(racePath);
+        for (size_t key = 0; key < 4; ++key) {
+            if (cache.get(sidPath(key), 1) != expected[key]) {
+                std::cerr << "Reload restored stale value: " << cache.get(sidPath(key), 1) << " instead of "
+                          << expected[key] << std::endl;
+                rc = 10;
+            }
+        }
+    }
+
+    // Altes Textformat übernehmen
+    {
+        std::ofstream text(dir + "/measured_lengths.cache");
+        text << "/music/a.sid:1=180\n/music/b:c.sid:2=90\nbroken line\n";
+    }
+    {
+        MeasuredLengthCache cache("");
+        if (cache.importText(dir + "/measured_lengths.cache") != 2 || cache.get("/music/a.sid", 1) != 180 ||
+            cache.get("/music/b:c.sid", 2) != 90) {
+            std::cerr << "Text import failed" << std::endl;
+            rc = 9;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    if (rc == 0) std::cout << "Measured length cache tests passed." << std::endl;
+    return rc;
+}
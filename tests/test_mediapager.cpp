@@ -0,0 +1,97 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+#include "../include/MediaPager.h"
+
+int main() {
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_pager_test_" + std::to_string(getpid());
+    std::filesystem::create_directories(dir);
+    int rc = 0;
+
+    {
+        MediaDatabase db(dir + "/media.db");
+        if (!db.initialize()) return 1;
+
+        const size_t total = 5000;
+        std::vector<MediaMetadata> items;
+        for (size_t i = 0; i < total; ++i) {
+            MediaMetadata meta;
+            char title[32];
+            std::snprintf(title, sizeof(title), "Track %05zu", i);
+            meta.filepath = "/music/" + std::to_string(i) + ".sid";
+            meta.title = title;
+            meta.artist = i % 2 ? "Rob Hubbard" : "Martin Galway";
+            meta.genre = "SID";
+            items.push_back(meta);
+        }
+        db.addMediaBatch(items);
+
+        MediaPager pager(db, MediaDatabase::ColTags);
+        MediaDatabase::MediaQuery query;
+        query.orderBy = "title DESC";
+        query.limit = 10;  // wird ignoriert
+        pager.setQuery(query);
+
+        // Kein Limit mehr: alle Treffer, Reihenfolge wie die SQL-Sortierung
+        if (pager.size() != total) {
+            std::cerr << "Size mismatch: " << pager.size() << std::endl;
+            rc = 2;
+        }
+        const MediaMetadata* first = pager.at(0);
+        if (!first || first->title != "Track 04999" || pager.at(total) != nullptr) {
+            std::cerr << "Order/bounds mismatch" << std::endl;
+            rc = 3;
+        }
+
+        // Nur sichtbare Seiten werden geladen, der Cache bleibt begrenzt
+        size_t loadsBefore = pager.pageLoads();
+        pager.prefetch(1000, 1050);
+        for (size_t i = 1000; i < 1050; ++i) {
+            const MediaMetadata* meta = pager.at(i);
+            if (!meta || meta->title != items[total - 1 - i].title || meta->artist != items[total - 1 - i].artist) {
+                std::cerr << "Row mismatch at " << i << std::endl;
+                rc = 4;
+                break;
+            }
+        }
+        if (pager.pageLoads() - loadsBefore != 1) {
+            std::cerr << "Unexpected page loads: " << pager.pageLoads() - loadsBefore << std::endl;
+            rc = 5;
+        }
+        for (size_t i = 0; i < total; i += MediaPager::kPageSize) pager.at(i);
+        if (pager.pageLoads() > total / MediaPager::kPageSize + 3) {
+            std::cerr << "Pages reloaded too often" << std::endl;
+            rc = 6;
+        }
+
+        // Filter + Volltext; gelöschte Zeilen liefern nullptr bis refresh()
+        MediaDatabase::MediaQuery hubbard;
+        hubbard.search = "hubbard";
+        hubbard.orderBy = "title ASC";
+        pager.setQuery(hubbard);
+        if (pager.size() != total / 2 || pager.at(0)->title != "Track 00001") {
+            std::cerr << "Search mismatch" << std::endl;
+            rc = 7;
+        }
+        db.deleteMedia(pager.idAt(300));
+        pager.invalidateRows();
+        if (pager.at(300) != nullptr || !pager.at(301)) {
+            std::cerr << "Deleted row not skipped" << std::endl;
+            rc = 8;
+        }
+        pager.refresh();
+        if (pager.size() != total / 2 - 1) {
+            std::cerr << "Refresh mismatch" << std::endl;
+            rc = 9;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    if (rc == 0) std::cout << "Media pager test passed" << std::endl;
+    return rc;
+}
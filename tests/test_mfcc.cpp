@@ -0,0 +1,74 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <complex>
+#include "../include/MFCCKernel.h"
+
+int main() {
+    std::cout << "SIMD-Backend: " << simd::backendName() << std::endl;
+
+    // dot() gegen skalare Referenz (ungerade Länge für den Rest-Pfad)
+    const size_t n = 1027;
+    std::vector<float> a(n), b(n);
+    double reference = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = std::sin(0.01f * i);
+        b[i] = std::cos(0.02f * i);
+        reference += static_cast<double>(a[i]) * b[i];
+    }
+    float result = simd::dot(a.data(), b.data(), n);
+    if (std::abs(result - reference) > 1e-3) {
+        std::cerr << "dot mismatch: " << result << " != " << reference << std::endl;
+        return 1;
+    }
+
+    // complexPower() gegen std::norm / std::abs
+    std::vector<std::complex<float>> bins(n);
+    for (size_t i = 0; i < n; ++i) bins[i] = {std::sin(0.3f * i), std::cos(0.7f * i) * 2.0f};
+    std::vector<float> power(n), magnitude(n);
+    simd::complexPower(bins.data(), power.data(), magnitude.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        if (std::abs(power[i] - std::norm(bins[i])) > 1e-4f ||
+            std::abs(magnitude[i] - std::abs(bins[i])) > 1e-4f) {
+            std::cerr << "complexPower mismatch at bin " << i << std::endl;
+            return 2;
+        }
+    }
+
+    // Filterbank: jeder Filter hat Gewichte, Sinus landet im passenden Filter
+    const int sampleRate = 44100;
+    const size_t fftSize = 2048;
+    MelFilterbank bank(sampleRate, fftSize, 26);
+    if (bank.numFilters() != 26 || bank.numBins() != fftSize / 2 + 1) {
+        std::cerr << "Unexpected filterbank shape" << std::endl;
+        return 3;
+    }
+    std::vector<float> spectrum(bank.numBins(), 0.0f);
+    size_t toneBin = static_cast<size_t>(1000.0f * fftSize / sampleRate);
+    spectrum[toneBin] = 1.0f;
+    std::vector<float> mel(26);
+    bank.apply(spectrum.data(), mel.data());
+    size_t peak = 0;
+    for (size_t m = 1; m < mel.size(); ++m) if (mel[m] > mel[peak]) peak = m;
+    float peakHz = MelFilterbank::melToHz(
+        MelFilterbank::hzToMel(20.0f) +
+        (MelFilterbank::hzToMel(sampleRate * 0.5f) - MelFilterbank::hzToMel(20.0f)) * (peak + 1) / 27.0f);
+    if (mel[peak] <= 0.0f || std::abs(peakHz - 1000.0f) > 250.0f) {
+        std::cerr << "1 kHz tone peaked in filter " << peak << " (" << peakHz << " Hz)" << std::endl;
+        return 4;
+    }
+
+    // DCT eines konstanten log-Mel-Spektrums: nur c0 != 0
+    MFCCKernel kernel(26, 13);
+    std::vector<float> flat(26, 1.0f), mfcc(13);
+    kernel.compute(flat.data(), mfcc.data());
+    for (size_t i = 1; i < mfcc.size(); ++i) {
+        if (std::abs(mfcc[i]) > 1e-4f) {
+            std::cerr << "DCT leak into c" << i << ": " << mfcc[i] << std::endl;
+            return 5;
+        }
+    }
+
+    std::cout << "MFCC kernel test passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+#include <lame/lame.h>
+#include "../include/MP3EncoderPool.h"
+
+namespace {
+
+const int kSampleRate = 44100;
+const int kChannels = 2;
+const int kBitrate = 192;
+
+// Pro Stream eigenes Signal (Frequenz + Rampe), damit vertauschte Blöcke auffallen
+std::vector<int16_t> signal(size_t stream, size_t frames) {
+    std::vector<int16_t> pcm(frames * kChannels);
+    const double frequency = 220.0 * (stream + 1);
+    for (size_t i = 0; i < frames; ++i) {
+        double tone = std::sin(2.0 * M_PI * frequency * i / kSampleRate);
+        double ramp = static_cast<double>(i) / frames;
+        pcm[i * kChannels] = static_cast<int16_t>(12000.0 * tone);
+        pcm[i * kChannels + 1] = static_cast<int16_t>(12000.0 * tone * ramp);
+    }
+    return pcm;
+}
+
+// Referenz: derselbe LAME-Aufruf im Test-Thread, blockweise wie der Pool
+std::vector<unsigned char> encodeDirect(const std::vector<int16_t>& pcm) {
+    lame_t lame = lame_init();
+    lame_set_in_samplerate(lame, kSampleRate);
+    lame_set_num_channels(lame, kChannels);
+    lame_set_brate(lame, kBitrate);
+    lame_set_quality(lame, 5);
+    lame_init_params(lame);
+
+    std::vector<unsigned char> out;
+    std::vector<unsigned char> buffer(MP3EncoderPool::kBlockFrames * 5 / 4 + 7200);
+    const size_t frames = pcm.size() / kChannels;
+    for (size_t start = 0; start < frames; start += MP3EncoderPool::kBlockFrames) {
+        size_t count = std::min(MP3EncoderPool::kBlockFrames, frames - start);
+        int bytes = lame_encode_buffer_interleaved(lame, const_cast<short*>(pcm.data() + start * kChannels),
+                                                   static_cast<int>(count), buffer.data(),
+                                                   static_cast<int>(buffer.size()));
+        if (bytes > 0) out.insert(out.end(), buffer.begin(), buffer.begin() + bytes);
+    }
+    int bytes = lame_encode_flush(lame, buffer.data(), static_cast<int>(buffer.size()));
+    if (bytes > 0) out.insert(out.end(), buffer.begin(), buffer.begin() + bytes);
+    lame_close(lame);
+    return out;
+}
+
+std::vector<unsigned char> readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+int main() {
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_mp3pool_test_" + std::to_string(getpid());
+    std::filesystem::create_directories(dir);
+    int rc = 0;
+
+    // 6 Emulator-Threads auf 2 Encodern, kleiner Ring erzwingt Backpressure.
+    // Krumme Push-Größen und Längen: Blöcke werden über Push-Grenzen gefüllt,
+    // der letzte Block ist nur teilweise voll.
+    const size_t streams = 6;
+    std::vector<std::vector<int16_t>> inputs;
+    uint64_t totalFrames = 0;
+    for (size_t s = 0; s < streams; ++s) {
+        inputs.push_back(signal(s, 20 * MP3EncoderPool::kBlockFrames + 777 * (s + 1)));
+        totalFrames += inputs.back().size() / kChannels;
+    }
+
+    {
+        MP3EncoderPool pool(2, 4);
+        std::vector<int> results(streams, -1);
+        std::vector<std::thread> producers;
+        for (size_t s = 0; s < streams; ++s) {
+            producers.emplace_back([&, s] {
+                auto stream = pool.open(dir + "/" + std::to_string(s) + ".mp3", kSampleRate, kChannels, kBitrate);
+                if (!stream) return;
+                const std::vector<int16_t>& pcm = inputs[s];
+                const size_t frames = pcm.size() / kChannels;
+                const size_t chunk = 1000 + 313 * s;
+                for (size_t start = 0; start < frames; start += chunk) {
+                    size_t count = std::min(chunk, frames - start);
+                    if (!pool.push(*stream, pcm.data() + start * kChannels, count)) return;
+                }
+                results[s] = pool.finish(*stream) ? 1 : 0;
+            });
+        }
+        for (auto& producer : producers) producer.join();
+
+        for (size_t s = 0; s < streams; ++s) {
+            if (results[s] != 1) {
+                std::cerr << "Stream " << s << " failed" << std::endl;
+                rc = 2;
+                continue;
+            }
+            // Byte-identisch zur sequentiellen Kodierung: Reihenfolge pro Stream erhalten
+            std::vector<unsigned char> expected = encodeDirect(inputs[s]);
+            std::vector<unsigned char> actual = readFile(dir + "/" + std::to_string(s) + ".mp3");
+            if (expected.empty() || actual != expected) {
+                std::cerr << "Stream " << s << " output differs (" << actual.size() << " vs "
+                          << expected.size() << " bytes)" << std::endl;
+                rc = 3;
+            }
+        }
+
+        MP3EncoderPool::Metrics metrics = pool.metrics();
+        if (metrics.streams != streams || metrics.framesPushed != totalFrames ||
+            metrics.framesEncoded != totalFrames || metrics.encoderBusySeconds <= 0.0) {
+            std::cerr << "Metrics wrong: " << metrics.framesPushed << " pushed, " << metrics.framesEncoded
+                      << " encoded of " << totalFrames << std::endl;
+            rc = 4;
+        }
+        pool.printMetrics("MP3-Pool-Test");
+    }
+
+    // Nicht beschreibbarer Pfad: open() meldet den Fehler statt eines Streams
+    {
+        MP3EncoderPool pool(1);
+        if (pool.open(dir + "/missing/out.mp3", kSampleRate, kChannels, kBitrate)) {
+            std::cerr << "Open succeeded on missing directory" << std::endl;
+            rc = 5;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    if (rc == 0) std::cout << "MP3 encoder pool tests passed." << std::endl;
+    return rc;
+}
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+#include "../include/SIDRenderCache.h"
+
+int main() {
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_rendercache_test_" + std::to_string(getpid());
+    int rc = 0;
+
+    {
+        const int channels = 2;
+        const int rate = 44100;
+        SIDRenderCache cache(dir, 3 * rate * channels * sizeof(int16_t) * 10);  // ~30 s Budget
+
+        std::vector<int16_t> pcm(10 * rate * channels);
+        for (size_t i = 0; i < pcm.size(); ++i) pcm[i] = static_cast<int16_t>(i * 7);
+
+        std::string key = SIDRenderCache::makeKey("0123456789abcdef0123456789abcdef", 2, "settings-a");
+        if (key == SIDRenderCache::makeKey("0123456789abcdef0123456789abcdef", 2, "settings-b") ||
+            key == SIDRenderCache::makeKey("0123456789abcdef0123456789abcdef", 3, "settings-a")) {
+            std::cerr << "Key does not separate subtune/settings" << std::endl;
+            rc = 1;
+        }
+
+        std::vector<int16_t> loaded;
+        if (cache.load(key, rate, channels, rate, loaded)) {
+            std::cerr << "Unexpected hit on empty cache" << std::endl;
+            rc = 2;
+        }
+        cache.store(key, pcm, channels, rate);
+
+        // Kürzere Anfrage wird aus dem längeren Eintrag bedient, längere nicht
+        if (!cache.load(key, 5 * rate, channels, rate, loaded) || loaded.size() != 5u * rate * channels ||
+            loaded[12345] != pcm[12345]) {
+            std::cerr << "Prefix load failed" << std::endl;
+            rc = 3;
+        }
+        if (cache.load(key, 20 * rate, channels, rate, loaded) || cache.load(key, rate, 1, rate, loaded)) {
+            std::cerr << "Longer/mismatching request must miss" << std::endl;
+            rc = 4;
+        }
+
+        // Kürzere Aufnahme ersetzt die längere nicht
+        std::vector<int16_t> shorter(pcm.begin(), pcm.begin() + rate * channels);
+        cache.store(key, shorter, channels, rate);
+        if (!cache.load(key, 10 * rate, channels, rate, loaded)) {
+            std::cerr << "Longer entry was replaced" << std::endl;
+            rc = 5;
+        }
+
+        // Budget überschritten: älteste Einträge fliegen raus, der neueste bleibt
+        for (int sub = 10; sub < 14; ++sub) {
+            cache.store(SIDRenderCache::makeKey("fedcba9876543210fedcba9876543210", sub, "settings-a"), pcm, channels, rate);
+        }
+        cache.prune();
+        if (cache.load(key, rate, channels, rate, loaded) ||
+            !cache.load(SIDRenderCache::makeKey("fedcba9876543210fedcba9876543210", 13, "settings-a"), rate, channels, rate, loaded)) {
+            std::cerr << "Prune did not evict least recently used entries" << std::endl;
+            rc = 6;
+        }
+
+        // Blockweise schreiben und lesen (konstanter Speicher), ohne commit() kein Eintrag
+        std::string streamKey = SIDRenderCache::makeKey("00112233445566778899aabbccddeeff", 1, "settings-a");
+        {
+            SIDRenderCache::Writer aborted(cache, streamKey, channels, rate);
+            aborted.append(pcm.data(), rate);
+        }
+        if (cache.load(streamKey, 1, channels, rate, loaded)) {
+            std::cerr << "Uncommitted writer left an entry" << std::endl;
+            rc = 7;
+        }
+        {
+            SIDRenderCache::Writer writer(cache, streamKey, channels, rate);
+            const size_t total = pcm.size() / channels;
+            for (size_t start = 0; start < total; start += 12345) {
+                writer.append(pcm.data() + start * channels, std::min<size_t>(12345, total - start));
+            }
+            if (!writer.commit() || writer.frames() != total) rc = 8;
+        }
+        size_t blocks = 0;
+        size_t position = 0;
+        bool same = cache.read(streamKey, 4 * rate, channels, rate, [&](const int16_t* block, size_t frames) {
+            blocks++;
+            for (size_t i = 0; i < frames * channels; ++i) {
+                if (block[i] != pcm[position + i]) return false;
+            }
+            position += frames * channels;
+            return true;
+        }, 1000);
+        if (rc == 8 || !same || position != 4u * rate * channels || blocks != (4u * rate + 999) / 1000) {
+            std::cerr << "Streamed entry differs" << std::endl;
+            rc = 8;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    if (rc == 0) std::cout << "Render cache test passed" << std::endl;
+    return rc;
+}
@@ -0,0 +1,133 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "../include/RenderGraph.h"
+
+using namespace SongGen;
+
+namespace {
+
+// Ein Ton (Rampe 0..1) alle interval Frames, jeweils length Frames lang
+class PulseNode : public VoiceNode {
+public:
+    PulseNode(uint64_t interval, size_t length, float gain, size_t* maxVoices)
+        : interval_(interval), length_(length), gain_(gain), maxVoices_(maxVoices) {}
+
+    static float sampleAt(size_t i, size_t length) { return static_cast<float>(i + 1) / length; }
+
+protected:
+    bool advance() override {
+        *maxVoices_ = std::max(*maxVoices_, activeVoices() + 1);
+        std::vector<float> samples(length_);
+        for (size_t i = 0; i < length_; ++i) samples[i] = sampleAt(i, length_);
+        play(cursor_, std::move(samples), gain_);
+        cursor_ += interval_;
+        return true;
+    }
+
+private:
+    uint64_t interval_;
+    size_t length_;
+    float gain_;
+    size_t* maxVoices_;
+};
+
+class HalfGain : public AudioEffect {
+public:
+    void process(std::vector<float>& buffer, float) override {
+        for (float& sample : buffer) sample *= 0.5f;
+    }
+    void reset() override {}
+};
+
+// Referenz: alle Pulse direkt in einen Gesamtpuffer gemischt
+std::vector<float> reference(uint64_t frames, uint64_t interval, size_t length, float gain) {
+    std::vector<float> out(frames, 0.0f);
+    for (uint64_t start = 0; start < frames; start += interval) {
+        for (size_t i = 0; i < length && start + i < frames; ++i) {
+            out[start + i] += PulseNode::sampleAt(i, length) * gain;
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+int main() {
+    int rc = 0;
+    const int sampleRate = 44100;
+
+    // 1. Ohne Limiter und Fade-In: blockweises Ergebnis == Gesamtpuffer (Voices über Blockgrenzen)
+    {
+        const uint64_t frames = 10 * sampleRate + 123;
+        size_t maxVoices = 0;
+        RenderGraph graph(sampleRate);
+        graph.peakTarget = 1000.0f;
+        graph.maxGain = 1.0f;
+        graph.fadeInSeconds = 0.0f;
+        graph.addSource(std::make_unique<PulseNode>(300, 1000, 0.25f, &maxVoices));
+        graph.effects().addEffect(std::make_shared<HalfGain>());
+
+        std::vector<float> output;
+        size_t blocks = 0;
+        bool sizesOk = true;
+        float lastProgress = 0.0f;
+        bool ok = graph.render(frames, [&](const std::vector<float>& block) {
+            blocks++;
+            if (block.size() != RenderGraph::kBlockFrames && output.size() + block.size() != frames) sizesOk = false;
+            output.insert(output.end(), block.begin(), block.end());
+            return true;
+        }, [&](float fraction) { lastProgress = fraction; });
+
+        std::vector<float> expected = reference(frames, 300, 1000, 0.125f);
+        float maxError = 0.0f;
+        for (size_t i = 0; i < std::min(output.size(), expected.size()); ++i) {
+            maxError = std::max(maxError, std::abs(output[i] - expected[i]));
+        }
+        if (!ok || output.size() != frames || !sizesOk || maxError > 1e-5f || lastProgress != 1.0f) {
+            std::cerr << "Block render mismatch (max error " << maxError << ", " << output.size() << " frames)"
+                      << std::endl;
+            rc = 2;
+        }
+        // Gespielte Voices werden nach jedem Block verworfen: höchstens (1000 + 512) / 300 + 1 gleichzeitig
+        if (maxVoices > 6 || blocks != (frames + RenderGraph::kBlockFrames - 1) / RenderGraph::kBlockFrames) {
+            std::cerr << "Unexpected voice count " << maxVoices << " or block count " << blocks << std::endl;
+            rc = 3;
+        }
+    }
+
+    // 2. Limiter: lauter Einsatz mitten im Song überschreitet peakTarget nie, Fade-In beginnt bei 0
+    {
+        size_t maxVoices = 0;
+        RenderGraph graph(sampleRate);
+        graph.addSource(std::make_unique<PulseNode>(5000, 20000, 3.0f, &maxVoices));
+        std::vector<float> output;
+        graph.render(5 * sampleRate, [&](const std::vector<float>& block) {
+            output.insert(output.end(), block.begin(), block.end());
+            return true;
+        });
+        float peak = 0.0f;
+        for (float sample : output) peak = std::max(peak, std::abs(sample));
+        if (peak > graph.peakTarget + 1e-4f || peak < 0.5f || output[0] != 0.0f ||
+            std::abs(graph.outputPeak() - peak) > 1e-6f) {
+            std::cerr << "Limiter failed: peak " << peak << std::endl;
+            rc = 4;
+        }
+    }
+
+    // 3. Abbruch durch den Sink
+    {
+        size_t maxVoices = 0;
+        RenderGraph graph(sampleRate);
+        graph.addSource(std::make_unique<PulseNode>(300, 1000, 0.25f, &maxVoices));
+        size_t blocks = 0;
+        if (graph.render(sampleRate, [&](const std::vector<float>&) { return ++blocks < 3; }) || blocks != 3) {
+            std::cerr << "Sink abort ignored" << std::endl;
+            rc = 5;
+        }
+    }
+
+    if (rc == 0) std::cout << "Render graph tests passed." << std::endl;
+    return rc;
+}
@@ -0,0 +1,270 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <curl/curl.h>
+#include "../include/SegmentedDownloader.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Minimaler HTTP/1.1-Server auf 127.0.0.1 als Mirror-Ersatz (ein Thread pro Verbindung)
+class LocalHttpServer {
+public:
+    explicit LocalHttpServer(const std::string& body) : body_(body) {
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listenFd_, 64);
+        socklen_t length = sizeof(addr);
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &length);
+        port_ = ntohs(addr.sin_port);
+        acceptThread_ = std::thread([this] { acceptLoop(); });
+    }
+
+    ~LocalHttpServer() {
+        ::shutdown(listenFd_, SHUT_RDWR);
+        ::close(listenFd_);
+        acceptThread_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& worker : workers_) worker.join();
+    }
+
+    std::string url(const std::string& path = "/file.zip") const {
+        return "http://127.0.0.1:" + std::to_string(port_) + path;
+    }
+
+    std::atomic<bool> ranges{true};
+    std::atomic<long long> budget{-1};      // Verbleibende Body-Bytes insgesamt, -1 = unbegrenzt
+    std::atomic<int> rangeRequests{0};
+
+    void setEtag(const std::string& etag) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        etag_ = etag;
+    }
+
+private:
+    std::string body_;
+    std::string etag_ = "\"v1\"";
+    int listenFd_ = -1;
+    int port_ = 0;
+    std::thread acceptThread_;
+    std::mutex mutex_;
+    std::vector<std::thread> workers_;
+
+    void acceptLoop() {
+        while (true) {
+            int fd = ::accept(listenFd_, nullptr, nullptr);
+            if (fd < 0) return;
+            std::lock_guard<std::mutex> lock(mutex_);
+            workers_.emplace_back([this, fd] { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string request;
+        char buffer[4096];
+        while (request.find("\r\n\r\n") == std::string::npos) {
+            ssize_t bytes = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (bytes <= 0) {
+                ::close(fd);
+                return;
+            }
+            request.append(buffer, static_cast<size_t>(bytes));
+        }
+
+        size_t first = 0;
+        size_t last = body_.size() - 1;
+        bool partial = false;
+        size_t rangePos = request.find("Range: bytes=");
+        if (ranges && rangePos != std::string::npos) {
+            partial = true;
+            rangeRequests++;
+            char* end = nullptr;
+            first = std::strtoull(request.c_str() + rangePos + 13, &end, 10);
+            if (end && *end == '-' && std::isdigit(static_cast<unsigned char>(end[1]))) {
+                last = std::min<size_t>(last, std::strtoull(end + 1, nullptr, 10));
+            }
+        }
+
+        std::string header = partial ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+        header += "Content-Length: " + std::to_string(last - first + 1) + "\r\n";
+        if (partial) {
+            header += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" +
+                      std::to_string(body_.size()) + "\r\n";
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            header += "ETag: " + etag_;
+        }
+        header += "\r\nConnection: close\r\n\r\n";
+        sendAll(fd, header.data(), header.size());
+
+        bool head = request.compare(0, 5, "HEAD ") == 0;
+        for (size_t offset = first; !head && offset <= last;) {
+            size_t chunk = std::min<size_t>(16 * 1024, last - offset + 1);
+            long long left = budget.load();
+            while (left > 0 && !budget.compare_exchange_weak(
+                                   left, left - static_cast<long long>(std::min<size_t>(chunk, left)))) {
+            }
+            if (left == 0) break;
+            if (left > 0) chunk = std::min<size_t>(chunk, static_cast<size_t>(left));
+            if (!sendAll(fd, body_.data() + offset, chunk)) break;
+            offset += chunk;
+        }
+        ::shutdown(fd, SHUT_RDWR);
+        ::close(fd);
+    }
+
+    static bool sendAll(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+            if (sent <= 0) return false;
+            data += sent;
+            size -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+};
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+int main() {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_download_test_" + std::to_string(getpid());
+    fs::create_directories(dir);
+    int rc = 0;
+
+    std::string body(5 * 1024 * 1024 + 123, '\0');
+    uint32_t seed = 12345;
+    for (auto& c : body) {
+        seed = seed * 1664525u + 1013904223u;
+        c = static_cast<char>(seed >> 24);
+    }
+    std::ofstream(dir + "/source.bin", std::ios::binary) << body;
+    const std::string bodySha = SegmentedDownloader::sha256File(dir + "/source.bin");
+
+    {
+        LocalHttpServer server(body);
+        SegmentedDownloader::Options options;
+        options.segments = 4;
+        options.minSegmentSize = 256 * 1024;
+        options.progressIntervalMs = 0;
+
+        // 1. Segmentierter Download mit Prüfsumme
+        size_t progressCalls = 0;
+        uint64_t lastDone = 0;
+        options.expectedSha256 = bodySha;
+        options.onProgress = [&](const SegmentedDownloader::Progress& p) {
+            progressCalls++;
+            lastDone = p.bytesDone;
+        };
+        SegmentedDownloader downloader(options);
+        std::string target = dir + "/full.zip";
+        if (!downloader.download(server.url(), target) || readFile(target) != body ||
+            downloader.sha256() != bodySha) {
+            std::cerr << "Segmented download failed: " << downloader.error() << std::endl;
+            rc = 2;
+        }
+        if (server.rangeRequests < 5 || progressCalls == 0 || lastDone != body.size() ||
+            fs::exists(target + ".part") || fs::exists(target + ".part.state")) {
+            std::cerr << "Unexpected segmentation (" << server.rangeRequests << " range requests)" << std::endl;
+            rc = 3;
+        }
+        options.onProgress = nullptr;
+
+        // 2. Abbruch nach ~2 MB, dann Fortsetzen
+        server.budget = 2 * 1024 * 1024;
+        options.maxRetries = 1;
+        SegmentedDownloader interrupted(options);
+        std::string resumeTarget = dir + "/resume.zip";
+        if (interrupted.download(server.url(), resumeTarget) || !fs::exists(resumeTarget + ".part.state")) {
+            std::cerr << "Interrupted download did not leave a resumable state" << std::endl;
+            rc = 4;
+        }
+        server.budget = -1;
+        SegmentedDownloader resumed(options);
+        if (!resumed.download(server.url(), resumeTarget) || readFile(resumeTarget) != body ||
+            resumed.resumedBytes() < 1024 * 1024) {
+            std::cerr << "Resume failed (" << resumed.resumedBytes() << " bytes resumed): " << resumed.error()
+                      << std::endl;
+            rc = 5;
+        }
+
+        // 3. Geänderte Datei auf dem Server (anderes ETag): kein Fortsetzen eines alten Stands
+        server.budget = 1024 * 1024;
+        SegmentedDownloader stale(options);
+        stale.download(server.url(), dir + "/stale.zip");
+        server.budget = -1;
+        server.setEtag("\"v2\"");
+        SegmentedDownloader fresh(options);
+        if (!fresh.download(server.url(), dir + "/stale.zip") || fresh.resumedBytes() != 0 ||
+            readFile(dir + "/stale.zip") != body) {
+            std::cerr << "Stale state was resumed" << std::endl;
+            rc = 6;
+        }
+
+        // 4. Falsche Prüfsumme: Fehler, kein Ziel, kein Rest
+        options.expectedSha256 = std::string(64, '0');
+        SegmentedDownloader mismatch(options);
+        std::string badTarget = dir + "/bad.zip";
+        if (mismatch.download(server.url(), badTarget) || fs::exists(badTarget) || fs::exists(badTarget + ".part")) {
+            std::cerr << "Checksum mismatch not detected" << std::endl;
+            rc = 7;
+        }
+        options.expectedSha256.clear();
+
+        // 5. Server ohne Range-Unterstützung: ein einzelner Transfer
+        server.ranges = false;
+        SegmentedDownloader single(options);
+        if (!single.download(server.url(), dir + "/single.zip") || readFile(dir + "/single.zip") != body) {
+            std::cerr << "Download without range support failed: " << single.error() << std::endl;
+            rc = 8;
+        }
+        server.ranges = true;
+
+        // 6. Mirror-Probe: erreichbarer und toter Server gleichzeitig
+        int deadFd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(deadFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        socklen_t length = sizeof(addr);
+        ::getsockname(deadFd, reinterpret_cast<sockaddr*>(&addr), &length);
+        std::string deadUrl = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/file.zip";
+        ::close(deadFd);
+
+        auto results = SegmentedDownloader::probe({server.url(), deadUrl}, 64 * 1024, 2000);
+        if (results.size() != 2 || !results[0].ok || results[0].bytes < 64 * 1024 ||
+            results[0].bytesPerSecond <= 0 || results[1].ok || results[1].url != deadUrl) {
+            std::cerr << "Unexpected probe results" << std::endl;
+            rc = 9;
+        }
+    }
+
+    fs::remove_all(dir);
+    curl_global_cleanup();
+    if (rc == 0) std::cout << "Segmented download tests passed." << std::endl;
+    return rc;
+}
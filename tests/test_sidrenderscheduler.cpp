@@ -0,0 +1,157 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include "../include/SIDRenderScheduler.h"
+
+namespace {
+
+SIDRenderScheduler::Job job(const std::string& name, int seconds) {
+    SIDRenderScheduler::Job entry;
+    entry.sidPath = "/music/" + name + ".sid";
+    entry.subtune = 1;
+    entry.outputPath = "/out/" + name + ".mp3";
+    entry.seconds = seconds;
+    return entry;
+}
+
+std::string names(const std::vector<std::string>& order) {
+    std::string joined;
+    for (const auto& name : order) joined += (joined.empty() ? "" : ",") + name;
+    return joined;
+}
+
+} // namespace
+
+int main() {
+    int rc = 0;
+
+    // 1. run(): Jobs mit bekannter Länge starten längste zuerst; der zuletzt
+    //    eingereichte Prioritäts-Job (längster) startet trotzdem als erster
+    {
+        SIDRenderScheduler scheduler(1);
+        scheduler.add(job("e", 40));
+        scheduler.add(job("b", 300));
+        scheduler.add(job("d", 60));
+        scheduler.add(job("a", 420));
+        scheduler.add(job("f", 5));
+        scheduler.add(job("c", 120));
+        scheduler.add(job("prio", 1200));
+
+        std::vector<std::string> started;
+        size_t done = scheduler.run([&](const SIDRenderScheduler::Job& entry, SIDLibConverter&, size_t) {
+            started.push_back(entry.outputPath.substr(5, entry.outputPath.size() - 9));
+            return true;
+        });
+        const std::string expected = "prio,a,b,c,d,e,f";
+        if (done != 7 || names(started) != expected) {
+            std::cerr << "LJF start order wrong: " << names(started) << " (expected " << expected << ")" << std::endl;
+            rc = 2;
+        }
+    }
+
+    // 2. Mehrere Worker: jeder Job genau einmal, die ersten Starts sind die längsten
+    {
+        SIDRenderScheduler scheduler(4);
+        for (int i = 0; i < 40; ++i) scheduler.add(job("s" + std::to_string(i), 10 + i % 7));
+        scheduler.add(job("prio", 1200));
+
+        std::mutex mutex;
+        std::vector<std::string> started;
+        std::atomic<size_t> reported(0);
+        size_t done = scheduler.run([&](const SIDRenderScheduler::Job& entry, SIDLibConverter&, size_t worker) {
+            if (worker >= 4) return false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                started.push_back(entry.outputPath);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            return true;
+        }, [&](size_t completed, size_t total) {
+            if (total == 41 && completed <= total) reported++;
+        });
+        bool prioEarly = false;
+        for (size_t i = 0; i < std::min<size_t>(4, started.size()); ++i) {
+            if (started[i] == "/out/prio.mp3") prioEarly = true;
+        }
+        if (done != 41 || started.size() != 41 || reported != 41 || !prioEarly) {
+            std::cerr << "Parallel run wrong: " << done << " done, " << reported << " reported" << std::endl;
+            rc = 3;
+        }
+    }
+
+    // 3. runStreaming(): ein während des Renderns nachgereichter langer Job
+    //    überholt die bereits wartenden kürzeren
+    {
+        SIDRenderScheduler scheduler(1);
+        scheduler.push(job("short", 10));
+        scheduler.push(job("long", 30));
+        scheduler.push(job("mid", 20));
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool firstStarted = false;
+        bool prioPushed = false;
+
+        std::thread producer([&] {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return firstStarted; });
+            lock.unlock();
+            scheduler.push(job("prio", 600));
+            lock.lock();
+            prioPushed = true;
+            cv.notify_all();
+            lock.unlock();
+            scheduler.close();
+        });
+
+        std::vector<std::string> started;
+        size_t done = scheduler.runStreaming([&](const SIDRenderScheduler::Job& entry, SIDLibConverter&, size_t) {
+            started.push_back(entry.outputPath.substr(5, entry.outputPath.size() - 9));
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!firstStarted) {
+                firstStarted = true;
+                cv.notify_all();
+                cv.wait(lock, [&] { return prioPushed; });
+            }
+            return true;
+        });
+        producer.join();
+
+        const std::string expected = "long,prio,mid,short";
+        if (done != 4 || names(started) != expected) {
+            std::cerr << "Streaming start order wrong: " << names(started) << " (expected " << expected << ")"
+                      << std::endl;
+            rc = 4;
+        }
+        if (scheduler.pushed() != 0) {
+            std::cerr << "Stream not reset after run" << std::endl;
+            rc = 5;
+        }
+    }
+
+    // 4. Unbekannte Länge: Planen schlägt nur nach, der Fallback greift (statt
+    //    der 180 s, die getTrackLength in den Mess-Cache schreiben würde)
+    {
+        SIDRenderScheduler scheduler(1);
+        scheduler.add("/music/unknown.sid", 0, "/out/unknown.mp3", 0, 77);
+        scheduler.add("/music/capped.sid", 2, "/out/capped.mp3", 30, 77);
+
+        std::vector<int> seconds;
+        scheduler.run([&](const SIDRenderScheduler::Job& entry, SIDLibConverter&, size_t) {
+            seconds.push_back(entry.seconds);
+            return true;
+        });
+        if (seconds.size() != 2 || seconds[0] != 77 || seconds[1] != 30) {
+            std::cerr << "Fallback length not applied" << std::endl;
+            rc = 6;
+        }
+    }
+
+    if (rc == 0) std::cout << "SID render scheduler tests passed." << std::endl;
+    return rc;
+}
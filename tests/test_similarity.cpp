@@ -0,0 +1,120 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include "../include/SimilarityIndex.h"
+
+int main() {
+    const size_t count = 20000;
+    const size_t dims = SimilarityIndex::kDimensions;
+    std::mt19937 gen(42);
+    std::normal_distribution<float> noise(0.0f, 0.1f);
+    std::uniform_real_distribution<float> center(-2.0f, 2.0f);
+
+    // Geclusterte Daten (wie Genres in einer Bibliothek)
+    std::vector<std::vector<float>> clusters(50, std::vector<float>(dims));
+    for (auto& c : clusters) for (auto& x : c) x = center(gen);
+
+    std::vector<std::vector<float>> data(count, std::vector<float>(dims));
+    SimilarityIndex index;
+    for (size_t i = 0; i < count; ++i) {
+        const auto& c = clusters[i % clusters.size()];
+        for (size_t d = 0; d < dims; ++d) data[i][d] = c[d] + noise(gen);
+        index.upsert(static_cast<int64_t>(i + 1), data[i]);
+    }
+    index.train();
+
+    if (index.size() != count) {
+        std::cerr << "Size mismatch: " << index.size() << std::endl;
+        return 1;
+    }
+
+    // Recall@10 gegen exakte Suche
+    const size_t k = 10, queries = 100;
+    size_t found = 0;
+    for (size_t q = 0; q < queries; ++q) {
+        const auto& query = data[q * 37];
+        std::vector<std::pair<float, int64_t>> exact;
+        for (size_t i = 0; i < count; ++i) {
+            float dist = 0.0f;
+            for (size_t d = 0; d < dims; ++d) dist += (query[d] - data[i][d]) * (query[d] - data[i][d]);
+            exact.push_back({dist, static_cast<int64_t>(i + 1)});
+        }
+        std::partial_sort(exact.begin(), exact.begin() + k, exact.end());
+
+        auto hits = index.search(query, k);
+        for (size_t i = 0; i < k; ++i) {
+            for (const auto& hit : hits) {
+                if (hit.id == exact[i].second) { found++; break; }
+            }
+        }
+    }
+    float recall = static_cast<float>(found) / (queries * k);
+    if (recall < 0.9f) {
+        std::cerr << "Recall too low: " << recall << std::endl;
+        return 2;
+    }
+
+    // Entfernen + Ausschluss der Referenz
+    index.remove(1);
+    auto hits = index.search(data[0], 5, 2);
+    for (const auto& hit : hits) {
+        if (hit.id == 1 || hit.id == 2) {
+            std::cerr << "Removed/excluded id returned: " << hit.id << std::endl;
+            return 3;
+        }
+    }
+
+    // Snapshot-Roundtrip
+    const char* path = "test_similarity.simidx";
+    if (!index.save(path)) {
+        std::cerr << "Save failed" << std::endl;
+        return 4;
+    }
+    SimilarityIndex loaded;
+    if (!loaded.load(path) || loaded.size() != index.size()) {
+        std::cerr << "Load failed" << std::endl;
+        return 5;
+    }
+    std::remove(path);
+    auto a = index.search(data[100], 10);
+    auto b = loaded.search(data[100], 10);
+    if (a.size() != b.size()) return 6;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].id != b[i].id) {
+            std::cerr << "Snapshot result mismatch" << std::endl;
+            return 6;
+        }
+    }
+
+    // Training ohne Lock: Änderungen zwischen prepare und apply bleiben auffindbar
+    if (!index.needsTraining()) {
+        for (size_t i = 0; i < 3 * count + 10; ++i) {
+            std::vector<float> v = data[i % count];
+            v[0] += 0.001f * static_cast<float>(i / count + 1);
+            index.upsert(static_cast<int64_t>(count + i + 1), v);
+        }
+    }
+    if (!index.needsTraining()) {
+        std::cerr << "Growth not detected" << std::endl;
+        return 7;
+    }
+    SimilarityIndex::TrainingJob job = index.prepareTraining();
+    SimilarityIndex::runTraining(job);
+    std::vector<float> moved = data[5];
+    for (auto& x : moved) x += 3.0f;
+    index.upsert(6, moved);
+    index.upsert(999999, data[7]);
+    index.applyTraining(job);
+    auto movedHits = index.search(moved, 1);
+    auto newHits = index.search(data[7], 50);
+    bool newFound = std::any_of(newHits.begin(), newHits.end(), [](const SimilarityIndex::Hit& h) { return h.id == 999999; });
+    if (index.needsTraining() || movedHits.empty() || movedHits[0].id != 6 || !newFound) {
+        std::cerr << "Split training lost updates" << std::endl;
+        return 8;
+    }
+
+    std::cout << "Similarity index test passed (recall@10 = " << recall << ")" << std::endl;
+    return 0;
+}
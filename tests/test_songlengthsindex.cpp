@@ -0,0 +1,185 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+#include "../include/SonglengthsDB.h"
+#include "../include/SonglengthsIndex.h"
+
+namespace {
+
+std::string fakeMD5(size_t i) {
+    static const char* hex = "0123456789abcdef";
+    std::string md5(32, '0');
+    uint64_t x = i * 0x9E3779B97F4A7C15ULL + 1;
+    for (size_t c = 0; c < 32; ++c) {
+        x ^= x >> 29;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        md5[c] = hex[(x >> 59) & 0xF];
+    }
+    return md5;
+}
+
+} // namespace
+
+int main() {
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_songlengthsindex_test_" + std::to_string(getpid());
+    std::filesystem::create_directories(dir);
+    std::string md5Path = dir + "/Songlengths.md5";
+    std::string indexPath = dir + "/songlengths.idx";
+    int rc = 0;
+
+    // SID außerhalb von C64Music: nur über den MD5-Fallback auffindbar
+    std::string sidPath = dir + "/moved.sid";
+    {
+        std::ofstream sid(sidPath, std::ios::binary);
+        std::vector<char> data(0x7C + 256, 0);
+        data[0] = 'P'; data[1] = 'S'; data[2] = 'I'; data[3] = 'D';
+        for (size_t i = 0x7C; i < data.size(); ++i) data[i] = static_cast<char>(i * 13);
+        sid.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+    std::string sidMD5 = SonglengthsDB::calculateSidMD5(sidPath);
+
+    const size_t count = 5000;
+    {
+        std::ofstream out(md5Path);
+        out << "[Database]\n";
+        for (size_t i = 0; i < count; ++i) {
+            out << "; /MUSICIANS/T/Tester_" << (i % 97) << "/Tune_" << i << ".sid\n";
+            out << fakeMD5(i) << "=";
+            for (size_t s = 0; s <= i % 4; ++s) {
+                out << (s ? " " : "") << (i % 7) << ":" << (10 + (i + s) % 50);
+                if (s == 1) out << ".750";
+                if (s == 2) out << "(G)";
+            }
+            out << "\n";
+        }
+        out << "; /MUSICIANS/T/Tester_1/Tune_1.sid\n" << fakeMD5(1) << "=9:59\n";   // spätere Zeile gewinnt
+        out << "; /elsewhere/moved.sid\n" << sidMD5 << "=1:02 0:33\n";
+    }
+
+    if (!SonglengthsIndex::build(md5Path, indexPath)) {
+        std::cerr << "Build failed" << std::endl;
+        return 1;
+    }
+    auto index = SonglengthsIndex::open(indexPath, md5Path);
+    if (!index || index->entryCount() != count + 1 || index->pathCount() != count + 1) {
+        std::cerr << "Open failed or wrong counts" << std::endl;
+        return 2;
+    }
+
+    // Jeder Pfad und Subtune liefert dasselbe wie die Text-Datenbank
+    SonglengthsDB reference;
+    reference.load(md5Path);
+    for (size_t i = 0; i < count && rc == 0; ++i) {
+        std::string path = "/hvsc/C64Music/MUSICIANS/T/Tester_" + std::to_string(i % 97) +
+                           "/Tune_" + std::to_string(i) + ".sid";
+        for (int subtune = 0; subtune <= 6; ++subtune) {
+            int expected = reference.getLength(path, subtune);
+            if (index->getLength(path, subtune) != expected) {
+                std::cerr << "Mismatch for " << path << " #" << subtune << ": "
+                          << index->getLength(path, subtune) << " != " << expected << std::endl;
+                rc = 3;
+                break;
+            }
+        }
+    }
+    if (index->getLength("/hvsc/C64Music/MUSICIANS/T/Tester_1/Tune_1.sid", 1) != 599) rc = 4;
+    if (index->getLengthByMD5(fakeMD5(2), 1) != reference.getLength("/C64Music/MUSICIANS/T/Tester_2/Tune_2.sid", 1)) rc = 5;
+
+    // Unbekannte Pfade/MD5s: 0, keine Fehltreffer im perfekten Hash
+    for (size_t i = count; i < count + 2000; ++i) {
+        if (index->getLength("/C64Music/MUSICIANS/T/Tester_0/Tune_" + std::to_string(i) + ".sid", 1) != 0 ||
+            index->getLengthByMD5(fakeMD5(i), 1) != 0) {
+            std::cerr << "False positive for unknown key " << i << std::endl;
+            rc = 6;
+            break;
+        }
+    }
+
+    // MD5-Fallback für Dateien, deren Pfad nicht im Index steht
+    if (index->getLength(sidPath, 1) != 62 || index->getLength(sidPath, 2) != 33 || index->getLength(sidPath, 3) != 0) {
+        std::cerr << "MD5 fallback failed" << std::endl;
+        rc = 7;
+    }
+
+    // Gleichzeitige Lookups ohne Lock
+    std::vector<std::thread> readers;
+    std::vector<int> failures(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t]() {
+            for (size_t i = t; i < count; i += 4) {
+                std::string md5 = fakeMD5(i);
+                if (i != 1 && index->getLengthByMD5(md5, 1) != static_cast<int>((i % 7) * 60 + 10 + i % 50)) {
+                    failures[t]++;
+                }
+            }
+        });
+    }
+    for (auto& reader : readers) reader.join();
+    for (int f : failures) {
+        if (f > 0) {
+            std::cerr << "Concurrent lookups failed" << std::endl;
+            rc = 8;
+        }
+    }
+
+    // Geänderte Quelle: alter Index gilt als veraltet, openOrBuild baut neu
+    {
+        std::ofstream out(md5Path, std::ios::app);
+        out << "; /MUSICIANS/N/New/Added.sid\n" << fakeMD5(count + 10) << "=2:00\n";
+    }
+    if (index->matchesSource(md5Path) || SonglengthsIndex::open(indexPath, md5Path)) {
+        std::cerr << "Stale index not detected" << std::endl;
+        rc = 9;
+    }
+    auto rebuilt = SonglengthsIndex::openOrBuild(md5Path, indexPath);
+    if (!rebuilt || rebuilt->getLength("/C64Music/MUSICIANS/N/New/Added.sid", 1) != 120 ||
+        index->getLength(sidPath, 1) != 62) {   // alte Abbildung bleibt gültig
+        std::cerr << "Rebuild failed" << std::endl;
+        rc = 10;
+    }
+
+    // Eigene Messungen außerhalb von HVSC: gleichnamige Dateien kollidieren nicht
+    {
+        std::string otherDir = dir + "/other";
+        std::filesystem::create_directories(otherDir);
+        std::string otherPath = otherDir + "/moved.sid";
+        std::ofstream sid(otherPath, std::ios::binary);
+        std::vector<char> data(0x7C + 256, 0);
+        data[0] = 'P'; data[1] = 'S'; data[2] = 'I'; data[3] = 'D';
+        for (size_t i = 0x7C; i < data.size(); ++i) data[i] = static_cast<char>(i * 7);
+        sid.write(data.data(), static_cast<std::streamsize>(data.size()));
+        sid.close();
+
+        std::string customPath = dir + "/custom.md5";
+        SonglengthsDB custom;
+        custom.addCustomLength(sidPath, 1, 42, customPath);
+        SonglengthsDB reloaded;
+        reloaded.load(customPath, true);
+        if (custom.getLength(otherPath, 1) != 0 || reloaded.getLength(otherPath, 1) != 0 ||
+            reloaded.getLength(sidPath, 1) != 42) {
+            std::cerr << "Custom length keyed by file name" << std::endl;
+            rc = 12;
+        }
+    }
+
+    // Beschädigte Datei wird abgelehnt
+    {
+        std::ofstream out(indexPath, std::ios::binary | std::ios::trunc);
+        out << "garbage";
+    }
+    if (SonglengthsIndex::open(indexPath)) {
+        std::cerr << "Corrupt index accepted" << std::endl;
+        rc = 11;
+    }
+
+    std::filesystem::remove_all(dir);
+    if (rc == 0) std::cout << "Songlengths index tests passed." << std::endl;
+    return rc;
+}
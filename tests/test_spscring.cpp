@@ -0,0 +1,67 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../include/SPSCRingBuffer.h"
+
+int main() {
+    // Kapazität wird auf Zweierpotenz aufgerundet, voll/leer werden erkannt
+    SPSCRingBuffer<int> small(5);
+    if (small.capacity() != 8) {
+        std::cerr << "Capacity not rounded: " << small.capacity() << std::endl;
+        return 1;
+    }
+    for (int i = 0; i < 8; ++i) {
+        if (!small.tryPush(int(i))) {
+            std::cerr << "Push failed before full" << std::endl;
+            return 2;
+        }
+    }
+    int value = 0;
+    if (small.tryPush(int(99)) || small.size() != 8) {
+        std::cerr << "Push succeeded on full ring" << std::endl;
+        return 3;
+    }
+    for (int i = 0; i < 8; ++i) {
+        if (!small.tryPop(value) || value != i) {
+            std::cerr << "FIFO order broken at " << i << std::endl;
+            return 4;
+        }
+    }
+    if (small.tryPop(value) || !small.empty()) {
+        std::cerr << "Pop succeeded on empty ring" << std::endl;
+        return 5;
+    }
+
+    // Producer/Consumer in zwei Threads: Reihenfolge und Inhalt bleiben erhalten,
+    // verschobene Puffer kommen vollständig an
+    const size_t count = 200000;
+    SPSCRingBuffer<std::vector<int>> ring(16);
+    std::thread producer([&]() {
+        for (size_t i = 0; i < count; ++i) {
+            std::vector<int> item(4, static_cast<int>(i));
+            while (!ring.tryPush(std::move(item))) std::this_thread::yield();
+        }
+    });
+
+    size_t received = 0;
+    bool ok = true;
+    std::vector<int> item;
+    while (received < count) {
+        if (!ring.tryPop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (item.size() != 4 || item[0] != static_cast<int>(received) || item[3] != static_cast<int>(received)) {
+            ok = false;
+        }
+        received++;
+    }
+    producer.join();
+    if (!ok || !ring.empty()) {
+        std::cerr << "Concurrent transfer corrupted" << std::endl;
+        return 6;
+    }
+
+    std::cout << "SPSC ring buffer tests passed." << std::endl;
+    return 0;
+}
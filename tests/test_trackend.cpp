@@ -0,0 +1,136 @@
+#include <iostream>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "../include/TrackEndDetector.h"
+
+namespace {
+
+const int kRate = 44100;
+
+// Pseudo-SID-Melodie: Rechteck-Noten mit zufälliger Frequenz/Lautstärke, 120 ms pro Note
+void appendMelody(std::vector<int16_t>& pcm, double seconds, unsigned seed, double& phase) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> freq(110.0, 880.0);
+    std::uniform_real_distribution<double> amp(0.05, 0.5);
+    std::uniform_int_distribution<int> dither(-2, 2);
+    const size_t noteFrames = kRate * 12 / 100;
+    const size_t total = static_cast<size_t>(seconds * kRate);
+    double f = freq(rng), a = amp(rng);
+    for (size_t i = 0; i < total; ++i) {
+        if (i % noteFrames == 0) {
+            f = freq(rng);
+            a = amp(rng);
+        }
+        phase += f / kRate;
+        double value = (std::fmod(phase, 1.0) < 0.5 ? a : -a) * 32767.0;
+        int16_t s = static_cast<int16_t>(value + dither(rng));
+        pcm.push_back(s);
+        pcm.push_back(s);
+    }
+}
+
+void appendSilence(std::vector<int16_t>& pcm, double seconds) {
+    pcm.insert(pcm.end(), static_cast<size_t>(seconds * kRate) * 2, 0);
+}
+
+// Füttert den Detektor in 0,5-s-Blöcken wie der Renderer
+void feed(TrackEndDetector& detector, const std::vector<int16_t>& pcm) {
+    const size_t chunk = kRate / 2;
+    for (size_t frame = 0; frame * 2 < pcm.size(); frame += chunk) {
+        size_t count = std::min(chunk, pcm.size() / 2 - frame);
+        if (detector.push(pcm.data() + frame * 2, count)) break;
+    }
+}
+
+} // namespace
+
+int main() {
+    int rc = 0;
+
+    // Intro 7 s + Hauptteil 25 s in Endlosschleife → Ende bei 32 s
+    {
+        std::vector<int16_t> pcm;
+        double phase = 0.0;
+        appendMelody(pcm, 7.0, 1, phase);
+        for (int i = 0; i < 4; ++i) appendMelody(pcm, 25.0, 2, phase);
+        TrackEndDetector detector(kRate, 2);
+        feed(detector, pcm);
+        if (detector.reason() != TrackEndDetector::Reason::Loop ||
+            std::fabs(detector.endSeconds() - 32.0) > 0.5 || std::fabs(detector.loopSeconds() - 25.0) > 0.1) {
+            std::cerr << "Loop not detected: reason " << static_cast<int>(detector.reason()) << ", end "
+                      << detector.endSeconds() << " s, period " << detector.loopSeconds() << " s" << std::endl;
+            rc = 1;
+        }
+        // Abbruch kurz nach dem zweiten Durchlauf, nicht erst am Ende
+        if (detector.framesSeen() > static_cast<size_t>(58 * kRate)) {
+            std::cerr << "Loop detected too late: " << detector.framesSeen() / kRate << " s" << std::endl;
+            rc = 2;
+        }
+    }
+
+    // 12 s Musik, danach Stille
+    {
+        std::vector<int16_t> pcm;
+        double phase = 0.0;
+        appendMelody(pcm, 12.0, 3, phase);
+        appendSilence(pcm, 60.0);
+        TrackEndDetector detector(kRate, 2);
+        feed(detector, pcm);
+        if (detector.reason() != TrackEndDetector::Reason::Silence || std::fabs(detector.endSeconds() - 12.0) > 0.05 ||
+            detector.framesSeen() > static_cast<size_t>(17 * kRate)) {
+            std::cerr << "Silence not detected: end " << detector.endSeconds() << " s after "
+                      << detector.framesSeen() / kRate << " s" << std::endl;
+            rc = 3;
+        }
+    }
+
+    // Komplett stummer Tune
+    {
+        std::vector<int16_t> pcm;
+        appendSilence(pcm, 30.0);
+        TrackEndDetector detector(kRate, 2);
+        feed(detector, pcm);
+        if (detector.reason() != TrackEndDetector::Reason::Silence || detector.endFrame() != 0 || detector.heardSound()) {
+            std::cerr << "Silent tune not recognized" << std::endl;
+            rc = 4;
+        }
+    }
+
+    // Ohne Wiederholung und Dauerton: kein Ende
+    {
+        std::vector<int16_t> pcm;
+        double phase = 0.0;
+        for (unsigned seed = 10; seed < 16; ++seed) appendMelody(pcm, 15.0, seed, phase);
+        for (size_t i = 0; i < static_cast<size_t>(40 * kRate); ++i) {
+            int16_t s = static_cast<int16_t>(8000.0 * std::sin(2.0 * M_PI * 440.0 * i / kRate));
+            pcm.push_back(s);
+            pcm.push_back(s);
+        }
+        TrackEndDetector detector(kRate, 2);
+        feed(detector, pcm);
+        if (detector.finished()) {
+            std::cerr << "False end: reason " << static_cast<int>(detector.reason()) << " at "
+                      << detector.endSeconds() << " s" << std::endl;
+            rc = 5;
+        }
+    }
+
+    // Loop-Erkennung abschaltbar (bekannte Länge aus Songlengths)
+    {
+        std::vector<int16_t> pcm;
+        double phase = 0.0;
+        for (int i = 0; i < 3; ++i) appendMelody(pcm, 12.0, 4, phase);
+        TrackEndDetector::Settings settings;
+        settings.detectLoops = false;
+        TrackEndDetector detector(kRate, 2, settings);
+        feed(detector, pcm);
+        if (detector.finished()) {
+            std::cerr << "Loop detected although disabled" << std::endl;
+            rc = 6;
+        }
+    }
+
+    if (rc == 0) std::cout << "Track end detector tests passed." << std::endl;
+    return rc;
+}
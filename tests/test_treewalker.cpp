@@ -0,0 +1,129 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+#include "../include/ParallelTreeWalker.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void writeFile(const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    out << "x";
+}
+
+// Referenz: sequentieller Durchlauf mit fs::recursive_directory_iterator
+std::vector<std::string> reference(const std::string& root, const std::vector<std::string>& extensions) {
+    std::vector<std::string> files;
+    for (const auto& entry : fs::recursive_directory_iterator(root)) {
+        if (!entry.is_regular_file()) continue;
+        std::string ext = entry.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (std::find(extensions.begin(), extensions.end(), ext) != extensions.end()) {
+            files.push_back(entry.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+} // namespace
+
+int main() {
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string root = tmp + "/songgen_treewalker_test_" + std::to_string(getpid());
+    int rc = 0;
+
+    // Breiter und tiefer Baum mit gemischten Endungen
+    for (int a = 0; a < 20; ++a) {
+        for (int b = 0; b < 5; ++b) {
+            std::string dir = root + "/A" + std::to_string(a) + "/B" + std::to_string(b);
+            fs::create_directories(dir);
+            for (int f = 0; f < 10; ++f) {
+                writeFile(dir + "/tune" + std::to_string(f) + (f % 3 == 0 ? ".SID" : f % 3 == 1 ? ".sid" : ".txt"));
+            }
+        }
+    }
+    fs::create_directories(root + "/deep/a/b/c/d/e/f/g");
+    writeFile(root + "/deep/a/b/c/d/e/f/g/last.sid");
+    writeFile(root + "/top.sid");
+    writeFile(root + "/.hidden.sid");
+    fs::create_directories(root + "/empty");
+
+    // Symlink auf Datei zählt, Symlink auf Verzeichnis wird nicht verfolgt (kein Zyklus)
+    fs::create_symlink(root + "/top.sid", root + "/empty/link.sid");
+    fs::create_directory_symlink(root, root + "/deep/loop");
+
+    ParallelTreeWalker::Options options;
+    options.extensions = {".sid"};
+    options.threads = 8;
+    ParallelTreeWalker walker(options);
+
+    auto files = walker.collect(root + "/");
+    auto expected = reference(root, {".sid"});
+    if (files != expected) {
+        std::cerr << "Mismatch: " << files.size() << " vs " << expected.size() << std::endl;
+        rc = 2;
+    }
+    if (files.size() != 20 * 5 * 7 + 4 || walker.lastStats().directories != 1 + 20 + 100 + 8 + 1) {
+        std::cerr << "Unexpected counts: " << files.size() << " files, "
+                  << walker.lastStats().directories << " dirs" << std::endl;
+        rc = 3;
+    }
+    if (!walker.errors().empty()) {
+        std::cerr << "Unexpected error: " << walker.errors().front() << std::endl;
+        rc = 4;
+    }
+
+    // Ein einzelner Thread liefert dasselbe Ergebnis
+    options.threads = 1;
+    if (ParallelTreeWalker(options).collect(root) != expected) {
+        std::cerr << "Single-threaded walk differs" << std::endl;
+        rc = 5;
+    }
+
+    // root als Datei bzw. nicht vorhanden
+    if (walker.collect(root + "/top.sid") != std::vector<std::string>{root + "/top.sid"}) {
+        std::cerr << "File root not handled" << std::endl;
+        rc = 6;
+    }
+    if (!walker.collect(root + "/missing").empty() || walker.errors().size() != 1) {
+        std::cerr << "Missing root not reported" << std::endl;
+        rc = 7;
+    }
+
+    // Ohne Endungsfilter: alle Dateien
+    if (ParallelTreeWalker().collect(root + "/A0").size() != 5 * 10) {
+        std::cerr << "Unfiltered walk wrong" << std::endl;
+        rc = 8;
+    }
+
+    // Verzeichnis-Listings
+    auto listing = ParallelTreeWalker::listNames(root + "/A0/B0");
+    if (!listing.exists || !listing.readable || listing.names.size() != 10 || !listing.names.count("tune0.SID")) {
+        std::cerr << "listNames wrong" << std::endl;
+        rc = 9;
+    }
+    auto missing = ParallelTreeWalker::listNames(root + "/nope");
+    auto notDir = ParallelTreeWalker::listNames(root + "/top.sid");
+    if (missing.exists || missing.readable || notDir.exists) {
+        std::cerr << "listNames on missing dir wrong" << std::endl;
+        rc = 10;
+    }
+
+    auto listings = ParallelTreeWalker::listDirectories({root + "/A1/B1", root + "/nope", root + "/A1/B1", root + "/empty"});
+    if (listings.size() != 3 || listings[root + "/A1/B1"].names.size() != 10 ||
+        listings[root + "/nope"].exists || listings[root + "/empty"].names.size() != 1) {
+        std::cerr << "listDirectories wrong" << std::endl;
+        rc = 11;
+    }
+
+    fs::remove_all(root);
+    if (rc == 0) std::cout << "Tree walker tests passed." << std::endl;
+    return rc;
+}
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include "../include/WorkStealingPool.h"
+
+int main() {
+    const size_t taskCount = 1000;
+    WorkStealingPool pool(4);
+
+    // Jeder Task muss genau einmal laufen
+    std::vector<std::atomic<int>> hits(taskCount);
+    for (auto& h : hits) h = 0;
+
+    pool.run(taskCount, [&](size_t idx, size_t worker) {
+        if (worker >= pool.threadCount()) {
+            std::cerr << "Invalid worker index: " << worker << std::endl;
+            return;
+        }
+        hits[idx]++;
+        // Ungleich lange Tasks, damit gestohlen wird
+        if (idx % 4 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    for (size_t i = 0; i < taskCount; ++i) {
+        if (hits[i] != 1) {
+            std::cerr << "Task " << i << " executed " << hits[i] << " times" << std::endl;
+            return 2;
+        }
+    }
+
+    size_t executed = 0;
+    for (const auto& stats : pool.lastStats()) executed += stats.tasksExecuted;
+    if (executed != taskCount) {
+        std::cerr << "Stats mismatch: " << executed << " != " << taskCount << std::endl;
+        return 3;
+    }
+
+    // Stop-Flag: nach dem Setzen dürfen keine neuen Tasks starten
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> started(0);
+    pool.run(taskCount, [&](size_t, size_t) {
+        if (++started >= 10) stop = true;
+    }, &stop);
+    if (started >= taskCount) {
+        std::cerr << "Stop flag ignored" << std::endl;
+        return 4;
+    }
+
+    // Limiter: nie mehr als 2 gleichzeitig im kritischen Abschnitt
+    InFlightLimiter limiter(2);
+    std::atomic<int> inFlight(0);
+    std::atomic<int> maxSeen(0);
+    pool.run(64, [&](size_t, size_t) {
+        InFlightLimiter::Slot slot(limiter);
+        int now = ++inFlight;
+        int prev = maxSeen.load();
+        while (now > prev && !maxSeen.compare_exchange_weak(prev, now)) {}
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        --inFlight;
+    });
+    if (maxSeen > 2) {
+        std::cerr << "Limiter exceeded: " << maxSeen << std::endl;
+        return 5;
+    }
+
+    // Längste zuerst: 4 lange + viele kurze Jobs, der Tail bleibt unter einem langen Job
+    std::vector<int> durationsMs(4, 60);
+    durationsMs.resize(124, 3);
+    pool.run(durationsMs.size(), [&](size_t idx, size_t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(durationsMs[idx]));
+    });
+    double busy = 0.0;
+    for (const auto& stats : pool.lastStats()) {
+        busy += stats.busySeconds;
+        if (stats.finishSeconds > pool.lastRunSeconds() + 1e-6) {
+            std::cerr << "Worker finished after run end" << std::endl;
+            return 6;
+        }
+    }
+    double firstIdle = pool.lastRunSeconds();
+    for (const auto& stats : pool.lastStats()) firstIdle = std::min(firstIdle, stats.finishSeconds);
+    if (busy < 0.5 || busy > pool.lastRunSeconds() * pool.lastStats().size() * 1.01 ||
+        pool.lastRunSeconds() - firstIdle > 0.06) {
+        std::cerr << "Utilization stats implausible: busy " << busy << " s, run " << pool.lastRunSeconds()
+                  << " s, tail " << pool.lastRunSeconds() - firstIdle << " s" << std::endl;
+        return 7;
+    }
+    pool.printUtilization("LJF-Test", true);
+
+    std::cout << "Work-stealing pool tests passed." << std::endl;
+    return 0;
+}
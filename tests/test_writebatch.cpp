@@ -0,0 +1,165 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+#include "../include/MediaDatabase.h"
+
+namespace {
+
+MediaMetadata track(const std::string& name) {
+    MediaMetadata meta;
+    meta.filepath = "/music/" + name + ".sid";
+    meta.fileHash = "hash-" + name;
+    meta.title = name;
+    meta.genre = "SID";
+    return meta;
+}
+
+} // namespace
+
+int main() {
+    std::string tmp = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    std::string dir = tmp + "/songgen_writebatch_test_" + std::to_string(getpid());
+    std::filesystem::create_directories(dir);
+    int rc = 0;
+
+    {
+        MediaDatabase db(dir + "/media.db");
+        if (!db.initialize()) return 1;
+
+        // 1. Gezählt wird erst nach dem Commit; Leser sehen vorher nichts
+        {
+            MediaDatabase::WriteBatch batch(db, 100, 60000);
+            for (int i = 0; i < 10; ++i) batch.add(track("a" + std::to_string(i)));
+            if (batch.written() != 0 || db.getTotalCount() != 0) {
+                std::cerr << "Rows counted before commit" << std::endl;
+                rc = 2;
+            }
+            if (!batch.commit() || batch.written() != 10 || batch.failed() != 0 || db.getTotalCount() != 10) {
+                std::cerr << "Commit accounting wrong: " << batch.written() << std::endl;
+                rc = 3;
+            }
+        }
+
+        // 2. Zeitgrenze: nach maxOpenMs committet die nächste Operation
+        {
+            MediaDatabase::WriteBatch batch(db, 100, 50);
+            batch.add(track("b0"));
+            std::this_thread::sleep_for(std::chrono::milliseconds(80));
+            batch.add(track("b1"));
+            if (batch.written() != 2 || db.getTotalCount() != 12) {
+                std::cerr << "Time bound not applied" << std::endl;
+                rc = 4;
+            }
+        }
+
+        // 3. Fremde Schreibzugriffe werden nicht in die offene Transaktion gefaltet
+        {
+            MediaDatabase::WriteBatch first(db, 100, 60000);
+            first.add(track("c0"));
+            db.addMedia(track("c1"));
+            if (first.written() != 1 || db.getTotalCount() != 14) {
+                std::cerr << "Foreign write folded into batch" << std::endl;
+                rc = 5;
+            }
+
+            MediaDatabase::WriteBatch second(db, 100, 60000);
+            first.add(track("c2"));
+            second.add(track("c3"));
+            if (first.written() != 2 || second.written() != 0) {
+                std::cerr << "Batches share a transaction" << std::endl;
+                rc = 6;
+            }
+            // Duplikatprüfung sieht offene Einträge, ohne sie zu committen
+            if (!db.existsByPath(track("c3").filepath) || second.written() != 0) {
+                std::cerr << "Lookup committed the open batch" << std::endl;
+                rc = 7;
+            }
+            second.commit();
+            // Bereits vorhandener Pfad zählt nicht als geschrieben
+            second.add(track("c3"));
+            second.commit();
+            if (second.written() != 1 || db.getTotalCount() != 16) {
+                std::cerr << "Unexpected row count " << db.getTotalCount() << std::endl;
+                rc = 8;
+            }
+        }
+
+        // 4. Mehrere Worker auf einem Batch
+        {
+            MediaDatabase::WriteBatch batch(db, 7);
+            std::vector<std::thread> workers;
+            for (int w = 0; w < 4; ++w) {
+                workers.emplace_back([&batch, w] {
+                    for (int i = 0; i < 50; ++i) batch.add(track("d" + std::to_string(w) + "_" + std::to_string(i)));
+                });
+            }
+            for (auto& worker : workers) worker.join();
+            batch.commit();
+            if (batch.written() != 200 || db.getTotalCount() != 216) {
+                std::cerr << "Concurrent batch lost rows" << std::endl;
+                rc = 9;
+            }
+        }
+
+        // 5. Datenbank-Aufrufe im iterate-Callback: alle 4 Leser sind verliehen,
+        //    verschachtelte Lese- und Schreibzugriffe dürfen trotzdem nicht blockieren
+        {
+            const int threads = 4;
+            std::mutex mutex;
+            std::condition_variable allInside;
+            int inside = 0;
+            std::atomic<int> nestedOk(0);
+            std::vector<std::thread> readers;
+            for (int t = 0; t < threads; ++t) {
+                readers.emplace_back([&, t] {
+                    MediaDatabase::MediaQuery query;
+                    query.limit = 1;
+                    db.iterate(query, [&](const MediaMetadata& meta) {
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            if (++inside == threads) allInside.notify_all();
+                            allInside.wait(lock, [&] { return inside == threads; });
+                        }
+                        bool ok = db.getByIds({meta.id}).size() == 1 && db.getTotalCount() >= 216;
+                        ok = db.addMedia(track("e" + std::to_string(t))) && ok;
+                        if (ok) nestedOk++;
+                        return false;
+                    });
+                });
+            }
+            for (auto& reader : readers) reader.join();
+            if (nestedOk != threads || db.getTotalCount() != 216 + threads) {
+                std::cerr << "Nested calls inside iterate failed" << std::endl;
+                rc = 10;
+            }
+        }
+
+        // 6. Lesen innerhalb einer offenen Batch-Transaktion über die Writer-Verbindung
+        {
+            MediaDatabase::WriteBatch batch(db, 100, 60000);
+            batch.add(track("f0"));
+            size_t seen = 0;
+            MediaDatabase::MediaQuery query;
+            db.iterate(query, [&](const MediaMetadata&) {
+                if (!db.existsByPath(track("f0").filepath)) return false;
+                return ++seen < 3;
+            });
+            if (seen != 3 || batch.written() != 0) {
+                std::cerr << "Lookup inside iterate failed" << std::endl;
+                rc = 11;
+            }
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    if (rc == 0) std::cout << "Write batch tests passed." << std::endl;
+    return rc;
+}